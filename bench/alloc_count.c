@@ -0,0 +1,39 @@
+#include "alloc_count.h"
+
+/**
+ * @brief Funciones reales de glibc, usadas por los reemplazos que cuentan asignaciones.
+ */
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t nmemb, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+static size_t alloc_count;
+
+size_t alloc_count_get(void)
+{
+    return alloc_count;
+}
+
+void* malloc(size_t size)
+{
+    alloc_count++;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t nmemb, size_t size)
+{
+    alloc_count++;
+    return __libc_calloc(nmemb, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    alloc_count++;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr)
+{
+    __libc_free(ptr);
+}
@@ -0,0 +1,20 @@
+/**
+ * @file alloc_count.h
+ * @brief Conteo de asignaciones del proceso para los benchmarks.
+ *
+ * alloc_count.c reemplaza malloc, calloc y realloc por versiones que cuentan cada llamada y
+ * delegan en glibc. Basta con enlazarlo en el ejecutable del benchmark.
+ */
+
+#ifndef ALLOC_COUNT_H
+#define ALLOC_COUNT_H
+
+#include <stddef.h>
+
+/**
+ * @brief Cantidad de asignaciones realizadas por el proceso (incluye las internas de libc).
+ * @return Llamadas a malloc, calloc y realloc desde el arranque.
+ */
+size_t alloc_count_get(void);
+
+#endif // ALLOC_COUNT_H
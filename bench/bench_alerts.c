@@ -0,0 +1,166 @@
+/**
+ * @file bench_alerts.c
+ * @brief Mide el costo por tick del motor de alertas con cientos de reglas.
+ *
+ * Compila -r reglas repartidas entre señales fijas, tasas, meminfo, PSI y estados TCP, y las
+ * evalúa sobre muestras sintéticas con un pico de 20 ticks cada 500, de modo que haya disparos
+ * y resoluciones sin que dominen el costo (en un host real la gran mayoría de los ticks no
+ * cambia el estado de ninguna regla). Los eventos no se escriben al FIFO: se cuentan; el log de
+ * cambios de estado va a /dev/null por el logger asíncrono, como en el agente. Falla si el costo
+ * medio por tick supera el presupuesto.
+ *
+ * Uso: bench_alerts [-r reglas] [-n ticks] [-b presupuesto_us]
+ */
+
+#include "alerts.h"
+#include "events.h"
+#include "log.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static long transitions;
+
+// Reemplaza al de events.c: el benchmark solo cuenta los cambios de estado
+void events_publish(const char* json, size_t length)
+{
+    (void)json;
+    (void)length;
+    transitions++;
+}
+
+static const char* const templates[] = {
+    "cpu_usage > %d for 2s",
+    "rate(context_switches) > %d000",
+    "used_memory >= %d00",
+    "meminfo.Dirty > %d000000",
+    "psi.memory.some.avg10 > %d",
+    "tcp.close_wait > %d",
+    "rate(rx_bytes) > %d00000 for 3s",
+    "net.Tcp.RetransSegs != %d",
+    "irq_imbalance_ratio > 1.%d",
+    "running_processes < %d",
+};
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Muestra del tick: reposo, salvo 20 ticks de pico cada 500.
+ */
+static void fill_sample(metrics_sample_t* sample, long tick)
+{
+    bool peak = tick % 500 >= 480;
+    int dirty = -1;
+    for (int f = 0; f < meminfo_field_count(); f++)
+    {
+        if (strcmp(meminfo_field_name(f), "Dirty") == 0)
+        {
+            dirty = f;
+        }
+    }
+
+    sample->cpu_usage = peak ? 95 : 10;
+    sample->context_switches += peak ? 80000 : 2000;
+    sample->memory.used_mem = peak ? 7000 : 1000;
+    sample->net.rx_bytes += peak ? 50000000 : 1000;
+    sample->running_processes = peak ? 2 : 40;
+    sample->irq_imbalance = peak ? 3 : 1;
+    if (dirty >= 0)
+    {
+        sample->meminfo.present[dirty] = true;
+        sample->meminfo.values[dirty] = peak ? 200000 : 100;
+    }
+    sample->psi[PSI_MEMORY].some.present = true;
+    sample->psi[PSI_MEMORY].some.avg10 = peak ? 40 : 0;
+    sample->netproto.have_states = true;
+    sample->netproto.tcp_states[8] = peak ? 500 : 0; // TCP_CLOSE_WAIT
+    int retrans = netproto_counter_index("Tcp", "RetransSegs");
+    if (retrans >= 0)
+    {
+        sample->netproto.present[retrans] = true;
+        sample->netproto.counters[retrans] += peak ? 10 : 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int rules = 500;
+    long ticks = 200000;
+    double budget_us = 20;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:n:b:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            rules = atoi(optarg);
+            break;
+        case 'n':
+            ticks = atol(optarg);
+            break;
+        case 'b':
+            budget_us = atof(optarg);
+            break;
+        default:
+            fprintf(stderr, "Uso: %s [-r reglas] [-n ticks] [-b presupuesto_us]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    log_start("/dev/null");
+    alert_program_t* program = alert_program_new();
+    if (program == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+    size_t template_count = sizeof(templates) / sizeof(templates[0]);
+    for (int i = 0; i < rules && i < ALERTS_MAX_RULES; i++)
+    {
+        char name[32], expr[ALERT_EXPR_MAX], error[96];
+        snprintf(name, sizeof(name), "rule_%d", i);
+        snprintf(expr, sizeof(expr), templates[(size_t)i % template_count], 1 + i % 90);
+        if (alert_program_add(program, name, expr, error, sizeof(error)) != 0)
+        {
+            fprintf(stderr, "Regla inválida '%s': %s\n", expr, error);
+            alert_program_free(program);
+            return EXIT_FAILURE;
+        }
+    }
+    printf("%d reglas, %d slots\n", program->rule_count, program->slot_count);
+    alerts_install(program);
+
+    metrics_sample_t* sample = calloc(1, sizeof(*sample));
+    if (sample == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+    double elapsed = 0;
+    for (long tick = 0; tick < ticks; tick++)
+    {
+        fill_sample(sample, tick);
+        double start = now_ns();
+        alerts_evaluate(sample, tick * 1000);
+        elapsed += now_ns() - start;
+    }
+    free(sample);
+    alerts_install(NULL);
+    log_stop();
+
+    double per_tick_us = elapsed / (double)ticks / 1000.0;
+    printf("alerts_evaluate: %.2f us/tick (%.1f ns/regla), %ld cambios de estado, presupuesto %.1f us\n",
+           per_tick_us, per_tick_us * 1000.0 / rules, transitions, budget_us);
+    if (per_tick_us > budget_us)
+    {
+        fprintf(stderr, "El motor de alertas supera el presupuesto por tick\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
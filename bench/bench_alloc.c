@@ -0,0 +1,312 @@
+/**
+ * @file bench_alloc.c
+ * @brief Compara los métodos de asignación sobre la misma traza de reservas y liberaciones.
+ *
+ * La traza reproduce el patrón de simulate_memory_activity(): reservas de tamaño aleatorio,
+ * mayormente chicas, intercaladas con liberaciones de bloques vivos al azar. Se genera con una
+ * semilla fija para que todos los métodos reciban exactamente la misma secuencia.
+ *
+ * Cada método corre en un proceso hijo propio para que su pico de RSS y su fragmentación no se
+ * mezclen con los de los demás. Se reporta:
+ *  - ops/s: reservas y liberaciones por segundo.
+ *  - pico RSS: crecimiento del máximo de memoria residente durante la traza.
+ *  - fragmentación: allocator_fragmentation() al final, con los bloques vivos todavía reservados.
+ */
+
+#include "allocator.h"
+#include "memory.h"
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Bloques vivos como máximo durante la traza.
+ */
+#define LIVE_SLOTS 4096
+
+/**
+ * @brief Una operación: reservar size bytes en el slot, o liberarlo si size es 0.
+ */
+typedef struct
+{
+    uint32_t slot;
+    uint32_t size;
+} trace_op_t;
+
+/**
+ * @brief Resultado de un método, enviado del hijo al padre por un pipe.
+ */
+typedef struct
+{
+    double ops_per_s;
+    double peak_rss_mb;
+    double fragmentation;
+    unsigned long corrupted;
+} alloc_result_t;
+
+/**
+ * @brief Generador xorshift64*: determinista e independiente de la libc.
+ */
+static uint64_t next_random(uint64_t* state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief Tamaño log-uniforme en [lo, hi].
+ */
+static uint32_t random_size(uint64_t* state, uint32_t lo, uint32_t hi)
+{
+    double u = (double)(next_random(state) >> 11) / (double)(1ULL << 53);
+    double log_lo = log((double)lo);
+    double log_hi = log((double)hi);
+    return (uint32_t)exp(log_lo + u * (log_hi - log_lo));
+}
+
+/**
+ * @brief Genera la traza: 70% bloques de 16 B a 512 B, 25% hasta 16 kB y 5% hasta 256 kB.
+ */
+static trace_op_t* build_trace(size_t count, uint64_t seed)
+{
+    trace_op_t* ops = malloc(count * sizeof(*ops));
+    bool* live = calloc(LIVE_SLOTS, sizeof(*live));
+    if (ops == NULL || live == NULL)
+    {
+        free(ops);
+        free(live);
+        return NULL;
+    }
+
+    uint64_t state = seed;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t slot = (uint32_t)(next_random(&state) % LIVE_SLOTS);
+        ops[i].slot = slot;
+        if (live[slot])
+        {
+            ops[i].size = 0;
+            live[slot] = false;
+            continue;
+        }
+        uint32_t kind = (uint32_t)(next_random(&state) % 100);
+        if (kind < 70)
+        {
+            ops[i].size = random_size(&state, 16, 512);
+        }
+        else if (kind < 95)
+        {
+            ops[i].size = random_size(&state, 512, 16384);
+        }
+        else
+        {
+            ops[i].size = random_size(&state, 16384, 262144);
+        }
+        live[slot] = true;
+    }
+    free(live);
+    return ops;
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static long max_rss_kb(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief Reproduce la traza con el método ya seleccionado.
+ *
+ * Cada bloque se marca en su primer y último byte y se verifica al liberarlo, de modo que un
+ * allocator que solape bloques no pueda pasar por rápido.
+ */
+static void replay(const trace_op_t* ops, size_t count, alloc_result_t* result)
+{
+    static unsigned char* blocks[LIVE_SLOTS];
+    static uint32_t sizes[LIVE_SLOTS];
+
+    long rss_before = max_rss_kb();
+    double start = now_seconds();
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t slot = ops[i].slot;
+        if (ops[i].size == 0)
+        {
+            unsigned char mark = (unsigned char)slot;
+            if (blocks[slot][0] != mark || blocks[slot][sizes[slot] - 1] != mark)
+            {
+                result->corrupted++;
+            }
+            allocator_free(blocks[slot]);
+            blocks[slot] = NULL;
+            continue;
+        }
+        blocks[slot] = allocator_malloc(ops[i].size);
+        if (blocks[slot] == NULL)
+        {
+            fprintf(stderr, "Sin memoria en la operación %zu (%u bytes)\n", i, ops[i].size);
+            exit(EXIT_FAILURE);
+        }
+        sizes[slot] = ops[i].size;
+        blocks[slot][0] = (unsigned char)slot;
+        blocks[slot][ops[i].size - 1] = (unsigned char)slot;
+    }
+    double elapsed = now_seconds() - start;
+
+    result->ops_per_s = (double)count / elapsed;
+    result->peak_rss_mb = (double)(max_rss_kb() - rss_before) / 1024.0;
+    result->fragmentation = allocator_fragmentation(); // Con los bloques vivos todavía reservados
+
+    for (int slot = 0; slot < LIVE_SLOTS; slot++)
+    {
+        allocator_free(blocks[slot]);
+    }
+}
+
+/**
+ * @brief Corre un método en un proceso hijo y recibe su resultado.
+ * @return 0 si el hijo terminó bien, -1 en caso contrario.
+ */
+static int run_method(int method, const trace_op_t* ops, size_t count, alloc_result_t* result)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        fprintf(stderr, "Error al crear el pipe: %s\n", strerror(errno));
+        return -1;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        fprintf(stderr, "Error en fork: %s\n", strerror(errno));
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (pid == 0)
+    {
+        alloc_result_t child = {0};
+        close(fds[0]);
+        allocator_select(method);
+        replay(ops, count, &child);
+        ssize_t written = write(fds[1], &child, sizeof(child));
+        _exit(written == (ssize_t)sizeof(child) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(fds[1]);
+    ssize_t got = read(fds[0], result, sizeof(*result));
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    if (got != (ssize_t)sizeof(*result) || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+    {
+        fprintf(stderr, "El método %s no terminó la traza\n", allocator_method_name(method));
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    static const int methods[] = {FIRST_FIT, BEST_FIT, WORST_FIT, SEGREGATED_FIT};
+    size_t count = 1000000;
+    uint64_t seed = 31;
+    const char* json_file = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:o:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            count = strtoull(optarg, NULL, 10);
+            break;
+        case 'o':
+            json_file = optarg;
+            break;
+        case 's':
+            seed = strtoull(optarg, NULL, 10) | 1;
+            break;
+        default:
+            fprintf(stderr, "Uso: %s [-n operaciones] [-o resultados.json] [-s semilla]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    trace_op_t* ops = build_trace(count, seed);
+    if (ops == NULL)
+    {
+        fprintf(stderr, "Sin memoria para la traza de %zu operaciones\n", count);
+        return EXIT_FAILURE;
+    }
+
+    FILE* json = NULL;
+    if (json_file != NULL && (json = fopen(json_file, "w")) == NULL)
+    {
+        fprintf(stderr, "Error al abrir %s: %s\n", json_file, strerror(errno));
+        free(ops);
+        return EXIT_FAILURE;
+    }
+    if (json != NULL)
+    {
+        fprintf(json, "{\n  \"operations\": %zu,\n  \"benchmarks\": [\n", count);
+    }
+
+    printf("%-16s %14s %14s %16s\n", "método", "ops/s", "pico RSS (MB)", "fragmentación %");
+    int failures = 0;
+    int json_entries = 0;
+    size_t method_count = sizeof(methods) / sizeof(methods[0]);
+    for (size_t i = 0; i < method_count; i++)
+    {
+        alloc_result_t result;
+        const char* name = allocator_method_name(methods[i]);
+        if (run_method(methods[i], ops, count, &result) != 0)
+        {
+            failures++;
+            continue;
+        }
+        if (result.corrupted > 0)
+        {
+            fprintf(stderr, "El método %s corrompió %lu bloques\n", name, result.corrupted);
+            failures++;
+        }
+        printf("%-16s %14.0f %14.1f %16.2f\n", name, result.ops_per_s, result.peak_rss_mb, result.fragmentation);
+        if (json != NULL)
+        {
+            fprintf(json,
+                    "%s    {\"method\": \"%s\", \"ops_per_s\": %.0f, \"peak_rss_mb\": %.1f, "
+                    "\"fragmentation_percent\": %.2f}",
+                    json_entries > 0 ? ",\n" : "", name, result.ops_per_s, result.peak_rss_mb, result.fragmentation);
+            json_entries++;
+        }
+    }
+
+    if (json != NULL)
+    {
+        fprintf(json, "\n  ]\n}\n");
+        fclose(json);
+    }
+    free(ops);
+    return failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
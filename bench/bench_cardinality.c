@@ -0,0 +1,252 @@
+/**
+ * @file bench_cardinality.c
+ * @brief Mide el costo por muestra de los límites de cardinalidad y verifica filtros, tope y top-K.
+ *
+ * Se simulan tres familias con una función de guardado que solo cuenta: una por CPU con miles de
+ * series y un tope menor (el valor de cada serie es su número de CPU, así el top-K son las CPUs
+ * más altas), una por nodo y campo con reglas de etiqueta (node permitido por regex, field
+ * denegado por glob) y una denegada por nombre. Se compara el costo de guardar a través de
+ * cardinality_store() con y sin reglas instaladas.
+ *
+ * Falla si se guarda alguna serie filtrada, si el tope no se respeta, si las admitidas no son las
+ * de mayor valor, si los descartes informados no coinciden o si el costo supera el presupuesto.
+ *
+ * Uso: bench_cardinality [-c cpus] [-k tope] [-t ticks] [-b presupuesto_ns]
+ */
+
+#include "cardinality.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Nodos y campos de la familia con reglas de etiqueta.
+ */
+#define NODES 8
+#define FIELDS 24
+
+/**
+ * @brief Campos cuyo nombre empieza con Hugetlb (denegados).
+ */
+#define HUGETLB_FIELDS 4
+
+// Métricas falsas: solo importa su dirección
+static int cpu_metric;
+static int numa_metric;
+static int denied_metric;
+
+static long* cpu_stores; // Guardados por CPU
+static long numa_stores[NODES][FIELDS];
+static long denied_stores;
+static unsigned long long dropped_reported;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void count_store(void* metric, double value, const char** labels)
+{
+    (void)value;
+    if (metric == &cpu_metric)
+    {
+        cpu_stores[atoi(labels[0])]++;
+    }
+    else if (metric == &numa_metric)
+    {
+        numa_stores[atoi(labels[0])][atoi(labels[1] + strcspn(labels[1], "0123456789"))]++;
+    }
+    else
+    {
+        denied_stores++;
+    }
+}
+
+static void count_drop(const char* name, uint64_t dropped)
+{
+    (void)name;
+    dropped_reported += dropped;
+}
+
+/**
+ * @brief Un tick: todas las series de las tres familias, con la cardinalidad cerrada al final.
+ * @return Muestras guardadas a través de cardinality_store().
+ */
+static long run_tick(char (*cpu_names)[16], int cpus, char (*field_names)[16])
+{
+    long samples = 0;
+    for (int c = 0; c < cpus; c++)
+    {
+        cardinality_store(&cpu_metric, c, c, (const char*[]){cpu_names[c]});
+        samples++;
+    }
+    for (int n = 0; n < NODES; n++)
+    {
+        for (int f = 0; f < FIELDS; f++)
+        {
+            cardinality_store(&numa_metric, f, f, (const char*[]){cpu_names[n], field_names[f]});
+            cardinality_store(&denied_metric, f, f, (const char*[]){cpu_names[n], field_names[f]});
+            samples += 2;
+        }
+    }
+    cardinality_flush(count_drop);
+    return samples;
+}
+
+static cardinality_rules_t* build_rules(int max_series)
+{
+    char error[96];
+    cardinality_rules_t* rules = cardinality_rules_new();
+    if (rules == NULL || cardinality_rules_add_metric(rules, true, "vmstat_*", error, sizeof(error)) != 0 ||
+        cardinality_rules_add_label(rules, false, "node=/[0-3]/", error, sizeof(error)) != 0 ||
+        cardinality_rules_add_label(rules, true, "field=Hugetlb*", error, sizeof(error)) != 0 ||
+        cardinality_rules_add_label(rules, false, "zone=Normal", error, sizeof(error)) != 0)
+    {
+        fprintf(stderr, "No se pudieron compilar las reglas: %s\n", error);
+        cardinality_rules_free(rules);
+        return NULL;
+    }
+    rules->max_series = max_series;
+    return rules;
+}
+
+int main(int argc, char* argv[])
+{
+    int cpus = 4096;
+    int max_series = 500;
+    int ticks = 200;
+    double budget_ns = 150;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:k:t:b:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c':
+            cpus = atoi(optarg);
+            break;
+        case 'k':
+            max_series = atoi(optarg);
+            break;
+        case 't':
+            ticks = atoi(optarg);
+            break;
+        case 'b':
+            budget_ns = atof(optarg);
+            break;
+        default:
+            fprintf(stderr, "Uso: %s [-c cpus] [-k tope] [-t ticks] [-b presupuesto_ns]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (cpus < NODES || max_series < NODES * FIELDS || max_series >= cpus || ticks < 2)
+    {
+        fprintf(stderr, "Se necesita %d <= tope < cpus y al menos 2 ticks\n", NODES * FIELDS);
+        return EXIT_FAILURE;
+    }
+
+    char(*cpu_names)[16] = malloc((size_t)cpus * sizeof(*cpu_names));
+    char field_names[FIELDS][16];
+    cpu_stores = calloc((size_t)cpus, sizeof(*cpu_stores));
+    if (cpu_names == NULL || cpu_stores == NULL)
+    {
+        fprintf(stderr, "Sin memoria para %d CPUs\n", cpus);
+        return EXIT_FAILURE;
+    }
+    for (int c = 0; c < cpus; c++)
+    {
+        snprintf(cpu_names[c], sizeof(cpu_names[c]), "%d", c);
+    }
+    for (int f = 0; f < FIELDS; f++)
+    {
+        snprintf(field_names[f], sizeof(field_names[f]), "%s%02d", f < HUGETLB_FIELDS ? "Hugetlb" : "Field", f);
+    }
+
+    if (cardinality_track(&cpu_metric, "irq_cpu_rate", 1, (const char*[]){"cpu"}, false, count_store) != 0 ||
+        cardinality_track(&numa_metric, "numa_memory_bytes", 2, (const char*[]){"node", "field"}, false,
+                          count_store) != 0 ||
+        cardinality_track(&denied_metric, "vmstat_total", 2, (const char*[]){"node", "field"}, true, count_store) !=
+            0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    // Sin reglas: cada muestra se guarda directo, es la referencia del costo
+    cardinality_install(NULL);
+    double start = now_ns();
+    long samples = 0;
+    for (int t = 0; t < ticks; t++)
+    {
+        samples += run_tick(cpu_names, cpus, field_names);
+    }
+    double direct_ns = (now_ns() - start) / (double)samples;
+
+    // Con reglas: el primer tick elige las series, los siguientes se miden
+    cardinality_rules_t* rules = build_rules(max_series);
+    if (rules == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+    cardinality_install(rules);
+    bool claimed = !cardinality_claim_registration(&denied_metric) && cardinality_claim_registration(&numa_metric);
+    memset(cpu_stores, 0, (size_t)cpus * sizeof(*cpu_stores));
+    memset(numa_stores, 0, sizeof(numa_stores));
+    denied_stores = 0;
+    dropped_reported = 0;
+    run_tick(cpu_names, cpus, field_names);
+
+    start = now_ns();
+    samples = 0;
+    for (int t = 1; t < ticks; t++)
+    {
+        samples += run_tick(cpu_names, cpus, field_names);
+    }
+    double guarded_ns = (now_ns() - start) / (double)samples;
+
+    // Verificación: top-K por valor en la familia por CPU y filtros de etiqueta en la de NUMA
+    int errors = 0;
+    int admitted = 0;
+    for (int c = 0; c < cpus; c++)
+    {
+        bool expected = c >= cpus - max_series;
+        admitted += cpu_stores[c] > 0;
+        errors += cpu_stores[c] != (expected ? ticks : 0);
+    }
+    for (int n = 0; n < NODES; n++)
+    {
+        for (int f = 0; f < FIELDS; f++)
+        {
+            bool expected = n <= 3 && f >= HUGETLB_FIELDS;
+            errors += numa_stores[n][f] != (expected ? ticks : 0);
+        }
+    }
+    unsigned long long expected_drops = (unsigned long long)(cpus - max_series) * (unsigned long long)ticks;
+    errors += denied_stores != 0;
+    errors += dropped_reported != expected_drops;
+    errors += !claimed;
+
+    printf("%d series por CPU con tope %d: %d admitidas, %llu muestras descartadas (esperadas %llu)\n", cpus,
+           max_series, admitted, dropped_reported, expected_drops);
+    printf("sin reglas: %.1f ns/muestra, con filtros y tope: %.1f ns/muestra (presupuesto %.0f ns)\n", direct_ns,
+           guarded_ns, budget_ns);
+    printf("series o descartes incorrectos: %d\n", errors);
+
+    cardinality_install(NULL);
+    free(cpu_names);
+    free(cpu_stores);
+    if (errors > 0)
+    {
+        fprintf(stderr, "Los límites de cardinalidad no filtran o no eligen las series esperadas\n");
+        return EXIT_FAILURE;
+    }
+    if (guarded_ns > budget_ns)
+    {
+        fprintf(stderr, "Los límites de cardinalidad superan el presupuesto por muestra\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
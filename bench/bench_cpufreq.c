@@ -0,0 +1,239 @@
+/**
+ * @file bench_cpufreq.c
+ * @brief Mide el costo por CPU del colector de frecuencia y temperatura y verifica el uso normalizado.
+ *
+ * Se genera un /sys sintético con cientos de CPUs (cpufreq, thermal_throttle y topology) y
+ * algunas zonas térmicas, y un /proc/stat cuyas líneas por CPU avanzan en cada tick con la mitad
+ * del tiempo ocupado. Las CPUs pares corren a la mitad de su frecuencia máxima y las impares al
+ * máximo, así el uso es 50% y el normalizado 37.5%. Falla si el resumen no coincide (uso,
+ * normalizado, temperatura máxima, suma de throttling) o si el costo por CPU supera el presupuesto.
+ *
+ * Uso: bench_cpufreq [-c cpus] [-t ticks] [-b presupuesto_us_por_cpu]
+ */
+
+#include "cpufreq.h"
+#include "procfs.h"
+#include <dirent.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Zonas térmicas del árbol sintético.
+ */
+#define ZONES 8
+
+/**
+ * @brief Jiffies por CPU y por tick; la mitad son ocupados.
+ */
+#define TICK_JIFFIES 100
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Borra el árbol sintético.
+ */
+static int remove_tree(const char* path)
+{
+    DIR* dir = opendir(path);
+    if (dir == NULL)
+    {
+        return remove(path);
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+        {
+            char child[PROCFS_PATH_MAX];
+            snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+            remove_tree(child);
+        }
+    }
+    closedir(dir);
+    return rmdir(path);
+}
+
+static int write_file(const char* root, const char* rel, const char* content)
+{
+    char path[PROCFS_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", root, rel);
+
+    // Crea los directorios intermedios
+    for (char* slash = strchr(path + strlen(root) + 1, '/'); slash != NULL; slash = strchr(slash + 1, '/'))
+    {
+        *slash = '\0';
+        mkdir(path, 0755);
+        *slash = '/';
+    }
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    fputs(content, file);
+    return fclose(file);
+}
+
+static int write_value(const char* root, const char* format, int number, long long value)
+{
+    char rel[128], content[32];
+    snprintf(rel, sizeof(rel), format, number);
+    snprintf(content, sizeof(content), "%lld\n", value);
+    return write_file(root, rel, content);
+}
+
+/**
+ * @brief Reescribe /proc/stat con el avance del tick: mitad ocupado (user) y mitad idle.
+ */
+static int write_stat(const char* proc, int cpus, int tick, char* scratch, size_t len)
+{
+    long long half = (long long)tick * TICK_JIFFIES / 2;
+    size_t used = (size_t)snprintf(scratch, len, "cpu  %lld 0 0 %lld 0 0 0 0 0 0\n", half * cpus, half * cpus);
+    for (int c = 0; c < cpus && used < len; c++)
+    {
+        used += (size_t)snprintf(scratch + used, len - used, "cpu%d %lld 0 0 %lld 0 0 0 0 0 0\n", c, half, half);
+    }
+    if (used < len)
+    {
+        snprintf(scratch + used, len - used, "intr 0\nctxt 0\n");
+    }
+    return write_file(proc, "stat", scratch);
+}
+
+int main(int argc, char* argv[])
+{
+    int cpus = 256;
+    int ticks = 200;
+    double budget_us = 10;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:t:b:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c':
+            cpus = atoi(optarg);
+            break;
+        case 't':
+            ticks = atoi(optarg);
+            break;
+        case 'b':
+            budget_us = atof(optarg);
+            break;
+        default:
+            fprintf(stderr, "Uso: %s [-c cpus] [-t ticks] [-b presupuesto_us_por_cpu]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (cpus < 2 || ticks < 2)
+    {
+        fprintf(stderr, "Se necesitan al menos 2 CPUs y 2 ticks\n");
+        return EXIT_FAILURE;
+    }
+
+    char root[] = "/tmp/bench_cpufreq_XXXXXX";
+    if (mkdtemp(root) == NULL)
+    {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    char proc[PROCFS_PATH_MAX], sys[PROCFS_PATH_MAX];
+    snprintf(proc, sizeof(proc), "%s/proc", root);
+    snprintf(sys, sizeof(sys), "%s/sys", root);
+    mkdir(proc, 0755);
+    mkdir(sys, 0755);
+
+    size_t stat_len = (size_t)cpus * 64 + 256;
+    char* scratch = malloc(stat_len);
+    int rc = scratch != NULL ? 0 : -1;
+    for (int c = 0; c < cpus && rc == 0; c++)
+    {
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", c, 3000000);
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq", c,
+                          c % 2 == 0 ? 1500000 : 3000000);
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/topology/physical_package_id", c, c < cpus / 2 ? 0 : 1);
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/thermal_throttle/core_throttle_count", c, 0);
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/thermal_throttle/package_throttle_count", c, 0);
+    }
+    for (int z = 0; z < ZONES && rc == 0; z++)
+    {
+        rc |= write_value(sys, "class/thermal/thermal_zone%d/temp", z, 40000 + z * 1500);
+        char rel[64];
+        snprintf(rel, sizeof(rel), "class/thermal/thermal_zone%d/type", z);
+        rc |= write_file(sys, rel, "x86_pkg_temp\n");
+    }
+    rc |= rc == 0 ? write_stat(proc, cpus, 1, scratch, stat_len) : 0;
+
+    procfs_set_root(proc, sys);
+    cpufreq_topology_t topo;
+    cpu_stat_t cpu_stat = {0};
+    cpufreq_summary_t summary = {0};
+    int mismatches = 0;
+    double elapsed = 0;
+    if (rc == 0 && cpufreq_discover(&topo) == 0)
+    {
+        cpu_stat_read(&cpu_stat); // Primera lectura: fija la base de /proc/stat
+        for (int t = 2; t <= ticks + 1; t++)
+        {
+            // Dos CPUs suman un evento de throttling por tick
+            write_value(sys, "devices/system/cpu/cpu%d/thermal_throttle/core_throttle_count", 0, t);
+            write_value(sys, "devices/system/cpu/cpu%d/thermal_throttle/core_throttle_count", cpus - 1, t);
+            write_stat(proc, cpus, t, scratch, stat_len);
+
+            // El tick lee /proc/stat una vez para todos los colectores; se mide junto con cpufreq
+            double start = now_ns();
+            int read_rc = cpu_stat_read(&cpu_stat);
+            cpufreq_read(&topo, read_rc == 0 ? &cpu_stat : NULL, &summary);
+            elapsed += now_ns() - start;
+
+            double max_celsius = (40000 + (ZONES - 1) * 1500) / 1000.0;
+            mismatches += read_rc != 0 || fabs(summary.usage - 50.0) > 1e-6 ||
+                          fabs(summary.normalized_usage - 37.5) > 1e-6 || summary.cpus_with_freq != cpus ||
+                          !summary.have_temperature || summary.max_celsius != max_celsius ||
+                          summary.core_throttles != 2ul * (unsigned long)t;
+        }
+        printf("CPUs: %d, zonas: %d, uso %.1f%%, normalizado %.1f%%, frecuencia media %.0f MHz\n", topo.cpu_count,
+               topo.zone_count, summary.usage, summary.normalized_usage, summary.freq_avg_hz / 1e6);
+        cpufreq_free(&topo);
+        cpu_stat_free(&cpu_stat);
+    }
+    else
+    {
+        fprintf(stderr, "No se pudo armar o descubrir el /sys sintético\n");
+        mismatches = ticks;
+    }
+    free(scratch);
+
+    if (remove_tree(root) != 0)
+    {
+        fprintf(stderr, "No se pudo borrar %s\n", root);
+    }
+
+    double per_cpu = elapsed / 1e3 / ticks / cpus;
+    printf("cpufreq_read: %.2f us/CPU, %.1f us/tick (presupuesto %.1f us/CPU)\n", per_cpu, elapsed / 1e3 / ticks,
+           budget_us);
+    printf("ticks con resumen incorrecto: %d de %d\n", mismatches, ticks);
+    if (mismatches > 0)
+    {
+        fprintf(stderr, "El resumen de cpufreq no coincide con el /sys sintético\n");
+        return EXIT_FAILURE;
+    }
+    if (per_cpu > budget_us)
+    {
+        fprintf(stderr, "El colector supera el presupuesto por CPU\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
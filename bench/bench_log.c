@@ -0,0 +1,142 @@
+/**
+ * @file bench_log.c
+ * @brief Mide el costo de una llamada al logger asíncrono y verifica que no se pierdan registros.
+ *
+ * Fase 1: rondas de registros admitidos (menos que la capacidad del ring) separadas por más de
+ * un período del hilo escritor, como los errores esporádicos de un colector. Fase 2: un sitio
+ * que se repite sin pausa, donde casi todo lo suprime el límite por sitio (el caso de una
+ * interfaz ausente en cada tick). Al final se cuentan las líneas del archivo: deben estar todos
+ * los admitidos, los LOG_RATE_BURST de la fase 2 y la línea de suprimidos. Falla si se pierde
+ * algo o si alguno de los costos supera su presupuesto.
+ *
+ * Uso: bench_log [-r rondas] [-n repeticiones] [-a presupuesto_admitido_ns] [-s presupuesto_suprimido_ns]
+ */
+
+#include "log.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Registros por ronda de la fase 1 (menos que LOG_RING_RECORDS).
+ */
+#define ROUND_RECORDS 64
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static long count_lines(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    long lines = 0;
+    int c;
+    while ((c = fgetc(file)) != EOF)
+    {
+        lines += c == '\n';
+    }
+    fclose(file);
+    return lines;
+}
+
+int main(int argc, char* argv[])
+{
+    int rounds = 20;
+    long repeats = 1000000;
+    double admitted_budget_ns = 1000;
+    double suppressed_budget_ns = 200;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:n:a:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            rounds = atoi(optarg);
+            break;
+        case 'n':
+            repeats = atol(optarg);
+            break;
+        case 'a':
+            admitted_budget_ns = atof(optarg);
+            break;
+        case 's':
+            suppressed_budget_ns = atof(optarg);
+            break;
+        default:
+            fprintf(stderr, "Uso: %s [-r rondas] [-n repeticiones] [-a presupuesto_ns] [-s presupuesto_ns]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    char path[] = "/tmp/bench_log_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        perror("mkstemp");
+        return EXIT_FAILURE;
+    }
+    close(fd);
+    if (log_start(path) != 0)
+    {
+        unlink(path);
+        return EXIT_FAILURE;
+    }
+
+    // Fase 1: admitidos, con strings que viven en la pila como los paths de los colectores
+    double admitted = 0;
+    for (int r = 0; r < rounds; r++)
+    {
+        char device[32];
+        snprintf(device, sizeof(device), "/dev/sd%c", 'a' + r % 26);
+        double start = now_ns();
+        for (int i = 0; i < ROUND_RECORDS; i++)
+        {
+            log_event("Error al abrir %s: %d lecturas, %.2f%% (%zu)", device, i, 12.5, (size_t)r);
+        }
+        admitted += now_ns() - start;
+        usleep(LOG_FLUSH_MS * 1500);
+    }
+
+    // Fase 2: un mismo sitio en un bucle; pasa LOG_RATE_BURST, el resto se suprime
+    double start = now_ns();
+    for (long i = 0; i < repeats; i++)
+    {
+        log_error("No se encontraron datos para la interfaz %s", "wlp1s0");
+    }
+    double suppressed = now_ns() - start;
+    log_stop();
+
+    long expected = (long)rounds * ROUND_RECORDS + LOG_RATE_BURST + 1;
+    long lines = count_lines(path);
+    unlink(path);
+
+    double admitted_ns = admitted / ((double)rounds * ROUND_RECORDS);
+    double suppressed_ns = suppressed / (double)repeats;
+    printf("log admitido: %.1f ns/llamada (presupuesto %.0f ns)\n", admitted_ns, admitted_budget_ns);
+    printf("log suprimido: %.1f ns/llamada (presupuesto %.0f ns)\n", suppressed_ns, suppressed_budget_ns);
+    printf("líneas escritas: %ld de %ld esperadas\n", lines, expected);
+
+    if (lines != expected)
+    {
+        fprintf(stderr, "El logger perdió o duplicó registros\n");
+        return EXIT_FAILURE;
+    }
+    if (admitted_ns > admitted_budget_ns || suppressed_ns > suppressed_budget_ns)
+    {
+        fprintf(stderr, "El logger supera el presupuesto por llamada\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
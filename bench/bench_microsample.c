@@ -0,0 +1,160 @@
+/**
+ * @file bench_microsample.c
+ * @brief Verifica que el hilo de micro-muestreo cueste menos de MICROSAMPLE_OVERHEAD_BUDGET de un núcleo.
+ *
+ * Arranca el muestreador sobre el /proc real con el hilo principal dormido, de modo que todo el
+ * tiempo de CPU del proceso corresponde al muestreador, y lo mide con getrusage() (usuario +
+ * sistema, incluidos el despertar y la generación de /proc/stat en el kernel). Tras un
+ * calentamiento en el que el muestreador puede ampliar su intervalo si no entra en el
+ * presupuesto, se mide el costo durante -t segundos; falla si lo supera.
+ *
+ * Como referencia se mide también el piso de la plataforma: un hilo que solo duerme hasta el
+ * siguiente plazo con la cadencia pedida, sin leer nada.
+ *
+ * Uso: bench_microsample [-i intervalo_ms] [-t segundos]
+ */
+
+#include "microsample.h"
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Segundos para que el muestreador ajuste su intervalo antes de medir.
+ */
+#define WARMUP_SECONDS 3
+
+static double process_cpu_seconds(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           (double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+typedef struct
+{
+    int interval_ms;
+    int seconds;
+} floor_args_t;
+
+/**
+ * @brief Duerme con plazos absolutos a la cadencia dada, sin hacer trabajo.
+ */
+static void* timer_only(void* arg)
+{
+    const floor_args_t* args = arg;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    long ticks = (long)args->seconds * 1000 / args->interval_ms;
+    for (long i = 0; i < ticks; i++)
+    {
+        next.tv_nsec += (long)args->interval_ms * 1000000L;
+        while (next.tv_nsec >= 1000000000L)
+        {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000L;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR)
+        {
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Costo de CPU de solo despertar a la cadencia dada, en porcentaje de un núcleo.
+ */
+static double timer_floor(int interval_ms, int seconds)
+{
+    floor_args_t args = {interval_ms, seconds};
+    pthread_t thread;
+    double cpu_start = process_cpu_seconds();
+    double wall_start = now_seconds();
+    if (pthread_create(&thread, NULL, timer_only, &args) != 0)
+    {
+        return 0;
+    }
+    pthread_join(thread, NULL);
+    return (process_cpu_seconds() - cpu_start) * 100.0 / (now_seconds() - wall_start);
+}
+
+int main(int argc, char* argv[])
+{
+    int interval_ms = 10;
+    int seconds = 5;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "i:t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'i':
+            interval_ms = atoi(optarg);
+            break;
+        case 't':
+            seconds = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Uso: %s [-i intervalo_ms] [-t segundos]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    double floor = timer_floor(interval_ms, seconds);
+
+    if (microsample_start(interval_ms) != 0)
+    {
+        return EXIT_FAILURE;
+    }
+    sleep(WARMUP_SECONDS);
+    microsample_summary_t summary;
+    microsample_collect(&summary);
+
+    double cpu_start = process_cpu_seconds();
+    double wall_start = now_seconds();
+    sleep((unsigned)seconds);
+    int rc = microsample_collect(&summary);
+    double overhead = (process_cpu_seconds() - cpu_start) * 100.0 / (now_seconds() - wall_start);
+    microsample_stop();
+
+    if (rc != 0)
+    {
+        fprintf(stderr, "El muestreador no produjo muestras\n");
+        return EXIT_FAILURE;
+    }
+
+    const quantile_summary_t* cpu = &summary.cpu_usage;
+    const quantile_summary_t* procs = &summary.running_processes;
+    printf("intervalo: %d ms (pedido %d ms)  muestras: %llu (%.1f/s)\n", summary.interval_ms, interval_ms,
+           (unsigned long long)procs->count, (double)procs->count / seconds);
+    printf("cpu %%:         min %.1f  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f  (%llu muestras)\n", cpu->min, cpu->p50,
+           cpu->p90, cpu->p99, cpu->max, (unsigned long long)cpu->count);
+    printf("procs_running: min %.0f  p50 %.0f  p90 %.0f  p99 %.0f  max %.0f\n", procs->min, procs->p50, procs->p90,
+           procs->p99, procs->max);
+    printf("costo: %.3f%% de un núcleo (el hilo mide %.3f%%); presupuesto %.1f%%; solo despertar cada %d ms: %.3f%%\n",
+           overhead, summary.overhead_percent, MICROSAMPLE_OVERHEAD_BUDGET, interval_ms, floor);
+    if (summary.interval_ms != interval_ms)
+    {
+        printf("aviso: en esta plataforma el muestreador amplió su intervalo para respetar el presupuesto\n");
+    }
+
+    if (overhead > MICROSAMPLE_OVERHEAD_BUDGET)
+    {
+        fprintf(stderr, "FALLO: el micro-muestreo excede su presupuesto de CPU\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,679 @@
+/**
+ * @file bench_parsers.c
+ * @brief Micro-benchmarks de los parsers de /proc sobre fixtures con forma de host grande.
+ *
+ * Cada caso ejecuta un parser de src/metrics.c en un bucle cerrado contra un archivo de
+ * bench/fixtures y reporta ns/op, asignaciones/op y throughput. Los resultados se imprimen
+ * como tabla y, opcionalmente, como JSON para compararlos entre versiones.
+ *
+ * Antes de medir, cada parser se compara contra su versión original basada en sscanf
+ * (legacy_parsers.c): si la salida difiere el caso falla. Los casos "*_legacy" miden esas
+ * versiones originales como referencia.
+ *
+ * Uso: bench_parsers [-d dir_fixtures] [-o resultados.json] [-t segundos_minimos] [filtro]
+ */
+
+#include "alloc_count.h"
+#include "buddyinfo.h"
+#include "interrupts.h"
+#include "legacy_parsers.h"
+#include "meminfo.h"
+#include "metrics.h"
+#include "netproto.h"
+#include "psi.h"
+#include <errno.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <time.h>
+
+/**
+ * @brief Descripción de un caso de benchmark.
+ */
+typedef struct
+{
+    const char* name;             /**< Nombre del caso. */
+    const char* fixture;          /**< Archivo dentro del directorio de fixtures. */
+    const char* arg;              /**< Argumento para el parser (interfaz, dispositivo) o NULL. */
+    bool (*run)(const char* path, const char* arg); /**< Ejecuta una operación; false si el parser falló. */
+    bool (*verify)(const char* path, const char* arg); /**< Compara contra el parser original, o NULL. */
+} bench_case_t;
+
+/**
+ * @brief Resultado de un caso de benchmark.
+ */
+typedef struct
+{
+    const char* name;     /**< Nombre del caso. */
+    const char* fixture;  /**< Fixture utilizado. */
+    uint64_t iterations;  /**< Operaciones medidas. */
+    double ns_per_op;     /**< Nanosegundos por operación. */
+    double allocs_per_op; /**< Asignaciones de heap por operación. */
+    double bytes_per_op;  /**< Bytes del fixture procesados por operación. */
+    double mb_per_s;      /**< Throughput en MB/s sobre el tamaño del fixture. */
+} bench_result_t;
+
+static bool run_cpu_times(const char* path, const char* arg)
+{
+    (void)arg;
+    cpu_times_t times;
+    return read_cpu_times(path, &times) == 0;
+}
+
+static bool run_context_switches(const char* path, const char* arg)
+{
+    (void)arg;
+    return read_context_switches(path) >= 0;
+}
+
+static bool run_running_processes(const char* path, const char* arg)
+{
+    (void)arg;
+    return read_running_processes(path) >= 0;
+}
+
+static bool run_memory_usage(const char* path, const char* arg)
+{
+    (void)arg;
+    return read_memory_usage(path).total_mem >= 0;
+}
+
+static bool run_net_stats(const char* path, const char* arg)
+{
+    return read_net_stats(path, arg).rx_bytes >= 0;
+}
+
+static bool run_disk_stats(const char* path, const char* arg)
+{
+    return read_disk_stats(path, arg).reads_completed != (unsigned long)-1;
+}
+
+static bool run_meminfo(const char* path, const char* arg)
+{
+    (void)arg;
+    static meminfo_t info;
+    return read_meminfo(path, &info) == 0;
+}
+
+static bool run_vmstat(const char* path, const char* arg)
+{
+    (void)arg;
+    static vmstat_t stats;
+    return read_vmstat(path, &stats) == 0;
+}
+
+static bool run_buddyinfo(const char* path, const char* arg)
+{
+    (void)arg;
+    static buddyinfo_t info;
+    return read_buddyinfo(path, &info) == 0;
+}
+
+/**
+ * @brief Arma la ruta de un fixture hermano del que se está midiendo.
+ */
+static const char* sibling_fixture(const char* path, const char* name, char* buf, size_t len)
+{
+    const char* slash = strrchr(path, '/');
+    int dir_len = slash != NULL ? (int)(slash - path) : 1;
+    snprintf(buf, len, "%.*s/%s", dir_len, slash != NULL ? path : ".", name);
+    return buf;
+}
+
+static bool run_pagetypeinfo(const char* path, const char* arg)
+{
+    // Un tick completo de fragmentación: buddyinfo (arg) y después pagetypeinfo
+    static buddyinfo_t info;
+    char buddy_path[512];
+    return read_buddyinfo(sibling_fixture(path, arg, buddy_path, sizeof(buddy_path)), &info) == 0 &&
+           read_pagetypeinfo(path, &info) == 0;
+}
+
+/**
+ * @brief Compara el hash perfecto contra una búsqueda lineal por nombre con sscanf.
+ */
+static bool verify_key_table(const char* path, const char* sep, int count, const char* (*name)(int),
+                             const uint64_t* values, const bool* present)
+{
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        return false;
+    }
+
+    char line[256];
+    char format[32];
+    char key[64];
+    unsigned long long value;
+    int found = 0;
+    snprintf(format, sizeof(format), "%%63[^%s]%s %%llu", sep, sep);
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        if (sscanf(line, format, key, &value) != 2)
+        {
+            continue;
+        }
+        for (int i = 0; i < count; i++)
+        {
+            if (strcmp(key, name(i)) == 0)
+            {
+                if (!present[i] || values[i] != value)
+                {
+                    fclose(fp);
+                    return false;
+                }
+                found++;
+            }
+        }
+    }
+    fclose(fp);
+
+    // Tampoco puede haber campos marcados que no estén en el archivo
+    int marked = 0;
+    for (int i = 0; i < count; i++)
+    {
+        marked += present[i];
+    }
+    return found == marked;
+}
+
+static bool verify_meminfo(const char* path, const char* arg)
+{
+    (void)arg;
+    static meminfo_t info;
+    return read_meminfo(path, &info) == 0 &&
+           verify_key_table(path, ":", meminfo_field_count(), meminfo_field_name, info.values, info.present);
+}
+
+static bool verify_vmstat(const char* path, const char* arg)
+{
+    (void)arg;
+    static vmstat_t stats;
+    return read_vmstat(path, &stats) == 0 &&
+           verify_key_table(path, " ", vmstat_field_count(), vmstat_field_name, stats.values, stats.present);
+}
+
+static bool run_irq_table(const char* path, const char* arg)
+{
+    (void)arg;
+    static irq_table_t table;
+    return read_irq_table(path, &table) == 0;
+}
+
+/**
+ * @brief Compara la matriz contra un parseo con strtoull de cada fila.
+ */
+static bool verify_irq_table(const char* path, const char* arg)
+{
+    (void)arg;
+    static irq_table_t table;
+    if (read_irq_table(path, &table) != 0)
+    {
+        return false;
+    }
+
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        return false;
+    }
+    static char line[1 << 16];
+    int row = -1; // La primera línea es la cabecera
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), fp) != NULL)
+    {
+        char* colon = strchr(line, ':');
+        if (row < 0 || colon == NULL)
+        {
+            row++;
+            continue;
+        }
+        char name[IRQ_NAME_MAX];
+        if (sscanf(line, " %15[^:]", name) != 1 || row >= table.row_count || strcmp(name, table.rows[row].name) != 0)
+        {
+            ok = false;
+            break;
+        }
+        char* p = colon + 1;
+        for (int c = 0; c < table.cpu_count && ok; c++)
+        {
+            char* next;
+            unsigned long long value = strtoull(p, &next, 10);
+            if (next == p)
+            {
+                value = 0; // Fila corta
+            }
+            else
+            {
+                p = next;
+            }
+            ok = table.counts[(size_t)row * (size_t)table.cpu_count + (size_t)c] == value;
+        }
+        row++;
+    }
+    fclose(fp);
+    return ok && row == table.row_count;
+}
+
+static bool run_proto_counters(const char* path, const char* arg)
+{
+    (void)arg;
+    netproto_stats_t stats = {0};
+    return read_proto_counters(path, &stats) == 0;
+}
+
+/**
+ * @brief Compara los contadores registrados contra un parseo con strtok_r y strtoull de cada par de líneas.
+ */
+static bool verify_proto_counters(const char* path, const char* arg)
+{
+    (void)arg;
+    netproto_stats_t stats = {0};
+    if (read_proto_counters(path, &stats) != 0)
+    {
+        return false;
+    }
+
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        return false;
+    }
+    static char names[8192], values[8192];
+    bool ok = true;
+    int found = 0;
+    while (ok && fgets(names, sizeof(names), fp) != NULL && fgets(values, sizeof(values), fp) != NULL)
+    {
+        char *name_save, *value_save;
+        char* proto = strtok_r(names, ":", &name_save);
+        strtok_r(values, ":", &value_save);
+        char* name;
+        while (ok && (name = strtok_r(NULL, " \n", &name_save)) != NULL)
+        {
+            char* value = strtok_r(NULL, " \n", &value_save);
+            int i = netproto_counter_index(proto, name);
+            if (i >= 0)
+            {
+                ok = value != NULL && stats.present[i] && stats.counters[i] == strtoull(value, NULL, 10);
+                found++;
+            }
+        }
+    }
+    fclose(fp);
+    for (int i = 0; i < NETPROTO_COUNTERS; i++)
+    {
+        found -= stats.present[i];
+    }
+    return ok && found == 0;
+}
+
+static bool run_psi(const char* path, const char* arg)
+{
+    (void)arg;
+    psi_stats_t stats;
+    return read_psi(path, &stats) == 0;
+}
+
+/**
+ * @brief Compara las dos líneas contra un parseo con sscanf y strtod.
+ */
+static bool verify_psi(const char* path, const char* arg)
+{
+    (void)arg;
+    psi_stats_t stats;
+    if (read_psi(path, &stats) != 0)
+    {
+        return false;
+    }
+
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        return false;
+    }
+    char line[256];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), fp) != NULL)
+    {
+        char kind[8];
+        double avg10, avg60, avg300;
+        unsigned long long total;
+        if (sscanf(line, "%7s avg10=%lf avg60=%lf avg300=%lf total=%llu", kind, &avg10, &avg60, &avg300, &total) != 5)
+        {
+            ok = false;
+            break;
+        }
+        const psi_line_t* l = strcmp(kind, "full") == 0 ? &stats.full : &stats.some;
+        ok = l->present && fabs(l->avg10 - avg10) < 1e-9 && fabs(l->avg60 - avg60) < 1e-9 &&
+             fabs(l->avg300 - avg300) < 1e-9 && l->total_us == total;
+    }
+    fclose(fp);
+    return ok && stats.full.present;
+}
+
+/**
+ * @brief Compara cada zona contra un parseo con sscanf de la misma línea.
+ */
+static bool verify_buddyinfo(const char* path, const char* arg)
+{
+    (void)arg;
+    static buddyinfo_t info;
+    if (read_buddyinfo(path, &info) != 0)
+    {
+        return false;
+    }
+
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        return false;
+    }
+    char line[512];
+    int zone = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), fp) != NULL)
+    {
+        int node, offset;
+        char name[16];
+        if (sscanf(line, "Node %d, zone %15s%n", &node, name, &offset) != 2)
+        {
+            continue;
+        }
+        const buddy_zone_t* z = &info.zones[zone++];
+        ok = z->node == node && strcmp(z->zone, name) == 0;
+        const char* p = line + offset;
+        int order = 0;
+        unsigned long long value;
+        int used;
+        while (ok && sscanf(p, "%llu%n", &value, &used) == 1)
+        {
+            ok = order < z->orders && z->free_blocks[order] == value;
+            order++;
+            p += used;
+        }
+        ok = ok && order == z->orders;
+    }
+    fclose(fp);
+    return ok && zone == info.zone_count;
+}
+
+/**
+ * @brief Las páginas libres por tipo de migración deben sumar lo mismo que buddyinfo.
+ */
+static bool verify_pagetypeinfo(const char* path, const char* arg)
+{
+    static buddyinfo_t info;
+    char buddy_path[512];
+    if (read_buddyinfo(sibling_fixture(path, arg, buddy_path, sizeof(buddy_path)), &info) != 0 ||
+        read_pagetypeinfo(path, &info) != 0 || info.pageblock_order != 9)
+    {
+        return false;
+    }
+    for (int i = 0; i < info.zone_count; i++)
+    {
+        uint64_t pages = 0;
+        uint64_t blocks = 0;
+        for (int t = 0; t < info.type_count; t++)
+        {
+            pages += info.zones[i].type_free_pages[t];
+            blocks += info.zones[i].type_blocks[t];
+        }
+        if (pages != buddy_free_pages(&info.zones[i]) || blocks == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool run_cpu_times_legacy(const char* path, const char* arg)
+{
+    (void)arg;
+    cpu_times_t times;
+    return legacy_read_cpu_times(path, &times) == 0;
+}
+
+static bool run_context_switches_legacy(const char* path, const char* arg)
+{
+    (void)arg;
+    return legacy_read_context_switches(path) >= 0;
+}
+
+static bool run_running_processes_legacy(const char* path, const char* arg)
+{
+    (void)arg;
+    return legacy_read_running_processes(path) >= 0;
+}
+
+static bool run_memory_usage_legacy(const char* path, const char* arg)
+{
+    (void)arg;
+    return legacy_read_memory_usage(path).total_mem >= 0;
+}
+
+static bool run_net_stats_legacy(const char* path, const char* arg)
+{
+    return legacy_read_net_stats(path, arg).rx_bytes >= 0;
+}
+
+static bool run_disk_stats_legacy(const char* path, const char* arg)
+{
+    return legacy_read_disk_stats(path, arg).reads_completed != (unsigned long)-1;
+}
+
+static bool verify_cpu_times(const char* path, const char* arg)
+{
+    (void)arg;
+    cpu_times_t a, b;
+    return read_cpu_times(path, &a) == legacy_read_cpu_times(path, &b) && memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static bool verify_context_switches(const char* path, const char* arg)
+{
+    (void)arg;
+    return read_context_switches(path) == legacy_read_context_switches(path);
+}
+
+static bool verify_running_processes(const char* path, const char* arg)
+{
+    (void)arg;
+    return read_running_processes(path) == legacy_read_running_processes(path);
+}
+
+static bool verify_memory_usage(const char* path, const char* arg)
+{
+    (void)arg;
+    memory_info_t a = read_memory_usage(path);
+    memory_info_t b = legacy_read_memory_usage(path);
+    return a.total_mem == b.total_mem && a.used_mem == b.used_mem && a.free_mem == b.free_mem;
+}
+
+static bool verify_net_stats(const char* path, const char* arg)
+{
+    net_stats_t a = read_net_stats(path, arg);
+    net_stats_t b = legacy_read_net_stats(path, arg);
+    return a.rx_bytes == b.rx_bytes && a.tx_bytes == b.tx_bytes && strcmp(a.iface, b.iface) == 0;
+}
+
+static bool verify_disk_stats(const char* path, const char* arg)
+{
+    disk_stats_t a = read_disk_stats(path, arg);
+    disk_stats_t b = legacy_read_disk_stats(path, arg);
+    return a.reads_completed == b.reads_completed && a.writes_completed == b.writes_completed &&
+           strcmp(a.device, b.device) == 0;
+}
+
+/**
+ * @brief Casos registrados. El dispositivo y la interfaz buscados son los últimos del fixture (peor caso).
+ */
+static const bench_case_t cases[] = {
+    {"cpu_times", "proc_stat_512cpu", NULL, run_cpu_times, verify_cpu_times},
+    {"context_switches", "proc_stat_512cpu", NULL, run_context_switches, verify_context_switches},
+    {"running_processes", "proc_stat_512cpu", NULL, run_running_processes, verify_running_processes},
+    {"memory_usage", "proc_meminfo", NULL, run_memory_usage, verify_memory_usage},
+    {"net_stats", "proc_net_dev_5k", "wlp1s0", run_net_stats, verify_net_stats},
+    {"disk_stats", "proc_diskstats_1k", "/dev/nvme100n1", run_disk_stats, verify_disk_stats},
+    {"meminfo", "proc_meminfo", NULL, run_meminfo, verify_meminfo},
+    {"vmstat", "proc_vmstat", NULL, run_vmstat, verify_vmstat},
+    {"buddyinfo", "proc_buddyinfo_16node", NULL, run_buddyinfo, verify_buddyinfo},
+    {"pagetypeinfo", "proc_pagetypeinfo_16node", "proc_buddyinfo_16node", run_pagetypeinfo, verify_pagetypeinfo},
+    {"psi", "proc_pressure_memory", NULL, run_psi, verify_psi},
+    {"interrupts", "proc_interrupts_256cpu", NULL, run_irq_table, verify_irq_table},
+    {"softirqs", "proc_softirqs_256cpu", NULL, run_irq_table, verify_irq_table},
+    {"net_snmp", "proc_net_snmp", NULL, run_proto_counters, verify_proto_counters},
+    {"net_netstat", "proc_net_netstat", NULL, run_proto_counters, verify_proto_counters},
+    {"cpu_times_legacy", "proc_stat_512cpu", NULL, run_cpu_times_legacy, NULL},
+    {"context_switches_legacy", "proc_stat_512cpu", NULL, run_context_switches_legacy, NULL},
+    {"running_processes_legacy", "proc_stat_512cpu", NULL, run_running_processes_legacy, NULL},
+    {"memory_usage_legacy", "proc_meminfo", NULL, run_memory_usage_legacy, NULL},
+    {"net_stats_legacy", "proc_net_dev_5k", "wlp1s0", run_net_stats_legacy, NULL},
+    {"disk_stats_legacy", "proc_diskstats_1k", "/dev/nvme100n1", run_disk_stats_legacy, NULL},
+};
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Ejecuta un caso duplicando el lote hasta superar el tiempo mínimo.
+ * @return 0 si el caso se midió, -1 si el fixture falta o el parser falla.
+ */
+static int run_case(const bench_case_t* bc, const char* dir, double min_seconds, bench_result_t* out)
+{
+    char path[512];
+    struct stat st;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, bc->fixture);
+    if (stat(path, &st) != 0)
+    {
+        fprintf(stderr, "Fixture %s no disponible: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    // Validar una vez fuera de la medición: un parser que falla no debe parecer rápido
+    if (!bc->run(path, bc->arg))
+    {
+        fprintf(stderr, "El caso %s falló sobre %s\n", bc->name, path);
+        return -1;
+    }
+    if (bc->verify != NULL && !bc->verify(path, bc->arg))
+    {
+        fprintf(stderr, "El caso %s difiere del parser original sobre %s\n", bc->name, path);
+        return -1;
+    }
+
+    uint64_t batch = 1;
+    for (;;)
+    {
+        size_t allocs_before = alloc_count_get();
+        double start = now_ns();
+        for (uint64_t i = 0; i < batch; i++)
+        {
+            bc->run(path, bc->arg);
+        }
+        double elapsed = now_ns() - start;
+        size_t allocs = alloc_count_get() - allocs_before;
+
+        if (elapsed >= min_seconds * 1e9)
+        {
+            out->name = bc->name;
+            out->fixture = bc->fixture;
+            out->iterations = batch;
+            out->ns_per_op = elapsed / (double)batch;
+            out->allocs_per_op = (double)allocs / (double)batch;
+            out->bytes_per_op = (double)st.st_size;
+            out->mb_per_s = ((double)st.st_size * (double)batch) / (elapsed / 1e9) / (1024.0 * 1024.0);
+            return 0;
+        }
+        batch *= 2;
+    }
+}
+
+/**
+ * @brief Escribe los resultados en formato JSON.
+ */
+static int write_json(const char* filename, const bench_result_t* results, size_t count)
+{
+    FILE* fp = fopen(filename, "w");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "Error al abrir %s: %s\n", filename, strerror(errno));
+        return -1;
+    }
+
+    fprintf(fp, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < count; i++)
+    {
+        const bench_result_t* r = &results[i];
+        fprintf(fp,
+                "    {\"name\": \"%s\", \"fixture\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.1f, "
+                "\"allocs_per_op\": %.2f, \"bytes_per_op\": %.0f, \"mb_per_s\": %.1f}%s\n",
+                r->name, r->fixture, (unsigned long long)r->iterations, r->ns_per_op, r->allocs_per_op,
+                r->bytes_per_op, r->mb_per_s, i + 1 < count ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* dir = "bench/fixtures";
+    const char* json_file = NULL;
+    double min_seconds = 0.5;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:o:t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd':
+            dir = optarg;
+            break;
+        case 'o':
+            json_file = optarg;
+            break;
+        case 't':
+            min_seconds = atof(optarg);
+            break;
+        default:
+            fprintf(stderr, "Uso: %s [-d dir_fixtures] [-o resultados.json] [-t segundos_minimos] [filtro]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    const char* filter = (optind < argc) ? argv[optind] : NULL;
+
+    bench_result_t results[sizeof(cases) / sizeof(cases[0])];
+    size_t count = 0;
+    int failures = 0;
+
+    printf("%-24s %-20s %12s %12s %12s %10s\n", "caso", "fixture", "iteraciones", "ns/op", "allocs/op", "MB/s");
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        if (filter != NULL && strstr(cases[i].name, filter) == NULL)
+        {
+            continue;
+        }
+        if (run_case(&cases[i], dir, min_seconds, &results[count]) != 0)
+        {
+            failures++;
+            continue;
+        }
+        const bench_result_t* r = &results[count++];
+        printf("%-24s %-20s %12llu %12.1f %12.2f %10.1f\n", r->name, r->fixture, (unsigned long long)r->iterations,
+               r->ns_per_op, r->allocs_per_op, r->mb_per_s);
+    }
+
+    if (json_file != NULL && write_json(json_file, results, count) != 0)
+    {
+        return EXIT_FAILURE;
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
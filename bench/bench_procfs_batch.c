@@ -0,0 +1,269 @@
+/**
+ * @file bench_procfs_batch.c
+ * @brief Compara syscalls y latencia por tick de las lecturas directas, por lote con pread y por lote con io_uring.
+ *
+ * Se genera un árbol sintético del estilo de /proc/<pid>/stat con miles de archivos chicos (uno
+ * de cada 50 más grande que el buffer inicial, para ejercitar el crecimiento) y en cada tick se
+ * leen todos con procfs_read() entre procfs_batch_begin() y procfs_batch_end(), como hacen los
+ * colectores. Antes de cada tick se escribe el número de tick al principio de cada archivo: una
+ * lectura que devuelva un número viejo es un lote servido fuera de fecha. Los primeros ticks de
+ * cada backend (aprendizaje del conjunto de archivos) no se miden.
+ *
+ * Falla si alguna lectura está desactualizada, si un backend por lote no sirve todas las lecturas
+ * del lote o si no reduce las syscalls respecto del anterior (directo > pread > io_uring).
+ *
+ * Uso: bench_procfs_batch [-n archivos] [-t ticks] [-d directorio]
+ */
+
+#include "procfs.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Ticks de aprendizaje que no se miden.
+ */
+#define WARMUP_TICKS 3
+
+/**
+ * @brief Dígitos del número de tick al principio de cada archivo.
+ */
+#define STAMP_DIGITS 10
+
+/**
+ * @brief Resultado de un backend.
+ */
+typedef struct
+{
+    const char* name;      /**< Backend medido. */
+    bool ran;              /**< false si el backend no estaba disponible. */
+    double syscalls;       /**< Syscalls por tick. */
+    double batched;        /**< Lecturas servidas desde el lote por tick. */
+    double us;             /**< Microsegundos por tick. */
+    long stale;            /**< Lecturas con un número de tick viejo. */
+} run_result_t;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Escribe un archivo del estilo de /proc/<pid>/stat; los grandes imitan /proc/<pid>/status.
+ */
+static int write_fixture(const char* path, int pid, bool large)
+{
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    fprintf(file, "%0*d %d (worker-%d) S 1 %d %d 0 -1 4194560 %d 0 0 0 %d %d 0 0 20 0 1 0 %d\n", STAMP_DIGITS, 0,
+            pid, pid, pid, pid, pid * 3, pid % 977, pid % 131, pid * 7);
+    for (int line = 0; large && line < 400; line++)
+    {
+        fprintf(file, "Field%03d:\t%d kB\n", line, pid + line);
+    }
+    return fclose(file);
+}
+
+static int stamp(const char* path, int tick)
+{
+    char digits[STAMP_DIGITS + 1];
+    snprintf(digits, sizeof(digits), "%0*d", STAMP_DIGITS, tick);
+    int fd = open(path, O_WRONLY);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    ssize_t n = pwrite(fd, digits, STAMP_DIGITS, 0);
+    close(fd);
+    return n == STAMP_DIGITS ? 0 : -1;
+}
+
+static run_result_t run_backend(procfs_batch_backend_t backend, char** paths, int count, int ticks)
+{
+    run_result_t result = {.name = procfs_batch_name(backend)};
+    if (procfs_batch_init(backend) != backend)
+    {
+        procfs_batch_init(PROCFS_BATCH_OFF);
+        return result;
+    }
+    result.ran = true;
+
+    procfs_buf_t buf = {0};
+    procfs_stats_t before = {0};
+    procfs_stats_t after;
+    double elapsed = 0;
+    for (int t = 0; t < WARMUP_TICKS + ticks; t++)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            stamp(paths[i], t);
+        }
+        if (t == WARMUP_TICKS)
+        {
+            procfs_stats_get(&before);
+        }
+
+        double start = now_ns();
+        procfs_batch_begin();
+        for (int i = 0; i < count; i++)
+        {
+            if (procfs_read(paths[i], &buf) != 0 || strtol(buf.data, NULL, 10) != t)
+            {
+                result.stale++;
+            }
+        }
+        procfs_batch_end();
+        if (t >= WARMUP_TICKS)
+        {
+            elapsed += now_ns() - start;
+        }
+    }
+    procfs_stats_get(&after);
+    procfs_batch_init(PROCFS_BATCH_OFF);
+    free(buf.data);
+
+    result.syscalls = (double)(after.syscalls - before.syscalls) / ticks;
+    result.batched = (double)(after.batched - before.batched) / ticks;
+    result.us = elapsed / 1e3 / ticks;
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    int count = 2000;
+    int ticks = 100;
+    const char* dir_arg = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:t:d:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            count = atoi(optarg);
+            break;
+        case 't':
+            ticks = atoi(optarg);
+            break;
+        case 'd':
+            dir_arg = optarg;
+            break;
+        default:
+            fprintf(stderr, "Uso: %s [-n archivos] [-t ticks] [-d directorio]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (count < 1 || ticks < 1)
+    {
+        fprintf(stderr, "Se necesitan al menos 1 archivo y 1 tick\n");
+        return EXIT_FAILURE;
+    }
+
+    // El lote usa a lo sumo la mitad de RLIMIT_NOFILE
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+        if (limit.rlim_cur != RLIM_INFINITY && (rlim_t)count > limit.rlim_cur / 2 - 16)
+        {
+            count = (int)(limit.rlim_cur / 2) - 16;
+            printf("RLIMIT_NOFILE limita el conjunto a %d archivos\n", count);
+        }
+    }
+
+    char dir_template[] = "/tmp/bench_procfs_XXXXXX";
+    const char* dir = dir_arg != NULL ? dir_arg : mkdtemp(dir_template);
+    if (dir == NULL || (dir_arg != NULL && mkdir(dir, 0755) != 0 && errno != EEXIST))
+    {
+        perror("directorio de fixtures");
+        return EXIT_FAILURE;
+    }
+
+    char** paths = calloc((size_t)count, sizeof(*paths));
+    if (paths == NULL)
+    {
+        fprintf(stderr, "Sin memoria para %d rutas\n", count);
+        return EXIT_FAILURE;
+    }
+    int created = 0;
+    for (; created < count; created++)
+    {
+        char path[PROCFS_PATH_MAX];
+        int pid = 1000 + created;
+        snprintf(path, sizeof(path), "%s/%d", dir, pid);
+        mkdir(path, 0755);
+        snprintf(path, sizeof(path), "%s/%d/stat", dir, pid);
+        if (write_fixture(path, pid, created % 50 == 0) != 0 || (paths[created] = strdup(path)) == NULL)
+        {
+            perror(path);
+            break;
+        }
+    }
+
+    run_result_t results[3] = {0};
+    if (created == count)
+    {
+        results[0] = run_backend(PROCFS_BATCH_OFF, paths, count, ticks);
+        results[1] = run_backend(PROCFS_BATCH_PREAD, paths, count, ticks);
+        results[2] = run_backend(PROCFS_BATCH_IO_URING, paths, count, ticks);
+    }
+
+    for (int i = 0; i < created; i++)
+    {
+        unlink(paths[i]);
+        *strrchr(paths[i], '/') = '\0';
+        rmdir(paths[i]);
+        free(paths[i]);
+    }
+    free(paths);
+    if (dir_arg == NULL)
+    {
+        rmdir(dir);
+    }
+    if (created != count)
+    {
+        return EXIT_FAILURE;
+    }
+
+    printf("%d archivos, %d ticks medidos\n", count, ticks);
+    int failures = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        const run_result_t* r = &results[i];
+        if (!r->ran)
+        {
+            printf("%-9s no disponible en este kernel, se omite\n", r->name);
+            continue;
+        }
+        printf("%-9s %9.1f syscalls/tick %9.1f us/tick %8.0f lecturas del lote/tick, %ld desactualizadas\n", r->name,
+               r->syscalls, r->us, r->batched, r->stale);
+        failures += r->stale > 0;
+        failures += i > 0 && r->batched < count;
+    }
+    if (results[1].syscalls >= results[0].syscalls ||
+        (results[2].ran && results[2].syscalls >= results[1].syscalls))
+    {
+        fprintf(stderr, "Un backend por lote no reduce las syscalls por tick\n");
+        failures++;
+    }
+    if (failures > 0)
+    {
+        fprintf(stderr, "Lecturas por lote incorrectas o incompletas\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
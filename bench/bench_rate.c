@@ -0,0 +1,139 @@
+/**
+ * @file bench_rate.c
+ * @brief Mide el costo por serie del engine de tasas y verifica los avances con desbordes y reinicios.
+ *
+ * Se simulan decenas de miles de contadores: la mitad de 32 bits, que arrancan cerca del tope y
+ * desbordan durante la corrida, y la otra mitad de 64 bits, de los que una parte se reinicia a
+ * mitad de camino. La suma de los avances que devuelve rate_update() debe coincidir con lo que
+ * cada contador avanzó de verdad (para los reiniciados, lo contado desde el reinicio). Falla si
+ * alguna serie no coincide o si el costo por actualización supera el presupuesto.
+ *
+ * Uso: bench_rate [-s series] [-t ticks] [-b presupuesto_ns]
+ */
+
+#include "rate.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(int argc, char* argv[])
+{
+    int series_count = 50000;
+    int ticks = 200;
+    double budget_ns = 50;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:t:b:")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            series_count = atoi(optarg);
+            break;
+        case 't':
+            ticks = atoi(optarg);
+            break;
+        case 'b':
+            budget_ns = atof(optarg);
+            break;
+        default:
+            fprintf(stderr, "Uso: %s [-s series] [-t ticks] [-b presupuesto_ns]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (series_count < 2 || ticks < 4)
+    {
+        fprintf(stderr, "Se necesitan al menos 2 series y 4 ticks\n");
+        return EXIT_FAILURE;
+    }
+
+    rate_engine_t engine = {0};
+    int narrow = series_count / 2;
+    int first32 = rate_series_reserve(&engine, narrow, 32);
+    int first64 = rate_series_reserve(&engine, series_count - narrow, 64);
+    uint64_t* counter = malloc((size_t)series_count * sizeof(uint64_t));
+    double* expected = malloc((size_t)series_count * sizeof(double));
+    double* summed = malloc((size_t)series_count * sizeof(double));
+    if (first32 < 0 || first64 < 0 || counter == NULL || expected == NULL || summed == NULL)
+    {
+        fprintf(stderr, "Sin memoria para %d series\n", series_count);
+        return EXIT_FAILURE;
+    }
+
+    // Primera lectura: los de 32 bits quedan a unos pocos ticks del tope
+    for (int i = 0; i < series_count; i++)
+    {
+        counter[i] = i < narrow ? UINT32_MAX - (uint64_t)(i % 5000) * 10 : (uint64_t)i * 1000;
+        expected[i] = (double)counter[i];
+        rate_update(&engine, i, counter[i], -1000, &summed[i]);
+    }
+
+    unsigned seed = 1;
+    int reset_tick = ticks / 2;
+    double elapsed = 0;
+    for (int t = 0; t < ticks; t++)
+    {
+        int64_t now_ms = (int64_t)t * 1000;
+        for (int i = 0; i < series_count; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            uint64_t increment = (seed >> 16) % 1000;
+            if (i >= narrow && t == reset_tick && i % 7 == 0)
+            {
+                counter[i] = increment;
+            }
+            else
+            {
+                counter[i] += increment;
+                if (i < narrow)
+                {
+                    counter[i] &= UINT32_MAX;
+                }
+            }
+            expected[i] += (double)increment;
+        }
+
+        double start = now_ns();
+        for (int i = 0; i < series_count; i++)
+        {
+            double delta;
+            rate_update(&engine, i, counter[i], now_ms, &delta);
+            summed[i] += delta;
+        }
+        elapsed += now_ns() - start;
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < series_count; i++)
+    {
+        mismatches += summed[i] != expected[i];
+    }
+    double per_update = elapsed / ((double)series_count * ticks);
+    printf("rate_update: %.1f ns/serie con %d series (presupuesto %.0f ns)\n", per_update, series_count, budget_ns);
+    printf("series con avance incorrecto: %d de %d\n", mismatches, series_count);
+
+    free(counter);
+    free(expected);
+    free(summed);
+    rate_engine_free(&engine);
+
+    if (mismatches > 0)
+    {
+        fprintf(stderr, "El engine no reconstruyó el avance de todos los contadores\n");
+        return EXIT_FAILURE;
+    }
+    if (per_update > budget_ns)
+    {
+        fprintf(stderr, "El engine supera el presupuesto por serie\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,999 @@
+/**
+ * @file bench_soak.c
+ * @brief Prueba de resistencia: el agente completo sobre snapshots reproducidos a ritmo acelerado.
+ *
+ * Se arma un directorio de replay con los fixtures de host grande (un /proc/stat que avanza en
+ * cada snapshot y el resto fijo) y un /sys con cpufreq, throttling y topología de cada CPU, una
+ * zona térmica y dos nodos NUMA cuyos contadores también avanzan. Se lanza metricShell con todos
+ * los colectores activos (el micro-muestreo no corre en replay), algunas reglas de alerta, un
+ * tope de series por métrica, y replay_loop y replay_speed elegidos para un tick cada -i ms.
+ * Mientras corre:
+ *  - un cliente HTTP propio pide /metrics cada -s ms y mide la latencia de cada scrape;
+ *  - un hilo vacía el FIFO y toma la hora de llegada de cada mensaje del tick (los eventos se
+ *    separan por su clave "event") para medir el intervalo entre ticks y su desvío;
+ *  - el hilo principal anota cada segundo el RSS y los descriptores abiertos del agente.
+ *
+ * Las mediciones empiezan después del calentamiento (-w). Falla si el agente termina antes de
+ * tiempo, si el p99 del desvío del tick o de la latencia de scrape supera su umbral, si el RSS o
+ * los descriptores crecen más de lo permitido entre el fin del calentamiento y el final, si
+ * fallan más del 1% de los scrapes o si llegan menos de la mitad de los ticks esperados.
+ *
+ * Con -l se lanza un proceso que gira sin parar por cada CPU en línea (el host a plena carga) y
+ * con -R el agente corre en modo de baja latencia: colector fijado a la última CPU en SCHED_FIFO
+ * con la prioridad dada, HTTP en la anteúltima y memoria bloqueada. El hilo que vacía el FIFO
+ * también pasa a SCHED_FIFO para que la medición no sufra la carga que se quiere mostrar. -R
+ * necesita CAP_SYS_NICE y CAP_IPC_LOCK (root); sin permisos el agente y la medición informan
+ * el error y siguen con la política normal.
+ *
+ * El FIFO (FIFO_PATH) y el puerto 8000 son los del agente: no correr junto a otra instancia.
+ *
+ * Uso: bench_soak -a metricShell [-d dir_fixtures] [-t segundos] [-i tick_ms] [-s scrape_ms]
+ *                 [-w calentamiento_s] [-J p99_desvío_ms] [-L p99_scrape_ms] [-M crecimiento_rss_kb]
+ *                 [-F crecimiento_fds] [-l] [-R prioridad]
+ */
+
+#include "events.h"
+#include "quantile.h"
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/prctl.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Snapshots del replay; al terminar se repiten.
+ */
+#define SNAPSHOTS 20
+
+/**
+ * @brief Separación grabada entre snapshots; replay_speed la lleva al tick pedido.
+ */
+#define RECORDED_INTERVAL_MS 1000
+
+/**
+ * @brief Puerto del servidor HTTP del agente.
+ */
+#define HTTP_PORT 8000
+
+/**
+ * @brief Espera máxima hasta el primer scrape y el primer tick.
+ */
+#define STARTUP_TIMEOUT_MS 15000
+
+/**
+ * @brief Procesos de carga como máximo (uno por CPU).
+ */
+#define LOAD_MAX_PROCS 1024
+
+/**
+ * @brief Largo máximo de una ruta del directorio temporal.
+ */
+#define SOAK_PATH_MAX 512
+
+/**
+ * @brief Tope de series por métrica: por debajo de las CPUs y los discos de los fixtures, para que el
+ * recorte trabaje en cada tick.
+ */
+#define SERIES_CAP 256
+
+/**
+ * @brief Fixture copiado en cada snapshot.
+ */
+typedef struct
+{
+    const char* fixture; /**< Archivo en el directorio de fixtures. */
+    const char* rel;     /**< Ruta dentro de proc/. */
+} fixture_map_t;
+
+static const fixture_map_t fixture_files[] = {
+    {"proc_meminfo", "meminfo"},
+    {"proc_vmstat", "vmstat"},
+    {"proc_buddyinfo_16node", "buddyinfo"},
+    {"proc_pagetypeinfo_16node", "pagetypeinfo"},
+    {"proc_diskstats_1k", "diskstats"},
+    {"proc_net_dev_5k", "net/dev"},
+    {"proc_net_snmp", "net/snmp"},
+    {"proc_net_netstat", "net/netstat"},
+    {"proc_interrupts_256cpu", "interrupts"},
+    {"proc_softirqs_256cpu", "softirqs"},
+    {"proc_pressure_memory", "pressure/memory"},
+    {"proc_pressure_memory", "pressure/cpu"},
+    {"proc_pressure_memory", "pressure/io"},
+};
+
+/**
+ * @brief Mediciones compartidas entre los hilos del cliente.
+ */
+static struct
+{
+    pthread_mutex_t lock;
+    bool measuring;       /**< Terminó el calentamiento. */
+    bool stopping;        /**< Los hilos deben terminar. */
+    qsketch_t intervals;  /**< Intervalo entre ticks en ms. */
+    qsketch_t jitter;     /**< |intervalo - tick| en ms. */
+    qsketch_t scrapes;    /**< Latencia de scrape en ms. */
+    long ticks;           /**< Mensajes del tick recibidos (medidos). */
+    long events;          /**< Eventos recibidos (medidos). */
+    long scrape_ok;       /**< Scrapes correctos (medidos). */
+    long scrape_failed;   /**< Scrapes fallidos (medidos). */
+    long first_tick;      /**< Se recibió al menos un tick. */
+    long first_scrape;    /**< Hubo al menos un scrape correcto. */
+    size_t last_body;     /**< Tamaño de la última respuesta de /metrics. */
+} soak = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+static int tick_ms = 10;
+static int scrape_ms = 100;
+static int rt_priority = 0; // -R: prioridad SCHED_FIFO del colector (0: sin modo de baja latencia)
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+static void sleep_ms(double ms)
+{
+    struct timespec ts = {(time_t)(ms / 1000), (long)(fmod(ms, 1000) * 1e6)};
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR)
+    {
+    }
+}
+
+static bool stopping(void)
+{
+    return __atomic_load_n(&soak.stopping, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Lee un archivo completo en memoria.
+ * @return Contenido terminado en NUL (el llamador lo libera), o NULL en caso de error.
+ */
+static char* read_file(const char* path, size_t* length)
+{
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* data = size >= 0 ? malloc((size_t)size + 1) : NULL;
+    if (data != NULL)
+    {
+        *length = fread(data, 1, (size_t)size, file);
+        data[*length] = '\0';
+    }
+    fclose(file);
+    return data;
+}
+
+static int write_file(const char* root, const char* rel, const char* data, size_t length)
+{
+    char path[SOAK_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", root, rel);
+
+    // Crea los directorios intermedios (también los del snapshot)
+    for (char* slash = strchr(path + 1, '/'); slash != NULL; slash = strchr(slash + 1, '/'))
+    {
+        *slash = '\0';
+        mkdir(path, 0755);
+        *slash = '/';
+    }
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    fwrite(data, 1, length, file);
+    return fclose(file);
+}
+
+static int remove_tree(const char* path)
+{
+    DIR* dir = opendir(path);
+    if (dir == NULL)
+    {
+        return remove(path);
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+        {
+            char child[SOAK_PATH_MAX];
+            snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+            remove_tree(child);
+        }
+    }
+    closedir(dir);
+    return rmdir(path);
+}
+
+/**
+ * @brief /proc/stat del snapshot: cada CPU suma tiempo ocupado y ocioso, y ctxt avanza.
+ */
+static char* advance_stat(const char* base, size_t base_length, int snapshot, size_t* length)
+{
+    size_t capacity = base_length * 2 + 256;
+    char* out = malloc(capacity);
+    size_t used = 0;
+    for (const char* line = base; out != NULL && *line != '\0' && used < capacity;)
+    {
+        const char* end = strchr(line, '\n');
+        size_t line_length = end != NULL ? (size_t)(end - line) : strlen(line);
+        if (strncmp(line, "cpu", 3) == 0)
+        {
+            char name[16];
+            unsigned long long v[10] = {0};
+            int n = sscanf(line, "%15s %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu", name, &v[0], &v[1], &v[2],
+                           &v[3], &v[4], &v[5], &v[6], &v[7], &v[8], &v[9]);
+            unsigned long long step = (unsigned long long)snapshot * 50;
+            used += (size_t)snprintf(out + used, capacity - used,
+                                     "%s %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu\n", name,
+                                     v[0] + step * (n > 1), v[1], v[2], v[3] + step * (n > 4), v[4], v[5], v[6], v[7],
+                                     v[8], v[9]);
+        }
+        else if (strncmp(line, "ctxt ", 5) == 0)
+        {
+            used += (size_t)snprintf(out + used, capacity - used, "ctxt %llu\n",
+                                     strtoull(line + 5, NULL, 10) + (unsigned long long)snapshot * 100000);
+        }
+        else
+        {
+            used += (size_t)snprintf(out + used, capacity - used, "%.*s\n", (int)line_length, line);
+        }
+        line += line_length + (end != NULL);
+    }
+    *length = used < capacity ? used : capacity - 1;
+    return out;
+}
+
+static int write_value(const char* root, const char* format, int number, long long value)
+{
+    char rel[128], data[32];
+    snprintf(rel, sizeof(rel), format, number);
+    int length = snprintf(data, sizeof(data), "%lld\n", value);
+    return write_file(root, rel, data, (size_t)length);
+}
+
+static int write_text(const char* root, const char* rel, const char* text)
+{
+    return write_file(root, rel, text, strlen(text));
+}
+
+/**
+ * @brief CPUs numeradas ("cpuN") en un /proc/stat.
+ */
+static int count_cpus(const char* stat)
+{
+    int cpus = 0;
+    for (const char* line = stat; line != NULL && *line != '\0';)
+    {
+        cpus += strncmp(line, "cpu", 3) == 0 && line[3] >= '0' && line[3] <= '9';
+        const char* next = strchr(line, '\n');
+        line = next != NULL ? next + 1 : NULL;
+    }
+    return cpus;
+}
+
+/**
+ * @brief /sys del snapshot y /proc/net/sockstat: frecuencias que varían por CPU, throttling y
+ * numastat que avanzan, una zona térmica y las CPUs repartidas en dos nodos NUMA.
+ */
+static int build_sys(const char* sys, const char* proc, int snapshot, int cpus)
+{
+    char text[256];
+    int half = cpus / 2;
+    int rc = 0;
+
+    snprintf(text, sizeof(text), "0-%d\n", cpus - 1);
+    rc |= write_text(sys, "devices/system/cpu/possible", text);
+    rc |= write_text(sys, "devices/system/node/online", half > 0 ? "0-1\n" : "0\n");
+    for (int node = 0; node < (half > 0 ? 2 : 1); node++)
+    {
+        char rel[128];
+        snprintf(rel, sizeof(rel), "devices/system/node/node%d/cpulist", node);
+        snprintf(text, sizeof(text), "%d-%d\n", node == 0 ? 0 : half, node == 0 && half > 0 ? half - 1 : cpus - 1);
+        rc |= write_text(sys, rel, text);
+        snprintf(rel, sizeof(rel), "devices/system/node/node%d/meminfo", node);
+        snprintf(text, sizeof(text),
+                 "Node %d MemTotal:       65536000 kB\nNode %d MemFree:        %d kB\n"
+                 "Node %d MemUsed:        %d kB\nNode %d FilePages:      8192000 kB\n",
+                 node, node, 32768000 - snapshot * 1024, node, 32768000 + snapshot * 1024, node);
+        rc |= write_text(sys, rel, text);
+        snprintf(rel, sizeof(rel), "devices/system/node/node%d/numastat", node);
+        long long hits = 1000000LL + snapshot * 5000LL;
+        snprintf(text, sizeof(text),
+                 "numa_hit %lld\nnuma_miss %d\nnuma_foreign %d\ninterleave_hit 5\nlocal_node %lld\n"
+                 "other_node %d\n",
+                 hits, snapshot * 10, snapshot * 10, hits, snapshot * 10);
+        rc |= write_text(sys, rel, text);
+    }
+    for (int c = 0; c < cpus && rc == 0; c++)
+    {
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", c, 3000000);
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq", c,
+                          1200000 + (long long)((c + snapshot) % 10) * 180000);
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/topology/physical_package_id", c, c < half ? 0 : 1);
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/thermal_throttle/core_throttle_count", c, snapshot);
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/thermal_throttle/package_throttle_count", c, 0);
+    }
+    rc |= write_text(sys, "class/thermal/thermal_zone0/type", "x86_pkg_temp\n");
+    rc |= write_value(sys, "class/thermal/thermal_zone%d/temp", 0, 60000 + snapshot * 500);
+
+    snprintf(text, sizeof(text), "sockets: used 812\nTCP: inuse 41 orphan 0 tw %d alloc 58 mem 9\nUDP: inuse 6 mem 2\n",
+             17 + snapshot);
+    rc |= write_text(proc, "net/sockstat", text);
+    return rc;
+}
+
+/**
+ * @brief Arma el directorio de replay y devuelve en iface la primera interfaz de red que no es lo.
+ */
+static int build_replay(const char* fixtures, const char* replay, char* iface, size_t iface_len)
+{
+    size_t stat_length;
+    char path[SOAK_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/proc_stat_512cpu", fixtures);
+    char* stat = read_file(path, &stat_length);
+    if (stat == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+
+    int cpus = count_cpus(stat);
+    int rc = mkdir(replay, 0755);
+    for (int s = 0; s < SNAPSHOTS && rc == 0; s++)
+    {
+        char snapshot[SOAK_PATH_MAX], sys[SOAK_PATH_MAX];
+        int n = snprintf(snapshot, sizeof(snapshot), "%s/%d/proc", replay, 1000000 + s * RECORDED_INTERVAL_MS);
+        snprintf(sys, sizeof(sys), "%s/%d/sys", replay, 1000000 + s * RECORDED_INTERVAL_MS);
+        if (n < 0 || (size_t)n >= sizeof(snapshot))
+        {
+            fprintf(stderr, "Ruta de snapshot demasiado larga bajo %s\n", replay);
+            rc = -1;
+            break;
+        }
+        size_t length;
+        char* data = advance_stat(stat, stat_length, s, &length);
+        rc = data != NULL ? write_file(snapshot, "stat", data, length) : -1;
+        free(data);
+        rc = rc == 0 ? build_sys(sys, snapshot, s, cpus) : rc;
+        for (size_t f = 0; f < sizeof(fixture_files) / sizeof(fixture_files[0]) && rc == 0; f++)
+        {
+            snprintf(path, sizeof(path), "%s/%s", fixtures, fixture_files[f].fixture);
+            data = read_file(path, &length);
+            rc = data != NULL ? write_file(snapshot, fixture_files[f].rel, data, length) : -1;
+            if (data == NULL)
+            {
+                perror(path);
+            }
+            if (rc == 0 && s == 0 && strcmp(fixture_files[f].rel, "net/dev") == 0)
+            {
+                // Primera interfaz distinta de lo (las dos primeras líneas son encabezados)
+                iface[0] = '\0';
+                for (char* line = strtok(data, "\n"); line != NULL && iface[0] == '\0'; line = strtok(NULL, "\n"))
+                {
+                    char name[32];
+                    if (sscanf(line, " %31[^:]:", name) == 1 && strchr(line, ':') != NULL &&
+                        strcmp(name, "lo") != 0 && strchr(name, '|') == NULL)
+                    {
+                        snprintf(iface, iface_len, "%s", name);
+                    }
+                }
+            }
+            free(data);
+        }
+    }
+    free(stat);
+    return rc;
+}
+
+static int write_config(const char* path, const char* replay, const char* dir, const char* iface)
+{
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    char realtime[256] = "";
+    if (rt_priority > 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        snprintf(realtime, sizeof(realtime),
+                 "  \"realtime\": {\"collector_cpus\": \"%ld\", \"http_cpus\": \"%ld\", \"collector_priority\": %d,\n"
+                 "               \"lock_memory\": true},\n",
+                 cpus - 1, cpus > 1 ? cpus - 2 : 0, rt_priority);
+    }
+    fprintf(file,
+            "{\n"
+            "  \"sampling_interval\": 1,\n"
+            "  \"metrics\": [\"memory_fragmentation\", \"cpu\", \"cpufreq\", \"memory\", \"disk\", \"net\",\n"
+            "              \"context_switches\", \"running_processes\", \"meminfo\", \"psi\", \"interrupts\",\n"
+            "              \"numa\", \"netproto\"],\n"
+            "  \"alerts\": [\"cpu_usage > 40 for 1s\", \"thermal_max_celsius > 65\",\n"
+            "             \"rate(context_switches) > 1e6\",\n"
+            "             {\"name\": \"retransmits\", \"expr\": \"tcp_retransmit_ratio > 0.01 for 2s\"}],\n"
+            "  \"cardinality\": {\"max_series_per_metric\": %d},\n"
+            "  \"replay_dir\": \"%s\",\n"
+            "  \"replay_speed\": %.3f,\n"
+            "  \"replay_loop\": true,\n"
+            "  \"disk_device\": \"nvme0n1\",\n"
+            "  \"net_interface\": \"%s\",\n"
+            "%s"
+            "  \"log_file\": \"%s/metrics.log\"\n"
+            "}\n",
+            SERIES_CAP, replay, (double)RECORDED_INTERVAL_MS / tick_ms, iface, realtime, dir);
+    return fclose(file);
+}
+
+/**
+ * @brief Un scrape de /metrics con un cliente HTTP/1.0 mínimo.
+ * @return Bytes de la respuesta, o -1 si falló o el estado no es 200.
+ */
+static long scrape_once(void)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    struct timeval timeout = {2, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(HTTP_PORT)};
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    static const char request[] = "GET /metrics HTTP/1.0\r\nHost: localhost\r\n\r\n";
+    long total = -1;
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0 &&
+        write(fd, request, sizeof(request) - 1) == (ssize_t)(sizeof(request) - 1))
+    {
+        char buf[16384];
+        char status[16] = "";
+        ssize_t n;
+        total = 0;
+        while ((n = read(fd, buf, sizeof(buf))) > 0)
+        {
+            if (total == 0)
+            {
+                snprintf(status, sizeof(status), "%.*s", (int)(n < 15 ? n : 15), buf);
+            }
+            total += n;
+        }
+        if (n < 0 || strncmp(status, "HTTP/1.", 7) != 0 || strncmp(status + 9, "200", 3) != 0)
+        {
+            total = -1;
+        }
+    }
+    close(fd);
+    return total;
+}
+
+static void* scrape_loop(void* arg)
+{
+    (void)arg;
+    while (!stopping())
+    {
+        double start = now_ms();
+        long bytes = scrape_once();
+        double elapsed = now_ms() - start;
+
+        pthread_mutex_lock(&soak.lock);
+        soak.first_scrape |= bytes > 0;
+        if (soak.measuring && bytes > 0)
+        {
+            qsketch_add(&soak.scrapes, elapsed);
+            soak.scrape_ok++;
+            soak.last_body = (size_t)bytes;
+        }
+        else if (soak.measuring)
+        {
+            soak.scrape_failed++;
+        }
+        pthread_mutex_unlock(&soak.lock);
+
+        if (elapsed < scrape_ms)
+        {
+            sleep_ms(scrape_ms - elapsed);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Registra la llegada de un mensaje completo del FIFO.
+ */
+static void on_message(const char* message, double arrival_ms, double* last_tick_ms)
+{
+    pthread_mutex_lock(&soak.lock);
+    if (strstr(message, "\"event\"") != NULL)
+    {
+        soak.events += soak.measuring;
+    }
+    else
+    {
+        soak.first_tick = 1;
+        if (soak.measuring && *last_tick_ms > 0)
+        {
+            double interval = arrival_ms - *last_tick_ms;
+            qsketch_add(&soak.intervals, interval);
+            qsketch_add(&soak.jitter, fabs(interval - tick_ms));
+            soak.ticks++;
+        }
+        *last_tick_ms = arrival_ms;
+    }
+    pthread_mutex_unlock(&soak.lock);
+}
+
+/**
+ * @brief Vacía el FIFO y separa los mensajes por la profundidad de llaves (el JSON del tick tiene saltos de línea).
+ */
+static void* drain_fifo(void* arg)
+{
+    int fd = *(const int*)arg;
+    size_t capacity = 1 << 16;
+    char* message = malloc(capacity);
+    size_t used = 0;
+    int depth = 0;
+    bool in_string = false;
+    bool escaped = false;
+    double last_tick_ms = -1;
+    char buf[1 << 16];
+
+    // En modo de baja latencia la llegada de cada tick se mide con la misma prioridad que el colector
+    if (rt_priority > 0)
+    {
+        struct sched_param param = {.sched_priority = rt_priority};
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0)
+        {
+            fprintf(stderr, "El lector del FIFO sigue con la política normal: %s\n", strerror(err));
+        }
+    }
+
+    while (message != NULL && !stopping())
+    {
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        if (poll(&pfd, 1, 100) <= 0)
+        {
+            continue;
+        }
+        ssize_t n = read(fd, buf, sizeof(buf));
+        double arrival = now_ms();
+        for (ssize_t i = 0; i < n; i++)
+        {
+            char c = buf[i];
+            if (depth == 0 && c != '{')
+            {
+                continue; // Separadores entre mensajes
+            }
+            if (used + 1 >= capacity)
+            {
+                char* grown = realloc(message, capacity * 2);
+                if (grown == NULL)
+                {
+                    break;
+                }
+                message = grown;
+                capacity *= 2;
+            }
+            message[used++] = c;
+            if (in_string)
+            {
+                in_string = escaped || c != '"';
+                escaped = !escaped && c == '\\';
+                continue;
+            }
+            in_string = c == '"';
+            depth += (c == '{') - (c == '}');
+            if (depth == 0)
+            {
+                message[used] = '\0';
+                on_message(message, arrival, &last_tick_ms);
+                used = 0;
+            }
+        }
+    }
+    free(message);
+    return NULL;
+}
+
+/**
+ * @brief RSS del proceso en kB, o -1.
+ */
+static long read_rss_kb(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/status", (int)pid);
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    char line[256];
+    long rss = -1;
+    while (rss < 0 && fgets(line, sizeof(line), file) != NULL)
+    {
+        if (strncmp(line, "VmRSS:", 6) == 0)
+        {
+            rss = strtol(line + 6, NULL, 10);
+        }
+    }
+    fclose(file);
+    return rss;
+}
+
+/**
+ * @brief Descriptores abiertos del proceso, o -1.
+ */
+static int count_fds(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/fd", (int)pid);
+    DIR* dir = opendir(path);
+    if (dir == NULL)
+    {
+        return -1;
+    }
+    int count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        count += entry->d_name[0] != '.';
+    }
+    closedir(dir);
+    return count;
+}
+
+/**
+ * @brief Abre el FIFO del agente para leer; O_RDWR evita ver EOF cada vez que el agente lo cierra.
+ */
+static int open_fifo(void)
+{
+    struct stat st;
+    if (stat(FIFO_PATH, &st) == 0 && !S_ISFIFO(st.st_mode))
+    {
+        unlink(FIFO_PATH); // fifo_write() lo crea como archivo regular si no existe
+    }
+    if (mkfifo(FIFO_PATH, 0666) != 0 && errno != EEXIST)
+    {
+        perror(FIFO_PATH);
+        return -1;
+    }
+    return open(FIFO_PATH, O_RDWR | O_NONBLOCK);
+}
+
+static pid_t start_agent(const char* agent, const char* config, const char* dir)
+{
+    char log_path[SOAK_PATH_MAX];
+    snprintf(log_path, sizeof(log_path), "%s/agent.out", dir);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        int out = open(log_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (out >= 0)
+        {
+            dup2(out, STDOUT_FILENO);
+            dup2(out, STDERR_FILENO);
+            close(out);
+        }
+        execl(agent, agent, config, (char*)NULL);
+        perror(agent);
+        _exit(127);
+    }
+    return pid;
+}
+
+/**
+ * @brief Lanza un proceso que gira sin parar por cada CPU en línea.
+ * @return Procesos lanzados.
+ */
+static int start_load(pid_t* burners, int max)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int count = 0;
+    for (long c = 0; c < cpus && count < max; c++)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            prctl(PR_SET_PDEATHSIG, SIGKILL); // No sobrevive a la prueba aunque esta termine mal
+            for (volatile unsigned long spin = 0;; spin++)
+            {
+            }
+        }
+        if (pid > 0)
+        {
+            burners[count++] = pid;
+        }
+    }
+    return count;
+}
+
+static void stop_agent(pid_t pid)
+{
+    kill(pid, SIGTERM);
+    for (int i = 0; i < 40; i++)
+    {
+        if (waitpid(pid, NULL, WNOHANG) == pid)
+        {
+            return;
+        }
+        sleep_ms(50);
+    }
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+}
+
+int main(int argc, char* argv[])
+{
+    const char* agent = NULL;
+    const char* fixtures = "bench/fixtures";
+    int seconds = 60;
+    int warmup = 5;
+    double max_jitter_ms = 5;
+    double max_scrape_ms = 100;
+    long max_rss_growth_kb = 1024;
+    int max_fd_growth = 0;
+    bool load = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "a:d:t:i:s:w:J:L:M:F:lR:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'a':
+            agent = optarg;
+            break;
+        case 'd':
+            fixtures = optarg;
+            break;
+        case 't':
+            seconds = atoi(optarg);
+            break;
+        case 'i':
+            tick_ms = atoi(optarg);
+            break;
+        case 's':
+            scrape_ms = atoi(optarg);
+            break;
+        case 'w':
+            warmup = atoi(optarg);
+            break;
+        case 'J':
+            max_jitter_ms = atof(optarg);
+            break;
+        case 'L':
+            max_scrape_ms = atof(optarg);
+            break;
+        case 'M':
+            max_rss_growth_kb = atol(optarg);
+            break;
+        case 'F':
+            max_fd_growth = atoi(optarg);
+            break;
+        case 'l':
+            load = true;
+            break;
+        case 'R':
+            rt_priority = atoi(optarg);
+            break;
+        default:
+            agent = NULL;
+            seconds = 0;
+            break;
+        }
+    }
+    if (agent == NULL || seconds <= warmup || warmup < 0 || tick_ms < 1 || scrape_ms < 1 || rt_priority < 0 ||
+        rt_priority > 99)
+    {
+        fprintf(stderr,
+                "Uso: %s -a metricShell [-d dir_fixtures] [-t segundos] [-i tick_ms] [-s scrape_ms] "
+                "[-w calentamiento_s] [-J p99_desvío_ms] [-L p99_scrape_ms] [-M crecimiento_rss_kb] "
+                "[-F crecimiento_fds] [-l] [-R prioridad]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Las filas periódicas se ven en el momento aunque la salida vaya a un archivo o a CTest
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    char dir[] = "/tmp/bench_soak_XXXXXX";
+    if (mkdtemp(dir) == NULL)
+    {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    char replay[SOAK_PATH_MAX], config[SOAK_PATH_MAX], iface[32] = "";
+    snprintf(replay, sizeof(replay), "%s/replay", dir);
+    snprintf(config, sizeof(config), "%s/config.json", dir);
+    int fifo = -1;
+    if (build_replay(fixtures, replay, iface, sizeof(iface)) != 0 || write_config(config, replay, dir, iface) != 0 ||
+        (fifo = open_fifo()) < 0)
+    {
+        fprintf(stderr, "No se pudo preparar el replay en %s\n", dir);
+        remove_tree(dir);
+        return EXIT_FAILURE;
+    }
+
+    qsketch_init(&soak.intervals, 0.01);
+    qsketch_init(&soak.jitter, 0.01);
+    qsketch_init(&soak.scrapes, 0.01);
+    pthread_t drainer, scraper;
+    pthread_create(&drainer, NULL, drain_fifo, &fifo);
+    pthread_create(&scraper, NULL, scrape_loop, NULL);
+
+    pid_t pid = start_agent(agent, config, dir);
+    printf("Agente %s (pid %d): tick cada %d ms, scrape cada %d ms, %d s (%d de calentamiento)\n", agent, (int)pid,
+           tick_ms, scrape_ms, seconds, warmup);
+    if (rt_priority > 0)
+    {
+        printf("Modo de baja latencia: colector en SCHED_FIFO %d con CPU y memoria propias\n", rt_priority);
+        if (sysconf(_SC_NPROCESSORS_ONLN) < 2)
+        {
+            // El colector va a la última CPU y el HTTP a la anteúltima; con una sola, las dos son la misma
+            fprintf(stderr, "Con una sola CPU el colector la comparte con el HTTP: el desvío no muestra el "
+                            "aislamiento\n");
+        }
+    }
+
+    pid_t burners[LOAD_MAX_PROCS];
+    int burner_count = load ? start_load(burners, LOAD_MAX_PROCS) : 0;
+    if (load)
+    {
+        printf("Carga: %d procesos girando, uno por CPU\n", burner_count);
+    }
+
+    // Arranque: primer tick y primer scrape
+    double start = now_ms();
+    bool started = false;
+    bool died = pid < 0;
+    while (!started && !died && now_ms() - start < STARTUP_TIMEOUT_MS)
+    {
+        sleep_ms(50);
+        pthread_mutex_lock(&soak.lock);
+        started = soak.first_tick && soak.first_scrape;
+        pthread_mutex_unlock(&soak.lock);
+        died = waitpid(pid, NULL, WNOHANG) == pid;
+    }
+
+    long rss_base = -1, rss = -1, rss_peak = -1;
+    int fds_base = -1, fds = -1;
+    int elapsed_s = 0;
+    if (started)
+    {
+        printf("%6s %8s %10s %6s %8s\n", "t", "ticks", "rss_kb", "fds", "scrapes");
+        double run_start = now_ms();
+        for (elapsed_s = 1; elapsed_s <= seconds && !died; elapsed_s++)
+        {
+            sleep_ms(run_start + elapsed_s * 1000.0 - now_ms());
+            died = waitpid(pid, NULL, WNOHANG) == pid;
+            rss = read_rss_kb(pid);
+            fds = count_fds(pid);
+            rss_peak = rss > rss_peak ? rss : rss_peak;
+
+            pthread_mutex_lock(&soak.lock);
+            if (elapsed_s == warmup)
+            {
+                soak.measuring = true;
+                rss_base = rss;
+                fds_base = fds;
+            }
+            long ticks = soak.ticks;
+            long scrapes = soak.scrape_ok;
+            pthread_mutex_unlock(&soak.lock);
+
+            int every = seconds >= 60 ? 10 : 1;
+            if (elapsed_s % every == 0 || elapsed_s == warmup)
+            {
+                printf("%5ds %8ld %10ld %6d %8ld\n", elapsed_s, ticks, rss, fds, scrapes);
+            }
+        }
+    }
+    else
+    {
+        fprintf(stderr, "El agente %s antes de responder (ver %s/agent.out)\n", died ? "terminó" : "no arrancó", dir);
+    }
+
+    __atomic_store_n(&soak.stopping, true, __ATOMIC_RELEASE);
+    pthread_join(scraper, NULL);
+    pthread_join(drainer, NULL);
+    if (!died && pid > 0)
+    {
+        stop_agent(pid);
+    }
+    for (int b = 0; b < burner_count; b++)
+    {
+        kill(burners[b], SIGKILL);
+        waitpid(burners[b], NULL, 0);
+    }
+    close(fifo);
+
+    int failures = !started || died;
+    if (started)
+    {
+        double measured_s = seconds - warmup;
+        long expected_ticks = (long)(measured_s * 1000 / tick_ms);
+        long rss_growth = rss_base >= 0 && rss >= 0 ? rss - rss_base : 0;
+        int fd_growth = fds_base >= 0 && fds >= 0 ? fds - fds_base : 0;
+        long scrape_total = soak.scrape_ok + soak.scrape_failed;
+
+        printf("ticks: %ld de %ld esperados, %ld eventos\n", soak.ticks, expected_ticks, soak.events);
+        printf("intervalo del tick (ms): p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+               qsketch_quantile(&soak.intervals, 0.5), qsketch_quantile(&soak.intervals, 0.9),
+               qsketch_quantile(&soak.intervals, 0.99), qsketch_quantile(&soak.intervals, 1));
+        printf("desvío del tick (ms):     p50 %.2f  p90 %.2f  p99 %.2f  max %.2f  (umbral p99 %.1f)\n",
+               qsketch_quantile(&soak.jitter, 0.5), qsketch_quantile(&soak.jitter, 0.9),
+               qsketch_quantile(&soak.jitter, 0.99), qsketch_quantile(&soak.jitter, 1), max_jitter_ms);
+        printf("scrape de /metrics (ms):  p50 %.2f  p90 %.2f  p99 %.2f  max %.2f  (umbral p99 %.1f), %ld de %ld "
+               "correctos, %zu bytes\n",
+               qsketch_quantile(&soak.scrapes, 0.5), qsketch_quantile(&soak.scrapes, 0.9),
+               qsketch_quantile(&soak.scrapes, 0.99), qsketch_quantile(&soak.scrapes, 1), max_scrape_ms,
+               soak.scrape_ok, scrape_total, soak.last_body);
+        printf("RSS: %ld kB tras el calentamiento, %ld kB al final (%+ld kB, umbral %ld), pico %ld kB\n", rss_base,
+               rss, rss_growth, max_rss_growth_kb, rss_peak);
+        printf("descriptores: %d tras el calentamiento, %d al final (%+d, umbral %d)\n", fds_base, fds, fd_growth,
+               max_fd_growth);
+
+        if (died)
+        {
+            fprintf(stderr, "El agente terminó durante la prueba (ver %s/agent.out)\n", dir);
+        }
+        if (soak.ticks < expected_ticks / 2)
+        {
+            fprintf(stderr, "Llegaron menos de la mitad de los ticks esperados\n");
+            failures++;
+        }
+        if (qsketch_quantile(&soak.jitter, 0.99) > max_jitter_ms)
+        {
+            fprintf(stderr, "El p99 del desvío del tick supera el umbral\n");
+            failures++;
+        }
+        if (soak.scrape_ok == 0 || qsketch_quantile(&soak.scrapes, 0.99) > max_scrape_ms ||
+            soak.scrape_failed * 100 > scrape_total)
+        {
+            fprintf(stderr, "Los scrapes de /metrics fallan o superan el umbral de latencia\n");
+            failures++;
+        }
+        if (rss_growth > max_rss_growth_kb)
+        {
+            fprintf(stderr, "El RSS crece más que el umbral: posible pérdida de memoria\n");
+            failures++;
+        }
+        if (fd_growth > max_fd_growth)
+        {
+            fprintf(stderr, "Los descriptores abiertos crecen: posible pérdida de descriptores\n");
+            failures++;
+        }
+    }
+
+    if (failures == 0)
+    {
+        remove_tree(dir);
+        return EXIT_SUCCESS;
+    }
+    fprintf(stderr, "Prueba de resistencia fallida; se conserva %s\n", dir);
+    return EXIT_FAILURE;
+}
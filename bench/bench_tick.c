@@ -0,0 +1,592 @@
+/**
+ * @file bench_tick.c
+ * @brief Verifica que la parte del tick que no toca Prometheus no llame a malloc en régimen estable.
+ *
+ * Arma un /proc y un /sys sintéticos con los fixtures de host grande (más CPUS CPUs con cpufreq,
+ * una zona térmica y un nodo NUMA) y en cada tick hace el trabajo de collectors_collect() y de
+ * send_metrics() con todos los colectores activos, salvo el guardado en prometheus-client-c:
+ *  - las lecturas de todos los colectores dentro del lote del tick, con la lectura de /proc/stat
+ *    compartida por cpufreq y NUMA;
+ *  - rate_update() de cada contador (cambios de contexto, red, disco, vmstat, PSI, throttling,
+ *    numastat y protocolos de red);
+ *  - cardinality_store() de las familias por CPU, por campo y por nodo, con un tope de series, y
+ *    cardinality_flush() al cerrar el tick;
+ *  - la codificación del JSON del FIFO sobre el arena y tick_arena_reset().
+ *
+ * No cubre el guardado en prometheus-client-c (prom_gauge_set() y prom_counter_add() arman la
+ * clave de cada serie en un string nuevo en cada llamada), la escritura en el FIFO ni el scrape.
+ * Entre ticks se reescribe /proc/stat para que los contadores avancen; esa escritura no se mide
+ * ni se cuenta. Tras unos ticks de calentamiento (en los que el arena, los buffers de lectura y
+ * las tablas alcanzan su tamaño) cuenta las asignaciones de los ticks siguientes y falla si hay
+ * alguna.
+ *
+ * Uso: bench_tick [-d dir_fixtures] [-n ticks] [-b off|pread|io_uring]
+ */
+
+#include "alloc_count.h"
+#include "arena.h"
+#include "buddyinfo.h"
+#include "cardinality.h"
+#include "interrupts.h"
+#include "metrics_json.h"
+#include "procfs.h"
+#include "rate.h"
+#include <cjson/cJSON.h>
+#include <dirent.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define WARMUP_TICKS 5
+
+/**
+ * @brief CPUs del árbol sintético.
+ */
+#define CPUS 64
+
+/**
+ * @brief Jiffies por CPU y por tick en /proc/stat; la mitad son ocupados.
+ */
+#define TICK_JIFFIES 100
+
+/**
+ * @brief Tope de series por familia de las reglas de cardinalidad.
+ */
+#define SERIES_CAP 32
+
+/**
+ * @brief Celdas top-K de interrupciones, como irq_top_k por defecto.
+ */
+#define IRQ_TOP_K 10
+
+/**
+ * @brief Fixture copiado al /proc sintético.
+ */
+typedef struct
+{
+    const char* fixture; /**< Archivo en el directorio de fixtures. */
+    const char* rel;     /**< Ruta dentro de proc/. */
+} fixture_map_t;
+
+static const fixture_map_t fixture_files[] = {
+    {"proc_meminfo", "meminfo"},
+    {"proc_vmstat", "vmstat"},
+    {"proc_buddyinfo_16node", "buddyinfo"},
+    {"proc_pagetypeinfo_16node", "pagetypeinfo"},
+    {"proc_diskstats_1k", "diskstats"},
+    {"proc_net_dev_5k", "net/dev"},
+    {"proc_net_snmp", "net/snmp"},
+    {"proc_net_netstat", "net/netstat"},
+    {"proc_interrupts_256cpu", "interrupts"},
+    {"proc_softirqs_256cpu", "softirqs"},
+    {"proc_pressure_memory", "pressure/memory"},
+    {"proc_pressure_memory", "pressure/cpu"},
+    {"proc_pressure_memory", "pressure/io"},
+};
+
+/**
+ * @brief Lecturas anteriores y series de un colector de interrupciones.
+ */
+typedef struct
+{
+    irq_table_t tables[2];
+    int current;
+    bool have_prev;
+} irq_history_t;
+
+/**
+ * @brief Estado que los colectores conservan entre ticks.
+ */
+static struct
+{
+    cpu_stat_t cpu_stat;
+    cpufreq_topology_t cpufreq;
+    numa_topology_t numa;
+    irq_history_t irq;
+    irq_history_t softirq;
+    rate_engine_t rates;
+    int ctxt_series;     // Una serie
+    int net_series;      // rx y tx
+    int disk_series;     // Lecturas y escrituras
+    int vmstat_series;   // VMSTAT_MAX_FIELDS series
+    int psi_series;      // some y full por recurso
+    int throttle_series; // Dos por CPU
+    int numastat_series; // NUMA_STAT_FIELDS por nodo
+    int netproto_series; // NETPROTO_COUNTERS series
+} tick;
+
+// Familias de cardinalidad; solo importa su dirección
+static int cpu_frequency_family, irq_rate_family, vmstat_family, numa_memory_family;
+
+static char cpu_labels[CPUS][12];
+static size_t stores;
+
+static void count_store(void* metric, double value, const char** labels)
+{
+    (void)metric;
+    (void)value;
+    (void)labels;
+    stores++;
+}
+
+static int remove_tree(const char* path)
+{
+    DIR* dir = opendir(path);
+    if (dir == NULL)
+    {
+        return remove(path);
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+        {
+            char child[PROCFS_PATH_MAX];
+            snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+            remove_tree(child);
+        }
+    }
+    closedir(dir);
+    return rmdir(path);
+}
+
+/**
+ * @brief Escribe un archivo del árbol sintético, creando los directorios intermedios.
+ */
+static int write_file(const char* root, const char* rel, const char* content, size_t len)
+{
+    char path[PROCFS_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", root, rel);
+    for (char* slash = strchr(path + strlen(root) + 1, '/'); slash != NULL; slash = strchr(slash + 1, '/'))
+    {
+        *slash = '\0';
+        mkdir(path, 0755);
+        *slash = '/';
+    }
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    fwrite(content, 1, len, file);
+    return fclose(file);
+}
+
+static int write_text(const char* root, const char* rel, const char* content)
+{
+    return write_file(root, rel, content, strlen(content));
+}
+
+static int write_value(const char* root, const char* format, int number, long long value)
+{
+    char rel[128], content[32];
+    snprintf(rel, sizeof(rel), format, number);
+    snprintf(content, sizeof(content), "%lld\n", value);
+    return write_text(root, rel, content);
+}
+
+static int copy_fixture(const char* dir, const char* proc, const fixture_map_t* map)
+{
+    char path[PROCFS_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", dir, map->fixture);
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    long len = ftell(file);
+    rewind(file);
+    char* data = malloc(len > 0 ? (size_t)len : 1);
+    size_t got = data != NULL ? fread(data, 1, (size_t)len, file) : 0;
+    fclose(file);
+    int rc = data != NULL && got == (size_t)len ? write_file(proc, map->rel, data, got) : -1;
+    free(data);
+    return rc;
+}
+
+/**
+ * @brief Reescribe /proc/stat con el avance del tick: mitad ocupado (user) y mitad idle.
+ */
+static int write_stat(const char* proc, int number, char* scratch, size_t len)
+{
+    long long half = (long long)number * TICK_JIFFIES / 2;
+    size_t used = (size_t)snprintf(scratch, len, "cpu  %lld 0 0 %lld 0 0 0 0 0 0\n", half * CPUS, half * CPUS);
+    for (int c = 0; c < CPUS && used < len; c++)
+    {
+        used += (size_t)snprintf(scratch + used, len - used, "cpu%d %lld 0 0 %lld 0 0 0 0 0 0\n", c, half, half);
+    }
+    if (used < len)
+    {
+        used += (size_t)snprintf(scratch + used, len - used, "intr 0\nctxt %lld\nprocs_running %d\n",
+                                 (long long)number * 1000, number % 8 + 1);
+    }
+    return used < len ? write_file(proc, "stat", scratch, used) : -1;
+}
+
+/**
+ * @brief Arma el árbol sintético: fixtures en proc/ y CPUs, zona térmica y nodo NUMA en sys/.
+ */
+static int build_tree(const char* dir, const char* proc, const char* sys)
+{
+    int rc = 0;
+    for (size_t i = 0; i < sizeof(fixture_files) / sizeof(fixture_files[0]) && rc == 0; i++)
+    {
+        rc = copy_fixture(dir, proc, &fixture_files[i]);
+    }
+    rc |= write_text(proc, "net/sockstat",
+                     "sockets: used 812\nTCP: inuse 41 orphan 0 tw 17 alloc 58 mem 9\nUDP: inuse 6 mem 2\n");
+
+    char range[32];
+    snprintf(range, sizeof(range), "0-%d\n", CPUS - 1);
+    rc |= write_text(sys, "devices/system/cpu/possible", range);
+    rc |= write_text(sys, "devices/system/node/online", "0\n");
+    rc |= write_text(sys, "devices/system/node/node0/cpulist", range);
+    rc |= write_text(sys, "devices/system/node/node0/meminfo",
+                     "Node 0 MemTotal:       65536000 kB\nNode 0 MemFree:        32768000 kB\n"
+                     "Node 0 MemUsed:        32768000 kB\nNode 0 FilePages:      8192000 kB\n");
+    rc |= write_text(sys, "devices/system/node/node0/numastat",
+                     "numa_hit 1000\nnuma_miss 10\nnuma_foreign 10\ninterleave_hit 5\nlocal_node 990\n"
+                     "other_node 10\n");
+    for (int c = 0; c < CPUS && rc == 0; c++)
+    {
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", c, 3000000);
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq", c, c % 2 == 0 ? 1500000 : 3000000);
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/topology/physical_package_id", c, 0);
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/thermal_throttle/core_throttle_count", c, 0);
+        rc |= write_value(sys, "devices/system/cpu/cpu%d/thermal_throttle/package_throttle_count", c, 0);
+    }
+    rc |= write_value(sys, "class/thermal/thermal_zone%d/temp", 0, 45000);
+    rc |= write_text(sys, "class/thermal/thermal_zone0/type", "x86_pkg_temp\n");
+    return rc;
+}
+
+/**
+ * @brief Descubre las topologías, reserva las series y registra las familias, como al activar los colectores.
+ */
+static int prepare_collectors(void)
+{
+    if (cpufreq_discover(&tick.cpufreq) != 0 || numa_topology_discover(&tick.numa) != 0)
+    {
+        return -1;
+    }
+    tick.ctxt_series = rate_series_reserve(&tick.rates, 1, RATE_WIDTH_LONG);
+    tick.net_series = rate_series_reserve(&tick.rates, 2, 64);
+    tick.disk_series = rate_series_reserve(&tick.rates, 2, RATE_WIDTH_LONG);
+    tick.vmstat_series = rate_series_reserve(&tick.rates, VMSTAT_MAX_FIELDS, RATE_WIDTH_LONG);
+    tick.psi_series = rate_series_reserve(&tick.rates, PSI_RESOURCE_COUNT * 2, 64);
+    tick.throttle_series = rate_series_reserve(&tick.rates, tick.cpufreq.cpu_count * 2, RATE_WIDTH_LONG);
+    tick.numastat_series = rate_series_reserve(&tick.rates, NUMA_MAX_NODES * NUMA_STAT_FIELDS, RATE_WIDTH_LONG);
+    tick.netproto_series = rate_series_reserve(&tick.rates, NETPROTO_COUNTERS, 64);
+    if (tick.netproto_series < 0)
+    {
+        return -1;
+    }
+
+    for (int c = 0; c < CPUS; c++)
+    {
+        snprintf(cpu_labels[c], sizeof(cpu_labels[c]), "%d", c);
+    }
+    if (cardinality_track(&cpu_frequency_family, "cpu_frequency_hz", 1, (const char*[]){"cpu"}, false,
+                          count_store) != 0 ||
+        cardinality_track(&irq_rate_family, "irq_rate", 2, (const char*[]){"irq", "cpu"}, false, count_store) != 0 ||
+        cardinality_track(&vmstat_family, "vmstat_total", 1, (const char*[]){"field"}, true, count_store) != 0 ||
+        cardinality_track(&numa_memory_family, "numa_memory_bytes", 2, (const char*[]){"node", "field"}, false,
+                          count_store) != 0)
+    {
+        return -1;
+    }
+    cardinality_rules_t* rules = cardinality_rules_new();
+    if (rules == NULL)
+    {
+        return -1;
+    }
+    rules->max_series = SERIES_CAP;
+    cardinality_install(rules);
+    return 0;
+}
+
+/**
+ * @brief Lee una tabla de interrupciones y guarda el top-K contra la lectura anterior.
+ * @return Celdas en top, o -1 sin tasas.
+ */
+static int irq_rates(const char* rel, irq_history_t* history, irq_cell_rate_t* top, double* total)
+{
+    char path[PROCFS_PATH_MAX];
+    int next = history->have_prev ? 1 - history->current : history->current;
+    if (read_irq_table(procfs_path(rel, path, sizeof(path)), &history->tables[next]) != 0)
+    {
+        return -1;
+    }
+    int count = -1;
+    const irq_table_t* cur = &history->tables[next];
+    double* cpu_rates = tick_alloc((size_t)cur->cpu_count * sizeof(double));
+    if (history->have_prev && cpu_rates != NULL)
+    {
+        count = irq_top_rates(&history->tables[history->current], cur, 1.0, top, IRQ_TOP_K, cpu_rates);
+        for (int c = 0; c < cur->cpu_count; c++)
+        {
+            *total += cpu_rates[c];
+        }
+    }
+    history->current = next;
+    history->have_prev = true;
+    return count;
+}
+
+/**
+ * @brief Trabajo de un tick sin Prometheus.
+ * @return Longitud del JSON generado, o 0 si algo falló.
+ */
+static size_t run_tick(const config_t* config, metrics_sample_t* sample)
+{
+    char path[PROCFS_PATH_MAX];
+    int64_t now_ms = rate_now_ms();
+    double delta;
+
+    procfs_batch_begin();
+
+    buddyinfo_t* info = tick_alloc(sizeof(*info));
+    if (info == NULL || read_buddyinfo(procfs_path("buddyinfo", path, sizeof(path)), info) != 0)
+    {
+        return 0;
+    }
+    read_pagetypeinfo(procfs_path("pagetypeinfo", path, sizeof(path)), info);
+    sample->memory_fragmentation = buddy_unusable_index(&info->zones[0], info->pageblock_order) * 100.0;
+
+    sample->cpu_usage = get_cpu_usage();
+
+    const cpu_stat_t* cpu_stat = cpu_stat_read(&tick.cpu_stat) == 0 ? &tick.cpu_stat : NULL;
+    cpufreq_read(&tick.cpufreq, cpu_stat, &sample->cpufreq);
+    for (int i = 0; i < tick.cpufreq.cpu_count; i++)
+    {
+        const cpufreq_cpu_t* cpu = &tick.cpufreq.cpus[i];
+        if (cpu->cur_hz > 0)
+        {
+            cardinality_store(&cpu_frequency_family, cpu->cur_hz, cpu->cur_hz, (const char*[]){cpu_labels[i]});
+        }
+        rate_update(&tick.rates, tick.throttle_series + i * 2, cpu->core_throttles, now_ms, &delta);
+        rate_update(&tick.rates, tick.throttle_series + i * 2 + 1, cpu->package_throttles, now_ms, &delta);
+    }
+
+    sample->memory = get_memory_usage();
+
+    sample->disk = get_disk_stats("/dev/nvme0n1");
+    rate_update(&tick.rates, tick.disk_series, sample->disk.reads_completed, now_ms, &delta);
+    rate_update(&tick.rates, tick.disk_series + 1, sample->disk.writes_completed, now_ms, &delta);
+
+    sample->net = get_net_stats("eth0");
+    rate_update(&tick.rates, tick.net_series, (uint64_t)sample->net.rx_bytes, now_ms, &delta);
+    rate_update(&tick.rates, tick.net_series + 1, (uint64_t)sample->net.tx_bytes, now_ms, &delta);
+
+    sample->context_switches = get_context_switches();
+    rate_update(&tick.rates, tick.ctxt_series, (uint64_t)sample->context_switches, now_ms, &delta);
+    sample->running_processes = get_running_processes();
+
+    vmstat_t vmstat;
+    if (read_meminfo(procfs_path("meminfo", path, sizeof(path)), &sample->meminfo) != 0 ||
+        read_vmstat(procfs_path("vmstat", path, sizeof(path)), &vmstat) != 0)
+    {
+        return 0;
+    }
+    for (int i = 0; i < vmstat_field_count(); i++)
+    {
+        sample->vmstat_rates[i] = -1.0;
+        if (vmstat.present[i])
+        {
+            sample->vmstat_rates[i] =
+                rate_update(&tick.rates, tick.vmstat_series + i, vmstat.values[i], now_ms, &delta);
+            cardinality_store(&vmstat_family, delta, (double)vmstat.values[i], (const char*[]){vmstat_field_name(i)});
+        }
+    }
+
+    for (int r = 0; r < PSI_RESOURCE_COUNT; r++)
+    {
+        char rel[32];
+        snprintf(rel, sizeof(rel), "pressure/%s", psi_resource_name((psi_resource_t)r));
+        if (read_psi(procfs_path(rel, path, sizeof(path)), &sample->psi[r]) == 0)
+        {
+            rate_update(&tick.rates, tick.psi_series + r * 2, sample->psi[r].some.total_us, now_ms, &delta);
+            rate_update(&tick.rates, tick.psi_series + r * 2 + 1, sample->psi[r].full.total_us, now_ms, &delta);
+        }
+    }
+
+    irq_cell_rate_t top[IRQ_TOP_K];
+    sample->irq_rate = 0;
+    int count = irq_rates("interrupts", &tick.irq, top, &sample->irq_rate);
+    const irq_table_t* table = &tick.irq.tables[tick.irq.current];
+    for (int i = 0; i < count; i++)
+    {
+        const char* labels[] = {table->rows[top[i].row].name, cpu_labels[table->cpus[top[i].column] % CPUS]};
+        cardinality_store(&irq_rate_family, top[i].rate, top[i].rate, labels);
+    }
+    sample->softirq_rate = 0;
+    irq_rates("softirqs", &tick.softirq, top, &sample->softirq_rate);
+
+    sample->numa_node_count = numa_read(&tick.numa, cpu_stat, sample->numa);
+    for (int n = 0; n < sample->numa_node_count; n++)
+    {
+        const numa_node_stats_t* stats = &sample->numa[n];
+        for (int f = 0; f < NUMA_MEM_FIELDS && stats->have_memory; f++)
+        {
+            cardinality_store(&numa_memory_family, (double)stats->mem[f], (double)stats->mem[f],
+                              (const char*[]){cpu_labels[stats->node % CPUS], numa_mem_field_name(f)});
+        }
+        for (int f = 0; f < NUMA_STAT_FIELDS && stats->have_memory; f++)
+        {
+            rate_update(&tick.rates, tick.numastat_series + n * NUMA_STAT_FIELDS + f, stats->stat[f], now_ms,
+                        &delta);
+        }
+    }
+
+    if (netproto_read(-1, &sample->netproto) == 0)
+    {
+        for (int i = 0; i < NETPROTO_COUNTERS; i++)
+        {
+            if (sample->netproto.present[i])
+            {
+                rate_update(&tick.rates, tick.netproto_series + i, sample->netproto.counters[i], now_ms, &delta);
+            }
+        }
+    }
+
+    procfs_batch_end();
+    cardinality_flush(NULL);
+
+    size_t length = 0;
+    char* json = metrics_json_encode(config, sample, &length);
+    tick_arena_reset();
+    return json != NULL ? length : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* dir = "bench/fixtures";
+    long ticks = 1000;
+    procfs_batch_backend_t backend = PROCFS_BATCH_OFF;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:n:b:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd':
+            dir = optarg;
+            break;
+        case 'n':
+            ticks = atol(optarg);
+            break;
+        case 'b':
+            backend = strcmp(optarg, "pread") == 0      ? PROCFS_BATCH_PREAD
+                      : strcmp(optarg, "io_uring") == 0 ? PROCFS_BATCH_IO_URING
+                                                        : PROCFS_BATCH_OFF;
+            break;
+        default:
+            fprintf(stderr, "Uso: %s [-d dir_fixtures] [-n ticks] [-b off|pread|io_uring]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    char root[] = "/tmp/bench_tick_XXXXXX";
+    if (mkdtemp(root) == NULL)
+    {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    char proc[PROCFS_PATH_MAX], sys[PROCFS_PATH_MAX];
+    snprintf(proc, sizeof(proc), "%s/proc", root);
+    snprintf(sys, sizeof(sys), "%s/sys", root);
+    mkdir(proc, 0755);
+    mkdir(sys, 0755);
+
+    size_t stat_len = (size_t)CPUS * 64 + 256;
+    char* scratch = malloc(stat_len);
+    int rc = scratch != NULL && build_tree(dir, proc, sys) == 0 && write_stat(proc, 1, scratch, stat_len) == 0 ? 0 : -1;
+    procfs_set_root(proc, sys);
+    if (rc != 0 || tick_arena_init(0) != 0 || prepare_collectors() != 0)
+    {
+        fprintf(stderr, "No se pudo armar el árbol sintético sobre los fixtures de %s\n", dir);
+        remove_tree(root);
+        return EXIT_FAILURE;
+    }
+    procfs_batch_backend_t active = procfs_batch_init(backend);
+
+    // Todos los colectores activos: el JSON más grande posible
+    config_t config;
+    memset(&config, 0, sizeof(config));
+    config.collect_cpu = true;
+    config.collect_memory = true;
+    config.collect_disk = true;
+    config.collect_net = true;
+    config.collect_context_switches = true;
+    config.collect_running_processes = true;
+    config.collect_memory_fragmentation = true;
+    config.collect_meminfo = true;
+    config.collect_interrupts = true;
+    config.collect_netproto = true;
+    config.collect_numa = true;
+    config.collect_cpufreq = true;
+    config.collect_psi = true;
+
+    metrics_sample_t sample;
+    memset(&sample, 0, sizeof(sample));
+
+    size_t length = 0;
+    long number = 2;
+    for (int i = 0; i < WARMUP_TICKS; i++, number++)
+    {
+        write_stat(proc, (int)number, scratch, stat_len);
+        length = run_tick(&config, &sample);
+        if (length == 0)
+        {
+            fprintf(stderr, "El tick falló sobre el árbol sintético\n");
+            remove_tree(root);
+            return EXIT_FAILURE;
+        }
+    }
+    size_t system_allocs = tick_arena()->system_allocs;
+
+    // Solo se miden y cuentan los ticks, no la reescritura de /proc/stat entre ellos
+    double elapsed_us = 0;
+    size_t allocs = 0;
+    int failed = 0;
+    for (long i = 0; i < ticks; i++, number++)
+    {
+        write_stat(proc, (int)number, scratch, stat_len);
+
+        struct timespec start, end;
+        size_t allocs_before = alloc_count_get();
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        failed += run_tick(&config, &sample) == 0;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        allocs += alloc_count_get() - allocs_before;
+        elapsed_us += (double)(end.tv_sec - start.tv_sec) * 1e6 + (double)(end.tv_nsec - start.tv_nsec) / 1e3;
+    }
+    free(scratch);
+    remove_tree(root);
+
+    printf("lector: %s  CPUs: %d  uso %.1f%%, normalizado %.1f%%, nodo 0 %.1f%%\n", procfs_batch_name(active),
+           tick.cpufreq.cpu_count, sample.cpu_usage, sample.cpufreq.normalized_usage, sample.numa[0].cpu_usage);
+    printf("ticks: %ld  us/tick: %.1f  JSON: %zu bytes  arena: pico %zu bytes, %zu bloques del sistema\n", ticks,
+           elapsed_us / (double)ticks, length, tick_arena()->high_water, tick_arena()->system_allocs);
+    printf("guardados en cardinalidad: %zu  asignaciones en régimen estable: %zu (%.3f por tick)\n", stores, allocs,
+           (double)allocs / (double)ticks);
+
+    if (failed > 0)
+    {
+        fprintf(stderr, "FALLO: %d ticks no pudieron leer el árbol sintético\n", failed);
+        return EXIT_FAILURE;
+    }
+    if (allocs > 0 || tick_arena()->system_allocs != system_allocs)
+    {
+        fprintf(stderr, "FALLO: un tick en régimen estable no debe llamar a malloc\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""Genera los fixtures de /proc con forma de host grande usados por bench_parsers.
+
+Los archivos generados se versionan; este script solo existe para poder
+regenerarlos de forma determinista (semilla fija) si cambia su forma.
+proc_vmstat, proc_net_snmp y proc_net_netstat no se generan: son capturas de un kernel 6.x.
+"""
+
+import os
+import random
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+rng = random.Random(26)
+
+
+def write(name, text):
+    with open(os.path.join(HERE, name), "w") as f:
+        f.write(text)
+
+
+def proc_stat(ncpu=512, nirq=4096):
+    lines = []
+    per_cpu = []
+    for _ in range(ncpu):
+        per_cpu.append([rng.randint(10**6, 10**8), rng.randint(0, 10**5), rng.randint(10**5, 10**7),
+                        rng.randint(10**8, 10**9), rng.randint(0, 10**6), 0, rng.randint(0, 10**6), 0, 0, 0])
+    total = [sum(c[i] for c in per_cpu) for i in range(10)]
+    lines.append("cpu  " + " ".join(map(str, total)))
+    for i, c in enumerate(per_cpu):
+        lines.append("cpu%d " % i + " ".join(map(str, c)))
+    irqs = [rng.randint(0, 10**9) if rng.random() < 0.2 else 0 for _ in range(nirq)]
+    lines.append("intr %d " % sum(irqs) + " ".join(map(str, irqs)))
+    lines.append("ctxt 98765432109")
+    lines.append("btime 1700000000")
+    lines.append("processes 123456789")
+    lines.append("procs_running 37")
+    lines.append("procs_blocked 2")
+    soft = [rng.randint(0, 10**9) for _ in range(10)]
+    lines.append("softirq %d " % sum(soft) + " ".join(map(str, soft)))
+    write("proc_stat_512cpu", "\n".join(lines) + "\n")
+
+
+def proc_net_dev(nif=5000):
+    lines = ["Inter-|   Receive                                                |  Transmit",
+             " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs drop fifo colls carrier compressed"]
+    names = ["lo", "eth0"] + ["veth%08x" % rng.getrandbits(32) for _ in range(nif - 3)] + ["wlp1s0"]
+    for name in names:
+        vals = [rng.randint(0, 10**12), rng.randint(0, 10**9), 0, rng.randint(0, 1000), 0, 0, 0, rng.randint(0, 10**6),
+                rng.randint(0, 10**12), rng.randint(0, 10**9), 0, 0, 0, 0, 0, 0]
+        lines.append("%6s: %s" % (name, " ".join("%7d" % v for v in vals)))
+    write("proc_net_dev_5k", "\n".join(lines) + "\n")
+
+
+def proc_diskstats(ndev=1000):
+    lines = []
+    devs = []
+    for i in range(ndev // 10):
+        devs.append((259, i * 10, "nvme%dn1" % i))
+        for p in range(1, 10):
+            devs.append((259, i * 10 + p, "nvme%dn1p%d" % (i, p)))
+    devs = devs[: ndev - 1] + [(259, 1000, "nvme100n1")]
+    for major, minor, name in devs:
+        vals = [rng.randint(0, 10**9) for _ in range(17)]
+        lines.append("%4d %7d %s %s" % (major, minor, name, " ".join(map(str, vals))))
+    write("proc_diskstats_1k", "\n".join(lines) + "\n")
+
+
+def proc_meminfo():
+    keys = ["MemTotal", "MemFree", "MemAvailable", "Buffers", "Cached", "SwapCached", "Active", "Inactive",
+            "Active(anon)", "Inactive(anon)", "Active(file)", "Inactive(file)", "Unevictable", "Mlocked",
+            "SwapTotal", "SwapFree", "Zswap", "Zswapped", "Dirty", "Writeback", "AnonPages", "Mapped", "Shmem",
+            "KReclaimable", "Slab", "SReclaimable", "SUnreclaim", "KernelStack", "PageTables", "SecPageTables",
+            "NFS_Unstable", "Bounce", "WritebackTmp", "CommitLimit", "Committed_AS", "VmallocTotal", "VmallocUsed",
+            "VmallocChunk", "Percpu", "HardwareCorrupted", "AnonHugePages", "ShmemHugePages", "ShmemPmdMapped",
+            "FileHugePages", "FilePmdMapped", "Unaccepted", "HugePages_Total", "HugePages_Free", "HugePages_Rsvd",
+            "HugePages_Surp", "Hugepagesize", "Hugetlb", "DirectMap4k", "DirectMap2M", "DirectMap1G"]
+    lines = []
+    for k in keys:
+        v = 4194304000 if k == "MemTotal" else rng.randint(0, 2 * 10**9)
+        if k.startswith("HugePages_"):
+            lines.append("%-16s%8d" % (k + ":", rng.randint(0, 4096)))
+        else:
+            lines.append("%-16s%8d kB" % (k + ":", v))
+    write("proc_meminfo", "\n".join(lines) + "\n")
+
+
+def proc_buddyinfo(nnodes=16):
+    """Genera proc_buddyinfo_16node y proc_pagetypeinfo_16node, consistentes entre sí."""
+    types = ["Unmovable", "Movable", "Reclaimable", "HighAtomic", "CMA", "Isolate"]
+    zones = [(0, "DMA"), (0, "DMA32")] + [(n, "Normal") for n in range(nnodes)] + [(n, "Movable") for n in range(nnodes)]
+    buddy = []
+    free_lines = []
+    block_lines = []
+    for node, zone in zones:
+        per_type = []
+        for t in types:
+            if t in ("HighAtomic", "Isolate") or (t == "CMA" and zone != "Normal"):
+                per_type.append([0] * 11)
+            else:
+                per_type.append([rng.randint(0, 100000 >> order) for order in range(11)])
+        totals = [sum(c[o] for c in per_type) for o in range(11)]
+        buddy.append("Node %d, zone %8s %s " % (node, zone, " ".join("%6d" % v for v in totals)))
+        for t, counts in zip(types, per_type):
+            free_lines.append("Node %4d, zone %8s, type %12s %s " % (node, zone, t, " ".join("%6d" % v for v in counts)))
+        blocks = [rng.randint(0, 60000) for _ in types]
+        block_lines.append("Node %d, zone %8s %s " % (node, zone, " ".join("%12d" % v for v in blocks)))
+    write("proc_buddyinfo_16node", "\n".join(buddy) + "\n")
+    lines = ["Page block order: 9", "Pages per block:  512", "",
+             "Free pages count per migrate type at order " + " ".join("%6d" % o for o in range(11)) + " "]
+    lines += free_lines
+    lines += ["", "Number of blocks type    " + " ".join("%12s" % t for t in types) + " "]
+    lines += block_lines
+    write("proc_pagetypeinfo_16node", "\n".join(lines) + "\n")
+
+
+def proc_pressure():
+    """Genera proc_pressure_memory con el formato de /proc/pressure/<recurso>."""
+    lines = []
+    for kind in ("some", "full"):
+        avgs = " ".join("%s=%.2f" % (w, rng.uniform(0, 100)) for w in ("avg10", "avg60", "avg300"))
+        lines.append("%s %s total=%d" % (kind, avgs, rng.randint(0, 10**13)))
+    write("proc_pressure_memory", "\n".join(lines) + "\n")
+
+
+def proc_interrupts(ncpu=256, ndev=48):
+    """Genera proc_interrupts_256cpu y proc_softirqs_256cpu con el formato del kernel."""
+    def counts(scale):
+        return [rng.randint(0, scale) if rng.random() < 0.3 else 0 for _ in range(ncpu)]
+
+    lines = [" " * 11 + "".join("CPU%-8d" % c for c in range(ncpu))]
+    for i in range(ndev):
+        irq = 24 + i
+        device = "eth0-TxRx-%d" % i if i < 32 else "nvme0q%d" % (i - 32)
+        lines.append("%4d: %s IR-PCI-MSI %d-edge      %s" %
+                     (irq, "".join("%10u " % v for v in counts(10**9)), 524288 + i, device))
+    for name, desc in [("NMI", "Non-maskable interrupts"), ("LOC", "Local timer interrupts"),
+                       ("SPU", "Spurious interrupts"), ("PMI", "Performance monitoring interrupts"),
+                       ("IWI", "IRQ work interrupts"), ("RTR", "APIC ICR read retries"),
+                       ("RES", "Rescheduling interrupts"), ("CAL", "Function call interrupts"),
+                       ("TLB", "TLB shootdowns"), ("TRM", "Thermal event interrupts"),
+                       ("THR", "Threshold APIC interrupts"), ("DFR", "Deferred Error APIC interrupts"),
+                       ("MCE", "Machine check exceptions"), ("MCP", "Machine check polls")]:
+        lines.append("%4s: %s  %s" % (name, "".join("%10u " % v for v in counts(10**10)), desc))
+    lines.append("%4s: %10u" % ("ERR", 0))
+    lines.append("%4s: %10u" % ("MIS", 0))
+    write("proc_interrupts_256cpu", "\n".join(lines) + "\n")
+
+    names = ["HI", "TIMER", "NET_TX", "NET_RX", "BLOCK", "IRQ_POLL", "TASKLET", "SCHED", "HRTIMER", "RCU"]
+    lines = [" " * 20 + "".join("CPU%-8d" % c for c in range(ncpu))]
+    for name in names:
+        lines.append("%12s:%s" % (name, "".join(" %10u" % v for v in counts(10**9))))
+    write("proc_softirqs_256cpu", "\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    proc_stat()
+    proc_net_dev()
+    proc_diskstats()
+    proc_meminfo()
+    proc_buddyinfo()
+    proc_pressure()
+    proc_interrupts()
@@ -0,0 +1,280 @@
+/**
+ * @file legacy_parsers.c
+ * @brief Copia de referencia de los parsers de src/metrics.c basados en sscanf/strtok_r.
+ *
+ * bench_parsers verifica que los parsers actuales producen exactamente lo mismo que estos
+ * sobre cada fixture, y los mide para comparar.
+ */
+
+#include "legacy_parsers.h"
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+net_stats_t legacy_read_net_stats(const char* path, const char* iface)
+{
+    FILE* fp;
+    char buffer[BUFFER_SIZE];
+    net_stats_t stats = {0};
+    stats.rx_bytes = -1;
+    stats.tx_bytes = -1;
+
+    // Abrir el archivo de red (normalmente /proc/net/dev)
+    fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "Error al abrir %s: %s\n", path, strerror(errno));
+        return stats; // Error
+    }
+
+    // Saltar las dos primeras líneas (encabezado)
+    fgets(buffer, sizeof(buffer), fp);
+    fgets(buffer, sizeof(buffer), fp);
+
+    // Leer cada línea del archivo
+    while (fgets(buffer, sizeof(buffer), fp) != NULL)
+    {
+        char* ptr = buffer;
+        char* token;
+        char* saveptr;
+
+        // Obtener el nombre de la interfaz
+        token = strtok_r(ptr, " \t\n", &saveptr);
+        if (token == NULL)
+            continue;
+
+        // Quitar ':' del nombre de la interfaz
+        char* colon = strchr(token, ':');
+        if (colon)
+            *colon = '\0';
+
+        // Quitar espacios en blanco iniciales
+        while (isspace(*token))
+            token++;
+
+        if (strcmp(token, iface) == 0)
+        {
+            unsigned long long values[16];
+            int i = 0;
+            while (i < 16 && (token = strtok_r(NULL, " \t\n", &saveptr)) != NULL)
+            {
+                values[i++] = strtoull(token, NULL, 10);
+            }
+            if (i >= 16)
+            {
+                stats.rx_bytes = values[0];
+                stats.tx_bytes = values[8];
+                snprintf(stats.iface, sizeof(stats.iface), "%s", iface);
+            }
+            else
+            {
+                fprintf(stderr, "Error al leer los campos para la interfaz %s\n", iface);
+            }
+            break;
+        }
+    }
+
+    fclose(fp);
+
+    if (stats.rx_bytes == -1 && stats.tx_bytes == -1)
+    {
+        fprintf(stderr, "No se encontraron datos para la interfaz %s\n", iface);
+    }
+
+    return stats;
+}
+
+disk_stats_t legacy_read_disk_stats(const char* path, const char* device)
+{
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "Error al abrir %s: %s\n", path, strerror(errno));
+        disk_stats_t error_stats = {0};
+        strncpy(error_stats.device, device, sizeof(error_stats.device) - 1);
+        error_stats.reads_completed = (unsigned long)-1;
+        error_stats.writes_completed = (unsigned long)-1;
+        return error_stats;
+    }
+
+    char buffer[BUFFER_SIZE];
+    disk_stats_t stats = {0};
+    strncpy(stats.device, device, sizeof(stats.device) - 1);
+
+    // Remover "/dev/" si está presente
+    const char* device_name = device;
+    if (strncmp(device, "/dev/", 5) == 0)
+    {
+        device_name = device + 5; // Saltar el prefijo "/dev/"
+    }
+
+    while (fgets(buffer, sizeof(buffer), fp) != NULL)
+    {
+        unsigned int major_num, minor_num;
+        char dev_name[32];
+        unsigned long reads_completed, writes_completed;
+
+        int items = sscanf(buffer, "%u %u %31s %lu %*s %*s %*s %lu", &major_num, &minor_num, dev_name, &reads_completed,
+                           &writes_completed);
+
+        if (items >= 5 && strcmp(dev_name, device_name) == 0)
+        {
+            stats.reads_completed = reads_completed;
+            stats.writes_completed = writes_completed;
+            fclose(fp);
+            return stats;
+        }
+    }
+
+    fclose(fp);
+    // Si no se encontró el dispositivo
+    fprintf(stderr, "No se encontraron datos para el dispositivo %s\n", device);
+    stats.reads_completed = (unsigned long)-1;
+    stats.writes_completed = (unsigned long)-1;
+    return stats;
+}
+
+int legacy_read_running_processes(const char* path)
+{
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "Error al abrir %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    char buffer[256];
+    int running_procs = -1;
+
+    while (fgets(buffer, sizeof(buffer), fp) != NULL)
+    {
+        if (strncmp(buffer, "procs_running", 13) == 0)
+        {
+            sscanf(buffer, "procs_running %d", &running_procs);
+            break;
+        }
+    }
+
+    fclose(fp);
+
+    if (running_procs == -1)
+    {
+        fprintf(stderr, "No se pudo encontrar 'procs_running' en %s\n", path);
+    }
+
+    return running_procs;
+}
+
+long long legacy_read_context_switches(const char* path)
+{
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "Error al abrir %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    char buffer[256];
+    long long ctxt = -1;
+
+    while (fgets(buffer, sizeof(buffer), fp) != NULL)
+    {
+        if (strncmp(buffer, "ctxt", 4) == 0)
+        {
+            if (sscanf(buffer, "ctxt %lld", &ctxt) != 1)
+            {
+                fprintf(stderr, "Error al analizar 'ctxt' en %s\n", path);
+                ctxt = -1;
+            }
+            break;
+        }
+    }
+
+    fclose(fp);
+
+    if (ctxt == -1)
+    {
+        fprintf(stderr, "No se pudo encontrar 'ctxt' en %s\n", path);
+    }
+
+    return ctxt;
+}
+
+memory_info_t legacy_read_memory_usage(const char* path)
+{
+    FILE* fp;
+    char buffer[BUFFER_SIZE];
+    unsigned long long total_mem = 0, free_mem = 0;
+
+    // Abrir el archivo de memoria (normalmente /proc/meminfo)
+    fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "Error al abrir %s: %s\n", path, strerror(errno));
+        return (memory_info_t){-1.0, -1.0, -1.0}; // Devolver error
+    }
+
+    // Leer los valores de memoria total y disponible
+    while (fgets(buffer, sizeof(buffer), fp) != NULL)
+    {
+        if (sscanf(buffer, "MemTotal: %llu kB", &total_mem) == 1)
+        {
+            continue; // MemTotal encontrado
+        }
+        if (sscanf(buffer, "MemAvailable: %llu kB", &free_mem) == 1)
+        {
+            break; // MemAvailable encontrado
+        }
+    }
+
+    fclose(fp);
+
+    // Verificar si se encontraron ambos valores
+    if (total_mem == 0 || free_mem == 0)
+    {
+        fprintf(stderr, "Error al leer la información de memoria desde %s\n", path);
+        return (memory_info_t){-1.0, -1.0, -1.0}; // Devolver error
+    }
+
+    // Calcular la memoria usada
+    double used_mem = total_mem - free_mem;
+
+    // Devolver los valores de memoria total, usada y disponible (convertidos a MB)
+    memory_info_t memory_info = {
+        .total_mem = (double)total_mem / 1024.0, // Convertir de kB a MB
+        .used_mem = (double)used_mem / 1024.0,   // Convertir de kB a MB
+        .free_mem = (double)free_mem / 1024.0    // Convertir de kB a MB
+    };
+
+    return memory_info;
+}
+
+int legacy_read_cpu_times(const char* path, cpu_times_t* times)
+{
+    char buffer[BUFFER_SIZE];
+
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "Error al abrir %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    if (fgets(buffer, sizeof(buffer), fp) == NULL)
+    {
+        fprintf(stderr, "Error al leer %s\n", path);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+
+    // Los campos que el kernel no reporte quedan en cero
+    *times = (cpu_times_t){0};
+    if (sscanf(buffer, "cpu %llu %llu %llu %llu %llu %llu %llu %llu", &times->user, &times->nice, &times->system,
+               &times->idle, &times->iowait, &times->irq, &times->softirq, &times->steal) < 4)
+    {
+        fprintf(stderr, "Error al analizar %s\n", path);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file legacy_parsers.h
+ * @brief Parsers de /proc originales (sscanf/strtok_r), usados como referencia en los benchmarks.
+ */
+
+#ifndef LEGACY_PARSERS_H
+#define LEGACY_PARSERS_H
+
+#include "metrics.h"
+
+/**
+ * @brief Versión original de read_net_stats().
+ * @param path Ruta del archivo con formato de /proc/net/dev.
+ * @param iface Nombre de la interfaz de red.
+ * @return Estadísticas de la interfaz, o {-1, -1} en caso de error.
+ */
+net_stats_t legacy_read_net_stats(const char* path, const char* iface);
+
+/**
+ * @brief Versión original de read_disk_stats().
+ * @param path Ruta del archivo con formato de /proc/diskstats.
+ * @param device Nombre del dispositivo.
+ * @return Estadísticas del dispositivo, o con reads_completed = -1 en caso de error.
+ */
+disk_stats_t legacy_read_disk_stats(const char* path, const char* device);
+
+/**
+ * @brief Versión original de read_running_processes().
+ * @param path Ruta del archivo con formato de /proc/stat.
+ * @return Procesos en ejecución, o -1 en caso de error.
+ */
+int legacy_read_running_processes(const char* path);
+
+/**
+ * @brief Versión original de read_context_switches().
+ * @param path Ruta del archivo con formato de /proc/stat.
+ * @return Cambios de contexto, o -1 en caso de error.
+ */
+long long legacy_read_context_switches(const char* path);
+
+/**
+ * @brief Versión original de read_memory_usage().
+ * @param path Ruta del archivo con formato de /proc/meminfo.
+ * @return Memoria en MB, o {-1.0, -1.0, -1.0} en caso de error.
+ */
+memory_info_t legacy_read_memory_usage(const char* path);
+
+/**
+ * @brief Versión original de read_cpu_times().
+ * @param path Ruta del archivo con formato de /proc/stat.
+ * @param times Estructura de salida.
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int legacy_read_cpu_times(const char* path, cpu_times_t* times);
+
+#endif // LEGACY_PARSERS_H
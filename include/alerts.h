@@ -0,0 +1,175 @@
+/**
+ * @file alerts.h
+ * @brief Motor de reglas de alerta evaluado en cada tick sobre la muestra recolectada.
+ *
+ * Las reglas se escriben en config.json con la forma `señal op umbral [for duración]`, por
+ * ejemplo `cpu_usage > 90 for 5s` o `rate(context_switches) > 50000`. Al cargar la
+ * configuración se compilan a un programa plano: una tabla de slots (cada señal distinta se
+ * lee de la muestra una sola vez por tick, y las tasas se derivan ahí) y un arreglo de
+ * instrucciones (slot, operador, umbral, duración) que se recorre sin saltos ni strings.
+ *
+ * Los cambios de estado (firing y resolved) se publican como eventos en el FIFO, se agregan
+ * al log y quedan visibles en el endpoint HTTP /alerts.
+ *
+ * Señales disponibles: cpu_usage, cpu_usage_freq_normalized, cpu_freq_ratio, thermal_max_celsius,
+ * cpu_core_throttles, total_memory, used_memory, free_memory, disk_reads,
+ * disk_writes, rx_bytes, tx_bytes, context_switches, running_processes, memory_fragmentation,
+ * irq_rate, softirq_rate, irq_imbalance_ratio, tcp_retransmit_ratio, tcp_listen_queue_ratio,
+ * meminfo.<Campo> (en bytes), psi.<recurso>.<some|full>.<avg10|avg60>, tcp.<estado> y
+ * net.<Proto>.<Contador>.
+ */
+
+#ifndef ALERTS_H
+#define ALERTS_H
+
+#include "config.h"
+#include "metrics.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Máximo de reglas por programa.
+ */
+#define ALERTS_MAX_RULES 512
+
+/**
+ * @brief Máximo de slots (señales o tasas distintas) por programa.
+ */
+#define ALERTS_MAX_SLOTS 128
+
+/**
+ * @brief Largo máximo del nombre de una regla.
+ */
+#define ALERT_NAME_MAX 64
+
+/**
+ * @brief Largo máximo del texto de una regla.
+ */
+#define ALERT_EXPR_MAX 128
+
+/**
+ * @brief Tipo del campo de metrics_sample_t que lee un slot.
+ */
+typedef enum
+{
+    ALERT_VALUE_DOUBLE,
+    ALERT_VALUE_INT,
+    ALERT_VALUE_LLONG,
+    ALERT_VALUE_ULONG,
+    ALERT_VALUE_U64
+} alert_value_type_t;
+
+/**
+ * @brief Operador de comparación de una regla.
+ */
+typedef enum
+{
+    ALERT_OP_GT,
+    ALERT_OP_GE,
+    ALERT_OP_LT,
+    ALERT_OP_LE,
+    ALERT_OP_EQ,
+    ALERT_OP_NE
+} alert_op_t;
+
+/**
+ * @brief Valor que se carga de la muestra en cada tick.
+ */
+typedef struct
+{
+    size_t offset;           /**< Posición del campo en metrics_sample_t. */
+    long present_offset;     /**< Posición de su bool de presencia, o -1 si siempre está. */
+    alert_value_type_t type; /**< Tipo del campo. */
+    double scale;            /**< Factor de conversión (kB a bytes). */
+    bool rate;               /**< true si el slot es la tasa por segundo del campo. */
+} alert_slot_t;
+
+/**
+ * @brief Instrucción de una regla: solo lo que se toca al evaluar.
+ */
+typedef struct
+{
+    int slot;         /**< Slot con el valor a comparar. */
+    alert_op_t op;    /**< Operador. */
+    double threshold; /**< Umbral. */
+    int64_t for_ms;   /**< Tiempo que la condición debe sostenerse antes de disparar. */
+} alert_instr_t;
+
+/**
+ * @brief Texto de una regla, para eventos y /alerts.
+ */
+typedef struct
+{
+    char name[ALERT_NAME_MAX]; /**< Nombre de la regla. */
+    char expr[ALERT_EXPR_MAX]; /**< Regla tal como se escribió. */
+} alert_rule_info_t;
+
+/**
+ * @brief Programa compilado a partir de las reglas de la configuración.
+ */
+typedef struct alert_program
+{
+    int rule_count;                           /**< Reglas válidas. */
+    alert_instr_t code[ALERTS_MAX_RULES];     /**< Instrucciones, en el orden de la configuración. */
+    alert_rule_info_t info[ALERTS_MAX_RULES]; /**< Nombre y texto de cada regla. */
+    size_t needs[ALERTS_MAX_RULES];           /**< Colector que necesita cada regla (offset en config_t). */
+    int slot_count;                           /**< Slots válidos. */
+    alert_slot_t slots[ALERTS_MAX_SLOTS];     /**< Valores distintos que leen las reglas. */
+} alert_program_t;
+
+/**
+ * @brief Crea un programa vacío.
+ * @return Programa, o NULL si no hay memoria.
+ */
+alert_program_t* alert_program_new(void);
+
+/**
+ * @brief Compila una regla y la agrega al programa.
+ *
+ * @param program Programa destino.
+ * @param name Nombre de la regla (letras, dígitos, '_', '-', '.' o ':').
+ * @param expr Regla, por ejemplo "rate(context_switches) > 50000 for 10s".
+ * @param error Buffer para el motivo del rechazo.
+ * @param error_len Tamaño de error.
+ * @return 0 si la regla se agregó, -1 si es inválida.
+ */
+int alert_program_add(alert_program_t* program, const char* name, const char* expr, char* error, size_t error_len);
+
+/**
+ * @brief Activa en la configuración los colectores que leen las reglas del programa.
+ * @param program Programa compilado.
+ * @param config Configuración a completar.
+ */
+void alert_program_enable_collectors(const alert_program_t* program, config_t* config);
+
+/**
+ * @brief Libera un programa.
+ * @param program Programa, o NULL.
+ */
+void alert_program_free(alert_program_t* program);
+
+/**
+ * @brief Instala un programa en el motor y libera el anterior.
+ *
+ * Las reglas con el mismo nombre y texto conservan su estado (pendiente o disparada).
+ *
+ * @param program Programa; el motor pasa a ser su dueño. NULL desactiva las alertas.
+ */
+void alerts_install(alert_program_t* program);
+
+/**
+ * @brief Evalúa todas las reglas contra la muestra del tick y publica los cambios de estado.
+ * @param sample Muestra recolectada en el tick.
+ * @param now_ms Instante del tick en milisegundos, del mismo reloj que las lecturas (sample_now_ms()).
+ */
+void alerts_evaluate(const metrics_sample_t* sample, int64_t now_ms);
+
+/**
+ * @brief Estado de todas las reglas como JSON, para el endpoint /alerts. Seguro desde cualquier hilo.
+ * @param length Longitud del texto devuelto.
+ * @return Texto reservado con malloc (el llamador lo libera), o NULL si no hay memoria.
+ */
+char* alerts_render_json(size_t* length);
+
+#endif // ALERTS_H
@@ -0,0 +1,55 @@
+/**
+ * @file allocator.h
+ * @brief Punto único de selección del método de asignación de memoria.
+ *
+ * FIRST_FIT, BEST_FIT y WORST_FIT delegan en la biblioteca memory (malloc_control, my_malloc);
+ * SEGREGATED_FIT usa el allocator por clases de tamaño de segregated_alloc.h.
+ */
+
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include "segregated_alloc.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Selecciona el método de asignación.
+ * @param method FIRST_FIT, BEST_FIT, WORST_FIT o SEGREGATED_FIT.
+ * @return 0 si el método es válido, -1 en caso contrario.
+ */
+int allocator_select(int method);
+
+/**
+ * @brief Método de asignación seleccionado.
+ * @return Método actual.
+ */
+int allocator_method(void);
+
+/**
+ * @brief Nombre del método tal como se escribe en config.json.
+ * @param method Método de asignación.
+ * @return Nombre ("first_fit", "segregated_fit", ...) o "desconocido".
+ */
+const char* allocator_method_name(int method);
+
+/**
+ * @brief Reserva memoria con el método seleccionado.
+ * @param size Tamaño pedido.
+ * @return Puntero al bloque, o NULL si no hay memoria.
+ */
+void* allocator_malloc(size_t size);
+
+/**
+ * @brief Libera un bloque de allocator_malloc(). Acepta NULL.
+ * @param ptr Bloque a liberar.
+ */
+void allocator_free(void* ptr);
+
+/**
+ * @brief Fragmentación del heap del método seleccionado, en porcentaje.
+ * @return Fragmentación según calculate_memory_fragmentation() o seg_fragmentation().
+ */
+double allocator_fragmentation(void);
+
+#endif // ALLOCATOR_H
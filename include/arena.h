@@ -0,0 +1,78 @@
+/**
+ * @file arena.h
+ * @brief Arena de asignación por bump-pointer para memoria que vive un solo tick.
+ *
+ * Todo lo que se reserva en el arena se descarta junto con arena_reset(): no hay free por
+ * bloque. Si un tick necesita más memoria que la disponible se encadena un bloque nuevo, y
+ * en el siguiente reset los bloques se consolidan en uno solo del tamaño del pico, de modo
+ * que en régimen estable un tick no pide memoria al sistema.
+ *
+ * El arena del tick (tick_alloc) se registra como allocator de cJSON y también lo usan los
+ * colectores para buffers temporales. Pertenece al hilo de muestreo: no es thread-safe.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+typedef struct arena_chunk arena_chunk_t;
+
+/**
+ * @brief Estado de un arena.
+ */
+typedef struct
+{
+    arena_chunk_t* chunks; /**< Bloque actual, seguido de los anteriores del mismo ciclo. */
+    size_t capacity;       /**< Bytes utilizables sumando todos los bloques. */
+    size_t used;           /**< Bytes reservados desde el último reset. */
+    size_t high_water;     /**< Máximo de used entre resets. */
+    size_t system_allocs;  /**< Veces que se pidió memoria al sistema. */
+} arena_t;
+
+/**
+ * @brief Reserva memoria alineada a 16 bytes válida hasta el próximo arena_reset().
+ * @param arena Arena a usar (puede estar vacío: el primer bloque se crea a demanda).
+ * @param size Tamaño pedido.
+ * @return Puntero al bloque, o NULL si no hay memoria.
+ */
+void* arena_alloc(arena_t* arena, size_t size);
+
+/**
+ * @brief Descarta todo lo reservado y consolida los bloques en uno del tamaño del pico.
+ * @param arena Arena a reiniciar.
+ */
+void arena_reset(arena_t* arena);
+
+/**
+ * @brief Libera toda la memoria del arena.
+ * @param arena Arena a destruir; queda vacío y reutilizable.
+ */
+void arena_destroy(arena_t* arena);
+
+/**
+ * @brief Prepara el arena del tick con la capacidad inicial dada y lo registra en cJSON.
+ * @param initial Capacidad inicial en bytes (0 usa un valor por defecto).
+ * @return 0 si se pudo reservar la capacidad inicial, -1 en caso contrario.
+ */
+int tick_arena_init(size_t initial);
+
+/**
+ * @brief Reserva memoria temporal del tick actual.
+ * @param size Tamaño pedido.
+ * @return Puntero válido hasta tick_arena_reset(), o NULL si no hay memoria.
+ */
+void* tick_alloc(size_t size);
+
+/**
+ * @brief Termina el tick: descarta toda la memoria temporal reservada durante él.
+ */
+void tick_arena_reset(void);
+
+/**
+ * @brief Estado del arena del tick, para diagnóstico.
+ * @return Puntero de solo lectura al arena.
+ */
+const arena_t* tick_arena(void);
+
+#endif // ARENA_H
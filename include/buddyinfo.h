@@ -0,0 +1,111 @@
+/**
+ * @file buddyinfo.h
+ * @brief Fragmentación real de la memoria del sistema a partir de /proc/buddyinfo y /proc/pagetypeinfo.
+ *
+ * Para cada nodo NUMA y zona se leen los bloques libres por orden del buddy allocator y,
+ * si el proceso tiene permiso, la distribución por tipo de migración. Con eso se calcula el
+ * índice de espacio libre inutilizable (unusable free index) para cada orden, que anticipa
+ * fallas al reservar hugepages aun cuando hay memoria libre.
+ */
+
+#ifndef BUDDYINFO_H
+#define BUDDYINFO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Máximo de órdenes del buddy allocator que se registran.
+ */
+#define BUDDY_MAX_ORDER 16
+
+/**
+ * @brief Máximo de pares (nodo, zona) que se registran.
+ */
+#define BUDDY_MAX_ZONES 64
+
+/**
+ * @brief Máximo de tipos de migración de /proc/pagetypeinfo.
+ */
+#define PAGETYPE_MAX_TYPES 8
+
+/**
+ * @brief Orden de una hugepage cuando /proc/pagetypeinfo no está disponible (2 MB con páginas de 4 kB).
+ */
+#define BUDDY_DEFAULT_HUGEPAGE_ORDER 9
+
+/**
+ * @brief Estado de una zona de un nodo NUMA.
+ */
+typedef struct
+{
+    int node;                                 /**< Nodo NUMA. */
+    char zone[16];                            /**< Nombre de la zona (DMA, DMA32, Normal, Movable...). */
+    int orders;                               /**< Cantidad de órdenes reportados. */
+    uint64_t free_blocks[BUDDY_MAX_ORDER];    /**< Bloques libres de 2^orden páginas. */
+    uint64_t type_free_pages[PAGETYPE_MAX_TYPES]; /**< Páginas libres por tipo de migración. */
+    uint64_t type_blocks[PAGETYPE_MAX_TYPES];     /**< Pageblocks asignados a cada tipo de migración. */
+} buddy_zone_t;
+
+/**
+ * @brief Estado del buddy allocator de todo el sistema.
+ */
+typedef struct
+{
+    int zone_count;                                 /**< Zonas válidas en zones. */
+    buddy_zone_t zones[BUDDY_MAX_ZONES];            /**< Zonas por nodo. */
+    bool have_types;                                /**< true si se pudo leer /proc/pagetypeinfo. */
+    int type_count;                                 /**< Tipos de migración válidos. */
+    char type_names[PAGETYPE_MAX_TYPES][16];        /**< Nombre de cada tipo de migración. */
+    int pageblock_order;                            /**< Orden de un pageblock (tamaño de una hugepage). */
+} buddyinfo_t;
+
+/**
+ * @brief Lee los bloques libres por orden de un archivo con formato de /proc/buddyinfo.
+ *
+ * @param path Ruta del archivo.
+ * @param info Estructura de salida; se reinicia antes de leer.
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int read_buddyinfo(const char* path, buddyinfo_t* info);
+
+/**
+ * @brief Completa info con la distribución por tipo de migración de /proc/pagetypeinfo.
+ *
+ * Debe llamarse después de read_buddyinfo(). El archivo solo es legible por root; si no se
+ * puede leer, info->have_types queda en false y el resto de los datos sigue siendo válido.
+ *
+ * @param path Ruta del archivo.
+ * @param info Estructura a completar.
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int read_pagetypeinfo(const char* path, buddyinfo_t* info);
+
+/**
+ * @brief Páginas libres totales de una zona.
+ * @param zone Zona a evaluar.
+ * @return Suma de 2^orden por cada bloque libre.
+ */
+uint64_t buddy_free_pages(const buddy_zone_t* zone);
+
+/**
+ * @brief Índice de espacio libre inutilizable para una reserva del orden dado.
+ *
+ * Fracción de las páginas libres que están en bloques más chicos que 2^orden, y por lo
+ * tanto no sirven para esa reserva: 0 es sin fragmentación, 1 es totalmente fragmentado.
+ *
+ * @param zone Zona a evaluar.
+ * @param order Orden de la reserva.
+ * @return Índice entre 0 y 1, o 0 si la zona no tiene páginas libres.
+ */
+double buddy_unusable_index(const buddy_zone_t* zone, int order);
+
+/**
+ * @brief Cantidad de bloques de 2^orden páginas que se pueden reservar sin compactar.
+ * @param zone Zona a evaluar.
+ * @param order Orden de la reserva.
+ * @return Bloques disponibles del orden pedido.
+ */
+uint64_t buddy_allocatable_blocks(const buddy_zone_t* zone, int order);
+
+#endif // BUDDYINFO_H
@@ -0,0 +1,187 @@
+/**
+ * @file cardinality.h
+ * @brief Límites de cardinalidad: listas de métricas y etiquetas permitidas o denegadas y tope de series por familia.
+ *
+ * Las reglas vienen de la clave "cardinality" de config.json y se compilan una sola vez al
+ * cargar la configuración. Un patrón es un glob (fnmatch) o, si está entre barras, una
+ * expresión regular extendida anclada a todo el valor: "vmstat_*" o "/numa_.*_(hit|miss)/".
+ *
+ * Cada métrica creada se registra como una familia. Antes de guardar un valor en Prometheus se
+ * consulta la familia: una métrica denegada no se registra ni recibe valores, y una serie cuya
+ * etiqueta cae en un patrón denegado (o fuera de los permitidos para esa etiqueta) se descarta
+ * sin ocupar memoria. Con un tope de series, el primer tick de cada familia se retiene y al
+ * cerrarlo se admiten las series de mayor valor; las que aparecen después entran solo si queda
+ * lugar. Las series que no entran se cuentan como descartadas.
+ *
+ * prometheus-client-c no permite borrar una serie: una serie admitida no se reemplaza por otra
+ * de mayor valor, y si una recarga niega una métrica o una serie ya publicada, esta queda con
+ * su último valor.
+ *
+ * El módulo no tiene bloqueo propio: todas las funciones, salvo las de armado de reglas,
+ * requieren que el llamador serialice el acceso (en expose_metrics.c, con lock).
+ */
+
+#ifndef CARDINALITY_H
+#define CARDINALITY_H
+
+#include <regex.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Máximo de patrones por lista.
+ */
+#define CARDINALITY_MAX_PATTERNS 64
+
+/**
+ * @brief Máximo de familias (métricas creadas).
+ */
+#define CARDINALITY_MAX_FAMILIES 256
+
+/**
+ * @brief Máximo de etiquetas por familia.
+ */
+#define CARDINALITY_MAX_LABELS 8
+
+/**
+ * @brief Largo máximo del nombre de una etiqueta en una regla.
+ */
+#define CARDINALITY_LABEL_MAX 32
+
+/**
+ * @brief Patrón compilado.
+ */
+typedef struct
+{
+    char text[128];   /**< Patrón tal como se escribió. */
+    bool any;         /**< "*": acepta cualquier valor sin evaluar. */
+    bool literal;     /**< Glob sin comodines: se compara con strcmp. */
+    bool regex;       /**< Expresión regular (entre barras); si no, glob. */
+    regex_t compiled; /**< Expresión compilada si regex. */
+} cardinality_pattern_t;
+
+/**
+ * @brief Regla sobre el valor de una etiqueta ("cpu=1??").
+ */
+typedef struct
+{
+    char label[CARDINALITY_LABEL_MAX]; /**< Etiqueta a la que aplica. */
+    bool deny;                         /**< true deniega los valores que coinciden; false los permite. */
+    cardinality_pattern_t pattern;     /**< Patrón del valor. */
+} cardinality_label_rule_t;
+
+/**
+ * @brief Reglas compiladas a partir de la configuración.
+ */
+typedef struct cardinality_rules
+{
+    int max_series;                                          /**< Series por familia (0 sin tope). */
+    int metric_allow_count;                                  /**< Patrones válidos en metric_allow. */
+    cardinality_pattern_t metric_allow[CARDINALITY_MAX_PATTERNS]; /**< Métricas permitidas (vacío: todas). */
+    int metric_deny_count;                                   /**< Patrones válidos en metric_deny. */
+    cardinality_pattern_t metric_deny[CARDINALITY_MAX_PATTERNS];  /**< Métricas denegadas. */
+    int label_rule_count;                                    /**< Reglas válidas en label_rules. */
+    cardinality_label_rule_t label_rules[CARDINALITY_MAX_PATTERNS]; /**< Reglas sobre valores de etiquetas. */
+} cardinality_rules_t;
+
+/**
+ * @brief Guarda un valor en la métrica de Prometheus (prom_gauge_set o prom_counter_add).
+ * @param metric Métrica registrada con cardinality_track().
+ * @param value Valor a guardar.
+ * @param labels Valores de las etiquetas.
+ */
+typedef void (*cardinality_store_fn)(void* metric, double value, const char** labels);
+
+/**
+ * @brief Informa las series descartadas por el tope desde el flush anterior.
+ * @param name Nombre de la familia.
+ * @param dropped Series descartadas.
+ */
+typedef void (*cardinality_drop_fn)(const char* name, uint64_t dropped);
+
+/**
+ * @brief Crea un conjunto de reglas vacío (sin tope ni filtros).
+ * @return Reglas, o NULL si no hay memoria.
+ */
+cardinality_rules_t* cardinality_rules_new(void);
+
+/**
+ * @brief Compila un patrón de nombre de métrica y lo agrega a la lista de permitidas o denegadas.
+ * @param rules Reglas destino.
+ * @param deny true para la lista de denegadas.
+ * @param pattern Glob o expresión entre barras.
+ * @param error Buffer para el motivo del rechazo.
+ * @param error_len Tamaño de error.
+ * @return 0 si el patrón se agregó, -1 si es inválido.
+ */
+int cardinality_rules_add_metric(cardinality_rules_t* rules, bool deny, const char* pattern, char* error,
+                                 size_t error_len);
+
+/**
+ * @brief Compila una regla de etiqueta con la forma "etiqueta=patrón" y la agrega.
+ *
+ * Si una etiqueta tiene reglas permitidas, sus valores deben coincidir con alguna; un valor que
+ * coincide con una regla denegada se descarta siempre.
+ *
+ * @param rules Reglas destino.
+ * @param deny true para denegar los valores que coinciden.
+ * @param rule Regla "etiqueta=patrón".
+ * @param error Buffer para el motivo del rechazo.
+ * @param error_len Tamaño de error.
+ * @return 0 si la regla se agregó, -1 si es inválida.
+ */
+int cardinality_rules_add_label(cardinality_rules_t* rules, bool deny, const char* rule, char* error,
+                                size_t error_len);
+
+/**
+ * @brief Libera un conjunto de reglas.
+ * @param rules Reglas, o NULL.
+ */
+void cardinality_rules_free(cardinality_rules_t* rules);
+
+/**
+ * @brief Instala las reglas y libera las anteriores; recalcula qué familias y etiquetas quedan filtradas.
+ *
+ * Las series ya admitidas se conservan.
+ *
+ * @param rules Reglas; el módulo pasa a ser su dueño. NULL quita filtros y tope.
+ */
+void cardinality_install(cardinality_rules_t* rules);
+
+/**
+ * @brief Registra una métrica recién creada como familia.
+ * @param metric Métrica de Prometheus.
+ * @param name Nombre de la métrica.
+ * @param label_count Cantidad de etiquetas (a lo sumo CARDINALITY_MAX_LABELS).
+ * @param label_names Nombres de las etiquetas.
+ * @param cumulative true si la métrica acumula lo que se guarda (counter).
+ * @param store Función que guarda un valor en la métrica.
+ * @return 0 si se registró, -1 si no hay lugar o memoria.
+ */
+int cardinality_track(void* metric, const char* name, int label_count, const char** label_names, bool cumulative,
+                      cardinality_store_fn store);
+
+/**
+ * @brief Indica si una familia debe registrarse en Prometheus y la marca como registrada.
+ * @param metric Métrica registrada con cardinality_track().
+ * @return true si la métrica está permitida y todavía no se registró.
+ */
+bool cardinality_claim_registration(void* metric);
+
+/**
+ * @brief Guarda un valor si la familia y la serie pasan los filtros y el tope.
+ * @param metric Métrica registrada con cardinality_track().
+ * @param value Valor a guardar.
+ * @param rank Valor con el que compite la serie por un lugar (el valor del gauge o el total del counter).
+ * @param labels Valores de las etiquetas, o NULL si la métrica no tiene.
+ */
+void cardinality_store(void* metric, double value, double rank, const char** labels);
+
+/**
+ * @brief Cierra el tick: admite las series de mayor valor de las familias retenidas e informa los descartes.
+ * @param on_drop Función que recibe los descartes de cada familia, o NULL.
+ */
+void cardinality_flush(cardinality_drop_fn on_drop);
+
+#endif // CARDINALITY_H
@@ -0,0 +1,42 @@
+/**
+ * @file collector_list.h
+ * @brief Lista de colectores, única fuente de la tabla de colectores, del parser de "metrics" y del JSON del FIFO.
+ *
+ * No tiene guarda de inclusión: quien la incluye define COLLECTOR(id, nombre, etiqueta, flag, fuentes)
+ * y la expande a lo que necesite. Cada colector aporta, por convención de nombres:
+ *  - id_metrics_register(): crea y registra sus métricas (expose_metrics.c);
+ *  - collect_id(): lectura del tick (collectors.c);
+ *  - encode_id(): su parte del JSON del FIFO (metrics_json.c).
+ *
+ * nombre es el de la lista "metrics" de config.json, o NULL si lo activa otra opción; flag es el
+ * campo bool de config_t que lo activa. El orden es el de la recolección en cada tick.
+ *
+ * fuentes es la lista entre paréntesis de los archivos que lee el colector, relativos a la raíz
+ * (proc/... o sys/..., con comodines de shell). El código C la descarta; la lee
+ * tools/record_procfs.sh para grabar todo lo que hace falta para un replay.
+ */
+
+COLLECTOR(memory_fragmentation, "memory_fragmentation", "Fragmentación de memoria", collect_memory_fragmentation,
+          ("proc/buddyinfo", "proc/pagetypeinfo"))
+COLLECTOR(cpu, "cpu", "CPU", collect_cpu, ("proc/stat"))
+COLLECTOR(cpufreq, "cpufreq", "Frecuencia y temperatura de CPU", collect_cpufreq,
+          ("proc/stat", "sys/devices/system/cpu/cpu*/cpufreq/cpuinfo_max_freq",
+           "sys/devices/system/cpu/cpu*/cpufreq/scaling_cur_freq",
+           "sys/devices/system/cpu/cpu*/topology/physical_package_id",
+           "sys/devices/system/cpu/cpu*/thermal_throttle/*_throttle_count",
+           "sys/class/thermal/thermal_zone*/type", "sys/class/thermal/thermal_zone*/temp"))
+COLLECTOR(memory, "memory", "Memoria", collect_memory, ("proc/meminfo"))
+COLLECTOR(disk, "disk", "Disco", collect_disk, ("proc/diskstats"))
+COLLECTOR(net, "net", "Red", collect_net, ("proc/net/dev"))
+COLLECTOR(context_switches, "context_switches", "Cambios de contexto", collect_context_switches, ("proc/stat"))
+COLLECTOR(running_processes, "running_processes", "Procesos en ejecución", collect_running_processes, ("proc/stat"))
+COLLECTOR(meminfo, "meminfo", "Meminfo/vmstat", collect_meminfo, ("proc/meminfo", "proc/vmstat"))
+COLLECTOR(psi, "psi", "PSI", collect_psi, ("proc/pressure/cpu", "proc/pressure/memory", "proc/pressure/io"))
+COLLECTOR(interrupts, "interrupts", "Interrupciones", collect_interrupts, ("proc/interrupts", "proc/softirqs"))
+COLLECTOR(numa, "numa", "NUMA", collect_numa,
+          ("proc/stat", "sys/devices/system/cpu/possible", "sys/devices/system/node/online",
+           "sys/devices/system/node/node*/cpulist", "sys/devices/system/node/node*/meminfo",
+           "sys/devices/system/node/node*/numastat"))
+COLLECTOR(netproto, "netproto", "Protocolos de red", collect_netproto,
+          ("proc/net/snmp", "proc/net/netstat", "proc/net/sockstat"))
+COLLECTOR(microsample, NULL, "Micro-muestreo", collect_microsample, ("proc/stat"))
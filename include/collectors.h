@@ -0,0 +1,61 @@
+/**
+ * @file collectors.h
+ * @brief Registro de colectores: tabla con nombre, flag de config_t, inicialización y lectura por tick.
+ *
+ * La tabla se genera desde collector_list.h. Las métricas de Prometheus de un colector se crean
+ * y registran la primera vez que se lo activa (al arrancar o en una recarga), no al iniciar el
+ * proceso: un colector desactivado no cuesta memoria, series ni tiempo de arranque.
+ */
+
+#ifndef COLLECTORS_H
+#define COLLECTORS_H
+
+#include "config.h"
+
+/**
+ * @brief Descriptor de un colector.
+ */
+typedef struct
+{
+    const char* name;                        /**< Nombre en la lista "metrics" de config.json, o NULL. */
+    const char* label;                       /**< Nombre en el resumen de la configuración. */
+    size_t config_flag;                      /**< offsetof del bool de config_t que lo activa. */
+    int (*init)(void);                       /**< Crea y registra sus métricas; 0 si quedaron registradas. */
+    void (*collect)(const config_t* config); /**< Lee su fuente y actualiza sus métricas y la muestra. */
+} collector_t;
+
+/**
+ * @brief Tabla de colectores, en el orden de collector_list.h.
+ */
+extern const collector_t collectors[];
+
+/**
+ * @brief Cantidad de entradas de collectors.
+ */
+extern const int collector_count;
+
+/**
+ * @brief Inicializa los colectores activos que todavía no lo estaban y actualiza su estado
+ *        (por ejemplo, el disco si cambió disk_device). Llamar al arrancar y tras cada recarga,
+ *        antes de iniciar los hilos que publican en sus métricas.
+ * @param config Configuración vigente.
+ * @return Cantidad de colectores activos listos para recolectar.
+ */
+int collectors_prepare(const config_t* config);
+
+/**
+ * @brief Ejecuta la lectura del tick de cada colector activo y listo, en el orden de la lista, dentro del
+ *        lote de lecturas del tick (procfs_batch_begin() y procfs_batch_end()). Al terminar cierra el tick
+ *        de los límites de cardinalidad (publish_cardinality()).
+ * @param config Configuración vigente.
+ */
+void collectors_collect(const config_t* config);
+
+/**
+ * @brief Busca un colector por su nombre en la lista "metrics".
+ * @param name Nombre tal como aparece en config.json.
+ * @return Descriptor, o NULL si no hay un colector seleccionable con ese nombre.
+ */
+const collector_t* collector_find(const char* name);
+
+#endif // COLLECTORS_H
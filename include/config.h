@@ -6,7 +6,16 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include "procfs.h"
+#include "psi.h"
+#include "realtime.h"
+#include "scheduler.h"
 #include <stdbool.h>
+#include <stddef.h>
+
+struct alert_program;
+struct cardinality_rules;
+
 /**
  * @brief Estructura de informacion de monitor.
  */
@@ -20,22 +29,78 @@ typedef struct
     bool collect_context_switches;  /**< Recopila cambios de contexto si es true */
     bool collect_memory_fragmentation; /**< Fragmentacion de memoria */
     bool collect_running_processes; /**< Recopila número de procesos activos si es true */
+    bool collect_meminfo;           /**< Recopila todo /proc/meminfo y contadores de /proc/vmstat si es true */
+    bool collect_interrupts;        /**< Recopila tasas de /proc/interrupts y /proc/softirqs si es true */
+    int irq_top_k;                  /**< Series por archivo de interrupciones (top-K por tasa) */
+    bool collect_netproto;          /**< Recopila contadores de protocolos de red y sockets TCP por estado si es true */
+    bool collect_numa;              /**< Recopila memoria, numastat y uso de CPU por nodo NUMA si es true */
+    bool collect_cpufreq;           /**< Recopila frecuencia por núcleo, temperaturas y throttling si es true */
+    bool collect_psi;               /**< Recopila /proc/pressure y registra los triggers de PSI si es true */
+    psi_trigger_t psi_triggers[PSI_MAX_TRIGGERS]; /**< Umbrales de stall que generan eventos inmediatos */
+    int psi_trigger_count;          /**< Triggers válidos en psi_triggers */
+    adaptive_config_t adaptive;     /**< Muestreo adaptativo: intervalo lento y ráfagas rápidas ante picos */
+    realtime_config_t realtime;     /**< Baja latencia: CPUs fijas, SCHED_FIFO y memoria bloqueada (solo al arrancar) */
+    int micro_sampling_ms;          /**< Intervalo del micro-muestreo de /proc/stat (0 lo desactiva) */
+    bool collect_microsample;       /**< Derivado: true si micro_sampling_ms > 0 */
+    bool rate_gauges;               /**< Publica tasas por segundo precalculadas junto a los counters */
+    struct alert_program* alerts;   /**< Reglas de alerta compiladas (NULL si no hay); se entregan a alerts_install() */
+    struct cardinality_rules* cardinality; /**< Filtros y tope de series (NULL si no hay); van a install_cardinality() */
     char log_file[256];             /**< Ruta al archivo de log */
-    int allocation_method;          /**< Metodo de alocacion */
+    int allocation_method;          /**< Metodo de alocacion (FIRST_FIT, BEST_FIT, WORST_FIT o SEGREGATED_FIT) */
+    char proc_root[256];            /**< Directorio que reemplaza a /proc (vacío usa /proc) */
+    char sys_root[256];             /**< Directorio que reemplaza a /sys (vacío usa /sys) */
+    char replay_dir[256];           /**< Directorio de snapshots grabados; vacío desactiva el replay */
+    double replay_speed;            /**< Aceleración del replay respecto del tiempo grabado (0 = sin esperas) */
+    bool replay_loop;               /**< Repite la grabación al llegar al final */
+    procfs_batch_backend_t procfs_batch; /**< Lecturas de /proc y /sys por lote en cada tick (off, pread o io_uring) */
+    char disk_device[32];           /**< Disco a monitorear; vacío lo detecta automáticamente */
+    char net_interface[16];         /**< Interfaz de red a monitorear */
 
 } config_t;
 
+/**
+ * @brief Campo bool de config_t en un offset, como lo guardan las tablas de colectores y de alertas.
+ * @param config Configuración.
+ * @param offset offsetof del campo.
+ * @return Puntero al campo.
+ */
+static inline bool* config_flag(config_t* config, size_t offset)
+{
+    return (bool*)((char*)config + offset);
+}
+
+/**
+ * @brief Valor de un campo bool de config_t en un offset.
+ */
+static inline bool config_flag_enabled(const config_t* config, size_t offset)
+{
+    return *(const bool*)((const char*)config + offset);
+}
+
 /**
  * @brief Carga la configuración desde un archivo JSON.
  *
  * Esta función abre el archivo JSON especificado, lo analiza y carga la configuración
  * en la estructura config_t, asignando valores predeterminados si algunas opciones no están presentes.
+ * Las entradas inválidas (métricas desconocidas, reglas de alerta, triggers de PSI, patrones de
+ * cardinalidad, CPUs o prioridad de realtime) se informan por stderr, no se aplican y se cuentan
+ * en rejected_entries: al arrancar se sigue sin ellas, al recargar se rechaza el archivo entero.
  *
  * @param filename Nombre del archivo de configuración JSON.
  * @param config Puntero a la estructura `config_t` donde se almacenará la configuración cargada.
+ * @param rejected_entries Cantidad de entradas inválidas; puede ser NULL.
  * @return `true` si la configuración se carga correctamente, `false` en caso de error.
  */
-bool load_config(const char* filename, config_t* config);
+bool load_config(const char* filename, config_t* config, int* rejected_entries);
+
+/**
+ * @brief Resume la configuración en una sola línea: intervalo, colectores activos y las opciones que
+ *        se apartan de los valores por defecto.
+ * @param config Configuración.
+ * @param out Buffer destino.
+ * @param len Tamaño de out.
+ */
+void config_summary(const config_t* config, char* out, size_t len);
 
 /**
  * @brief Envía las métricas actuales a través de un FIFO.
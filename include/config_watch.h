@@ -0,0 +1,40 @@
+/**
+ * @file config_watch.h
+ * @brief Detecta cambios de config.json con inotify y pedidos de recarga con SIGHUP.
+ *
+ * Se vigila el directorio del archivo y no el archivo en sí: los editores y las herramientas de
+ * despliegue suelen reemplazarlo con un rename, lo que dejaría huérfano un watch sobre el inodo
+ * anterior. Solo cuentan IN_CLOSE_WRITE e IN_MOVED_TO sobre el nombre del archivo, así una
+ * escritura a medias no dispara la recarga.
+ *
+ * Nada se aplica desde el manejador de la señal ni desde otro hilo: el bucle principal consulta
+ * config_watch_pending() entre ticks, sin bloquear, y aplica la configuración nueva en ese punto.
+ */
+
+#ifndef CONFIG_WATCH_H
+#define CONFIG_WATCH_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Instala el manejador de SIGHUP y el watch de inotify sobre el directorio del archivo.
+ *
+ * Si inotify no está disponible la recarga sigue funcionando con SIGHUP.
+ *
+ * @param path Ruta de config.json.
+ * @return 0 si se vigila el archivo, -1 si solo queda SIGHUP.
+ */
+int config_watch_start(const char* path);
+
+/**
+ * @brief Indica si llegó un SIGHUP o cambió el archivo desde la última consulta. No bloquea.
+ * @return true si hay que recargar la configuración.
+ */
+bool config_watch_pending(void);
+
+/**
+ * @brief Cierra el descriptor de inotify.
+ */
+void config_watch_stop(void);
+
+#endif // CONFIG_WATCH_H
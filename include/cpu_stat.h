@@ -0,0 +1,82 @@
+/**
+ * @file cpu_stat.h
+ * @brief Jiffies de cada CPU desde las líneas "cpuN" de /proc/stat, con el avance del intervalo.
+ *
+ * El uso de CPU por nodo NUMA y el uso normalizado por frecuencia salen de los mismos contadores
+ * por CPU. En lugar de que cada colector abra y parsee /proc/stat, el tick hace una sola lectura
+ * con cpu_stat_read() y ambos colectores toman de ella el avance de cada CPU desde la lectura
+ * anterior (cpu_stat_delta()). La lectura pasa por procfs_read(), así que con el lote de lecturas
+ * activo es la misma que usan los colectores de CPU, cambios de contexto y procesos en ejecución.
+ *
+ * El micro-muestreo no la usa: lee /proc/stat varias veces por tick desde su propio hilo.
+ */
+
+#ifndef CPU_STAT_H
+#define CPU_STAT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Mayor número de CPU que se acepta; las líneas con números más altos se ignoran.
+ */
+#define CPU_STAT_MAX_CPUS (1 << 16)
+
+/**
+ * @brief Contadores de una CPU en la última lectura y su avance desde la anterior.
+ */
+typedef struct
+{
+    uint64_t busy;        /**< Jiffies ocupados acumulados (sin idle ni iowait). */
+    uint64_t total;       /**< Jiffies totales acumulados (0: la CPU nunca apareció). */
+    uint64_t busy_delta;  /**< Jiffies ocupados del intervalo. */
+    uint64_t total_delta; /**< Jiffies totales del intervalo, 0 si no hay intervalo válido. */
+} cpu_stat_cpu_t;
+
+/**
+ * @brief Lecturas por número de CPU. En cero antes del primer uso.
+ */
+typedef struct
+{
+    int cpu_slots;        /**< Tamaño de cpus (mayor número de CPU leído + 1). */
+    cpu_stat_cpu_t* cpus; /**< Contadores indexados por número de CPU. */
+} cpu_stat_t;
+
+/**
+ * @brief Lee /proc/stat bajo la raíz actual y calcula el avance de cada CPU.
+ *
+ * Una CPU sin lectura anterior, que no aparece en esta lectura (desconectada) o cuyos contadores
+ * retroceden (volvió a conectarse, o el replay volvió al principio) queda sin intervalo válido.
+ * Solo reserva memoria cuando aparece un número de CPU mayor a los ya vistos.
+ *
+ * @param stat Lecturas; guarda los contadores para el próximo intervalo.
+ * @return 0 si se leyó el archivo, -1 en caso de error.
+ */
+int cpu_stat_read(cpu_stat_t* stat);
+
+/**
+ * @brief Libera las lecturas; la próxima cpu_stat_read() empieza sin intervalo.
+ * @param stat Lecturas a liberar.
+ */
+void cpu_stat_free(cpu_stat_t* stat);
+
+/**
+ * @brief Avance de una CPU en el último intervalo.
+ * @param stat Lecturas.
+ * @param cpu Número de CPU.
+ * @param busy Jiffies ocupados del intervalo.
+ * @param total Jiffies totales del intervalo.
+ * @return true si la CPU tiene un intervalo válido.
+ */
+static inline bool cpu_stat_delta(const cpu_stat_t* stat, int cpu, uint64_t* busy, uint64_t* total)
+{
+    if (cpu < 0 || cpu >= stat->cpu_slots || stat->cpus[cpu].total_delta == 0)
+    {
+        return false;
+    }
+    *busy = stat->cpus[cpu].busy_delta;
+    *total = stat->cpus[cpu].total_delta;
+    return true;
+}
+
+#endif // CPU_STAT_H
@@ -0,0 +1,114 @@
+/**
+ * @file cpufreq.h
+ * @brief Frecuencia por núcleo, temperaturas de las zonas térmicas y contadores de throttling desde /sys.
+ *
+ * Un uso de CPU alto puede ser carga real o un núcleo que el kernel bajó de frecuencia (por
+ * temperatura o por el governor). Para distinguirlos se lee por CPU cpufreq/scaling_cur_freq y
+ * thermal_throttle/{core,package}_throttle_count, y por zona class/thermal/thermal_zoneN/temp.
+ * Los valores fijos (frecuencia máxima, paquete físico, tipo de zona) se leen una sola vez al
+ * descubrir la topología; el resto son cientos de archivos chicos que quedan abiertos y se releen
+ * con pread en cada tick.
+ *
+ * Además se deriva un uso normalizado por frecuencia: el tiempo ocupado de cada CPU en el
+ * intervalo (de la lectura de /proc/stat del tick, cpu_stat.h) pesa por cur_freq / max_freq de
+ * esa CPU, así un núcleo al 100% a media frecuencia cuenta como 50% de su capacidad.
+ */
+
+#ifndef CPUFREQ_H
+#define CPUFREQ_H
+
+#include "cpu_stat.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Máximo de zonas térmicas; las que sobran se ignoran con un aviso.
+ */
+#define CPUFREQ_MAX_ZONES 32
+
+/**
+ * @brief Una CPU: descriptores abiertos, valores fijos y última lectura.
+ */
+typedef struct
+{
+    int cpu;                  /**< Número de CPU. */
+    int package;              /**< physical_package_id, o -1. */
+    bool package_leader;      /**< Primera CPU de su paquete: publica package_throttle_count. */
+    int cur_freq_fd;          /**< Descriptor de scaling_cur_freq, o -1. */
+    int core_throttle_fd;     /**< Descriptor de core_throttle_count, o -1. */
+    int package_throttle_fd;  /**< Descriptor de package_throttle_count (solo el líder del paquete), o -1. */
+    double max_hz;            /**< cpuinfo_max_freq en Hz, o -1 sin cpufreq. */
+    double cur_hz;            /**< Última frecuencia leída en Hz, o -1. */
+    bool have_throttle;       /**< core_throttles (y package_throttles en el líder) son de esta lectura. */
+    uint64_t core_throttles;  /**< Eventos de throttling del núcleo desde el arranque. */
+    uint64_t package_throttles; /**< Eventos de throttling del paquete desde el arranque. */
+} cpufreq_cpu_t;
+
+/**
+ * @brief Una zona térmica.
+ */
+typedef struct
+{
+    int id;            /**< Número de thermal_zoneN. */
+    char type[32];     /**< Contenido de type (x86_pkg_temp, acpitz, cpu-thermal...). */
+    int temp_fd;       /**< Descriptor de temp, o -1. */
+    bool have_temp;    /**< celsius es de esta lectura. */
+    double celsius;    /**< Última temperatura en grados Celsius. */
+} thermal_zone_t;
+
+/**
+ * @brief CPUs y zonas descubiertas, con sus descriptores abiertos.
+ */
+typedef struct
+{
+    int cpu_count;                          /**< CPUs en cpus, ordenadas por número. */
+    cpufreq_cpu_t* cpus;                    /**< CPUs con directorio en devices/system/cpu. */
+    int cpu_slots;                          /**< Tamaño de cpu_index (mayor número de CPU + 1). */
+    int* cpu_index;                         /**< Posición en cpus de cada número de CPU, o -1. */
+    int zone_count;                         /**< Zonas válidas en zones. */
+    thermal_zone_t zones[CPUFREQ_MAX_ZONES]; /**< Zonas térmicas. */
+} cpufreq_topology_t;
+
+/**
+ * @brief Resumen de una lectura, para la muestra compartida, el JSON y las alertas.
+ */
+typedef struct
+{
+    int cpus_with_freq;         /**< CPUs con cpufreq. */
+    double freq_avg_hz;         /**< Frecuencia promedio de esas CPUs, o -1. */
+    double freq_ratio;          /**< Promedio de cur_freq / max_freq, o -1. */
+    double usage;               /**< Uso de CPU del intervalo sobre las líneas por CPU, o -1. */
+    double normalized_usage;    /**< Uso del intervalo pesado por cur_freq / max_freq, o -1 sin cpufreq. */
+    bool have_temperature;      /**< max_celsius es válido. */
+    double max_celsius;         /**< Temperatura de la zona más caliente. */
+    unsigned long core_throttles; /**< Suma de core_throttle_count de todas las CPUs. */
+} cpufreq_summary_t;
+
+/**
+ * @brief Descubre CPUs y zonas térmicas y abre los archivos que se releen en cada tick.
+ *
+ * En modo replay no se dejan descriptores abiertos, porque la raíz cambia en cada tick.
+ *
+ * @param topo Topología de salida.
+ * @return 0 si se encontró al menos una CPU, -1 en caso de error.
+ */
+int cpufreq_discover(cpufreq_topology_t* topo);
+
+/**
+ * @brief Cierra los descriptores y libera los arreglos de la topología.
+ * @param topo Topología a liberar.
+ */
+void cpufreq_free(cpufreq_topology_t* topo);
+
+/**
+ * @brief Relee frecuencias, throttling y temperaturas y calcula el uso del intervalo.
+ *
+ * Deja cada lectura en topo->cpus y topo->zones; un archivo que falla solo invalida su valor.
+ *
+ * @param topo Topología descubierta.
+ * @param cpu_stat Lectura de /proc/stat del tick, o NULL si falló (los usos quedan en -1).
+ * @param summary Resumen de salida.
+ */
+void cpufreq_read(cpufreq_topology_t* topo, const cpu_stat_t* cpu_stat, cpufreq_summary_t* summary);
+
+#endif // CPUFREQ_H
@@ -0,0 +1,35 @@
+/**
+ * @file events.h
+ * @brief Salida de mensajes hacia la shell por el FIFO de métricas.
+ *
+ * El FIFO lo escriben tanto el bucle de muestreo como hilos de eventos (triggers PSI), así que
+ * cada mensaje se escribe completo bajo un lock para que nunca se intercalen. Es el único destino
+ * de los eventos; el estado de las alertas también se consulta en /alerts.
+ */
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stddef.h>
+
+/**
+ * @brief Ruta del FIFO por el que se envían las métricas a la shell.
+ */
+#define FIFO_PATH "/tmp/metrics_fifo"
+
+/**
+ * @brief Escribe un mensaje completo en el FIFO. Es seguro llamarla desde cualquier hilo.
+ * @param data Mensaje.
+ * @param length Longitud del mensaje.
+ * @return 0 si se escribió, -1 en caso de error.
+ */
+int fifo_write(const char* data, size_t length);
+
+/**
+ * @brief Publica un evento en el FIFO.
+ * @param json Evento codificado como JSON.
+ * @param length Longitud del evento.
+ */
+void events_publish(const char* json, size_t length);
+
+#endif // EVENTS_H
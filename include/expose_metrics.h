@@ -3,7 +3,18 @@
  * @brief Programa para leer el uso de CPU y memoria y exponerlos como métricas de Prometheus.
  */
 
+#ifndef EXPOSE_METRICS_H
+#define EXPOSE_METRICS_H
+
+#include "cardinality.h"
+#include "cpufreq.h"
+#include "meminfo.h"
 #include "metrics.h"
+#include "microsample.h"
+#include "netproto.h"
+#include "numa.h"
+#include "psi.h"
+#include "scheduler.h"
 #include <cjson/cJSON.h>
 #include <config.h>
 #include <errno.h>
@@ -19,6 +30,66 @@
  * @brief Tamaño del buffer utilizado para leer datos del sistema.
  */
 #define BUFFER_SIZE 256
+/**
+ * @brief Descarta el estado de los colectores cuya fuente cambió al recargar la configuración.
+ *        Debe llamarse desde el hilo del bucle de muestreo.
+ *
+ * Lo demás se conserva: olvidar una lectura previa le quita un intervalo al counter y deja su
+ * tasa vacía un tick.
+ *
+ * @param roots true si cambiaron proc_root o sys_root: se reabren los descriptores, se vuelve a
+ *              descubrir la topología y se olvidan todas las series.
+ * @param disk true si cambió disk_device: se olvidan las series de disco.
+ * @param net true si cambió net_interface: se olvidan las series de red.
+ */
+void reset_collectors(bool roots, bool disk, bool net);
+
+/**
+ * @brief Activa o desactiva los gauges de tasa por segundo. Los counters se publican siempre.
+ * @param enabled true para publicar las tasas (rx_bytes_per_second, vmstat_rate_per_second, etc.).
+ */
+void set_rate_gauges(bool enabled);
+
+/**
+ * @brief Instala las reglas de cardinalidad y registra las métricas que antes estaban denegadas.
+ *
+ * Con un tope de series registra además cardinality_dropped_samples_total{metric}.
+ *
+ * @param rules Reglas compiladas; el módulo pasa a ser su dueño. NULL quita filtros y tope.
+ */
+void install_cardinality(cardinality_rules_t* rules);
+
+/**
+ * @brief Abre el tick de los colectores: la lectura de /proc/stat que comparten cpufreq y NUMA se
+ *        toma de nuevo la primera vez que uno de ellos la pide. Se llama antes de los colectores.
+ */
+void start_tick(void);
+
+/**
+ * @brief Cierra el tick de los límites de cardinalidad: elige las series de las familias nuevas y
+ *        suma los descartes al counter de overflow. Se llama después de los colectores.
+ */
+void publish_cardinality(void);
+
+/**
+ * @brief Copia los últimos valores recolectados por las funciones update_*.
+ *
+ * Permite que el FIFO reutilice la lectura del tick en lugar de volver a leer /proc.
+ *
+ * @param sample Estructura donde se copian los valores.
+ */
+void get_last_sample(metrics_sample_t* sample);
+
+/**
+ * @brief Instante de una lectura para calcular tasas: en replay, el tiempo grabado del snapshot.
+ *
+ * Con el reloj real, reproducir acelerado dividiría los mismos avances por intervalos más cortos.
+ * Lo usan las tasas de los colectores y las ventanas de las alertas.
+ *
+ * @return Milisegundos de CLOCK_MONOTONIC, o del tiempo grabado si el replay está activo.
+ */
+int64_t sample_now_ms(void);
+
 /**
  * @brief Actualiza la métrica de uso de CPU.
  */
@@ -51,19 +122,100 @@ void update_running_processes_gauge(void);
 void update_net_stats_gauge(const char* iface);
 /**
  * @brief Función del hilo para exponer las métricas vía HTTP en el puerto 8000.
- * @param arg Argumento no utilizado.
+ *
+ * El hilo se fija a las CPUs recibidas antes de arrancar libmicrohttpd, cuyo hilo interno
+ * hereda esa afinidad.
+ *
+ * @param arg CPUs del servidor HTTP (const realtime_cpuset_t*), o NULL para no fijarlo.
  * @return NULL
  */
 void* expose_metrics(void* arg);
 
 /**
- * @brief Inicializar mutex y métricas.
+ * @brief Inicializa el mutex, el registro de Prometheus y las series de contadores.
+ *
+ * Las métricas de cada colector se crean después, al activarlo (collectors_prepare()).
  */
 void init_metrics();
 
+// Registro de las métricas de cada colector: id_metrics_register() devuelve 0 o -1
+#define COLLECTOR(id, name, label, flag, sources) int id##_metrics_register(void);
+#include "collector_list.h"
+#undef COLLECTOR
+
 /**
  * @brief Destructor de mutex
  */
 void destroy_mutex(void);
 
+/**
+ * @brief Actualiza las métricas de fragmentación del sistema desde /proc/buddyinfo y /proc/pagetypeinfo.
+ */
 void update_memory_fragmentation_gauge();
+
+/**
+ * @brief Actualiza las métricas de todos los campos de /proc/meminfo y de los contadores de /proc/vmstat.
+ */
+void update_meminfo_gauge(void);
+
+/**
+ * @brief Actualiza las métricas de /proc/pressure/{cpu,memory,io}.
+ */
+void update_psi_gauge(void);
+
+/**
+ * @brief Actualiza las tasas de /proc/interrupts y /proc/softirqs.
+ *
+ * Solo se publican las top_k celdas (interrupción, CPU) con más tasa de cada archivo, más la
+ * tasa total por CPU y el desbalance entre CPUs.
+ *
+ * @param top_k Cantidad de series por archivo (hasta IRQ_TOP_K_MAX).
+ */
+void update_interrupts_gauge(int top_k);
+
+/**
+ * @brief Actualiza la frecuencia de cada núcleo, las temperaturas, los contadores de throttling y el
+ *        uso de CPU normalizado por frecuencia.
+ *
+ * CPUs y zonas se descubren en el primer llamado; sus archivos se releen sobre descriptores abiertos.
+ */
+void update_cpufreq_gauge(void);
+
+/**
+ * @brief Actualiza las métricas por nodo NUMA: memoria, numastat, reservas remotas y uso de CPU.
+ *
+ * La topología se descubre en el primer llamado y los archivos de cada nodo se releen
+ * sobre descriptores abiertos.
+ */
+void update_numa_gauge(void);
+
+/**
+ * @brief Actualiza los contadores de /proc/net/snmp, /proc/net/netstat y /proc/net/sockstat y los sockets TCP por estado.
+ *
+ * Los estados se cuentan con NETLINK_SOCK_DIAG sobre un socket abierto en el primer llamado;
+ * en modo replay solo se publican los contadores grabados.
+ */
+void update_netproto_gauge(void);
+
+/**
+ * @brief Publica los percentiles del micro-muestreo acumulados desde el tick anterior.
+ */
+void update_microsample_gauge(void);
+
+/**
+ * @brief Publica el estado del muestreo adaptativo y notifica por el FIFO el inicio y el fin de cada ráfaga.
+ * @param scheduler Planificador ya actualizado con el tick actual.
+ */
+void update_sampling_gauge(const scheduler_t* scheduler);
+
+/**
+ * @brief Maneja un evento de trigger PSI: actualiza las métricas y lo publica en el FIFO.
+ *
+ * Se pasa como callback a psi_monitor_start() y se ejecuta en el hilo de triggers.
+ *
+ * @param trigger Trigger que se disparó.
+ * @param stats Lectura del archivo de presión en el momento del evento.
+ */
+void handle_psi_event(const psi_trigger_t* trigger, const psi_stats_t* stats);
+
+#endif // EXPOSE_METRICS_H
@@ -0,0 +1,100 @@
+/**
+ * @file interrupts.h
+ * @brief Lectura de /proc/interrupts y /proc/softirqs como matriz densa fila x CPU, y tasas top-K.
+ *
+ * Ambos archivos tienen el mismo formato: una cabecera con las columnas "CPUn" (solo las CPUs
+ * en línea) y una fila por interrupción con su contador en cada CPU. La tabla se parsea en una
+ * sola pasada a un arreglo contiguo de contadores; los buffers se reutilizan entre lecturas y
+ * solo crecen si aparecen filas o CPUs nuevas.
+ */
+
+#ifndef INTERRUPTS_H
+#define INTERRUPTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Largo máximo del nombre de una fila ("24", "NMI", "NET_RX").
+ */
+#define IRQ_NAME_MAX 16
+
+/**
+ * @brief Largo máximo de la descripción de una fila (dispositivo o texto de la fila).
+ */
+#define IRQ_DESC_MAX 48
+
+/**
+ * @brief Mayor cantidad de celdas que se puede pedir a irq_top_rates().
+ */
+#define IRQ_TOP_K_MAX 64
+
+/**
+ * @brief Identificación de una fila de la tabla.
+ */
+typedef struct
+{
+    char name[IRQ_NAME_MAX]; /**< Etiqueta antes de ':' ("24", "LOC", "TIMER"). */
+    char desc[IRQ_DESC_MAX]; /**< Dispositivo (último campo) o descripción; vacío en /proc/softirqs. */
+} irq_row_t;
+
+/**
+ * @brief Tabla de contadores: counts[fila * cpu_count + columna].
+ */
+typedef struct
+{
+    int cpu_count;     /**< Columnas (CPUs en línea). */
+    int row_count;     /**< Filas leídas. */
+    int* cpus;         /**< Número de CPU de cada columna. */
+    irq_row_t* rows;   /**< Identificación de cada fila. */
+    uint64_t* counts;  /**< Contadores, fila por fila. */
+    int cpu_cap;       /**< Capacidad de cpus. */
+    int row_cap;       /**< Capacidad de rows. */
+    size_t counts_cap; /**< Capacidad de counts, en elementos. */
+} irq_table_t;
+
+/**
+ * @brief Tasa de una celda (fila, CPU).
+ */
+typedef struct
+{
+    int row;     /**< Fila en la tabla actual. */
+    int column;  /**< Columna en la tabla actual. */
+    double rate; /**< Interrupciones por segundo. */
+} irq_cell_rate_t;
+
+/**
+ * @brief Lee un archivo con formato de /proc/interrupts o /proc/softirqs.
+ *
+ * Las filas con menos columnas que CPUs (como ERR y MIS) se completan con ceros.
+ *
+ * @param path Ruta del archivo.
+ * @param table Tabla de salida; conserva sus buffers entre llamados.
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int read_irq_table(const char* path, irq_table_t* table);
+
+/**
+ * @brief Libera los buffers de una tabla.
+ * @param table Tabla a liberar.
+ */
+void irq_table_free(irq_table_t* table);
+
+/**
+ * @brief Calcula las tasas entre dos lecturas y devuelve las k celdas con más interrupciones por segundo.
+ *
+ * Las filas se emparejan por nombre, así que una interrupción que aparece o desaparece entre
+ * lecturas no desalinea al resto. Si cambió el conjunto de CPUs en línea no hay tasas.
+ *
+ * @param prev Lectura anterior.
+ * @param cur Lectura actual.
+ * @param seconds Tiempo entre ambas lecturas.
+ * @param top Arreglo de salida de al menos k elementos, ordenado de mayor a menor tasa.
+ * @param k Cantidad de celdas pedidas (hasta IRQ_TOP_K_MAX).
+ * @param cpu_rates Si no es NULL, recibe la tasa total de cada columna (cur->cpu_count elementos).
+ * @return Cantidad de celdas en top, o -1 si las lecturas no son comparables.
+ */
+int irq_top_rates(const irq_table_t* prev, const irq_table_t* cur, double seconds, irq_cell_rate_t* top, int k,
+                  double* cpu_rates);
+
+#endif // INTERRUPTS_H
@@ -0,0 +1,145 @@
+/**
+ * @file log.h
+ * @brief Logger asíncrono: registros binarios en un ring por hilo, formateados y escritos por un hilo aparte.
+ *
+ * En el camino caliente log_write() no formatea ni toca el disco: copia el puntero al formato,
+ * los argumentos crudos (los strings por valor, porque pueden vivir en la pila) y el errno a un
+ * registro de tamaño fijo en el ring del hilo que llama. Cada hilo tiene su ring de un solo
+ * productor y un solo consumidor, así que no hay locks ni contención entre productores. Si el
+ * ring está lleno el registro se descarta y se cuenta; nunca se bloquea.
+ *
+ * El hilo escritor drena los rings cada LOG_FLUSH_MS, mezcla los registros por timestamp, los
+ * formatea y escribe cada lote con un solo writev() sobre log_file.
+ *
+ * Cada llamada tiene un sitio estático (archivo y línea) con su propio límite: a lo sumo
+ * LOG_RATE_BURST registros por ventana de LOG_RATE_WINDOW_MS. Los que exceden el límite se
+ * suprimen, y al cerrar la ventana se escribe cuántos fueron.
+ *
+ * Antes de log_start() (o en herramientas que no lo llaman) los mensajes se escriben en el
+ * momento a stderr, con el mismo límite por sitio.
+ *
+ * Formatos admitidos: los de printf sin '*' en ancho ni precisión, más %m (el errno del
+ * momento de la llamada). Se capturan hasta LOG_MAX_ARGS argumentos. El formato se analiza en
+ * la primera llamada de cada sitio; las siguientes solo copian los argumentos según esa tabla.
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Máximo de argumentos capturados por registro.
+ */
+#define LOG_MAX_ARGS 8
+
+/**
+ * @brief Registros por ring (potencia de 2).
+ */
+#define LOG_RING_RECORDS 128
+
+/**
+ * @brief Máximo de hilos con ring propio (los rings de hilos terminados se reutilizan).
+ */
+#define LOG_MAX_THREADS 32
+
+/**
+ * @brief Período del hilo escritor.
+ */
+#define LOG_FLUSH_MS 100
+
+/**
+ * @brief Registros por sitio permitidos en cada ventana.
+ */
+#define LOG_RATE_BURST 5
+
+/**
+ * @brief Duración de la ventana del límite por sitio.
+ */
+#define LOG_RATE_WINDOW_MS 10000
+
+/**
+ * @brief Nivel de un registro.
+ */
+typedef enum
+{
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO
+} log_level_t;
+
+/**
+ * @brief Sitio de una llamada al logger. Lo declaran las macros; no se usa directamente.
+ */
+typedef struct log_site
+{
+    const char* file;                /**< Archivo de la llamada. */
+    int line;                        /**< Línea de la llamada. */
+    log_level_t level;               /**< Nivel. */
+    uint32_t burst;                  /**< Registros por ventana; 0 desactiva el límite. */
+    int64_t window_start_ns;         /**< Inicio de la ventana vigente. */
+    uint32_t window_count;           /**< Registros intentados en la ventana. */
+    uint32_t suppressed;             /**< Registros suprimidos aún no informados. */
+    int registered;                  /**< 1 una vez agregado a la lista de sitios. */
+    int layout_ready;                /**< 1 una vez calculados arg_types y arg_count. */
+    uint8_t arg_count;               /**< Argumentos que se capturan del formato. */
+    uint8_t arg_types[LOG_MAX_ARGS]; /**< Tipo C de cada argumento, resuelto del formato una sola vez. */
+    struct log_site* next;           /**< Siguiente sitio de la lista. */
+} log_site_t;
+
+/**
+ * @brief Agrega un registro al ring del hilo. No bloquea ni reserva memoria (salvo el primer uso del hilo).
+ * @param site Sitio estático de la llamada.
+ * @param format Formato estilo printf; debe ser un literal (se guarda el puntero).
+ */
+void log_write(log_site_t* site, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+#define LOG_AT(site_level, site_burst, ...)                                                                          \
+    do                                                                                                               \
+    {                                                                                                                \
+        static log_site_t log_site_ = {.file = __FILE__, .line = __LINE__,                                           \
+                                       .level = site_level, .burst = site_burst};                                    \
+        log_write(&log_site_, __VA_ARGS__);                                                                          \
+    } while (0)
+
+/**
+ * @brief Error con límite por sitio.
+ */
+#define log_error(...) LOG_AT(LOG_LEVEL_ERROR, LOG_RATE_BURST, __VA_ARGS__)
+
+/**
+ * @brief Advertencia con límite por sitio.
+ */
+#define log_warn(...) LOG_AT(LOG_LEVEL_WARN, LOG_RATE_BURST, __VA_ARGS__)
+
+/**
+ * @brief Mensaje informativo con límite por sitio.
+ */
+#define log_info(...) LOG_AT(LOG_LEVEL_INFO, LOG_RATE_BURST, __VA_ARGS__)
+
+/**
+ * @brief Mensaje informativo sin límite, para cambios de estado que no deben perderse.
+ */
+#define log_event(...) LOG_AT(LOG_LEVEL_INFO, 0, __VA_ARGS__)
+
+/**
+ * @brief Abre el archivo de log y arranca el hilo escritor.
+ * @param path Archivo donde se agregan los registros; NULL o vacío escribe en stderr.
+ * @return 0 si el logger quedó activo, -1 en caso de error (los mensajes siguen yendo a stderr).
+ */
+int log_start(const char* path);
+
+/**
+ * @brief Cambia el archivo de log sin perder registros. El hilo escritor pasa al nuevo en su próximo lote.
+ * @param path Archivo nuevo; NULL o vacío escribe en stderr.
+ * @return 0 si se abrió, -1 si no (se sigue usando el anterior).
+ */
+int log_reopen(const char* path);
+
+/**
+ * @brief Detiene el hilo escritor tras drenar los rings y cierra el archivo.
+ */
+void log_stop(void);
+
+#endif // LOG_H
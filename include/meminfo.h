@@ -0,0 +1,94 @@
+/**
+ * @file meminfo.h
+ * @brief Colector completo de /proc/meminfo y de contadores seleccionados de /proc/vmstat.
+ *
+ * Cada clave se resuelve a un slot fijo mediante un hash perfecto generado por
+ * tools/gen_meminfo_keys.py, así que un parseo completo es una sola pasada sin comparar strings.
+ */
+
+#ifndef MEMINFO_H
+#define MEMINFO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Máximo de campos de /proc/meminfo con slot fijo (debe cubrir MEMINFO_FIELD_COUNT).
+ */
+#define MEMINFO_MAX_FIELDS 80
+
+/**
+ * @brief Máximo de contadores de /proc/vmstat con slot fijo (debe cubrir VMSTAT_FIELD_COUNT).
+ */
+#define VMSTAT_MAX_FIELDS 32
+
+/**
+ * @brief Valores de /proc/meminfo indexados por slot.
+ */
+typedef struct
+{
+    uint64_t values[MEMINFO_MAX_FIELDS]; /**< Valor tal como lo reporta el kernel (kB o cantidad). */
+    bool present[MEMINFO_MAX_FIELDS];    /**< true si el kernel reportó el campo. */
+} meminfo_t;
+
+/**
+ * @brief Contadores acumulados de /proc/vmstat indexados por slot.
+ */
+typedef struct
+{
+    uint64_t values[VMSTAT_MAX_FIELDS]; /**< Valor acumulado desde el arranque. */
+    bool present[VMSTAT_MAX_FIELDS];    /**< true si el kernel reportó el contador. */
+} vmstat_t;
+
+/**
+ * @brief Cantidad de campos de /proc/meminfo conocidos.
+ * @return Número de slots válidos en meminfo_t.
+ */
+int meminfo_field_count(void);
+
+/**
+ * @brief Nombre del campo de /proc/meminfo en un slot.
+ * @param field Índice de slot.
+ * @return Nombre tal como aparece en /proc/meminfo.
+ */
+const char* meminfo_field_name(int field);
+
+/**
+ * @brief Indica si el campo se reporta en kB (y por lo tanto se exporta en bytes).
+ * @param field Índice de slot.
+ * @return true si el campo está en kB, false si es una cantidad (por ejemplo, HugePages_Total).
+ */
+bool meminfo_field_in_kb(int field);
+
+/**
+ * @brief Cantidad de contadores de /proc/vmstat conocidos.
+ * @return Número de slots válidos en vmstat_t.
+ */
+int vmstat_field_count(void);
+
+/**
+ * @brief Nombre del contador de /proc/vmstat en un slot.
+ * @param field Índice de slot.
+ * @return Nombre tal como aparece en /proc/vmstat.
+ */
+const char* vmstat_field_name(int field);
+
+/**
+ * @brief Lee todos los campos de un archivo con formato de /proc/meminfo.
+ *
+ * @param path Ruta del archivo.
+ * @param info Estructura de salida; los campos ausentes quedan con present = false.
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int read_meminfo(const char* path, meminfo_t* info);
+
+/**
+ * @brief Lee los contadores seleccionados de un archivo con formato de /proc/vmstat.
+ *
+ * @param path Ruta del archivo.
+ * @param stats Estructura de salida; los contadores ausentes quedan con present = false.
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int read_vmstat(const char* path, vmstat_t* stats);
+
+#endif // MEMINFO_H
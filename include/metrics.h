@@ -3,6 +3,16 @@
  * @brief Funciones para obtener el uso de CPU y memoria desde el sistema de archivos /proc.
  */
 
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "cpufreq.h"
+#include "meminfo.h"
+#include "microsample.h"
+#include "netproto.h"
+#include "numa.h"
+#include "psi.h"
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -42,6 +52,15 @@ typedef struct
  */
 disk_stats_t get_disk_stats(const char* device);
 
+/**
+ * @brief Igual que get_disk_stats() pero leyendo de una ruta explícita.
+ *
+ * @param path Ruta del archivo con formato de /proc/diskstats.
+ * @param device Nombre del dispositivo (por ejemplo, "sda").
+ * @return Estructura disk_stats_t con los datos del dispositivo, o con reads_completed = -1 en caso de error.
+ */
+disk_stats_t read_disk_stats(const char* path, const char* device);
+
 /**
  * @brief Estructura para almacenar las estadísticas de red.
  */
@@ -60,6 +79,15 @@ typedef struct
  */
 net_stats_t get_net_stats(const char* iface);
 
+/**
+ * @brief Igual que get_net_stats() pero leyendo de una ruta explícita.
+ *
+ * @param path Ruta del archivo con formato de /proc/net/dev.
+ * @param iface Nombre de la interfaz de red.
+ * @return Estructura net_stats_t con los datos de la interfaz, o {-1, -1} en caso de error.
+ */
+net_stats_t read_net_stats(const char* path, const char* iface);
+
 /**
  * @brief Obtiene el número de cambios de contexto desde /proc/stat.
  *
@@ -67,6 +95,14 @@ net_stats_t get_net_stats(const char* iface);
  */
 long long get_context_switches(void);
 
+/**
+ * @brief Igual que get_context_switches() pero leyendo de una ruta explícita.
+ *
+ * @param path Ruta del archivo con formato de /proc/stat.
+ * @return Número de cambios de contexto, o -1 en caso de error.
+ */
+long long read_context_switches(const char* path);
+
 /**
  * @brief Obtiene el número de procesos en ejecución desde /proc/stat.
  *
@@ -74,6 +110,14 @@ long long get_context_switches(void);
  */
 int get_running_processes(void);
 
+/**
+ * @brief Igual que get_running_processes() pero leyendo de una ruta explícita.
+ *
+ * @param path Ruta del archivo con formato de /proc/stat.
+ * @return Número de procesos en ejecución, o -1 en caso de error.
+ */
+int read_running_processes(const char* path);
+
 /**
  * @brief Obtiene los datos de uso de memoria desde /proc/meminfo.
  *
@@ -82,9 +126,74 @@ int get_running_processes(void);
  */
 memory_info_t get_memory_usage(void);
 
+/**
+ * @brief Igual que get_memory_usage() pero leyendo de una ruta explícita.
+ *
+ * @param path Ruta del archivo con formato de /proc/meminfo.
+ * @return Estructura memory_info_t con los valores en MB, o {-1.0, -1.0, -1.0} en caso de error.
+ */
+memory_info_t read_memory_usage(const char* path);
+
+/**
+ * @brief Tiempos acumulados de la línea "cpu" de /proc/stat, en jiffies.
+ */
+typedef struct
+{
+    unsigned long long user;    /**< Tiempo en modo usuario. */
+    unsigned long long nice;    /**< Tiempo en modo usuario con prioridad modificada. */
+    unsigned long long system;  /**< Tiempo en modo kernel. */
+    unsigned long long idle;    /**< Tiempo inactivo. */
+    unsigned long long iowait;  /**< Tiempo esperando E/S. */
+    unsigned long long irq;     /**< Tiempo atendiendo interrupciones. */
+    unsigned long long softirq; /**< Tiempo atendiendo softirqs. */
+    unsigned long long steal;   /**< Tiempo robado por el hipervisor. */
+} cpu_times_t;
+
+/**
+ * @brief Lee los tiempos agregados de CPU de la primera línea de un archivo con formato de /proc/stat.
+ *
+ * @param path Ruta del archivo con formato de /proc/stat.
+ * @param times Estructura donde se guardan los tiempos leídos.
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int read_cpu_times(const char* path, cpu_times_t* times);
+
 /**
  * @brief Obtiene el porcentaje de uso de CPU desde /proc/stat.
  *
+ * El uso se calcula sobre el intervalo transcurrido desde el llamado anterior; el primer
+ * llamado toma dos lecturas separadas por 100 ms.
+ *
  * @return Uso de CPU como porcentaje (0.0 a 100.0), o -1.0 en caso de error.
  */
 double get_cpu_usage(void);
+
+/**
+ * @brief Últimos valores recolectados en el tick, compartidos entre Prometheus y el FIFO.
+ */
+typedef struct
+{
+    double cpu_usage;            /**< Uso de CPU en porcentaje. */
+    cpufreq_summary_t cpufreq;   /**< Frecuencia promedio, uso normalizado por frecuencia, temperatura y throttling. */
+    memory_info_t memory;        /**< Memoria total, usada y disponible en MB. */
+    disk_stats_t disk;           /**< Estadísticas del disco monitoreado. */
+    net_stats_t net;             /**< Estadísticas de la interfaz monitoreada. */
+    long long context_switches;  /**< Cambios de contexto acumulados. */
+    int running_processes;       /**< Procesos en ejecución. */
+    double memory_fragmentation; /**< Memoria libre inutilizable para una hugepage, en porcentaje. */
+    meminfo_t meminfo;           /**< Todos los campos de /proc/meminfo. */
+    double vmstat_rates[VMSTAT_MAX_FIELDS]; /**< Tasa por segundo de cada contador de vmstat (-1 si no hay). */
+    psi_stats_t psi[PSI_RESOURCE_COUNT];    /**< Última lectura de /proc/pressure por recurso. */
+    bool sampling_burst;                    /**< true si el tick pertenece a una ráfaga del muestreo adaptativo. */
+    int sampling_interval_ms;               /**< Intervalo hasta el próximo tick. */
+    microsample_summary_t micro;            /**< Percentiles del micro-muestreo del intervalo. */
+    double irq_rate;                        /**< Interrupciones por segundo, todas las CPUs. */
+    double softirq_rate;                    /**< Softirqs por segundo, todas las CPUs. */
+    double irq_imbalance;                   /**< Tasa de la CPU con más interrupciones sobre el promedio. */
+    int numa_node_count;                    /**< Nodos válidos en numa. */
+    numa_node_stats_t numa[NUMA_MAX_NODES]; /**< Memoria, numastat y uso de CPU por nodo NUMA. */
+    netproto_stats_t netproto;              /**< Contadores de snmp/netstat/sockstat y sockets TCP por estado. */
+    double tcp_retransmit_ratio;            /**< Segmentos retransmitidos sobre enviados en el intervalo (-1 si no hay). */
+} metrics_sample_t;
+
+#endif // METRICS_H
@@ -0,0 +1,25 @@
+/**
+ * @file metrics_json.h
+ * @brief Serialización a JSON de una muestra de métricas para el FIFO de la shell.
+ */
+
+#ifndef METRICS_JSON_H
+#define METRICS_JSON_H
+
+#include "config.h"
+#include "metrics.h"
+
+/**
+ * @brief Codifica las métricas habilitadas de una muestra como JSON.
+ *
+ * Tanto el árbol de cJSON como el texto resultante se reservan en el arena del tick, así que
+ * el resultado es válido hasta tick_arena_reset() y no debe liberarse.
+ *
+ * @param config Configuración con las métricas habilitadas.
+ * @param sample Muestra a codificar.
+ * @param length Salida con la longitud del texto, sin el terminador.
+ * @return Texto JSON terminado en NUL, o NULL si no hay memoria.
+ */
+char* metrics_json_encode(const config_t* config, const metrics_sample_t* sample, size_t* length);
+
+#endif // METRICS_JSON_H
@@ -0,0 +1,74 @@
+/**
+ * @file microsample.h
+ * @brief Micro-muestreo de /proc/stat dentro del intervalo: percentiles de CPU y de procs_running.
+ *
+ * Un hilo dedicado relee /proc/stat cada pocos milisegundos sobre un descriptor abierto y
+ * vuelca el uso de CPU de cada sub-intervalo y procs_running en sketches de cuantiles. En cada
+ * tick el hilo principal toma el resumen (mínimo, p50, p90, p99 y máximo) y los sketches se
+ * vacían, de modo que las ráfagas cortas que el promedio del intervalo oculta quedan visibles.
+ *
+ * El hilo mide su propio tiempo de CPU, incluido el costo de despertar en cada intervalo; si
+ * supera MICROSAMPLE_OVERHEAD_BUDGET duplica su intervalo. Pasa en hosts con cientos de CPUs,
+ * donde /proc/stat es caro de generar, y en VMs donde cada despertar con la cache fría cuesta
+ * decenas de microsegundos.
+ */
+
+#ifndef MICROSAMPLE_H
+#define MICROSAMPLE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Costo máximo del muestreador, en porcentaje de un núcleo.
+ */
+#define MICROSAMPLE_OVERHEAD_BUDGET 0.5
+
+/**
+ * @brief Intervalo máximo al que el muestreador se degrada para respetar el presupuesto.
+ */
+#define MICROSAMPLE_MAX_INTERVAL_MS 1000
+
+/**
+ * @brief Distribución de una señal dentro de un intervalo.
+ */
+typedef struct
+{
+    double min;     /**< Valor mínimo. */
+    double p50;     /**< Mediana. */
+    double p90;     /**< Percentil 90. */
+    double p99;     /**< Percentil 99. */
+    double max;     /**< Valor máximo. */
+    uint64_t count; /**< Muestras en el intervalo. */
+} quantile_summary_t;
+
+/**
+ * @brief Resumen del micro-muestreo de un intervalo.
+ */
+typedef struct
+{
+    quantile_summary_t cpu_usage;         /**< Uso de CPU (%) de cada sub-intervalo. */
+    quantile_summary_t running_processes; /**< procs_running en cada muestra. */
+    double overhead_percent;              /**< CPU del hilo muestreador, en porcentaje de un núcleo. */
+    int interval_ms;                      /**< Intervalo de muestreo vigente. */
+} microsample_summary_t;
+
+/**
+ * @brief Arranca el hilo de micro-muestreo.
+ * @param interval_ms Intervalo entre lecturas de /proc/stat.
+ * @return 0 si el hilo arrancó, -1 en caso de error.
+ */
+int microsample_start(int interval_ms);
+
+/**
+ * @brief Detiene el hilo de micro-muestreo y libera sus recursos.
+ */
+void microsample_stop(void);
+
+/**
+ * @brief Toma el resumen de las muestras acumuladas desde el llamado anterior y las descarta.
+ * @param summary Resumen de salida.
+ * @return 0 si había muestras, -1 si el muestreador no está activo o no hubo muestras.
+ */
+int microsample_collect(microsample_summary_t* summary);
+
+#endif // MICROSAMPLE_H
@@ -0,0 +1,147 @@
+/**
+ * @file netproto.h
+ * @brief Contadores de protocolos de red (/proc/net/snmp, /proc/net/netstat, /proc/net/sockstat) y
+ *        sockets TCP por estado vía NETLINK_SOCK_DIAG.
+ *
+ * snmp y netstat tienen el mismo formato: pares de líneas "Proto: nombres..." y
+ * "Proto: valores...". Se guardan solo los contadores de netproto_counter_name().
+ *
+ * Contar sockets por estado recorriendo /proc/net/tcp es inviable con cientos de miles de
+ * conexiones. En su lugar se pide al kernel un volcado de inet_diag con el filtro de estados
+ * ya aplicado, sin extensiones, y solo para los estados que suelen ser pocos. ESTABLISHED y
+ * TIME_WAIT, que son la gran mayoría en un host cargado, salen de contadores que el kernel
+ * ya mantiene: CurrEstab de /proc/net/snmp y "tw" de /proc/net/sockstat.
+ */
+
+#ifndef NETPROTO_H
+#define NETPROTO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Cantidad de contadores de snmp/netstat con slot fijo.
+ */
+#define NETPROTO_COUNTERS 29
+
+/**
+ * @brief Slots de estados TCP, indexados por el número de estado del kernel (TCP_ESTABLISHED = 1 ...).
+ */
+#define NETPROTO_TCP_STATES 12
+
+/**
+ * @brief Campos de /proc/net/sockstat que se leen.
+ */
+typedef enum
+{
+    SOCKSTAT_TCP_INUSE,
+    SOCKSTAT_TCP_ORPHAN,
+    SOCKSTAT_TCP_TW,
+    SOCKSTAT_TCP_ALLOC,
+    SOCKSTAT_TCP_MEM,
+    SOCKSTAT_UDP_INUSE,
+    SOCKSTAT_FIELD_COUNT
+} sockstat_field_t;
+
+/**
+ * @brief Lectura de los contadores de protocolo.
+ */
+typedef struct
+{
+    uint64_t counters[NETPROTO_COUNTERS];        /**< Valor de cada contador de snmp/netstat. */
+    bool present[NETPROTO_COUNTERS];             /**< true si el kernel reportó el contador. */
+    uint64_t sockstat[SOCKSTAT_FIELD_COUNT];     /**< Campos de /proc/net/sockstat. */
+    bool have_sockstat;                          /**< true si se leyó /proc/net/sockstat. */
+    uint64_t tcp_states[NETPROTO_TCP_STATES];    /**< Sockets TCP (IPv4 + IPv6) por estado. */
+    bool have_states;                            /**< true si se pudo consultar sock_diag. */
+    double listen_queue_ratio;                   /**< Mayor ocupación de la cola de accept entre los sockets en LISTEN. */
+} netproto_stats_t;
+
+/**
+ * @brief Nombre de un contador de snmp/netstat.
+ * @param counter Índice de slot.
+ * @return Nombre tal como aparece en la cabecera ("RetransSegs", "ListenOverflows").
+ */
+const char* netproto_counter_name(int counter);
+
+/**
+ * @brief Protocolo de un contador de snmp/netstat.
+ * @param counter Índice de slot.
+ * @return Prefijo de la línea sin ':' ("Tcp", "TcpExt").
+ */
+const char* netproto_counter_proto(int counter);
+
+/**
+ * @brief Índice de slot de un contador.
+ * @param proto Protocolo ("Tcp").
+ * @param name Nombre del contador ("CurrEstab").
+ * @return Índice de slot, o -1 si no se registra.
+ */
+int netproto_counter_index(const char* proto, const char* name);
+
+/**
+ * @brief Nombre en minúsculas de un estado TCP ("established", "listen").
+ * @param state Número de estado del kernel.
+ * @return Nombre, o NULL si el estado no existe.
+ */
+const char* netproto_tcp_state_name(int state);
+
+/**
+ * @brief Nombre de un campo de /proc/net/sockstat ("tcp_tw", "udp_inuse").
+ * @param field Campo.
+ * @return Nombre con el protocolo como prefijo.
+ */
+const char* sockstat_field_name(sockstat_field_t field);
+
+/**
+ * @brief Lee los contadores de un archivo con formato de /proc/net/snmp o /proc/net/netstat.
+ *
+ * Los contadores ya presentes en stats se conservan, así que se pueden leer ambos archivos
+ * sobre la misma estructura.
+ *
+ * @param path Ruta del archivo.
+ * @param stats Estructura a completar.
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int read_proto_counters(const char* path, netproto_stats_t* stats);
+
+/**
+ * @brief Lee las líneas TCP y UDP de un archivo con formato de /proc/net/sockstat.
+ *
+ * @param path Ruta del archivo.
+ * @param stats Estructura a completar.
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int read_sockstat(const char* path, netproto_stats_t* stats);
+
+/**
+ * @brief Abre el socket de NETLINK_SOCK_DIAG que se reutiliza en cada tick.
+ * @return Descriptor del socket, o -1 en caso de error.
+ */
+int sock_diag_open(void);
+
+/**
+ * @brief Cuenta los sockets TCP de los estados pedidos con un volcado de inet_diag por familia.
+ *
+ * El filtro de estados se aplica en el kernel; los mensajes se procesan sin copiarlos.
+ *
+ * @param fd Socket devuelto por sock_diag_open().
+ * @param states Máscara de estados (bit 1 << estado).
+ * @param stats Estructura a completar: tcp_states de los estados pedidos y listen_queue_ratio.
+ * @return 0 si ambos volcados terminaron bien, -1 en caso de error.
+ */
+int sock_diag_count_tcp(int fd, uint32_t states, netproto_stats_t* stats);
+
+/**
+ * @brief Lee snmp, netstat y sockstat bajo la raíz de /proc y completa los estados TCP.
+ *
+ * Los estados poco poblados se cuentan con sock_diag (si diag_fd es válido); ESTABLISHED
+ * se deriva de CurrEstab y TIME_WAIT de sockstat.
+ *
+ * @param diag_fd Socket de sock_diag, o -1 para no contar estados.
+ * @param stats Estructura de salida; se reinicia antes de leer.
+ * @return 0 si se leyó /proc/net/snmp, -1 en caso de error.
+ */
+int netproto_read(int diag_fd, netproto_stats_t* stats);
+
+#endif // NETPROTO_H
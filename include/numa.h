@@ -0,0 +1,115 @@
+/**
+ * @file numa.h
+ * @brief Topología NUMA desde /sys y memoria, numastat y uso de CPU por nodo.
+ *
+ * La topología (nodos en línea y CPUs de cada nodo) se descubre una sola vez desde
+ * /sys/devices/system/node y /sys/devices/system/cpu. En cada tick se releen nodeN/meminfo y
+ * nodeN/numastat sobre descriptores que quedan abiertos, y el uso de CPU de cada nodo se obtiene
+ * sumando el avance de sus CPUs en la lectura de /proc/stat del tick (cpu_stat.h).
+ *
+ * En kernels sin NUMA (no existe /sys/devices/system/node) se reporta un único nodo 0 con
+ * todas las CPUs y sin datos de memoria.
+ */
+
+#ifndef NUMA_H
+#define NUMA_H
+
+#include "cpu_stat.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Máximo de nodos que se registran; los que sobran se ignoran con un aviso.
+ */
+#define NUMA_MAX_NODES 16
+
+/**
+ * @brief Campos de nodeN/meminfo que se leen (todos en kB, se guardan en bytes).
+ */
+#define NUMA_MEM_FIELDS 10
+
+/**
+ * @brief Contadores de nodeN/numastat que se leen (en páginas).
+ */
+#define NUMA_STAT_FIELDS 6
+
+/**
+ * @brief Un nodo de la topología.
+ */
+typedef struct
+{
+    int id;          /**< Número de nodo (pueden no ser consecutivos). */
+    int cpu_count;   /**< CPUs asignadas al nodo. */
+    int meminfo_fd;  /**< Descriptor abierto de nodeN/meminfo, o -1. */
+    int numastat_fd; /**< Descriptor abierto de nodeN/numastat, o -1. */
+    uint64_t prev_local;  /**< local_node de la lectura anterior. */
+    uint64_t prev_remote; /**< other_node de la lectura anterior. */
+} numa_node_t;
+
+/**
+ * @brief Topología descubierta y estado entre lecturas.
+ */
+typedef struct
+{
+    bool has_sysfs;                    /**< false si el kernel no expone nodos (un solo nodo implícito). */
+    int node_count;                    /**< Nodos válidos en nodes. */
+    numa_node_t nodes[NUMA_MAX_NODES]; /**< Nodos en línea. */
+    int cpu_slots;                     /**< Tamaño de cpu_node (mayor CPU posible + 1). */
+    int* cpu_node;                     /**< Índice en nodes de cada CPU, o -1. */
+} numa_topology_t;
+
+/**
+ * @brief Lectura de un nodo.
+ */
+typedef struct
+{
+    int node;                         /**< Número de nodo. */
+    int cpu_count;                    /**< CPUs del nodo. */
+    bool have_memory;                 /**< true si se leyeron meminfo y numastat del nodo. */
+    uint64_t mem[NUMA_MEM_FIELDS];    /**< Campos de meminfo, en bytes. */
+    uint64_t stat[NUMA_STAT_FIELDS];  /**< Contadores de numastat, en páginas. */
+    double cpu_usage;                 /**< Uso de CPU del nodo en porcentaje, o -1 sin intervalo. */
+    double remote_ratio;              /**< Fracción de las reservas del intervalo servidas desde otro nodo, o -1. */
+} numa_node_stats_t;
+
+/**
+ * @brief Nombre de un campo de meminfo por nodo.
+ * @param field Índice entre 0 y NUMA_MEM_FIELDS - 1.
+ * @return Nombre tal como aparece en nodeN/meminfo.
+ */
+const char* numa_mem_field_name(int field);
+
+/**
+ * @brief Nombre de un contador de numastat.
+ * @param field Índice entre 0 y NUMA_STAT_FIELDS - 1.
+ * @return Nombre tal como aparece en nodeN/numastat.
+ */
+const char* numa_stat_field_name(int field);
+
+/**
+ * @brief Descubre los nodos y sus CPUs y abre los descriptores que se releen en cada tick.
+ *
+ * En modo replay no se dejan descriptores abiertos, porque la raíz cambia en cada tick.
+ *
+ * @param topo Topología de salida.
+ * @return 0 si se descubrió al menos un nodo, -1 en caso de error.
+ */
+int numa_topology_discover(numa_topology_t* topo);
+
+/**
+ * @brief Cierra los descriptores y libera los arreglos de la topología.
+ * @param topo Topología a liberar.
+ */
+void numa_topology_free(numa_topology_t* topo);
+
+/**
+ * @brief Lee memoria y numastat de cada nodo y suma el uso de CPU de sus CPUs.
+ *
+ * @param topo Topología descubierta; guarda numastat para el próximo intervalo.
+ * @param cpu_stat Lectura de /proc/stat del tick, o NULL si falló (el uso queda en -1).
+ * @param stats Arreglo de salida de topo->node_count elementos.
+ * @return Cantidad de nodos leídos.
+ */
+int numa_read(numa_topology_t* topo, const cpu_stat_t* cpu_stat, numa_node_stats_t* stats);
+
+#endif // NUMA_H
@@ -0,0 +1,213 @@
+/**
+ * @file parse.h
+ * @brief Parsers de texto de /proc sin sscanf ni locale.
+ *
+ * Todas las funciones trabajan sobre un rango [p, end) de un buffer ya leído. Los números
+ * son decimales sin signo; con 8 dígitos disponibles se convierten de a bloques (SWAR)
+ * y el resto dígito a dígito. La separación de líneas usa memchr.
+ */
+
+#ifndef PARSE_H
+#define PARSE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Indica si c es un dígito decimal.
+ * @param c Carácter a evaluar.
+ * @return true si c está entre '0' y '9'.
+ */
+static inline bool parse_is_digit(char c)
+{
+    return (unsigned char)(c - '0') < 10;
+}
+
+/**
+ * @brief Avanza sobre espacios y tabulaciones (no cruza saltos de línea).
+ * @param p Posición actual.
+ * @param end Fin del buffer.
+ * @return Primera posición que no es espacio, o end.
+ */
+static inline const char* parse_skip_spaces(const char* p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t'))
+    {
+        p++;
+    }
+    return p;
+}
+
+/**
+ * @brief Avanza sobre el relleno de espacios de una columna alineada, de a 8 bytes.
+ *
+ * Pensado para tablas anchas como /proc/interrupts, donde cada número está alineado a la
+ * derecha en una columna con varios espacios delante. Solo salta ' ' (no tabulaciones).
+ *
+ * @param p Posición actual.
+ * @param end Fin del buffer.
+ * @return Primera posición que no es espacio, o end.
+ */
+static inline const char* parse_skip_padding(const char* p, const char* end)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (end - p >= 8)
+    {
+        uint64_t chunk;
+        memcpy(&chunk, p, sizeof(chunk));
+        uint64_t diff = chunk ^ 0x2020202020202020ULL; // Bytes en cero donde hay espacios
+        if (diff != 0)
+        {
+            return p + (__builtin_ctzll(diff) >> 3);
+        }
+        p += 8;
+    }
+#endif
+    while (p < end && *p == ' ')
+    {
+        p++;
+    }
+    return p;
+}
+
+/**
+ * @brief Avanza sobre una palabra (hasta el próximo espacio, tabulación o salto de línea).
+ * @param p Posición actual.
+ * @param end Fin del buffer.
+ * @return Posición del separador, o end.
+ */
+static inline const char* parse_skip_token(const char* p, const char* end)
+{
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\n')
+    {
+        p++;
+    }
+    return p;
+}
+
+/**
+ * @brief Busca el fin de la línea que empieza en p.
+ * @param p Posición actual.
+ * @param end Fin del buffer.
+ * @return Posición del '\n', o end si es la última línea.
+ */
+static inline const char* parse_line_end(const char* p, const char* end)
+{
+    const char* nl = memchr(p, '\n', (size_t)(end - p));
+    return nl != NULL ? nl : end;
+}
+
+/**
+ * @brief Devuelve el comienzo de la línea siguiente.
+ * @param p Posición actual.
+ * @param end Fin del buffer.
+ * @return Primer carácter de la línea siguiente, o end.
+ */
+static inline const char* parse_next_line(const char* p, const char* end)
+{
+    const char* nl = parse_line_end(p, end);
+    return nl < end ? nl + 1 : end;
+}
+
+/**
+ * @brief Indica si el rango empieza con el prefijo dado.
+ * @param p Posición actual.
+ * @param end Fin del buffer.
+ * @param prefix Prefijo a comparar.
+ * @param len Largo del prefijo.
+ * @return true si coincide.
+ */
+static inline bool parse_starts_with(const char* p, const char* end, const char* prefix, size_t len)
+{
+    return (size_t)(end - p) >= len && memcmp(p, prefix, len) == 0;
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+/**
+ * @brief Indica si los 8 bytes cargados en v son todos dígitos ASCII.
+ * @param v Ocho caracteres cargados en little endian.
+ * @return true si los 8 son dígitos.
+ */
+static inline bool parse_is_eight_digits(uint64_t v)
+{
+    return (((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+            0x3333333333333333ULL);
+}
+
+/**
+ * @brief Convierte 8 dígitos ASCII cargados en little endian con tres multiplicaciones.
+ * @param v Ocho dígitos cargados en little endian.
+ * @return Valor decimal de los 8 dígitos.
+ */
+static inline uint32_t parse_eight_digits(uint64_t v)
+{
+    v -= 0x3030303030303030ULL;
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+        32;
+    return (uint32_t)v;
+}
+#endif
+
+/**
+ * @brief Convierte el número decimal sin signo que empieza en *p y avanza *p al final.
+ *
+ * No salta espacios iniciales. Si no hay dígitos devuelve 0 y no avanza.
+ *
+ * @param p Puntero a la posición actual; queda después del último dígito.
+ * @param end Fin del buffer.
+ * @return Valor convertido.
+ */
+static inline uint64_t parse_u64(const char** p, const char* end)
+{
+    const char* s = *p;
+    uint64_t value = 0;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (end - s >= 8)
+    {
+        uint64_t chunk;
+        memcpy(&chunk, s, sizeof(chunk));
+        if (!parse_is_eight_digits(chunk))
+        {
+            break;
+        }
+        value = value * 100000000ULL + parse_eight_digits(chunk);
+        s += 8;
+    }
+#endif
+    while (s < end && parse_is_digit(*s))
+    {
+        value = value * 10 + (uint64_t)(*s - '0');
+        s++;
+    }
+    *p = s;
+    return value;
+}
+
+/**
+ * @brief Convierte hasta max números separados por espacios, sin pasar del fin de línea.
+ *
+ * @param p Posición del primer número (se admiten espacios previos).
+ * @param end Fin del buffer.
+ * @param values Arreglo de salida.
+ * @param max Cantidad máxima de números a convertir.
+ * @return Cantidad de números convertidos.
+ */
+size_t parse_u64_fields(const char* p, const char* end, uint64_t* values, size_t max);
+
+/**
+ * @brief Busca la primera línea que empieza con el prefijo dado.
+ *
+ * @param buf Comienzo del buffer.
+ * @param end Fin del buffer.
+ * @param prefix Prefijo de la línea (por ejemplo, "ctxt ").
+ * @param len Largo del prefijo.
+ * @return Posición inmediatamente después del prefijo, o NULL si no hay tal línea.
+ */
+const char* parse_find_line(const char* buf, const char* end, const char* prefix, size_t len);
+
+#endif // PARSE_H
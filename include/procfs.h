@@ -0,0 +1,188 @@
+/**
+ * @file procfs.h
+ * @brief Raíz configurable de /proc y /sys, y modo replay sobre snapshots grabados.
+ *
+ * Los colectores nunca usan rutas absolutas: piden la ruta relativa a procfs_path() o
+ * sysfs_path(). En modo replay la raíz apunta a un snapshot de un directorio grabado
+ * (`<dir>/<timestamp_ms>/proc`, `<dir>/<timestamp_ms>/sys`) y avanza en cada tick.
+ *
+ * Opcionalmente las lecturas del hilo de muestreo se hacen por lotes: procfs_read() recuerda los
+ * archivos que se leen en cada tick y los mantiene abiertos; al inicio del tick siguiente
+ * procfs_batch_begin() los relee todos juntos (un envío a io_uring, o un pread por archivo si
+ * io_uring no está disponible) y procfs_read() copia el resultado del lote sin tocar el kernel.
+ */
+
+#ifndef PROCFS_H
+#define PROCFS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Tamaño máximo de una ruta construida por procfs_path() o sysfs_path().
+ */
+#define PROCFS_PATH_MAX 512
+
+/**
+ * @brief Backend de las lecturas por lote.
+ */
+typedef enum
+{
+    PROCFS_BATCH_OFF,     /**< open/read/close en cada procfs_read() */
+    PROCFS_BATCH_PREAD,   /**< Descriptores abiertos entre ticks y un pread por archivo al inicio del tick */
+    PROCFS_BATCH_IO_URING /**< Todas las lecturas del tick en un solo envío a io_uring, con buffers fijos */
+} procfs_batch_backend_t;
+
+/**
+ * @brief Contadores acumulados del lector, para comparar backends.
+ */
+typedef struct
+{
+    unsigned long long syscalls; /**< Llamadas al sistema hechas para leer (open, read, pread, close, io_uring_enter...) */
+    unsigned long long batched;  /**< Lecturas servidas desde el lote del tick */
+    unsigned long long direct;   /**< Lecturas hechas con open/read/close */
+} procfs_stats_t;
+
+/**
+ * @brief Buffer reutilizable para leer archivos completos de /proc o /sys.
+ *
+ * Crece solo cuando el contenido no entra; en régimen estable una lectura no asigna memoria.
+ */
+typedef struct
+{
+    char* data; /**< Contenido leído, terminado en '\0'. */
+    size_t len; /**< Bytes leídos (sin contar el '\0'). */
+    size_t cap; /**< Capacidad reservada. */
+} procfs_buf_t;
+
+/**
+ * @brief Lee un archivo completo con open/read en un buffer reutilizable.
+ *
+ * @param path Ruta del archivo.
+ * @param buf Buffer de destino; se agranda si hace falta.
+ * @return 0 si la lectura fue correcta, -1 en caso de error (errno indica la causa).
+ */
+int procfs_read(const char* path, procfs_buf_t* buf);
+
+/**
+ * @brief Vuelve a leer completo un archivo ya abierto, sin pagar open/close en cada lectura.
+ *
+ * Pensado para muestreadores de alta frecuencia que mantienen abierto el descriptor.
+ *
+ * @param fd Descriptor abierto del archivo.
+ * @param buf Buffer de destino; se agranda si hace falta.
+ * @return 0 si la lectura fue correcta, -1 en caso de error (errno indica la causa).
+ */
+int procfs_read_fd(int fd, procfs_buf_t* buf);
+
+/**
+ * @brief Elige el backend de las lecturas por lote y cierra los descriptores del backend anterior.
+ *
+ * Se llama desde el hilo de muestreo, al arrancar o al recargar la configuración; con
+ * PROCFS_BATCH_OFF libera todo. Si io_uring no está disponible (kernel viejo o bloqueado por
+ * seccomp) se usa PROCFS_BATCH_PREAD.
+ *
+ * @param backend Backend pedido.
+ * @return Backend en uso.
+ */
+procfs_batch_backend_t procfs_batch_init(procfs_batch_backend_t backend);
+
+/**
+ * @brief Relee juntos todos los archivos leídos en los ticks anteriores.
+ *
+ * Desde esta llamada hasta procfs_batch_end(), procfs_read() en el mismo hilo sirve esos archivos
+ * desde el lote. No hace nada con el backend PROCFS_BATCH_OFF ni en modo replay.
+ */
+void procfs_batch_begin(void);
+
+/**
+ * @brief Cierra el lote del tick y olvida los archivos que dejaron de leerse.
+ */
+void procfs_batch_end(void);
+
+/**
+ * @brief Nombre de un backend, como se escribe en config.json ("off", "pread", "io_uring").
+ */
+const char* procfs_batch_name(procfs_batch_backend_t backend);
+
+/**
+ * @brief Copia los contadores acumulados del lector.
+ * @param stats Destino.
+ */
+void procfs_stats_get(procfs_stats_t* stats);
+
+/**
+ * @brief Cambia las raíces de /proc y /sys.
+ *
+ * Las rutas nuevas se escriben en un buffer distinto del publicado y se publican con un store
+ * release. El buffer anterior se reutiliza recién en el llamado siguiente: quien tenga hilos
+ * leyendo la raíz anterior debe detenerlos antes de volver a cambiarla.
+ *
+ * @param proc_root Directorio que reemplaza a /proc; NULL o vacío usa /proc.
+ * @param sys_root Directorio que reemplaza a /sys; NULL o vacío usa /sys.
+ */
+void procfs_set_root(const char* proc_root, const char* sys_root);
+
+/**
+ * @brief Construye la ruta de un archivo de /proc bajo la raíz actual.
+ *
+ * @param rel Ruta relativa a /proc (por ejemplo, "stat" o "net/dev").
+ * @param buf Buffer de salida.
+ * @param len Tamaño del buffer.
+ * @return Puntero a buf.
+ */
+const char* procfs_path(const char* rel, char* buf, size_t len);
+
+/**
+ * @brief Construye la ruta de un archivo de /sys bajo la raíz actual.
+ *
+ * @param rel Ruta relativa a /sys (por ejemplo, "devices/system/node").
+ * @param buf Buffer de salida.
+ * @param len Tamaño del buffer.
+ * @return Puntero a buf.
+ */
+const char* sysfs_path(const char* rel, char* buf, size_t len);
+
+/**
+ * @brief Abre un directorio de snapshots grabados y apunta las raíces al primero.
+ *
+ * Cada subdirectorio cuyo nombre es un timestamp en milisegundos es un snapshot.
+ *
+ * @param dir Directorio de grabación.
+ * @param speed Factor de aceleración respecto del tiempo grabado; 0 reproduce sin esperas.
+ * @param loop Si es true vuelve al primer snapshot al llegar al final.
+ * @return 0 si se encontró al menos un snapshot, -1 en caso de error.
+ */
+int procfs_replay_open(const char* dir, double speed, bool loop);
+
+/**
+ * @brief Indica si el modo replay está activo.
+ * @return true si hay un directorio de snapshots abierto.
+ */
+bool procfs_replay_active(void);
+
+/**
+ * @brief Avanza al siguiente snapshot.
+ *
+ * @return Microsegundos a esperar antes del próximo tick (tiempo grabado dividido por la velocidad),
+ *         o -1 si la grabación terminó y no se reproduce en bucle.
+ */
+long procfs_replay_advance(void);
+
+/**
+ * @brief Tiempo grabado del snapshot vigente, para calcular tasas sin que influya la velocidad.
+ *
+ * Parte del timestamp del primer snapshot y suma cada intervalo avanzado, también el que se
+ * repite al volver al principio en bucle, así nunca retrocede.
+ *
+ * @return Milisegundos, o -1 si el modo replay no está activo.
+ */
+int64_t procfs_replay_now_ms(void);
+
+/**
+ * @brief Cierra el modo replay y restaura /proc y /sys.
+ */
+void procfs_replay_close(void);
+
+#endif // PROCFS_H
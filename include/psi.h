@@ -0,0 +1,120 @@
+/**
+ * @file psi.h
+ * @brief Colector de pressure stall information (/proc/pressure/{cpu,memory,io}) con triggers del kernel.
+ *
+ * Además de la lectura periódica de los promedios, se pueden registrar triggers: se escribe
+ * "some|full <stall_us> <window_us>" en el archivo de presión y el kernel marca POLLPRI cuando
+ * el tiempo de stall dentro de la ventana supera el umbral. Un hilo dedicado espera esos
+ * eventos con poll(), así que un stall se detecta en milisegundos y no en el próximo tick.
+ */
+
+#ifndef PSI_H
+#define PSI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Máximo de triggers registrados a la vez.
+ */
+#define PSI_MAX_TRIGGERS 8
+
+/**
+ * @brief Recursos con información de presión.
+ */
+typedef enum
+{
+    PSI_CPU,
+    PSI_MEMORY,
+    PSI_IO,
+    PSI_RESOURCE_COUNT
+} psi_resource_t;
+
+/**
+ * @brief Una línea de un archivo de presión ("some" o "full").
+ */
+typedef struct
+{
+    bool present;      /**< true si el kernel reportó la línea. */
+    double avg10;      /**< Porcentaje de tiempo en stall en los últimos 10 s. */
+    double avg60;      /**< Porcentaje de tiempo en stall en los últimos 60 s. */
+    double avg300;     /**< Porcentaje de tiempo en stall en los últimos 300 s. */
+    uint64_t total_us; /**< Tiempo total en stall desde el arranque, en microsegundos. */
+} psi_line_t;
+
+/**
+ * @brief Contenido de un archivo de presión.
+ */
+typedef struct
+{
+    psi_line_t some; /**< Al menos una tarea en stall. */
+    psi_line_t full; /**< Todas las tareas no ociosas en stall a la vez. */
+} psi_stats_t;
+
+/**
+ * @brief Umbral de stall que dispara un evento.
+ */
+typedef struct
+{
+    psi_resource_t resource; /**< Recurso a vigilar. */
+    bool full;               /**< true para "full", false para "some". */
+    uint32_t stall_us;       /**< Tiempo de stall que dispara el evento. */
+    uint32_t window_us;      /**< Ventana de tiempo en la que se acumula el stall. */
+} psi_trigger_t;
+
+/**
+ * @brief Función llamada desde el hilo de triggers cada vez que el kernel reporta un evento.
+ * @param trigger Trigger que se disparó.
+ * @param stats Lectura del archivo de presión en el momento del evento.
+ */
+typedef void (*psi_event_cb)(const psi_trigger_t* trigger, const psi_stats_t* stats);
+
+/**
+ * @brief Nombre de un recurso tal como aparece en /proc/pressure.
+ * @param resource Recurso.
+ * @return "cpu", "memory" o "io".
+ */
+const char* psi_resource_name(psi_resource_t resource);
+
+/**
+ * @brief Busca un recurso por nombre.
+ * @param name "cpu", "memory" o "io".
+ * @return Recurso, o -1 si el nombre no es válido.
+ */
+int psi_resource_from_name(const char* name);
+
+/**
+ * @brief Lee un archivo con formato de /proc/pressure/<recurso>.
+ *
+ * @param path Ruta del archivo.
+ * @param stats Estructura de salida; las líneas ausentes quedan con present = false.
+ * @return 0 si la lectura fue correcta, -1 en caso de error.
+ */
+int read_psi(const char* path, psi_stats_t* stats);
+
+/**
+ * @brief Triggers por defecto: "some" de 150 ms por segundo en cpu, memory e io.
+ * @param triggers Arreglo de salida con al menos PSI_RESOURCE_COUNT posiciones.
+ * @return Cantidad de triggers escritos.
+ */
+int psi_default_triggers(psi_trigger_t* triggers);
+
+/**
+ * @brief Registra los triggers y lanza el hilo que espera sus eventos.
+ *
+ * Los triggers que el kernel rechaza (umbral inválido, sin permisos, kernel sin PSI) se
+ * informan por stderr y se omiten; el resto sigue funcionando.
+ *
+ * @param triggers Triggers a registrar.
+ * @param count Cantidad de triggers (como máximo PSI_MAX_TRIGGERS).
+ * @param callback Función a llamar por cada evento.
+ * @return 0 si se registró al menos un trigger, -1 en caso contrario.
+ */
+int psi_monitor_start(const psi_trigger_t* triggers, int count, psi_event_cb callback);
+
+/**
+ * @brief Detiene el hilo de triggers y cierra sus archivos. No hace nada si no estaba activo.
+ */
+void psi_monitor_stop(void);
+
+#endif // PSI_H
@@ -0,0 +1,68 @@
+/**
+ * @file quantile.h
+ * @brief Sketch de cuantiles con error relativo acotado (buckets logarítmicos, estilo DDSketch).
+ *
+ * Cada valor positivo cae en el bucket ceil(log_gamma(v)), con gamma = (1 + a) / (1 - a); el
+ * cuantil estimado difiere del real en a lo sumo un factor a relativo. La memoria es fija, la
+ * inserción es O(1) y no reserva memoria, así que puede alimentarse desde un hilo de muestreo
+ * de alta frecuencia. El mínimo y el máximo se guardan exactos.
+ */
+
+#ifndef QUANTILE_H
+#define QUANTILE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Cantidad de buckets del sketch.
+ */
+#define QSKETCH_BUCKETS 1024
+
+/**
+ * @brief Menor valor distinguible de cero; los valores menores se cuentan en el bucket cero.
+ */
+#define QSKETCH_MIN_VALUE 1e-3
+
+/**
+ * @brief Sketch de cuantiles.
+ */
+typedef struct
+{
+    double log_gamma;                  /**< log(gamma). */
+    int min_key;                       /**< Clave del primer bucket. */
+    uint64_t count;                    /**< Valores insertados. */
+    uint64_t zero_count;               /**< Valores menores que QSKETCH_MIN_VALUE. */
+    double min;                        /**< Menor valor insertado. */
+    double max;                        /**< Mayor valor insertado. */
+    uint32_t buckets[QSKETCH_BUCKETS]; /**< Conteo por bucket logarítmico. */
+} qsketch_t;
+
+/**
+ * @brief Inicializa un sketch vacío.
+ * @param sketch Sketch a inicializar.
+ * @param relative_accuracy Error relativo máximo de los cuantiles (por ejemplo 0.01).
+ */
+void qsketch_init(qsketch_t* sketch, double relative_accuracy);
+
+/**
+ * @brief Vacía el sketch conservando su precisión.
+ * @param sketch Sketch a vaciar.
+ */
+void qsketch_reset(qsketch_t* sketch);
+
+/**
+ * @brief Inserta un valor. Los negativos se tratan como cero.
+ * @param sketch Sketch destino.
+ * @param value Valor a insertar.
+ */
+void qsketch_add(qsketch_t* sketch, double value);
+
+/**
+ * @brief Estima un cuantil.
+ * @param sketch Sketch consultado.
+ * @param q Cuantil entre 0 y 1 (0 devuelve el mínimo y 1 el máximo exactos).
+ * @return Valor estimado, o 0 si el sketch está vacío.
+ */
+double qsketch_quantile(const qsketch_t* sketch, double q);
+
+#endif // QUANTILE_H
@@ -0,0 +1,99 @@
+/**
+ * @file rate.h
+ * @brief Derivadas de contadores acumulados del kernel, con detección de reinicios y desbordes.
+ *
+ * Cada serie es un índice en arreglos planos (valor y timestamp anteriores, última tasa, ancho
+ * del contador y estado), así decenas de miles de series ocupan unos pocos arreglos contiguos y
+ * actualizar una no toca memoria de las demás. Las series se reservan por rangos al iniciar los
+ * colectores; en el tick solo se llama a rate_update().
+ *
+ * Si un contador retrocede se decide entre dos casos:
+ *  - desborde: el contador es más angosto que 64 bits (los unsigned long del kernel en 32 bits)
+ *    y el avance dando la vuelta es menor que medio rango; el delta es ese avance.
+ *  - reinicio: cualquier otro retroceso; se toma el valor actual como lo contado desde el
+ *    reinicio, igual que rate() de Prometheus.
+ *
+ * El engine no usa locks: lo protege quien lo llama (en expose_metrics, el lock de las métricas).
+ */
+
+#ifndef RATE_H
+#define RATE_H
+
+#include <limits.h>
+#include <stdint.h>
+
+/**
+ * @brief Ancho de los contadores que el kernel publica como unsigned long.
+ */
+#define RATE_WIDTH_LONG ((int)(sizeof(unsigned long) * CHAR_BIT))
+
+/**
+ * @brief Series de todos los colectores, en arreglos paralelos indexados por el id de la serie.
+ */
+typedef struct
+{
+    int count;             /**< Series reservadas. */
+    int capacity;          /**< Capacidad de los arreglos. */
+    uint64_t* previous;    /**< Último valor crudo de cada serie. */
+    int64_t* previous_ms;  /**< Timestamp monotónico del último valor, en ms. */
+    double* rate;          /**< Última tasa por segundo, o -1 si no hay. */
+    uint8_t* width;        /**< Bits del contador (32 o 64). */
+    uint8_t* state;        /**< Banderas RATE_SEEN y RATE_HAVE_PREVIOUS. */
+} rate_engine_t;
+
+/**
+ * @brief Reserva un rango de series consecutivas. Se usa al iniciar, no en el tick.
+ * @param engine Engine (en cero antes del primer uso).
+ * @param count Series a reservar.
+ * @param width Bits del contador de origen: 32, 64 o RATE_WIDTH_LONG.
+ * @return Id de la primera serie del rango, o -1 si no hay memoria.
+ */
+int rate_series_reserve(rate_engine_t* engine, int count, int width);
+
+/**
+ * @brief Registra una lectura de un contador.
+ *
+ * La primera lectura de una serie devuelve en delta el valor completo, para que el counter de
+ * Prometheus arranque en el acumulado del kernel. Después de rate_forget() la primera lectura
+ * solo fija la base (delta 0), así un cambio de dispositivo no suma un salto espurio.
+ *
+ * @param engine Engine.
+ * @param series Id de la serie.
+ * @param value Valor crudo del contador.
+ * @param now_ms Timestamp monotónico de la lectura, en ms.
+ * @param delta Si no es NULL, recibe el avance del contador desde la lectura anterior (nunca negativo).
+ * @return Tasa por segundo, o -1 si no hay lectura anterior o no avanzó el reloj.
+ */
+double rate_update(rate_engine_t* engine, int series, uint64_t value, int64_t now_ms, double* delta);
+
+/**
+ * @brief Avance de un contador entre dos lecturas, con la regla de desborde y reinicio de rate_update().
+ *
+ * Para quien guarda sus propias lecturas anteriores (por ejemplo, la matriz de /proc/interrupts).
+ *
+ * @param previous Lectura anterior.
+ * @param value Lectura actual.
+ * @param width Bits del contador de origen: 32, 64 o RATE_WIDTH_LONG.
+ * @return Avance desde la lectura anterior.
+ */
+uint64_t rate_counter_delta(uint64_t previous, uint64_t value, int width);
+
+/**
+ * @brief Descarta las lecturas anteriores de un rango de series (por ejemplo, al cambiar de dispositivo).
+ * @param engine Engine.
+ * @param first Id de la primera serie.
+ * @param count Series del rango.
+ */
+void rate_forget(rate_engine_t* engine, int first, int count);
+
+/**
+ * @brief Libera los arreglos del engine y lo deja en cero.
+ */
+void rate_engine_free(rate_engine_t* engine);
+
+/**
+ * @brief Timestamp de CLOCK_MONOTONIC en ms, para pasar a rate_update().
+ */
+int64_t rate_now_ms(void);
+
+#endif // RATE_H
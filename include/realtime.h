@@ -0,0 +1,137 @@
+/**
+ * @file realtime.h
+ * @brief Modo de baja latencia: hilos fijados a CPUs, colector en SCHED_FIFO y memoria bloqueada.
+ *
+ * Con la clave "realtime" de config.json el hilo del colector (el del bucle principal) y el del
+ * servidor HTTP se fijan a las CPUs elegidas, el colector puede correr en SCHED_FIFO con la
+ * prioridad indicada y el proceso hace mlockall(). Con la memoria bloqueada, malloc deja de
+ * devolver memoria al sistema y al arrancar se tocan una reserva de heap y una porción de la pila
+ * del colector, así los primeros ticks no pagan fallos de página.
+ *
+ * SCHED_FIFO necesita CAP_SYS_NICE (o RLIMIT_RTPRIO) y mlockall CAP_IPC_LOCK (o RLIMIT_MEMLOCK
+ * suficiente); si falta el permiso se informa y el agente sigue sin esa parte. La configuración
+ * se aplica solo al arrancar. Los hilos auxiliares corren en SCHED_OTHER sobre las CPUs que tenía
+ * el proceso al arrancar, también cuando se reinician desde el colector.
+ */
+
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief CPUs direccionables en un conjunto.
+ */
+#define REALTIME_MAX_CPUS 1024
+
+/**
+ * @brief Reserva de heap tocada al arrancar si no se configura otra, en KB.
+ */
+#define REALTIME_DEFAULT_HEAP_KB 8192
+
+/**
+ * @brief Pila del colector tocada al arrancar si no se configura otra, en KB.
+ */
+#define REALTIME_DEFAULT_STACK_KB 256
+
+/**
+ * @brief Conjunto de CPUs con el formato de máscara de sched_setaffinity(2).
+ */
+typedef struct
+{
+    unsigned long bits[REALTIME_MAX_CPUS / (8 * sizeof(unsigned long))]; /**< Bit c encendido: CPU c incluida. */
+    int count;                                                            /**< CPUs en el conjunto (0: sin fijar). */
+} realtime_cpuset_t;
+
+/**
+ * @brief Parámetros del modo de baja latencia.
+ */
+typedef struct
+{
+    realtime_cpuset_t collector_cpus; /**< CPUs del hilo del colector (vacío: las que elija el kernel). */
+    realtime_cpuset_t http_cpus;      /**< CPUs del servidor HTTP (vacío: las que elija el kernel). */
+    int collector_priority;           /**< Prioridad SCHED_FIFO del colector (0: política normal). */
+    bool lock_memory;                 /**< mlockall() y reserva de memoria tocada al arrancar. */
+    int prefault_heap_kb;             /**< Heap reservado y tocado al arrancar, si lock_memory. */
+    int prefault_stack_kb;            /**< Pila del colector tocada al arrancar, si lock_memory. */
+} realtime_config_t;
+
+/**
+ * @brief Valores por defecto: nada fijado, política normal y memoria sin bloquear.
+ * @param config Parámetros a inicializar.
+ */
+void realtime_config_defaults(realtime_config_t* config);
+
+/**
+ * @brief Indica si la configuración pide alguna parte del modo de baja latencia.
+ */
+bool realtime_config_active(const realtime_config_t* config);
+
+/**
+ * @brief Interpreta una lista de CPUs con el formato de cpuset(7): "3", "2,6" o "0-3,8".
+ * @param list Lista de CPUs.
+ * @param set Conjunto resultante.
+ * @param error Buffer para el motivo del rechazo.
+ * @param error_len Tamaño de error.
+ * @return 0 si la lista es válida, -1 si no.
+ */
+int realtime_parse_cpus(const char* list, realtime_cpuset_t* set, char* error, size_t error_len);
+
+/**
+ * @brief Escribe un conjunto de CPUs en el formato de cpuset(7).
+ * @param set Conjunto.
+ * @param out Buffer destino.
+ * @param len Tamaño de out.
+ */
+void realtime_format_cpus(const realtime_cpuset_t* set, char* out, size_t len);
+
+/**
+ * @brief Fija el hilo que llama a las CPUs del conjunto; los hilos que cree después lo heredan.
+ * @param set CPUs; un conjunto vacío no cambia nada.
+ * @return 0 si se aplicó o no había nada que aplicar, -1 en caso de error.
+ */
+int realtime_pin_thread(const realtime_cpuset_t* set);
+
+/**
+ * @brief Guarda la afinidad del proceso, bloquea la memoria y toca la reserva de heap.
+ *
+ * Se llama al arrancar, antes de crear los hilos, para que sus pilas también queden bloqueadas y
+ * la afinidad guardada sea la del proceso y no la de un hilo ya fijado.
+ *
+ * @param config Parámetros; sin lock_memory no hace nada.
+ * @return 0 si se aplicó todo lo pedido, -1 si algo falló (se informa por stderr).
+ */
+int realtime_prepare_process(const realtime_config_t* config);
+
+/**
+ * @brief Aplica al hilo que llama la afinidad, la prioridad y la pila tocada del colector.
+ *
+ * Se llama desde el bucle principal después de crear los demás hilos, que así no heredan la
+ * prioridad ni la afinidad del colector.
+ *
+ * @param config Parámetros.
+ * @return 0 si se aplicó todo lo pedido, -1 si algo falló (se informa por stderr).
+ */
+int realtime_enter_collector(const realtime_config_t* config);
+
+/**
+ * @brief Atributos de un hilo auxiliar: SCHED_OTHER explícito, sin heredar la política de quien lo crea.
+ *
+ * Los hilos de PSI y de micro-muestreo se reinician desde el colector al recargar la configuración;
+ * con estos atributos no corren en SCHED_FIFO aunque el colector sí.
+ *
+ * @param attr Atributos a inicializar; se liberan con pthread_attr_destroy().
+ */
+void realtime_worker_attr(pthread_attr_t* attr);
+
+/**
+ * @brief Devuelve el hilo que llama a las CPUs que tenía el proceso al arrancar.
+ *
+ * La afinidad se hereda siempre de quien crea el hilo, así que la restaura el propio hilo auxiliar
+ * al empezar. Sin realtime_prepare_process() previo no cambia nada.
+ */
+void realtime_enter_worker(void);
+
+#endif // REALTIME_H
@@ -0,0 +1,93 @@
+/**
+ * @file scheduler.h
+ * @brief Planificador del muestreo adaptativo: intervalo lento en reposo y ráfagas rápidas ante picos de carga.
+ *
+ * En régimen estable se muestrea cada slow_interval_ms. Cuando alguna condición se dispara (CPU
+ * sobre un umbral, salto de la tasa de cambios de contexto o crecimiento de procs_running) se
+ * pasa a fast_interval_ms. La ráfaga termina cuando todas las señales quedan por debajo de su
+ * umbral de salida (umbral de entrada por hysteresis) durante calm_ms, o al cumplirse
+ * max_burst_ms; tras un corte forzado no se vuelve a entrar hasta pasado cooldown_ms.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Parámetros del muestreo adaptativo. Un umbral en 0 desactiva su condición.
+ */
+typedef struct
+{
+    bool enabled;             /**< Activa el muestreo adaptativo; si es false se usa sampling_interval. */
+    int slow_interval_ms;     /**< Intervalo en régimen estable. */
+    int fast_interval_ms;     /**< Intervalo durante una ráfaga. */
+    int calm_ms;              /**< Tiempo con las señales bajo el umbral de salida antes de terminar la ráfaga. */
+    int max_burst_ms;         /**< Duración máxima de una ráfaga. */
+    int cooldown_ms;          /**< Espera tras una ráfaga cortada por max_burst_ms antes de permitir otra. */
+    double cpu_threshold;     /**< Uso de CPU (%) que dispara una ráfaga. */
+    double ctxt_rate_factor;  /**< Ráfaga si la tasa de cambios de contexto supera este múltiplo de la base. */
+    int procs_running_growth; /**< Ráfaga si procs_running supera su base en esta cantidad. */
+    double hysteresis;        /**< Fracción del umbral de entrada por debajo de la cual una señal se considera calma. */
+} adaptive_config_t;
+
+/**
+ * @brief Señales de carga observadas en un tick.
+ */
+typedef struct
+{
+    double cpu_usage;           /**< Uso de CPU en porcentaje, o negativo si no se midió. */
+    long long context_switches; /**< Cambios de contexto acumulados, o negativo si no se midió. */
+    int running_processes;      /**< procs_running, o negativo si no se midió. */
+} scheduler_signals_t;
+
+/**
+ * @brief Estado del planificador.
+ */
+typedef struct
+{
+    adaptive_config_t config;   /**< Parámetros vigentes. */
+    bool burst;                 /**< true mientras dura una ráfaga. */
+    const char* reason;         /**< Condición que abrió la ráfaga actual o la última. */
+    int64_t burst_start_ms;     /**< Inicio de la ráfaga actual. */
+    int64_t calm_since_ms;      /**< Desde cuándo todas las señales están calmas (-1 si no lo están). */
+    int64_t cooldown_until_ms;  /**< No se abre otra ráfaga antes de este instante. */
+    int64_t last_ms;            /**< Instante de la observación anterior (-1 antes de la primera). */
+    long long last_ctxt;        /**< Cambios de contexto de la observación anterior. */
+    double ctxt_rate_base;      /**< Media móvil de la tasa de cambios de contexto fuera de ráfaga. */
+    double procs_base;          /**< Media móvil de procs_running fuera de ráfaga. */
+    unsigned long bursts;       /**< Ráfagas abiertas desde el arranque. */
+} scheduler_t;
+
+/**
+ * @brief Completa los parámetros con los valores predeterminados (desactivado).
+ * @param config Parámetros a inicializar.
+ * @param sampling_interval Intervalo fijo configurado, en segundos; se usa como intervalo lento.
+ */
+void adaptive_config_defaults(adaptive_config_t* config, int sampling_interval);
+
+/**
+ * @brief Inicializa el planificador.
+ * @param scheduler Estado a inicializar.
+ * @param config Parámetros del muestreo adaptativo.
+ */
+void scheduler_init(scheduler_t* scheduler, const adaptive_config_t* config);
+
+/**
+ * @brief Incorpora las señales de un tick y decide el intervalo hasta el siguiente.
+ * @param scheduler Estado del planificador.
+ * @param signals Señales medidas en el tick.
+ * @param now_ms Instante del tick en milisegundos (CLOCK_MONOTONIC).
+ * @return Intervalo hasta el próximo tick, en milisegundos.
+ */
+int scheduler_update(scheduler_t* scheduler, const scheduler_signals_t* signals, int64_t now_ms);
+
+/**
+ * @brief Intervalo vigente según el estado actual, en milisegundos.
+ * @param scheduler Estado del planificador.
+ * @return fast_interval_ms durante una ráfaga y slow_interval_ms fuera de ella.
+ */
+int scheduler_interval_ms(const scheduler_t* scheduler);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,86 @@
+/**
+ * @file segregated_alloc.h
+ * @brief Allocator por clases de tamaño (segregated fit) con caches por hilo.
+ *
+ * Los bloques de hasta SEG_MAX_SMALL bytes se redondean a una clase de tamaño y se sirven en
+ * O(1) desde una lista libre local del hilo; los bloques más grandes se toman de un heap con
+ * etiquetas de frontera cuyas listas libres están agrupadas por potencia de dos, y se
+ * fusionan con sus vecinos al liberarse.
+ */
+
+#ifndef SEGREGATED_ALLOC_H
+#define SEGREGATED_ALLOC_H
+
+#include <stddef.h>
+
+#ifndef SEGREGATED_FIT
+/**
+ * @brief Método de asignación por clases de tamaño, a continuación de FIRST_FIT, BEST_FIT y WORST_FIT.
+ */
+#define SEGREGATED_FIT 3
+#endif
+
+/**
+ * @brief Mayor tamaño servido por las clases de tamaño; lo que supere este valor va al heap de bloques grandes.
+ */
+#define SEG_MAX_SMALL 32768
+
+/**
+ * @brief Estadísticas del allocator.
+ */
+typedef struct
+{
+    size_t mapped_bytes;      /**< Memoria pedida al sistema con mmap. */
+    size_t small_in_use;      /**< Bytes en uso en bloques chicos (tamaño de clase). */
+    size_t small_free;        /**< Bytes libres en slabs, incluidos los caches por hilo. */
+    size_t large_in_use;      /**< Bytes en uso en bloques grandes, con encabezado. */
+    size_t large_free;        /**< Bytes libres en el heap de bloques grandes. */
+    size_t largest_free;      /**< Mayor bloque libre contiguo del heap de bloques grandes. */
+} seg_stats_t;
+
+/**
+ * @brief Reserva memoria alineada a 16 bytes.
+ * @param size Tamaño pedido.
+ * @return Puntero al bloque, o NULL si no hay memoria.
+ */
+void* seg_malloc(size_t size);
+
+/**
+ * @brief Libera un bloque de seg_malloc(), seg_calloc() o seg_realloc(). Acepta NULL.
+ * @param ptr Bloque a liberar.
+ */
+void seg_free(void* ptr);
+
+/**
+ * @brief Reserva memoria inicializada en cero.
+ * @param count Cantidad de elementos.
+ * @param size Tamaño de cada elemento.
+ * @return Puntero al bloque, o NULL si no hay memoria o el tamaño desborda.
+ */
+void* seg_calloc(size_t count, size_t size);
+
+/**
+ * @brief Cambia el tamaño de un bloque conservando su contenido.
+ * @param ptr Bloque actual o NULL.
+ * @param size Tamaño nuevo.
+ * @return Puntero al bloque, o NULL si no hay memoria (el bloque original sigue válido).
+ */
+void* seg_realloc(void* ptr, size_t size);
+
+/**
+ * @brief Obtiene las estadísticas del allocator.
+ * @param stats Estructura de salida.
+ */
+void seg_get_stats(seg_stats_t* stats);
+
+/**
+ * @brief Fragmentación externa del heap de bloques grandes: memoria libre fuera del mayor bloque libre.
+ *
+ * Los slots libres de las clases de tamaño no cuentan como huecos, porque se reutilizan en O(1)
+ * para su clase.
+ *
+ * @return Porcentaje entre 0 y 100, o 0 si no hay memoria libre.
+ */
+double seg_fragmentation(void);
+
+#endif // SEGREGATED_ALLOC_H
@@ -0,0 +1,597 @@
+#include "alerts.h"
+#include "events.h"
+#include "log.h"
+#include <ctype.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Señal con nombre fijo: campo de la muestra y colector que lo llena.
+ */
+typedef struct
+{
+    const char* name;
+    size_t offset;
+    alert_value_type_t type;
+    size_t config_flag;
+} fixed_signal_t;
+
+/**
+ * @brief Tamaño de un texto de la regla escapado para JSON (\u00XX ocupa 6 bytes por carácter).
+ */
+#define JSON_TEXT_MAX (6 * ALERT_EXPR_MAX)
+
+#define SIGNAL(name, field, type, flag) {name, offsetof(metrics_sample_t, field), type, offsetof(config_t, flag)}
+
+static const fixed_signal_t fixed_signals[] = {
+    SIGNAL("cpu_usage", cpu_usage, ALERT_VALUE_DOUBLE, collect_cpu),
+    SIGNAL("cpu_usage_freq_normalized", cpufreq.normalized_usage, ALERT_VALUE_DOUBLE, collect_cpufreq),
+    SIGNAL("cpu_freq_ratio", cpufreq.freq_ratio, ALERT_VALUE_DOUBLE, collect_cpufreq),
+    SIGNAL("thermal_max_celsius", cpufreq.max_celsius, ALERT_VALUE_DOUBLE, collect_cpufreq),
+    SIGNAL("cpu_core_throttles", cpufreq.core_throttles, ALERT_VALUE_ULONG, collect_cpufreq),
+    SIGNAL("total_memory", memory.total_mem, ALERT_VALUE_DOUBLE, collect_memory),
+    SIGNAL("used_memory", memory.used_mem, ALERT_VALUE_DOUBLE, collect_memory),
+    SIGNAL("free_memory", memory.free_mem, ALERT_VALUE_DOUBLE, collect_memory),
+    SIGNAL("disk_reads", disk.reads_completed, ALERT_VALUE_ULONG, collect_disk),
+    SIGNAL("disk_writes", disk.writes_completed, ALERT_VALUE_ULONG, collect_disk),
+    SIGNAL("rx_bytes", net.rx_bytes, ALERT_VALUE_LLONG, collect_net),
+    SIGNAL("tx_bytes", net.tx_bytes, ALERT_VALUE_LLONG, collect_net),
+    SIGNAL("context_switches", context_switches, ALERT_VALUE_LLONG, collect_context_switches),
+    SIGNAL("running_processes", running_processes, ALERT_VALUE_INT, collect_running_processes),
+    SIGNAL("memory_fragmentation", memory_fragmentation, ALERT_VALUE_DOUBLE, collect_memory_fragmentation),
+    SIGNAL("irq_rate", irq_rate, ALERT_VALUE_DOUBLE, collect_interrupts),
+    SIGNAL("softirq_rate", softirq_rate, ALERT_VALUE_DOUBLE, collect_interrupts),
+    SIGNAL("irq_imbalance_ratio", irq_imbalance, ALERT_VALUE_DOUBLE, collect_interrupts),
+    SIGNAL("tcp_retransmit_ratio", tcp_retransmit_ratio, ALERT_VALUE_DOUBLE, collect_netproto),
+    SIGNAL("tcp_listen_queue_ratio", netproto.listen_queue_ratio, ALERT_VALUE_DOUBLE, collect_netproto),
+};
+
+/**
+ * @brief Estado de una regla entre ticks.
+ */
+typedef struct
+{
+    int64_t pending_since_ms; /**< Desde cuándo se cumple la condición, o -1. */
+    bool firing;              /**< true si la alerta está disparada. */
+    double value;             /**< Último valor evaluado (NAN si no hubo dato). */
+    time_t changed_at;        /**< Último cambio entre firing y resolved, en tiempo real. */
+} rule_state_t;
+
+/**
+ * @brief Motor instalado. Todo se protege con lock: lo leen el tick y el servidor HTTP.
+ */
+static struct
+{
+    pthread_mutex_t lock;
+    alert_program_t* program;
+    rule_state_t* states;
+    double* values;    // Valor de cada slot en el tick
+    double* previous;  // Valor crudo anterior de cada slot de tasa
+    int64_t previous_ms;
+    bool have_previous;
+} engine = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+alert_program_t* alert_program_new(void)
+{
+    alert_program_t* program = calloc(1, sizeof(*program));
+    if (program == NULL)
+    {
+        fprintf(stderr, "Error al reservar el programa de alertas\n");
+    }
+    return program;
+}
+
+void alert_program_free(alert_program_t* program)
+{
+    free(program);
+}
+
+/**
+ * @brief Resuelve el nombre de una señal a su campo en la muestra.
+ * @return 0 si la señal existe, -1 en caso contrario.
+ */
+static int resolve_signal(const char* name, alert_slot_t* slot, size_t* config_flag)
+{
+    slot->present_offset = -1;
+    slot->scale = 1;
+    for (size_t i = 0; i < sizeof(fixed_signals) / sizeof(fixed_signals[0]); i++)
+    {
+        if (strcmp(name, fixed_signals[i].name) == 0)
+        {
+            slot->offset = fixed_signals[i].offset;
+            slot->type = fixed_signals[i].type;
+            *config_flag = fixed_signals[i].config_flag;
+            return 0;
+        }
+    }
+
+    if (strncmp(name, "meminfo.", 8) == 0)
+    {
+        for (int f = 0; f < meminfo_field_count(); f++)
+        {
+            if (strcmp(name + 8, meminfo_field_name(f)) == 0)
+            {
+                slot->offset = offsetof(metrics_sample_t, meminfo.values) + (size_t)f * sizeof(uint64_t);
+                slot->present_offset = (long)(offsetof(metrics_sample_t, meminfo.present) + (size_t)f * sizeof(bool));
+                slot->type = ALERT_VALUE_U64;
+                slot->scale = meminfo_field_in_kb(f) ? 1024 : 1;
+                *config_flag = offsetof(config_t, collect_meminfo);
+                return 0;
+            }
+        }
+        return -1;
+    }
+
+    if (strncmp(name, "tcp.", 4) == 0)
+    {
+        for (int s = 1; s < NETPROTO_TCP_STATES; s++)
+        {
+            if (strcmp(name + 4, netproto_tcp_state_name(s)) == 0)
+            {
+                slot->offset = offsetof(metrics_sample_t, netproto.tcp_states) + (size_t)s * sizeof(uint64_t);
+                slot->present_offset = (long)offsetof(metrics_sample_t, netproto.have_states);
+                slot->type = ALERT_VALUE_U64;
+                *config_flag = offsetof(config_t, collect_netproto);
+                return 0;
+            }
+        }
+        return -1;
+    }
+
+    // net.<Proto>.<Contador> y psi.<recurso>.<some|full>.<avg10|avg60>
+    char a[32], b[32], c[32];
+    if (sscanf(name, "net.%31[^.].%31s", a, b) == 2)
+    {
+        int i = netproto_counter_index(a, b);
+        if (i < 0)
+        {
+            return -1;
+        }
+        slot->offset = offsetof(metrics_sample_t, netproto.counters) + (size_t)i * sizeof(uint64_t);
+        slot->present_offset = (long)(offsetof(metrics_sample_t, netproto.present) + (size_t)i * sizeof(bool));
+        slot->type = ALERT_VALUE_U64;
+        *config_flag = offsetof(config_t, collect_netproto);
+        return 0;
+    }
+    if (sscanf(name, "psi.%31[^.].%31[^.].%31s", a, b, c) == 3)
+    {
+        int resource = psi_resource_from_name(a);
+        bool full = strcmp(b, "full") == 0;
+        if (resource < 0 || (!full && strcmp(b, "some") != 0) || (strcmp(c, "avg10") != 0 && strcmp(c, "avg60") != 0))
+        {
+            return -1;
+        }
+        size_t line = offsetof(metrics_sample_t, psi) + (size_t)resource * sizeof(psi_stats_t) +
+                      (full ? offsetof(psi_stats_t, full) : offsetof(psi_stats_t, some));
+        slot->offset = line + (strcmp(c, "avg10") == 0 ? offsetof(psi_line_t, avg10) : offsetof(psi_line_t, avg60));
+        slot->present_offset = (long)(line + offsetof(psi_line_t, present));
+        slot->type = ALERT_VALUE_DOUBLE;
+        *config_flag = offsetof(config_t, collect_psi);
+        return 0;
+    }
+    return -1;
+}
+
+/**
+ * @brief Devuelve el slot equivalente ya existente o agrega uno nuevo.
+ */
+static int intern_slot(alert_program_t* program, const alert_slot_t* slot)
+{
+    for (int i = 0; i < program->slot_count; i++)
+    {
+        if (program->slots[i].offset == slot->offset && program->slots[i].rate == slot->rate)
+        {
+            return i;
+        }
+    }
+    if (program->slot_count == ALERTS_MAX_SLOTS)
+    {
+        return -1;
+    }
+    program->slots[program->slot_count] = *slot;
+    return program->slot_count++;
+}
+
+/**
+ * @brief Parsea una duración ("5s", "500ms", "2m", "1h"; sin unidad son segundos).
+ */
+static int parse_duration(const char* p, int64_t* ms)
+{
+    char* end;
+    double value = strtod(p, &end);
+    if (end == p || value < 0)
+    {
+        return -1;
+    }
+    double scale = 1000;
+    if (strcmp(end, "ms") == 0)
+    {
+        scale = 1;
+    }
+    else if (strcmp(end, "m") == 0)
+    {
+        scale = 60000;
+    }
+    else if (strcmp(end, "h") == 0)
+    {
+        scale = 3600000;
+    }
+    else if (*end != '\0' && strcmp(end, "s") != 0)
+    {
+        return -1;
+    }
+    *ms = (int64_t)(value * scale);
+    return 0;
+}
+
+int alert_program_add(alert_program_t* program, const char* name, const char* expr, char* error, size_t error_len)
+{
+    if (program->rule_count == ALERTS_MAX_RULES)
+    {
+        snprintf(error, error_len, "más de %d reglas", ALERTS_MAX_RULES);
+        return -1;
+    }
+    size_t name_len = strlen(name);
+    if (name_len == 0 || name_len >= ALERT_NAME_MAX || strlen(expr) >= ALERT_EXPR_MAX)
+    {
+        snprintf(error, error_len, "nombre o regla demasiado largos");
+        return -1;
+    }
+    for (const char* p = name; *p != '\0'; p++)
+    {
+        // Nombres legibles como etiqueta; el JSON de eventos y de /alerts igual los escapa
+        if (!isalnum((unsigned char)*p) && strchr("_-.:", *p) == NULL)
+        {
+            snprintf(error, error_len, "nombre con caracteres no permitidos");
+            return -1;
+        }
+    }
+
+    // señal | rate(señal), operador, umbral y opcionalmente "for" duración
+    char lhs[96], op[3], threshold[32], keyword[8], duration[16], extra[2];
+    int fields =
+        sscanf(expr, " %95[^<>=! ] %2[<>=!] %31s %7s %15s %1s", lhs, op, threshold, keyword, duration, extra);
+    if (fields != 3 && fields != 5)
+    {
+        snprintf(error, error_len, "se esperaba 'señal op umbral [for duración]'");
+        return -1;
+    }
+
+    alert_slot_t slot = {0};
+    char* signal = lhs;
+    size_t lhs_len = strlen(lhs);
+    if (strncmp(lhs, "rate(", 5) == 0 && lhs_len > 6 && lhs[lhs_len - 1] == ')')
+    {
+        lhs[lhs_len - 1] = '\0';
+        signal = lhs + 5;
+        slot.rate = true;
+    }
+    size_t config_flag;
+    if (resolve_signal(signal, &slot, &config_flag) != 0)
+    {
+        snprintf(error, error_len, "señal desconocida '%s'", signal);
+        return -1;
+    }
+
+    alert_instr_t* instr = &program->code[program->rule_count];
+    static const char* const ops[] = {">", ">=", "<", "<=", "==", "!="};
+    instr->op = (alert_op_t)-1;
+    for (int i = 0; i < 6; i++)
+    {
+        if (strcmp(op, ops[i]) == 0)
+        {
+            instr->op = (alert_op_t)i;
+        }
+    }
+    if ((int)instr->op < 0)
+    {
+        snprintf(error, error_len, "operador desconocido '%s'", op);
+        return -1;
+    }
+
+    char* end;
+    instr->threshold = strtod(threshold, &end);
+    if (end == threshold || *end != '\0' || !isfinite(instr->threshold))
+    {
+        snprintf(error, error_len, "umbral inválido '%s'", threshold);
+        return -1;
+    }
+    instr->for_ms = 0;
+    if (fields == 5 && (strcmp(keyword, "for") != 0 || parse_duration(duration, &instr->for_ms) != 0))
+    {
+        snprintf(error, error_len, "duración inválida");
+        return -1;
+    }
+
+    instr->slot = intern_slot(program, &slot);
+    if (instr->slot < 0)
+    {
+        snprintf(error, error_len, "más de %d señales distintas", ALERTS_MAX_SLOTS);
+        return -1;
+    }
+    snprintf(program->info[program->rule_count].name, ALERT_NAME_MAX, "%s", name);
+    snprintf(program->info[program->rule_count].expr, ALERT_EXPR_MAX, "%s", expr);
+    program->needs[program->rule_count] = config_flag;
+    program->rule_count++;
+    return 0;
+}
+
+void alert_program_enable_collectors(const alert_program_t* program, config_t* config)
+{
+    for (int i = 0; i < program->rule_count; i++)
+    {
+        *config_flag(config, program->needs[i]) = true;
+    }
+}
+
+void alerts_install(alert_program_t* program)
+{
+    rule_state_t* states = NULL;
+    double* values = NULL;
+    double* previous = NULL;
+    if (program != NULL)
+    {
+        states = malloc((size_t)(program->rule_count > 0 ? program->rule_count : 1) * sizeof(*states));
+        values = calloc((size_t)(program->slot_count > 0 ? program->slot_count : 1), sizeof(double));
+        previous = calloc((size_t)(program->slot_count > 0 ? program->slot_count : 1), sizeof(double));
+        if (states == NULL || values == NULL || previous == NULL)
+        {
+            fprintf(stderr, "Error al reservar el estado de las alertas\n");
+            free(states);
+            free(values);
+            free(previous);
+            alert_program_free(program);
+            return;
+        }
+        for (int i = 0; i < program->rule_count; i++)
+        {
+            states[i] = (rule_state_t){.pending_since_ms = -1, .value = NAN};
+        }
+    }
+
+    pthread_mutex_lock(&engine.lock);
+    // Una regla que sigue igual conserva su estado: recargar no vuelve a disparar ni resuelve alertas
+    for (int i = 0; program != NULL && engine.program != NULL && i < program->rule_count; i++)
+    {
+        for (int j = 0; j < engine.program->rule_count; j++)
+        {
+            if (strcmp(program->info[i].name, engine.program->info[j].name) == 0 &&
+                strcmp(program->info[i].expr, engine.program->info[j].expr) == 0)
+            {
+                states[i] = engine.states[j];
+                break;
+            }
+        }
+    }
+    alert_program_free(engine.program);
+    free(engine.states);
+    free(engine.values);
+    free(engine.previous);
+    engine.program = program;
+    engine.states = states;
+    engine.values = values;
+    engine.previous = previous;
+    engine.have_previous = false;
+    pthread_mutex_unlock(&engine.lock);
+}
+
+/**
+ * @brief Lee el valor crudo de un slot, o NAN si el colector no lo reportó.
+ */
+static double load_slot(const metrics_sample_t* sample, const alert_slot_t* slot)
+{
+    const char* base = (const char*)sample;
+    if (slot->present_offset >= 0 && !*(const bool*)(base + slot->present_offset))
+    {
+        return NAN;
+    }
+    const void* field = base + slot->offset;
+    switch (slot->type)
+    {
+    case ALERT_VALUE_DOUBLE:
+        return *(const double*)field * slot->scale;
+    case ALERT_VALUE_INT:
+        return *(const int*)field * slot->scale;
+    case ALERT_VALUE_LLONG:
+        return (double)*(const long long*)field * slot->scale;
+    case ALERT_VALUE_ULONG:
+        return (double)*(const unsigned long*)field * slot->scale;
+    case ALERT_VALUE_U64:
+        return (double)*(const uint64_t*)field * slot->scale;
+    }
+    return NAN;
+}
+
+/**
+ * @brief Copia text a out como contenido de un string JSON: comillas, barras y controles escapados.
+ */
+static void json_escape(const char* text, char* out, size_t len)
+{
+    size_t used = 0;
+    for (const unsigned char* p = (const unsigned char*)text; *p != '\0' && used + 7 < len; p++)
+    {
+        if (*p == '"' || *p == '\\')
+        {
+            out[used++] = '\\';
+            out[used++] = (char)*p;
+        }
+        else if (*p < 0x20)
+        {
+            used += (size_t)snprintf(out + used, len - used, "\\u%04x", *p); // Tabs y saltos de la regla
+        }
+        else
+        {
+            out[used++] = (char)*p;
+        }
+    }
+    out[used] = '\0';
+}
+
+/**
+ * @brief Valor de una regla como número JSON, o null si la señal no se leyó.
+ */
+static void json_number(double value, char* out, size_t len)
+{
+    if (isfinite(value))
+    {
+        snprintf(out, len, "%g", value);
+    }
+    else
+    {
+        snprintf(out, len, "null");
+    }
+}
+
+/**
+ * @brief Publica un cambio de estado en el FIFO y en el log. Requiere engine.lock.
+ */
+static void emit_transition(const alert_rule_info_t* info, const alert_instr_t* instr, const rule_state_t* state)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    char name[JSON_TEXT_MAX], expr[JSON_TEXT_MAX], value[32];
+    json_escape(info->name, name, sizeof(name));
+    json_escape(info->expr, expr, sizeof(expr));
+    json_number(state->value, value, sizeof(value));
+    char json[2 * JSON_TEXT_MAX + 160];
+    int length = snprintf(json, sizeof(json),
+                          "{\"event\": \"%s\", \"alert\": \"%s\", \"expr\": \"%s\", \"value\": %s, \"threshold\": %g, "
+                          "\"timestamp_ms\": %lld}\n",
+                          state->firing ? "alert_firing" : "alert_resolved", name, expr, value, instr->threshold,
+                          (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000);
+    if (length > 0 && (size_t)length < sizeof(json))
+    {
+        events_publish(json, (size_t)length);
+    }
+
+    log_event("Alerta %s %s: %s (valor %g)", info->name, state->firing ? "disparada" : "resuelta", info->expr,
+              state->value);
+}
+
+void alerts_evaluate(const metrics_sample_t* sample, int64_t now_ms)
+{
+    pthread_mutex_lock(&engine.lock);
+    const alert_program_t* program = engine.program;
+    if (program == NULL || program->rule_count == 0)
+    {
+        pthread_mutex_unlock(&engine.lock);
+        return;
+    }
+
+    // Carga: cada señal distinta una vez; las tasas contra el tick anterior
+    double seconds = engine.have_previous ? (double)(now_ms - engine.previous_ms) / 1000.0 : 0;
+    for (int s = 0; s < program->slot_count; s++)
+    {
+        const alert_slot_t* slot = &program->slots[s];
+        double raw = load_slot(sample, slot);
+        if (!slot->rate)
+        {
+            engine.values[s] = raw;
+            continue;
+        }
+        // Un contador que retrocede (reinicio) no tiene tasa en ese tick
+        engine.values[s] = seconds > 0 && raw >= engine.previous[s] ? (raw - engine.previous[s]) / seconds : NAN;
+        engine.previous[s] = raw;
+    }
+    engine.previous_ms = now_ms;
+    engine.have_previous = true;
+
+    // Comparación: recorrido lineal de las instrucciones
+    for (int r = 0; r < program->rule_count; r++)
+    {
+        const alert_instr_t* instr = &program->code[r];
+        rule_state_t* state = &engine.states[r];
+        double value = engine.values[instr->slot];
+        if (isnan(value))
+        {
+            continue; // Sin dato no cambia el estado
+        }
+        state->value = value;
+
+        bool holds;
+        switch (instr->op)
+        {
+        case ALERT_OP_GT:
+            holds = value > instr->threshold;
+            break;
+        case ALERT_OP_GE:
+            holds = value >= instr->threshold;
+            break;
+        case ALERT_OP_LT:
+            holds = value < instr->threshold;
+            break;
+        case ALERT_OP_LE:
+            holds = value <= instr->threshold;
+            break;
+        case ALERT_OP_EQ:
+            holds = value == instr->threshold;
+            break;
+        default:
+            holds = value != instr->threshold;
+            break;
+        }
+
+        if (holds)
+        {
+            if (state->pending_since_ms < 0)
+            {
+                state->pending_since_ms = now_ms;
+            }
+            if (!state->firing && now_ms - state->pending_since_ms >= instr->for_ms)
+            {
+                state->firing = true;
+                state->changed_at = time(NULL);
+                emit_transition(&program->info[r], instr, state);
+            }
+        }
+        else
+        {
+            state->pending_since_ms = -1;
+            if (state->firing)
+            {
+                state->firing = false;
+                state->changed_at = time(NULL);
+                emit_transition(&program->info[r], instr, state);
+            }
+        }
+    }
+    pthread_mutex_unlock(&engine.lock);
+}
+
+char* alerts_render_json(size_t* length)
+{
+    pthread_mutex_lock(&engine.lock);
+    int rules = engine.program != NULL ? engine.program->rule_count : 0;
+    size_t capacity = 64 + (size_t)rules * (2 * JSON_TEXT_MAX + 160);
+    char* json = malloc(capacity);
+    if (json == NULL)
+    {
+        pthread_mutex_unlock(&engine.lock);
+        return NULL;
+    }
+
+    size_t used = (size_t)snprintf(json, capacity, "{\"alerts\": [");
+    for (int r = 0; r < rules; r++)
+    {
+        const alert_rule_info_t* info = &engine.program->info[r];
+        const rule_state_t* state = &engine.states[r];
+        const char* status = state->firing ? "firing" : state->pending_since_ms >= 0 ? "pending" : "inactive";
+        char name[JSON_TEXT_MAX], expr[JSON_TEXT_MAX], value[32];
+        json_escape(info->name, name, sizeof(name));
+        json_escape(info->expr, expr, sizeof(expr));
+        json_number(state->value, value, sizeof(value));
+        used += (size_t)snprintf(json + used, capacity - used,
+                                 "%s{\"name\": \"%s\", \"expr\": \"%s\", \"state\": \"%s\", \"value\": %s, "
+                                 "\"since\": %lld}",
+                                 r > 0 ? ", " : "", name, expr, status, value, (long long)state->changed_at);
+    }
+    used += (size_t)snprintf(json + used, capacity - used, "]}\n");
+    pthread_mutex_unlock(&engine.lock);
+
+    *length = used;
+    return json;
+}
@@ -0,0 +1,68 @@
+#include "allocator.h"
+#include "memory.h"
+#include <stdio.h>
+
+static int current_method = FIRST_FIT;
+
+int allocator_select(int method)
+{
+    switch (method)
+    {
+    case FIRST_FIT:
+    case BEST_FIT:
+    case WORST_FIT:
+        malloc_control(method);
+        break;
+    case SEGREGATED_FIT:
+        break;
+    default:
+        fprintf(stderr, "Método de asignación desconocido: %d\n", method);
+        return -1;
+    }
+    current_method = method;
+    return 0;
+}
+
+int allocator_method(void)
+{
+    return current_method;
+}
+
+const char* allocator_method_name(int method)
+{
+    switch (method)
+    {
+    case FIRST_FIT:
+        return "first_fit";
+    case BEST_FIT:
+        return "best_fit";
+    case WORST_FIT:
+        return "worst_fit";
+    case SEGREGATED_FIT:
+        return "segregated_fit";
+    default:
+        return "desconocido";
+    }
+}
+
+void* allocator_malloc(size_t size)
+{
+    return current_method == SEGREGATED_FIT ? seg_malloc(size) : my_malloc(size);
+}
+
+void allocator_free(void* ptr)
+{
+    if (current_method == SEGREGATED_FIT)
+    {
+        seg_free(ptr);
+    }
+    else
+    {
+        my_free(ptr);
+    }
+}
+
+double allocator_fragmentation(void)
+{
+    return current_method == SEGREGATED_FIT ? seg_fragmentation() : calculate_memory_fragmentation();
+}
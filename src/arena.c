@@ -0,0 +1,139 @@
+#include "arena.h"
+#include <cjson/cJSON.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ARENA_ALIGN 16
+#define TICK_ARENA_DEFAULT (64 * 1024)
+
+struct arena_chunk
+{
+    arena_chunk_t* next;
+    size_t size;
+    size_t used;
+    _Alignas(ARENA_ALIGN) unsigned char data[];
+};
+
+/**
+ * @brief Pide un bloque nuevo al sistema y lo pone al frente.
+ */
+static arena_chunk_t* push_chunk(arena_t* arena, size_t size)
+{
+    arena_chunk_t* chunk = malloc(sizeof(*chunk) + size);
+    if (chunk == NULL)
+    {
+        fprintf(stderr, "Error al reservar %zu bytes para el arena\n", size);
+        return NULL;
+    }
+    chunk->next = arena->chunks;
+    chunk->size = size;
+    chunk->used = 0;
+    arena->chunks = chunk;
+    arena->capacity += size;
+    arena->system_allocs++;
+    return chunk;
+}
+
+void* arena_alloc(arena_t* arena, size_t size)
+{
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    arena_chunk_t* chunk = arena->chunks;
+    if (chunk == NULL || chunk->size - chunk->used < size)
+    {
+        // Crecer al menos al doble para que un pico nuevo se resuelva con pocos bloques
+        size_t grow = arena->capacity > size ? arena->capacity : size;
+        chunk = push_chunk(arena, grow > TICK_ARENA_DEFAULT ? grow : TICK_ARENA_DEFAULT);
+        if (chunk == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    void* ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->used += size;
+    if (arena->used > arena->high_water)
+    {
+        arena->high_water = arena->used;
+    }
+    return ptr;
+}
+
+void arena_reset(arena_t* arena)
+{
+    arena->used = 0;
+    if (arena->chunks == NULL)
+    {
+        return;
+    }
+    if (arena->chunks->next == NULL)
+    {
+        arena->chunks->used = 0;
+        return;
+    }
+
+    // El ciclo necesitó varios bloques: se reemplazan por uno que cubra el pico
+    size_t capacity = arena->capacity;
+    size_t system_allocs = arena->system_allocs;
+    arena_destroy(arena);
+    arena->system_allocs = system_allocs;
+    push_chunk(arena, capacity);
+}
+
+void arena_destroy(arena_t* arena)
+{
+    arena_chunk_t* chunk = arena->chunks;
+    while (chunk != NULL)
+    {
+        arena_chunk_t* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->chunks = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+/**
+ * @brief Arena del hilo de muestreo.
+ */
+static arena_t tick;
+
+static void* tick_malloc_hook(size_t size)
+{
+    return arena_alloc(&tick, size);
+}
+
+static void tick_free_hook(void* ptr)
+{
+    (void)ptr; // Se libera en bloque con tick_arena_reset()
+}
+
+int tick_arena_init(size_t initial)
+{
+    cJSON_Hooks hooks = {tick_malloc_hook, tick_free_hook};
+    cJSON_InitHooks(&hooks);
+
+    if (tick.chunks == NULL && push_chunk(&tick, initial > 0 ? initial : TICK_ARENA_DEFAULT) == NULL)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+void* tick_alloc(size_t size)
+{
+    return arena_alloc(&tick, size);
+}
+
+void tick_arena_reset(void)
+{
+    arena_reset(&tick);
+}
+
+const arena_t* tick_arena(void)
+{
+    return &tick;
+}
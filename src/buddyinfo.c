@@ -0,0 +1,254 @@
+#include "buddyinfo.h"
+#include "log.h"
+#include "parse.h"
+#include "procfs.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Buffer de lectura por hilo, reutilizado entre llamados.
+ */
+static __thread procfs_buf_t read_buf;
+
+/**
+ * @brief Lee el prefijo "Node N, zone NOMBRE" común a ambos archivos.
+ * @return Posición después del nombre de la zona (en la coma final si la hay), o NULL si la línea no es de zona.
+ */
+static const char* parse_zone_prefix(const char* p, const char* end, int* node, const char** zone, size_t* zone_len)
+{
+    if (!parse_starts_with(p, end, "Node", 4))
+    {
+        return NULL;
+    }
+    p = parse_skip_spaces(p + 4, end);
+    *node = (int)parse_u64(&p, end);
+    if (!parse_starts_with(p, end, ", zone", 6))
+    {
+        return NULL;
+    }
+    *zone = parse_skip_spaces(p + 6, end);
+    p = parse_skip_token(*zone, end);
+    *zone_len = (size_t)(p - *zone);
+    if (*zone_len > 0 && (*zone)[*zone_len - 1] == ',')
+    {
+        (*zone_len)--; // En pagetypeinfo el nombre termina en ", type"
+        p--;
+    }
+    return p;
+}
+
+static buddy_zone_t* find_zone(buddyinfo_t* info, int node, const char* zone, size_t zone_len)
+{
+    for (int i = 0; i < info->zone_count; i++)
+    {
+        buddy_zone_t* z = &info->zones[i];
+        if (z->node == node && strlen(z->zone) == zone_len && memcmp(z->zone, zone, zone_len) == 0)
+        {
+            return z;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Busca el índice de un tipo de migración, registrándolo si es nuevo.
+ * @return Índice del tipo, o -1 si no hay lugar.
+ */
+static int type_index(buddyinfo_t* info, const char* name, size_t len)
+{
+    for (int i = 0; i < info->type_count; i++)
+    {
+        if (strlen(info->type_names[i]) == len && memcmp(info->type_names[i], name, len) == 0)
+        {
+            return i;
+        }
+    }
+    if (info->type_count == PAGETYPE_MAX_TYPES || len >= sizeof(info->type_names[0]))
+    {
+        return -1;
+    }
+    memcpy(info->type_names[info->type_count], name, len);
+    info->type_names[info->type_count][len] = '\0';
+    return info->type_count++;
+}
+
+int read_buddyinfo(const char* path, buddyinfo_t* info)
+{
+    info->zone_count = 0;
+    info->have_types = false;
+    info->type_count = 0;
+    info->pageblock_order = BUDDY_DEFAULT_HUGEPAGE_ORDER;
+
+    if (procfs_read(path, &read_buf) != 0)
+    {
+        log_error("Error al abrir %s: %m", path);
+        return -1;
+    }
+
+    const char* end = read_buf.data + read_buf.len;
+    for (const char* line = read_buf.data; line < end; line = parse_next_line(line, end))
+    {
+        const char* line_end = parse_line_end(line, end);
+        const char* zone;
+        size_t zone_len;
+        int node;
+        const char* p = parse_zone_prefix(line, line_end, &node, &zone, &zone_len);
+        if (p == NULL || info->zone_count == BUDDY_MAX_ZONES || zone_len >= sizeof(info->zones[0].zone))
+        {
+            continue;
+        }
+
+        buddy_zone_t* z = &info->zones[info->zone_count++];
+        memset(z, 0, sizeof(*z));
+        z->node = node;
+        memcpy(z->zone, zone, zone_len);
+        z->zone[zone_len] = '\0';
+        z->orders = (int)parse_u64_fields(p, line_end, z->free_blocks, BUDDY_MAX_ORDER);
+    }
+
+    if (info->zone_count == 0)
+    {
+        log_error("No se encontraron zonas en %s", path);
+        return -1;
+    }
+    return 0;
+}
+
+int read_pagetypeinfo(const char* path, buddyinfo_t* info)
+{
+    info->have_types = false;
+
+    if (procfs_read(path, &read_buf) != 0)
+    {
+        // Sin permisos (no root) no es un error: solo faltan los datos por tipo
+        if (errno != EACCES && errno != EPERM)
+        {
+            log_error("Error al abrir %s: %m", path);
+        }
+        return -1;
+    }
+
+    // Orden de cada columna de la tabla de pageblocks
+    int block_columns[PAGETYPE_MAX_TYPES];
+    int block_column_count = 0;
+
+    const char* end = read_buf.data + read_buf.len;
+    for (const char* line = read_buf.data; line < end; line = parse_next_line(line, end))
+    {
+        const char* line_end = parse_line_end(line, end);
+
+        if (parse_starts_with(line, line_end, "Page block order:", 17))
+        {
+            const char* p = parse_skip_spaces(line + 17, line_end);
+            info->pageblock_order = (int)parse_u64(&p, line_end);
+            continue;
+        }
+        if (parse_starts_with(line, line_end, "Number of blocks type", 21))
+        {
+            // Encabezado con los nombres de los tipos en el orden de las columnas
+            const char* p = line + 21;
+            block_column_count = 0;
+            while ((p = parse_skip_spaces(p, line_end)) < line_end && block_column_count < PAGETYPE_MAX_TYPES)
+            {
+                const char* name = p;
+                p = parse_skip_token(p, line_end);
+                block_columns[block_column_count++] = type_index(info, name, (size_t)(p - name));
+            }
+            continue;
+        }
+
+        const char* zone;
+        size_t zone_len;
+        int node;
+        const char* p = parse_zone_prefix(line, line_end, &node, &zone, &zone_len);
+        if (p == NULL)
+        {
+            continue;
+        }
+        buddy_zone_t* z = find_zone(info, node, zone, zone_len);
+        if (z == NULL)
+        {
+            continue;
+        }
+
+        if (parse_starts_with(p, line_end, ", type", 6))
+        {
+            // "Node N, zone Z, type T  k0 k1 ..." : bloques libres por orden de un tipo
+            const char* name = parse_skip_spaces(p + 6, line_end);
+            p = parse_skip_token(name, line_end);
+            int type = type_index(info, name, (size_t)(p - name));
+            uint64_t pages = 0;
+            for (int order = 0; order < BUDDY_MAX_ORDER; order++)
+            {
+                p = parse_skip_spaces(p, line_end);
+                if (p < line_end && *p == '>')
+                {
+                    p++; // El kernel satura los valores grandes como ">100000"
+                }
+                if (p >= line_end || !parse_is_digit(*p))
+                {
+                    break;
+                }
+                pages += parse_u64(&p, line_end) << order;
+            }
+            if (type >= 0)
+            {
+                z->type_free_pages[type] = pages;
+            }
+        }
+        else
+        {
+            // "Node N, zone Z  b0 b1 ..." : pageblocks por tipo, en el orden del encabezado
+            uint64_t blocks[PAGETYPE_MAX_TYPES];
+            size_t count = parse_u64_fields(p, line_end, blocks, (size_t)block_column_count);
+            for (size_t i = 0; i < count; i++)
+            {
+                if (block_columns[i] >= 0)
+                {
+                    z->type_blocks[block_columns[i]] = blocks[i];
+                }
+            }
+        }
+    }
+
+    info->have_types = info->type_count > 0;
+    return info->have_types ? 0 : -1;
+}
+
+uint64_t buddy_free_pages(const buddy_zone_t* zone)
+{
+    uint64_t pages = 0;
+    for (int order = 0; order < zone->orders; order++)
+    {
+        pages += zone->free_blocks[order] << order;
+    }
+    return pages;
+}
+
+double buddy_unusable_index(const buddy_zone_t* zone, int order)
+{
+    uint64_t total = buddy_free_pages(zone);
+    if (total == 0)
+    {
+        return 0.0;
+    }
+
+    // Páginas libres en bloques de al menos 2^order, que sí sirven para la reserva
+    uint64_t usable = 0;
+    for (int i = order; i < zone->orders; i++)
+    {
+        usable += zone->free_blocks[i] << i;
+    }
+    return (double)(total - usable) / (double)total;
+}
+
+uint64_t buddy_allocatable_blocks(const buddy_zone_t* zone, int order)
+{
+    uint64_t blocks = 0;
+    for (int i = order; i < zone->orders; i++)
+    {
+        blocks += zone->free_blocks[i] << (i - order);
+    }
+    return blocks;
+}
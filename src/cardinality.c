@@ -0,0 +1,618 @@
+#include "cardinality.h"
+#include "log.h"
+#include <fnmatch.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Capacidad inicial de la tabla de series de una familia.
+ */
+#define SERIES_INITIAL_SLOTS 64
+
+/**
+ * @brief Serie conocida de una familia, en una tabla de hash abierta.
+ */
+typedef struct
+{
+    uint64_t hash; /**< Hash de los valores de las etiquetas (0: lugar vacío). */
+    int pending;   /**< Posición en pending mientras la familia se retiene, o -1 si la serie está admitida. */
+} series_slot_t;
+
+/**
+ * @brief Valor retenido durante el primer tick de una familia con tope.
+ */
+typedef struct
+{
+    uint64_t hash; /**< Serie. */
+    double value;  /**< Valor a guardar (la suma de los avances si la métrica acumula). */
+    double rank;   /**< Valor con el que compite por un lugar. */
+    char* labels;  /**< Copia de los valores de las etiquetas, separados por '\0'. */
+} pending_t;
+
+/**
+ * @brief Métrica creada y sus series.
+ */
+typedef struct
+{
+    void* metric;                                   /**< Métrica de Prometheus. */
+    char* name;                                     /**< Nombre de la métrica. */
+    int label_count;                                /**< Etiquetas de la métrica. */
+    char* label_names[CARDINALITY_MAX_LABELS];      /**< Nombres de las etiquetas. */
+    bool cumulative;                                /**< Counter: los valores retenidos se suman. */
+    cardinality_store_fn store;                     /**< Guarda un valor en la métrica. */
+    bool registered;                                /**< Ya está en el registro de Prometheus. */
+    bool denied;                                    /**< Métrica denegada por las reglas instaladas. */
+    int rule_count;                                 /**< Reglas de etiqueta que aplican a la familia. */
+    short rule_index[CARDINALITY_MAX_PATTERNS];     /**< Regla en label_rules. */
+    unsigned char rule_label[CARDINALITY_MAX_PATTERNS]; /**< Posición de la etiqueta que evalúa. */
+    unsigned allow_mask;                            /**< Etiquetas con reglas permitidas (bit por posición). */
+    bool selected;                                  /**< Ya se eligieron sus series; si no, se retienen. */
+    series_slot_t* slots;                           /**< Series admitidas y retenidas. */
+    int slot_count;                                 /**< Tamaño de slots (potencia de 2). */
+    int admitted;                                   /**< Series admitidas. */
+    pending_t* pending;                             /**< Valores retenidos del tick en curso. */
+    int pending_count;                              /**< Valores válidos en pending. */
+    int pending_capacity;                           /**< Capacidad de pending. */
+    uint64_t dropped;                               /**< Muestras descartadas por el tope desde el último flush. */
+} family_t;
+
+static cardinality_rules_t* rules;
+static family_t families[CARDINALITY_MAX_FAMILIES];
+static int family_count;
+static int family_slots[CARDINALITY_MAX_FAMILIES * 2]; // Posición en families + 1, o 0 si está libre
+
+static unsigned hash_pointer(const void* metric)
+{
+    return (unsigned)(((uintptr_t)metric >> 4) * 2654435761u) & (CARDINALITY_MAX_FAMILIES * 2 - 1);
+}
+
+static family_t* find_family(const void* metric)
+{
+    for (unsigned slot = hash_pointer(metric);; slot = (slot + 1) & (CARDINALITY_MAX_FAMILIES * 2 - 1))
+    {
+        if (family_slots[slot] == 0)
+        {
+            return NULL;
+        }
+        if (families[family_slots[slot] - 1].metric == metric)
+        {
+            return &families[family_slots[slot] - 1];
+        }
+    }
+}
+
+static uint64_t hash_labels(const char** labels, int count)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (int i = 0; i < count; i++)
+    {
+        for (const unsigned char* p = (const unsigned char*)labels[i]; *p != '\0'; p++)
+        {
+            hash = (hash ^ *p) * 1099511628211ull;
+        }
+        hash = (hash ^ 0xff) * 1099511628211ull;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+static int compile_pattern(cardinality_pattern_t* pattern, const char* text, char* error, size_t error_len)
+{
+    size_t length = strlen(text);
+    memset(pattern, 0, sizeof(*pattern));
+    if (length == 0 || length >= sizeof(pattern->text))
+    {
+        snprintf(error, error_len, "patrón vacío o de más de %zu caracteres", sizeof(pattern->text) - 1);
+        return -1;
+    }
+    memcpy(pattern->text, text, length + 1);
+
+    if (length >= 2 && text[0] == '/' && text[length - 1] == '/')
+    {
+        // Anclada como en el relabeling de Prometheus: debe coincidir con todo el valor
+        char anchored[sizeof(pattern->text) + 8];
+        snprintf(anchored, sizeof(anchored), "^(%.*s)$", (int)(length - 2), text + 1);
+        int rc = regcomp(&pattern->compiled, anchored, REG_EXTENDED | REG_NOSUB);
+        if (rc != 0)
+        {
+            regerror(rc, &pattern->compiled, error, error_len);
+            return -1;
+        }
+        pattern->regex = true;
+        return 0;
+    }
+    pattern->any = strcmp(text, "*") == 0;
+    pattern->literal = strpbrk(text, "*?[\\") == NULL;
+    return 0;
+}
+
+static bool pattern_match(const cardinality_pattern_t* pattern, const char* value)
+{
+    if (pattern->any)
+    {
+        return true;
+    }
+    if (pattern->regex)
+    {
+        return regexec(&pattern->compiled, value, 0, NULL, 0) == 0;
+    }
+    if (pattern->literal)
+    {
+        return strcmp(pattern->text, value) == 0;
+    }
+    return fnmatch(pattern->text, value, 0) == 0;
+}
+
+cardinality_rules_t* cardinality_rules_new(void)
+{
+    cardinality_rules_t* created = calloc(1, sizeof(*created));
+    if (created == NULL)
+    {
+        fprintf(stderr, "Error al reservar las reglas de cardinalidad\n");
+    }
+    return created;
+}
+
+int cardinality_rules_add_metric(cardinality_rules_t* target, bool deny, const char* pattern, char* error,
+                                 size_t error_len)
+{
+    int* count = deny ? &target->metric_deny_count : &target->metric_allow_count;
+    if (*count >= CARDINALITY_MAX_PATTERNS)
+    {
+        snprintf(error, error_len, "más de %d patrones", CARDINALITY_MAX_PATTERNS);
+        return -1;
+    }
+    cardinality_pattern_t* slot = deny ? &target->metric_deny[*count] : &target->metric_allow[*count];
+    if (compile_pattern(slot, pattern, error, error_len) != 0)
+    {
+        return -1;
+    }
+    (*count)++;
+    return 0;
+}
+
+int cardinality_rules_add_label(cardinality_rules_t* target, bool deny, const char* rule, char* error,
+                                size_t error_len)
+{
+    if (target->label_rule_count >= CARDINALITY_MAX_PATTERNS)
+    {
+        snprintf(error, error_len, "más de %d reglas", CARDINALITY_MAX_PATTERNS);
+        return -1;
+    }
+    const char* equals = strchr(rule, '=');
+    size_t label_length = equals != NULL ? (size_t)(equals - rule) : 0;
+    if (label_length == 0 || label_length >= CARDINALITY_LABEL_MAX)
+    {
+        snprintf(error, error_len, "se espera etiqueta=patrón");
+        return -1;
+    }
+
+    cardinality_label_rule_t* slot = &target->label_rules[target->label_rule_count];
+    if (compile_pattern(&slot->pattern, equals + 1, error, error_len) != 0)
+    {
+        return -1;
+    }
+    memcpy(slot->label, rule, label_length);
+    slot->label[label_length] = '\0';
+    slot->deny = deny;
+    target->label_rule_count++;
+    return 0;
+}
+
+void cardinality_rules_free(cardinality_rules_t* target)
+{
+    if (target == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < target->metric_allow_count; i++)
+    {
+        if (target->metric_allow[i].regex)
+        {
+            regfree(&target->metric_allow[i].compiled);
+        }
+    }
+    for (int i = 0; i < target->metric_deny_count; i++)
+    {
+        if (target->metric_deny[i].regex)
+        {
+            regfree(&target->metric_deny[i].compiled);
+        }
+    }
+    for (int i = 0; i < target->label_rule_count; i++)
+    {
+        if (target->label_rules[i].pattern.regex)
+        {
+            regfree(&target->label_rules[i].pattern.compiled);
+        }
+    }
+    free(target);
+}
+
+/**
+ * @brief Evalúa las reglas de nombre y arma la lista de reglas de etiqueta que aplican a la familia.
+ */
+static void classify_family(family_t* family)
+{
+    family->denied = false;
+    family->rule_count = 0;
+    family->allow_mask = 0;
+    if (rules == NULL)
+    {
+        return;
+    }
+
+    bool allowed = rules->metric_allow_count == 0;
+    for (int i = 0; i < rules->metric_allow_count && !allowed; i++)
+    {
+        allowed = pattern_match(&rules->metric_allow[i], family->name);
+    }
+    for (int i = 0; i < rules->metric_deny_count && allowed; i++)
+    {
+        allowed = !pattern_match(&rules->metric_deny[i], family->name);
+    }
+    family->denied = !allowed;
+
+    for (int r = 0; r < rules->label_rule_count; r++)
+    {
+        for (int position = 0; position < family->label_count; position++)
+        {
+            if (strcmp(rules->label_rules[r].label, family->label_names[position]) == 0)
+            {
+                family->rule_index[family->rule_count] = (short)r;
+                family->rule_label[family->rule_count] = (unsigned char)position;
+                family->rule_count++;
+                family->allow_mask |= rules->label_rules[r].deny ? 0u : 1u << position;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Evalúa las reglas de etiqueta sobre una serie.
+ * @return true si la serie pasa: ningún valor denegado y cada etiqueta con reglas permitidas coincide con alguna.
+ */
+static bool labels_pass(const family_t* family, const char** labels)
+{
+    unsigned allowed = 0;
+    for (int i = 0; i < family->rule_count; i++)
+    {
+        const cardinality_label_rule_t* rule = &rules->label_rules[family->rule_index[i]];
+        unsigned bit = 1u << family->rule_label[i];
+        if (!rule->deny && (allowed & bit) != 0)
+        {
+            continue;
+        }
+        if (pattern_match(&rule->pattern, labels[family->rule_label[i]]))
+        {
+            if (rule->deny)
+            {
+                return false;
+            }
+            allowed |= bit;
+        }
+    }
+    return (family->allow_mask & ~allowed) == 0;
+}
+
+void cardinality_install(cardinality_rules_t* next)
+{
+    cardinality_rules_free(rules);
+    rules = next;
+    for (int i = 0; i < family_count; i++)
+    {
+        classify_family(&families[i]);
+    }
+}
+
+int cardinality_track(void* metric, const char* name, int label_count, const char** label_names, bool cumulative,
+                      cardinality_store_fn store)
+{
+    if (family_count >= CARDINALITY_MAX_FAMILIES || label_count > CARDINALITY_MAX_LABELS ||
+        find_family(metric) != NULL)
+    {
+        fprintf(stderr, "No se puede seguir la cardinalidad de %s\n", name);
+        return -1;
+    }
+    family_t* family = &families[family_count];
+    memset(family, 0, sizeof(*family));
+    family->metric = metric;
+    family->name = strdup(name);
+    family->label_count = label_count;
+    family->cumulative = cumulative;
+    family->store = store;
+    bool ok = family->name != NULL;
+    for (int i = 0; i < label_count && ok; i++)
+    {
+        ok = (family->label_names[i] = strdup(label_names[i])) != NULL;
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "Error al reservar la familia %s\n", name);
+        free(family->name);
+        for (int i = 0; i < label_count; i++)
+        {
+            free(family->label_names[i]);
+        }
+        return -1;
+    }
+    classify_family(family);
+
+    unsigned slot = hash_pointer(metric);
+    while (family_slots[slot] != 0)
+    {
+        slot = (slot + 1) & (CARDINALITY_MAX_FAMILIES * 2 - 1);
+    }
+    family_slots[slot] = ++family_count;
+    return 0;
+}
+
+bool cardinality_claim_registration(void* metric)
+{
+    family_t* family = find_family(metric);
+    if (family == NULL || family->registered || family->denied)
+    {
+        return false;
+    }
+    family->registered = true;
+    return true;
+}
+
+/**
+ * @brief Lugar de la serie en la tabla: el que tiene su hash o el vacío donde iría.
+ */
+static series_slot_t* find_series(const family_t* family, uint64_t hash)
+{
+    int mask = family->slot_count - 1;
+    for (int slot = (int)(hash & (uint64_t)mask);; slot = (slot + 1) & mask)
+    {
+        if (family->slots[slot].hash == hash || family->slots[slot].hash == 0)
+        {
+            return &family->slots[slot];
+        }
+    }
+}
+
+/**
+ * @brief Rearma la tabla de series con otro tamaño; las retenidas se descartan si keep_pending es false.
+ * @return 0 si se rearmó, -1 si no hay memoria.
+ */
+static int rebuild_series(family_t* family, int slot_count, bool keep_pending)
+{
+    series_slot_t* old = family->slots;
+    int old_count = family->slot_count;
+    series_slot_t* fresh = calloc((size_t)slot_count, sizeof(*fresh));
+    if (fresh == NULL)
+    {
+        return -1;
+    }
+    family->slots = fresh;
+    family->slot_count = slot_count;
+    for (int i = 0; i < old_count; i++)
+    {
+        if (old[i].hash != 0 && (keep_pending || old[i].pending < 0))
+        {
+            *find_series(family, old[i].hash) = old[i];
+        }
+    }
+    free(old);
+    return 0;
+}
+
+/**
+ * @brief Copia los valores de las etiquetas en un solo bloque para guardarlos al cerrar el tick.
+ */
+static char* copy_labels(const char** labels, int count)
+{
+    size_t total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        total += strlen(labels[i]) + 1;
+    }
+    char* copy = malloc(total > 0 ? total : 1);
+    char* cursor = copy;
+    for (int i = 0; i < count && copy != NULL; i++)
+    {
+        size_t length = strlen(labels[i]) + 1;
+        memcpy(cursor, labels[i], length);
+        cursor += length;
+    }
+    return copy;
+}
+
+static void store_pending(const family_t* family, const pending_t* pending)
+{
+    const char* labels[CARDINALITY_MAX_LABELS];
+    const char* cursor = pending->labels;
+    for (int i = 0; i < family->label_count; i++)
+    {
+        labels[i] = cursor;
+        cursor += strlen(cursor) + 1;
+    }
+    family->store(family->metric, pending->value, labels);
+}
+
+/**
+ * @brief Retiene el primer valor de una serie nueva mientras la familia no eligió sus series.
+ */
+static void hold_series(family_t* family, series_slot_t* slot, uint64_t hash, double value, double rank,
+                        const char** labels)
+{
+    if (family->pending_count == family->pending_capacity)
+    {
+        int capacity = family->pending_capacity > 0 ? family->pending_capacity * 2 : SERIES_INITIAL_SLOTS;
+        pending_t* grown = realloc(family->pending, (size_t)capacity * sizeof(*grown));
+        if (grown == NULL)
+        {
+            log_error("Sin memoria para retener las series de %s", family->name);
+            return;
+        }
+        family->pending = grown;
+        family->pending_capacity = capacity;
+    }
+    char* copy = copy_labels(labels, family->label_count);
+    if (copy == NULL)
+    {
+        log_error("Sin memoria para retener las series de %s", family->name);
+        return;
+    }
+    family->pending[family->pending_count] = (pending_t){hash, value, rank, copy};
+    *slot = (series_slot_t){hash, family->pending_count++};
+}
+
+void cardinality_store(void* metric, double value, double rank, const char** labels)
+{
+    family_t* family = find_family(metric);
+    if (family == NULL)
+    {
+        return;
+    }
+    if (rules == NULL)
+    {
+        family->store(metric, value, labels);
+        return;
+    }
+    if (family->denied || (family->rule_count > 0 && !labels_pass(family, labels)))
+    {
+        return;
+    }
+    if (rules->max_series == 0 || family->label_count == 0)
+    {
+        family->store(metric, value, labels);
+        return;
+    }
+
+    // La tabla se mantiene a menos de la mitad de carga
+    if ((family->admitted + family->pending_count + 1) * 2 > family->slot_count &&
+        rebuild_series(family, family->slot_count > 0 ? family->slot_count * 2 : SERIES_INITIAL_SLOTS, true) != 0)
+    {
+        log_error("Sin memoria para las series de %s", family->name);
+        return;
+    }
+
+    uint64_t hash = hash_labels(labels, family->label_count);
+    series_slot_t* slot = find_series(family, hash);
+    if (slot->hash == hash && slot->pending < 0)
+    {
+        family->store(metric, value, labels);
+    }
+    else if (slot->hash == hash)
+    {
+        pending_t* pending = &family->pending[slot->pending];
+        pending->value = family->cumulative ? pending->value + value : value;
+        pending->rank = rank;
+    }
+    else if (!family->selected)
+    {
+        hold_series(family, slot, hash, value, rank, labels);
+    }
+    else if (family->admitted < rules->max_series)
+    {
+        *slot = (series_slot_t){hash, -1};
+        family->admitted++;
+        family->store(metric, value, labels);
+    }
+    else
+    {
+        family->dropped++;
+    }
+}
+
+/**
+ * @brief Par (valor, posición) para ordenar los valores retenidos sin qsort_r.
+ */
+typedef struct
+{
+    double rank;
+    int index;
+} ranked_t;
+
+static int compare_ranked(const void* a, const void* b)
+{
+    const ranked_t* x = a;
+    const ranked_t* y = b;
+    if (x->rank != y->rank)
+    {
+        return x->rank > y->rank ? -1 : 1;
+    }
+    return x->index - y->index; // Empate: primero la que apareció antes
+}
+
+/**
+ * @brief Admite las series retenidas de mayor valor hasta el tope y descarta el resto.
+ */
+static void select_series(family_t* family)
+{
+    int room = family->pending_count;
+    if (rules != NULL && rules->max_series > 0)
+    {
+        room = rules->max_series - family->admitted;
+        room = room < 0 ? 0 : room;
+    }
+
+    ranked_t* order = malloc((size_t)family->pending_count * sizeof(*order));
+    for (int i = 0; i < family->pending_count && order != NULL; i++)
+    {
+        order[i] = (ranked_t){family->pending[i].rank, i};
+    }
+    if (order != NULL)
+    {
+        qsort(order, (size_t)family->pending_count, sizeof(*order), compare_ranked);
+    }
+    else
+    {
+        log_warn("Sin memoria para ordenar las series de %s; se admiten en orden de llegada", family->name);
+    }
+
+    for (int k = 0; k < family->pending_count; k++)
+    {
+        pending_t* pending = &family->pending[order != NULL ? order[k].index : k];
+        if (k < room)
+        {
+            find_series(family, pending->hash)->pending = -1;
+            family->admitted++;
+            store_pending(family, pending);
+        }
+        else
+        {
+            family->dropped++;
+        }
+    }
+    for (int i = 0; i < family->pending_count; i++)
+    {
+        free(family->pending[i].labels);
+    }
+    free(order);
+    family->pending_count = 0;
+    family->selected = true;
+
+    // Las descartadas salen de la tabla; si no hay memoria para rearmarla quedan como admitidas
+    if (rebuild_series(family, family->slot_count, false) != 0)
+    {
+        log_error("Sin memoria para rearmar las series de %s", family->name);
+        for (int i = 0; i < family->slot_count; i++)
+        {
+            family->slots[i].pending = -1;
+        }
+    }
+}
+
+void cardinality_flush(cardinality_drop_fn on_drop)
+{
+    for (int i = 0; i < family_count; i++)
+    {
+        family_t* family = &families[i];
+        if (family->pending_count > 0)
+        {
+            select_series(family);
+        }
+        if (family->dropped > 0)
+        {
+            if (on_drop != NULL)
+            {
+                on_drop(family->name, family->dropped);
+            }
+            family->dropped = 0;
+        }
+    }
+}
@@ -0,0 +1,220 @@
+#include "collectors.h"
+#include "expose_metrics.h"
+#include "procfs.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Estado de un colector; solo lo toca el hilo del bucle de muestreo.
+ */
+typedef enum
+{
+    COLLECTOR_IDLE,  /**< Nunca se activó: sus métricas no existen. */
+    COLLECTOR_READY, /**< Métricas registradas. */
+    COLLECTOR_FAILED /**< Falló el registro; no se reintenta para no duplicar métricas. */
+} collector_state_t;
+
+/**
+ * @brief Disco monitoreado ("/dev/<nombre>") y el disk_device con el que se resolvió.
+ */
+static struct
+{
+    char path[256];
+    char device[32];
+    bool resolved;
+} disk;
+
+/**
+ * @brief Primer disco físico de /sys/block (los que tienen "device") en orden alfabético, o "sda".
+ *
+ * Reemplaza a ejecutar lsblk con popen(): no lanza un shell en el arranque y descarta loop, ram y zram.
+ */
+static void detect_disk(char* device, size_t len)
+{
+    char path[PROCFS_PATH_MAX];
+    device[0] = '\0';
+    DIR* dir = opendir(sysfs_path("block", path, sizeof(path)));
+    if (dir != NULL)
+    {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL)
+        {
+            char rel[320];
+            if (entry->d_name[0] == '.')
+            {
+                continue;
+            }
+            snprintf(rel, sizeof(rel), "block/%s/device", entry->d_name);
+            if (access(sysfs_path(rel, path, sizeof(path)), F_OK) == 0 &&
+                (device[0] == '\0' || strcmp(entry->d_name, device) < 0))
+            {
+                snprintf(device, len, "%s", entry->d_name);
+            }
+        }
+        closedir(dir);
+    }
+    if (device[0] == '\0')
+    {
+        snprintf(device, len, "sda");
+    }
+}
+
+static void collect_memory_fragmentation(const config_t* config)
+{
+    (void)config;
+    update_memory_fragmentation_gauge();
+}
+
+static void collect_cpu(const config_t* config)
+{
+    (void)config;
+    update_cpu_gauge();
+}
+
+static void collect_memory(const config_t* config)
+{
+    (void)config;
+    update_memory_gauge();
+}
+
+static void collect_disk(const config_t* config)
+{
+    (void)config;
+    update_disk_stats_gauge(disk.path);
+}
+
+static void collect_net(const config_t* config)
+{
+    update_net_stats_gauge(config->net_interface);
+}
+
+static void collect_context_switches(const config_t* config)
+{
+    (void)config;
+    update_context_switches_gauge();
+}
+
+static void collect_running_processes(const config_t* config)
+{
+    (void)config;
+    update_running_processes_gauge();
+}
+
+static void collect_meminfo(const config_t* config)
+{
+    (void)config;
+    update_meminfo_gauge();
+}
+
+static void collect_psi(const config_t* config)
+{
+    (void)config;
+    update_psi_gauge();
+}
+
+static void collect_interrupts(const config_t* config)
+{
+    update_interrupts_gauge(config->irq_top_k);
+}
+
+static void collect_cpufreq(const config_t* config)
+{
+    (void)config;
+    update_cpufreq_gauge();
+}
+
+static void collect_numa(const config_t* config)
+{
+    (void)config;
+    update_numa_gauge();
+}
+
+static void collect_netproto(const config_t* config)
+{
+    (void)config;
+    update_netproto_gauge();
+}
+
+static void collect_microsample(const config_t* config)
+{
+    (void)config;
+    update_microsample_gauge();
+}
+
+const collector_t collectors[] = {
+#define COLLECTOR(id, name, label, flag, sources)                                                                 \
+    {name, label, offsetof(config_t, flag), id##_metrics_register, collect_##id},
+#include "collector_list.h"
+#undef COLLECTOR
+};
+
+const int collector_count = (int)(sizeof(collectors) / sizeof(collectors[0]));
+
+static collector_state_t states[sizeof(collectors) / sizeof(collectors[0])];
+
+int collectors_prepare(const config_t* config)
+{
+    // El disco se resuelve una vez por valor de disk_device, no en cada tick
+    if (config->collect_disk && (!disk.resolved || strcmp(disk.device, config->disk_device) != 0))
+    {
+        char device[64];
+        if (config->disk_device[0] != '\0')
+        {
+            snprintf(device, sizeof(device), "%s", config->disk_device);
+        }
+        else
+        {
+            detect_disk(device, sizeof(device));
+        }
+        snprintf(disk.path, sizeof(disk.path), "/dev/%s", device);
+        snprintf(disk.device, sizeof(disk.device), "%s", config->disk_device);
+        disk.resolved = true;
+    }
+
+    int ready = 0;
+    for (int i = 0; i < collector_count; i++)
+    {
+        if (!config_flag_enabled(config, collectors[i].config_flag))
+        {
+            continue;
+        }
+        if (states[i] == COLLECTOR_IDLE)
+        {
+            states[i] = collectors[i].init() == 0 ? COLLECTOR_READY : COLLECTOR_FAILED;
+        }
+        ready += states[i] == COLLECTOR_READY;
+    }
+    return ready;
+}
+
+void collectors_collect(const config_t* config)
+{
+    // Los archivos del tick se releen juntos; cada colector toma su contenido del lote
+    procfs_batch_begin();
+    start_tick();
+    for (int i = 0; i < collector_count; i++)
+    {
+        if (states[i] == COLLECTOR_READY && config_flag_enabled(config, collectors[i].config_flag))
+        {
+            collectors[i].collect(config);
+        }
+    }
+    procfs_batch_end();
+
+    // Las familias nuevas eligen sus series con los valores de todo el tick
+    publish_cardinality();
+}
+
+const collector_t* collector_find(const char* name)
+{
+    for (int i = 0; i < collector_count; i++)
+    {
+        if (collectors[i].name != NULL && strcmp(collectors[i].name, name) == 0)
+        {
+            return &collectors[i];
+        }
+    }
+    return NULL;
+}
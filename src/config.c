@@ -1,21 +1,88 @@
 // config.c
 #include "config.h"
+#include "alerts.h"
+#include "allocator.h"
+#include "arena.h"
+#include "cardinality.h"
+#include "collectors.h"
+#include "events.h"
+#include "interrupts.h"
 #include "memory.h" // Incluir memory.h
 #include "expose_metrics.h"
+#include "metrics_json.h"
+#include "realtime.h"
 #include <cjson/cJSON.h>
 #include <fcntl.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
-#define FIFO_PATH "/tmp/metrics_fifo"
+// Copia un string opcional del JSON a un buffer de tamaño fijo
+static void copy_string_option(cJSON* root, const char* key, char* dest, size_t size, const char* fallback)
+{
+    cJSON* item = cJSON_GetObjectItem(root, key);
+    snprintf(dest, size, "%s", cJSON_IsString(item) ? item->valuestring : fallback);
+}
+
+// Compila las listas "allow" y "deny" de un objeto de "cardinality"; devuelve los patrones rechazados
+static int add_cardinality_patterns(cardinality_rules_t* rules, cJSON* lists, bool labels)
+{
+    int rejected = 0;
+    const char* keys[] = {"allow", "deny"};
+    for (int deny = 0; deny < 2; deny++)
+    {
+        cJSON* pattern;
+        cJSON_ArrayForEach(pattern, cJSON_GetObjectItem(lists, keys[deny]))
+        {
+            char error[96];
+            if (!cJSON_IsString(pattern))
+            {
+                fprintf(stderr, "Patrón de cardinalidad en formato incorrecto\n");
+                rejected++;
+                continue;
+            }
+            int rc = labels ? cardinality_rules_add_label(rules, deny, pattern->valuestring, error, sizeof(error))
+                            : cardinality_rules_add_metric(rules, deny, pattern->valuestring, error, sizeof(error));
+            if (rc != 0)
+            {
+                fprintf(stderr, "Patrón de cardinalidad inválido '%s': %s\n", pattern->valuestring, error);
+                rejected++;
+            }
+        }
+    }
+    return rejected;
+}
+
+// Lee una lista de CPUs de "realtime"; con una lista inválida el hilo queda sin fijar y devuelve 1
+static int parse_cpu_option(cJSON* realtime, const char* key, realtime_cpuset_t* set)
+{
+    cJSON* item = cJSON_GetObjectItem(realtime, key);
+    char list[32], error[96] = "formato incorrecto";
+    if (cJSON_IsNumber(item))
+    {
+        snprintf(list, sizeof(list), "%d", item->valueint); // Una sola CPU: "collector_cpus": 2
+    }
+    const char* text = cJSON_IsString(item) ? item->valuestring : cJSON_IsNumber(item) ? list : NULL;
+    if (text != NULL && realtime_parse_cpus(text, set, error, sizeof(error)) == 0)
+    {
+        return 0;
+    }
+    memset(set, 0, sizeof(*set));
+    if (item != NULL)
+    {
+        fprintf(stderr, "CPUs de %s inválidas: %s\n", key, error);
+        return 1;
+    }
+    return 0;
+}
 
 // Cargar configuración desde config.json usando cJSON
-bool load_config(const char* filename, config_t* config)
+bool load_config(const char* filename, config_t* config, int* rejected_entries)
 {
+    int rejected = 0; // Entradas inválidas que no se aplicaron
     FILE* file = fopen(filename, "r");
-    printf("Intentando abrir %s\n", filename);
     if (!file)
     {
         fprintf(stderr, "Error al abrir el archivo %s\n", filename);
@@ -26,13 +93,19 @@ bool load_config(const char* filename, config_t* config)
     long file_size = ftell(file);
     fseek(file, 0, SEEK_SET);
 
-    char* file_contents = (char*)malloc(file_size + 1);
+    // El contenido y el árbol de cJSON se descartan con el arena al terminar el tick
+    char* file_contents = tick_alloc(file_size + 1);
+    if (file_contents == NULL)
+    {
+        fclose(file);
+        fprintf(stderr, "Error al reservar memoria para %s\n", filename);
+        return false;
+    }
     fread(file_contents, 1, file_size, file);
     file_contents[file_size] = '\0';
     fclose(file);
 
     cJSON* root = cJSON_Parse(file_contents);
-    free(file_contents);
     if (!root)
     {
         fprintf(stderr, "Error al parsear JSON\n");
@@ -41,73 +114,47 @@ bool load_config(const char* filename, config_t* config)
 
     // Obtener el intervalo de muestreo
     cJSON* interval = cJSON_GetObjectItem(root, "sampling_interval");
-    if (cJSON_IsNumber(interval))
+    if (cJSON_IsNumber(interval) && interval->valueint <= 0)
     {
-        config->sampling_interval = interval->valueint;
-        printf("Intervalo de muestreo: %d\n", config->sampling_interval);
+        fprintf(stderr, "Intervalo de muestreo inválido: %d\n", interval->valueint);
+        cJSON_Delete(root);
+        return false;
     }
-    else
+    config->sampling_interval = cJSON_IsNumber(interval) ? interval->valueint : 1; // 1 s si no se indica
+
+    // Todos los colectores de la lista "metrics" arrancan desactivados
+    for (int i = 0; i < collector_count; i++)
     {
-        config->sampling_interval = 1; // Valor predeterminado en caso de error
-        printf("Intervalo de muestreo no encontrado, usando valor predeterminado: 1\n");
+        if (collectors[i].name != NULL)
+        {
+            *config_flag(config, collectors[i].config_flag) = false;
+        }
     }
 
-    // Inicializar todas las métricas en falso
-    config->collect_cpu = config->collect_memory = config->collect_disk = config->collect_net = false;
-    config->collect_context_switches = config->collect_running_processes = false;
-    config->collect_memory_fragmentation = false; // Agregar para fragmentación
-
     // Obtener la lista de métricas
     cJSON* metrics = cJSON_GetObjectItem(root, "metrics");
     if (cJSON_IsArray(metrics))
     {
-        int metrics_count = cJSON_GetArraySize(metrics);
-        printf("Número de métricas: %d\n", metrics_count);
-        for (int i = 0; i < metrics_count; i++)
+        cJSON* metric;
+        cJSON_ArrayForEach(metric, metrics)
         {
-            cJSON* metric = cJSON_GetArrayItem(metrics, i);
-            if (cJSON_IsString(metric))
+            const collector_t* collector = cJSON_IsString(metric) ? collector_find(metric->valuestring) : NULL;
+            if (collector != NULL)
             {
-                printf("Leyendo métrica: %s\n", metric->valuestring);
-                if (strcmp(metric->valuestring, "cpu") == 0)
-                {
-                    config->collect_cpu = true;
-                }
-                else if (strcmp(metric->valuestring, "memory") == 0)
-                {
-                    config->collect_memory = true;
-                }
-                else if (strcmp(metric->valuestring, "disk") == 0)
-                {
-                    config->collect_disk = true;
-                }
-                else if (strcmp(metric->valuestring, "net") == 0)
-                {
-                    config->collect_net = true;
-                }
-                else if (strcmp(metric->valuestring, "context_switches") == 0)
-                {
-                    config->collect_context_switches = true;
-                }
-                else if (strcmp(metric->valuestring, "running_processes") == 0)
-                {
-                    config->collect_running_processes = true;
-                }
-                else if (strcmp(metric->valuestring, "memory_fragmentation") == 0)
-                {
-                    config->collect_memory_fragmentation = true;
-                }
+                *config_flag(config, collector->config_flag) = true;
+            }
+            else if (cJSON_IsString(metric))
+            {
+                fprintf(stderr, "Métrica desconocida: %s\n", metric->valuestring);
+                rejected++;
             }
             else
             {
-                printf("Métrica en formato incorrecto\n");
+                fprintf(stderr, "Métrica en formato incorrecto\n");
+                rejected++;
             }
         }
     }
-    else
-    {
-        printf("La lista de métricas no es un array o está ausente\n");
-    }
 
     // Obtener el archivo de log (opcional)
     cJSON* log_file = cJSON_GetObjectItem(root, "log_file");
@@ -115,18 +162,12 @@ bool load_config(const char* filename, config_t* config)
     {
         strncpy(config->log_file, log_file->valuestring, sizeof(config->log_file) - 1);
         config->log_file[sizeof(config->log_file) - 1] = '\0';
-        printf("Archivo de log: %s\n", config->log_file);
-    }
-    else
-    {
-        printf("Archivo de log no especificado\n");
     }
 
     // Obtener el método de asignación (opcional)
     cJSON* allocation_method = cJSON_GetObjectItem(root, "allocation_method");
     if (cJSON_IsString(allocation_method))
     {
-        printf("Método de asignación: %s\n", allocation_method->valuestring);
         if (strcmp(allocation_method->valuestring, "first_fit") == 0)
         {
             config->allocation_method = FIRST_FIT;
@@ -139,92 +180,357 @@ bool load_config(const char* filename, config_t* config)
         {
             config->allocation_method = WORST_FIT;
         }
+        else if (strcmp(allocation_method->valuestring, "segregated_fit") == 0)
+        {
+            config->allocation_method = SEGREGATED_FIT;
+        }
         else
         {
-            printf("Método de asignación desconocido, usando 'first_fit'\n");
+            fprintf(stderr, "Método de asignación desconocido '%s'\n", allocation_method->valuestring);
             config->allocation_method = FIRST_FIT;
+            rejected++;
         }
     }
     else
     {
-        printf("Método de asignación no especificado, usando 'first_fit'\n");
         config->allocation_method = FIRST_FIT;
     }
 
-    // Mostrar los estados de las métricas después de la carga
-    printf("Estados de métricas:\n");
-    printf("  CPU: %s\n", config->collect_cpu ? "Activado" : "Desactivado");
-    printf("  Memoria: %s\n", config->collect_memory ? "Activado" : "Desactivado");
-    printf("  Disco: %s\n", config->collect_disk ? "Activado" : "Desactivado");
-    printf("  Red: %s\n", config->collect_net ? "Activado" : "Desactivado");
-    printf("  Cambios de contexto: %s\n", config->collect_context_switches ? "Activado" : "Desactivado");
-    printf("  Procesos en ejecución: %s\n", config->collect_running_processes ? "Activado" : "Desactivado");
-    printf("  Fragmentación de memoria: %s\n", config->collect_memory_fragmentation ? "Activado" : "Desactivado");
+    // Fuentes de datos: raíces de /proc y /sys, y replay de snapshots grabados (opcionales)
+    copy_string_option(root, "proc_root", config->proc_root, sizeof(config->proc_root), "");
+    copy_string_option(root, "sys_root", config->sys_root, sizeof(config->sys_root), "");
+    copy_string_option(root, "replay_dir", config->replay_dir, sizeof(config->replay_dir), "");
+    cJSON* procfs_batch = cJSON_GetObjectItem(root, "procfs_batch");
+    config->procfs_batch = PROCFS_BATCH_OFF;
+    if (cJSON_IsString(procfs_batch))
+    {
+        if (strcmp(procfs_batch->valuestring, "pread") == 0)
+        {
+            config->procfs_batch = PROCFS_BATCH_PREAD;
+        }
+        else if (strcmp(procfs_batch->valuestring, "io_uring") == 0)
+        {
+            config->procfs_batch = PROCFS_BATCH_IO_URING;
+        }
+        else if (strcmp(procfs_batch->valuestring, "off") != 0)
+        {
+            fprintf(stderr, "Backend de lectura por lote desconocido '%s'\n", procfs_batch->valuestring);
+            rejected++;
+        }
+    }
+    cJSON* replay_speed = cJSON_GetObjectItem(root, "replay_speed");
+    config->replay_speed = cJSON_IsNumber(replay_speed) ? replay_speed->valuedouble : 1.0;
+    config->replay_loop = cJSON_IsTrue(cJSON_GetObjectItem(root, "replay_loop"));
+
+    // Dispositivos a monitorear (opcionales)
+    copy_string_option(root, "disk_device", config->disk_device, sizeof(config->disk_device), "");
+    copy_string_option(root, "net_interface", config->net_interface, sizeof(config->net_interface), "wlp1s0");
+
+    // Triggers de PSI (opcionales): [{"resource": "memory", "kind": "some", "stall_us": 150000, "window_us": 1000000}]
+    cJSON* psi_triggers = cJSON_GetObjectItem(root, "psi_triggers");
+    if (cJSON_IsArray(psi_triggers))
+    {
+        config->psi_trigger_count = 0;
+        cJSON* trigger;
+        cJSON_ArrayForEach(trigger, psi_triggers)
+        {
+            cJSON* resource = cJSON_GetObjectItem(trigger, "resource");
+            cJSON* kind = cJSON_GetObjectItem(trigger, "kind");
+            cJSON* stall = cJSON_GetObjectItem(trigger, "stall_us");
+            cJSON* window = cJSON_GetObjectItem(trigger, "window_us");
+            int index = cJSON_IsString(resource) ? psi_resource_from_name(resource->valuestring) : -1;
+            if (index < 0 || !cJSON_IsNumber(stall) || !cJSON_IsNumber(window) ||
+                config->psi_trigger_count == PSI_MAX_TRIGGERS)
+            {
+                fprintf(stderr, "Trigger de PSI inválido\n");
+                rejected++;
+                continue;
+            }
+            psi_trigger_t* t = &config->psi_triggers[config->psi_trigger_count++];
+            t->resource = (psi_resource_t)index;
+            t->full = cJSON_IsString(kind) && strcmp(kind->valuestring, "full") == 0;
+            t->stall_us = (uint32_t)stall->valueint;
+            t->window_us = (uint32_t)window->valueint;
+        }
+    }
+    else
+    {
+        config->psi_trigger_count = psi_default_triggers(config->psi_triggers);
+    }
+
+    // Muestreo adaptativo (opcional): {"enabled": true, "slow_interval_ms": 10000, "fast_interval_ms": 100, ...}
+    adaptive_config_defaults(&config->adaptive, config->sampling_interval);
+    cJSON* adaptive = cJSON_GetObjectItem(root, "adaptive_sampling");
+    if (cJSON_IsObject(adaptive))
+    {
+        adaptive_config_t* a = &config->adaptive;
+        cJSON* item;
+        a->enabled = !cJSON_IsFalse(cJSON_GetObjectItem(adaptive, "enabled"));
+        if (cJSON_IsNumber(item = cJSON_GetObjectItem(adaptive, "slow_interval_ms")) && item->valueint > 0)
+        {
+            a->slow_interval_ms = item->valueint;
+        }
+        if (cJSON_IsNumber(item = cJSON_GetObjectItem(adaptive, "fast_interval_ms")) && item->valueint > 0)
+        {
+            a->fast_interval_ms = item->valueint;
+        }
+        if (cJSON_IsNumber(item = cJSON_GetObjectItem(adaptive, "calm_ms")))
+        {
+            a->calm_ms = item->valueint;
+        }
+        if (cJSON_IsNumber(item = cJSON_GetObjectItem(adaptive, "max_burst_ms")))
+        {
+            a->max_burst_ms = item->valueint;
+        }
+        if (cJSON_IsNumber(item = cJSON_GetObjectItem(adaptive, "cooldown_ms")))
+        {
+            a->cooldown_ms = item->valueint;
+        }
+        if (cJSON_IsNumber(item = cJSON_GetObjectItem(adaptive, "cpu_threshold")))
+        {
+            a->cpu_threshold = item->valuedouble;
+        }
+        if (cJSON_IsNumber(item = cJSON_GetObjectItem(adaptive, "ctxt_rate_factor")))
+        {
+            a->ctxt_rate_factor = item->valuedouble;
+        }
+        if (cJSON_IsNumber(item = cJSON_GetObjectItem(adaptive, "procs_running_growth")))
+        {
+            a->procs_running_growth = item->valueint;
+        }
+        if (cJSON_IsNumber(item = cJSON_GetObjectItem(adaptive, "hysteresis")) && item->valuedouble > 0 &&
+            item->valuedouble <= 1)
+        {
+            a->hysteresis = item->valuedouble;
+        }
+
+        // Cada condición necesita el colector de su señal
+        if (a->enabled)
+        {
+            config->collect_cpu |= a->cpu_threshold > 0;
+            config->collect_context_switches |= a->ctxt_rate_factor > 0;
+            config->collect_running_processes |= a->procs_running_growth > 0;
+        }
+    }
+
+    // Baja latencia (opcional): {"collector_cpus": "2", "http_cpus": "3", "collector_priority": 50, ...}
+    realtime_config_defaults(&config->realtime);
+    cJSON* realtime = cJSON_GetObjectItem(root, "realtime");
+    if (cJSON_IsObject(realtime))
+    {
+        realtime_config_t* r = &config->realtime;
+        cJSON* item;
+        rejected += parse_cpu_option(realtime, "collector_cpus", &r->collector_cpus);
+        rejected += parse_cpu_option(realtime, "http_cpus", &r->http_cpus);
+        if (cJSON_IsNumber(item = cJSON_GetObjectItem(realtime, "collector_priority")))
+        {
+            if (item->valueint >= 0 && item->valueint <= 99)
+            {
+                r->collector_priority = item->valueint;
+            }
+            else
+            {
+                fprintf(stderr, "Prioridad SCHED_FIFO %d fuera de 0-99\n", item->valueint);
+                rejected++;
+            }
+        }
+        r->lock_memory = cJSON_IsTrue(cJSON_GetObjectItem(realtime, "lock_memory"));
+        if (cJSON_IsNumber(item = cJSON_GetObjectItem(realtime, "prefault_heap_kb")) && item->valueint >= 0)
+        {
+            r->prefault_heap_kb = item->valueint;
+        }
+        if (cJSON_IsNumber(item = cJSON_GetObjectItem(realtime, "prefault_stack_kb")) && item->valueint >= 0 &&
+            item->valueint <= 4096)
+        {
+            r->prefault_stack_kb = item->valueint;
+        }
+    }
+
+    // Series por archivo de interrupciones (top-K por tasa)
+    cJSON* top_k = cJSON_GetObjectItem(root, "irq_top_k");
+    config->irq_top_k = cJSON_IsNumber(top_k) && top_k->valueint > 0 ? top_k->valueint : 10;
+    if (config->irq_top_k > IRQ_TOP_K_MAX)
+    {
+        config->irq_top_k = IRQ_TOP_K_MAX;
+    }
+
+    // Micro-muestreo de CPU y procs_running dentro del intervalo (opcional, en milisegundos)
+    cJSON* micro = cJSON_GetObjectItem(root, "micro_sampling_ms");
+    config->micro_sampling_ms = cJSON_IsNumber(micro) && micro->valueint > 0 ? micro->valueint : 0;
+    config->collect_microsample = config->micro_sampling_ms > 0;
+
+    // Gauges de tasa por segundo junto a los counters acumulados (opcional, activado por defecto)
+    cJSON* rate_gauges = cJSON_GetObjectItem(root, "rate_gauges");
+    config->rate_gauges = !cJSON_IsBool(rate_gauges) || cJSON_IsTrue(rate_gauges);
+
+    // Reglas de alerta (opcionales): ["cpu_usage > 90 for 5s", {"name": "ctxt", "expr": "rate(context_switches) > 1e6"}]
+    config->alerts = NULL;
+    cJSON* alerts = cJSON_GetObjectItem(root, "alerts");
+    if (cJSON_IsArray(alerts) && cJSON_GetArraySize(alerts) > 0 && (config->alerts = alert_program_new()) != NULL)
+    {
+        cJSON* rule;
+        int index = 0;
+        cJSON_ArrayForEach(rule, alerts)
+        {
+            char default_name[16];
+            snprintf(default_name, sizeof(default_name), "alert_%d", index++);
+            cJSON* name = cJSON_IsObject(rule) ? cJSON_GetObjectItem(rule, "name") : NULL;
+            cJSON* expr = cJSON_IsObject(rule) ? cJSON_GetObjectItem(rule, "expr") : rule;
+            char error[96];
+            if (!cJSON_IsString(expr))
+            {
+                fprintf(stderr, "Regla de alerta en formato incorrecto\n");
+                rejected++;
+                continue;
+            }
+            if (alert_program_add(config->alerts, cJSON_IsString(name) ? name->valuestring : default_name,
+                                  expr->valuestring, error, sizeof(error)) != 0)
+            {
+                fprintf(stderr, "Regla de alerta inválida '%s': %s\n", expr->valuestring, error);
+                rejected++;
+            }
+        }
+        // Cada regla necesita el colector de su señal
+        alert_program_enable_collectors(config->alerts, config);
+    }
+
+    // Límites de cardinalidad (opcionales): {"max_series_per_metric": 500, "metrics": {"deny": ["vmstat_*"]},
+    // "labels": {"deny": ["cpu=/[0-9]{3,}/"]}}; un patrón entre barras es una expresión regular
+    config->cardinality = NULL;
+    cJSON* cardinality = cJSON_GetObjectItem(root, "cardinality");
+    if (cJSON_IsObject(cardinality) && (config->cardinality = cardinality_rules_new()) != NULL)
+    {
+        cJSON* max_series = cJSON_GetObjectItem(cardinality, "max_series_per_metric");
+        config->cardinality->max_series =
+            cJSON_IsNumber(max_series) && max_series->valueint > 0 ? max_series->valueint : 0;
+        rejected += add_cardinality_patterns(config->cardinality, cJSON_GetObjectItem(cardinality, "metrics"), false);
+        rejected += add_cardinality_patterns(config->cardinality, cJSON_GetObjectItem(cardinality, "labels"), true);
+    }
 
     cJSON_Delete(root);
+    if (rejected_entries != NULL)
+    {
+        *rejected_entries = rejected;
+    }
     return true;
 }
 
+// Agrega texto al resumen; lo que no entra se descarta
+static void summary_append(char* out, size_t len, size_t* used, const char* format, ...)
+    __attribute__((format(printf, 4, 5)));
 
-// Función para construir y enviar métricas a través del FIFO
-void send_metrics(config_t* config)
+static void summary_append(char* out, size_t len, size_t* used, const char* format, ...)
 {
-    // Crear el JSON con las métricas usando cJSON
-    cJSON* root = cJSON_CreateObject();
-    if (config->collect_cpu)
+    if (*used >= len)
+    {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(out + *used, len - *used, format, args);
+    va_end(args);
+    *used += n > 0 ? (size_t)n : 0;
+}
+
+void config_summary(const config_t* config, char* out, size_t len)
+{
+    size_t used = 0;
+    out[0] = '\0';
+
+    // Colectores activos desde la tabla de colectores
+    summary_append(out, len, &used, "cada %d s; colectores:", config->sampling_interval);
+    int active = 0;
+    for (int i = 0; i < collector_count; i++)
     {
-        cJSON_AddNumberToObject(root, "cpu_usage", get_cpu_usage());
+        if (config_flag_enabled(config, collectors[i].config_flag))
+        {
+            summary_append(out, len, &used, "%s %s", active++ > 0 ? "," : "", collectors[i].label);
+        }
+    }
+    if (active == 0)
+    {
+        summary_append(out, len, &used, " ninguno");
+    }
+
+    // Solo las opciones que se apartan del comportamiento por defecto
+    if (config->collect_interrupts)
+    {
+        summary_append(out, len, &used, "; interrupciones top %d", config->irq_top_k);
+    }
+    if (config->collect_psi)
+    {
+        summary_append(out, len, &used, "; %d triggers PSI", config->psi_trigger_count);
     }
-    if (config->collect_memory)
+    if (config->alerts != NULL)
     {
-        memory_info_t mem_info = get_memory_usage();
-        cJSON_AddNumberToObject(root, "total_memory", mem_info.total_mem);
-        cJSON_AddNumberToObject(root, "used_memory", mem_info.used_mem);
-        cJSON_AddNumberToObject(root, "free_memory", mem_info.free_mem);
+        summary_append(out, len, &used, "; %d alertas", config->alerts->rule_count);
     }
-    if (config->collect_disk)
+    if (config->cardinality != NULL)
     {
-        disk_stats_t disk_info = get_disk_stats("nvme0n1");
-        cJSON_AddNumberToObject(root, "disk_reads", disk_info.reads_completed);
-        cJSON_AddNumberToObject(root, "disk_writes", disk_info.writes_completed);
+        const cardinality_rules_t* rules = config->cardinality;
+        summary_append(out, len, &used, "; cardinalidad: %d+%d patrones de métrica, %d de etiqueta, tope %d",
+                       rules->metric_allow_count, rules->metric_deny_count, rules->label_rule_count,
+                       rules->max_series);
     }
-    if (config->collect_net)
+    if (!config->rate_gauges)
     {
-        net_stats_t net_info = get_net_stats("wlp1s0");
-        cJSON_AddNumberToObject(root, "rx_bytes", net_info.rx_bytes);
-        cJSON_AddNumberToObject(root, "tx_bytes", net_info.tx_bytes);
+        summary_append(out, len, &used, "; sin gauges de tasa");
     }
-    if (config->collect_context_switches)
+    if (config->procfs_batch != PROCFS_BATCH_OFF)
     {
-        cJSON_AddNumberToObject(root, "context_switches", get_context_switches());
+        summary_append(out, len, &used, "; lotes %s", procfs_batch_name(config->procfs_batch));
     }
-    if (config->collect_running_processes)
+    if (config->micro_sampling_ms > 0)
     {
-        cJSON_AddNumberToObject(root, "running_processes", get_running_processes());
+        summary_append(out, len, &used, "; micro-muestreo %d ms", config->micro_sampling_ms);
     }
-    if (config->collect_memory_fragmentation)
+    if (config->adaptive.enabled)
     {
-        double fragmentation = calculate_memory_fragmentation();
-        cJSON_AddNumberToObject(root, "memory_fragmentation", fragmentation);
+        summary_append(out, len, &used, "; adaptativo %d/%d ms", config->adaptive.slow_interval_ms,
+                       config->adaptive.fast_interval_ms);
     }
+    if (config->replay_dir[0] != '\0')
+    {
+        summary_append(out, len, &used, "; replay de %s x%.1f%s", config->replay_dir, config->replay_speed,
+                       config->replay_loop ? " en bucle" : "");
+    }
+    if (realtime_config_active(&config->realtime))
+    {
+        char collector[128], http[128];
+        realtime_format_cpus(&config->realtime.collector_cpus, collector, sizeof(collector));
+        realtime_format_cpus(&config->realtime.http_cpus, http, sizeof(http));
+        summary_append(out, len, &used, "; colector en CPUs %s, HTTP en CPUs %s, SCHED_FIFO %d, memoria %s",
+                       collector[0] != '\0' ? collector : "(sin fijar)", http[0] != '\0' ? http : "(sin fijar)",
+                       config->realtime.collector_priority,
+                       config->realtime.lock_memory ? "bloqueada" : "sin bloquear");
+    }
+    int method = config->allocation_method;
+    summary_append(out, len, &used, "; asignación %s",
+                   method == BEST_FIT         ? "best_fit"
+                   : method == WORST_FIT      ? "worst_fit"
+                   : method == SEGREGATED_FIT ? "segregated_fit"
+                                              : "first_fit");
+    summary_append(out, len, &used, "; log %s", config->log_file[0] != '\0' ? config->log_file : "stderr");
+}
 
-    // Convertir el JSON a una cadena
-    char* json_string = cJSON_Print(root);
-    cJSON_Delete(root);
+// Función para construir y enviar métricas a través del FIFO
+void send_metrics(config_t* config)
+{
+    // Reutilizar lo leído en el tick en lugar de volver a leer /proc
+    metrics_sample_t sample;
+    get_last_sample(&sample);
 
-    // Abrir el FIFO en modo escritura (crearlo si no existe)
-    int fifo_fd = open(FIFO_PATH, O_WRONLY | O_CREAT, 0666);
-    if (fifo_fd == -1)
+    // El texto vive en el arena del tick: no hay malloc ni free por envío
+    size_t length;
+    char* json_string = metrics_json_encode(config, &sample, &length);
+    if (json_string == NULL)
     {
-        perror("Error al abrir el FIFO");
-        free(json_string);
+        fprintf(stderr, "Error al codificar las métricas\n");
         return;
     }
 
-    // Enviar la cadena JSON a través del FIFO
-    write(fifo_fd, json_string, strlen(json_string));
-    close(fifo_fd);
-    free(json_string); // Liberar la cadena JSON
+    // Enviar la cadena JSON a través del FIFO; los eventos de otros hilos no se intercalan
+    fifo_write(json_string, length);
 }
 
 // config.c
@@ -0,0 +1,103 @@
+#include "config_watch.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+/**
+ * @brief Estado del watcher; solo lo toca el hilo principal, salvo reload_requested.
+ */
+static struct
+{
+    int fd;                  // Descriptor de inotify, o -1
+    char name[NAME_MAX + 1]; // Nombre del archivo dentro del directorio vigilado
+} watch = {.fd = -1};
+
+static volatile sig_atomic_t reload_requested;
+
+static void handle_sighup(int signal)
+{
+    (void)signal;
+    reload_requested = 1;
+}
+
+int config_watch_start(const char* path)
+{
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_sighup;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGHUP, &action, NULL) != 0)
+    {
+        fprintf(stderr, "Error al instalar el manejador de SIGHUP: %s\n", strerror(errno));
+    }
+
+    char dir[PATH_MAX];
+    const char* slash = strrchr(path, '/');
+    if (slash == NULL)
+    {
+        snprintf(dir, sizeof(dir), ".");
+        snprintf(watch.name, sizeof(watch.name), "%s", path);
+    }
+    else
+    {
+        snprintf(dir, sizeof(dir), "%.*s", slash == path ? 1 : (int)(slash - path), path);
+        snprintf(watch.name, sizeof(watch.name), "%s", slash + 1);
+    }
+
+    watch.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch.fd < 0)
+    {
+        fprintf(stderr, "inotify no disponible (%s); la configuración se recarga con SIGHUP\n", strerror(errno));
+        return -1;
+    }
+    if (inotify_add_watch(watch.fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        fprintf(stderr, "Error al vigilar %s (%s); la configuración se recarga con SIGHUP\n", dir, strerror(errno));
+        close(watch.fd);
+        watch.fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+bool config_watch_pending(void)
+{
+    bool pending = reload_requested != 0;
+    reload_requested = 0;
+    if (watch.fd < 0)
+    {
+        return pending;
+    }
+
+    // Se drena todo lo acumulado: varias escrituras entre dos ticks son una sola recarga
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t length;
+    while ((length = read(watch.fd, buf, sizeof(buf))) > 0)
+    {
+        for (char* p = buf; p < buf + length;)
+        {
+            const struct inotify_event* event = (const struct inotify_event*)p;
+            if (event->len > 0 && strcmp(event->name, watch.name) == 0)
+            {
+                pending = true;
+            }
+            p += sizeof(*event) + event->len;
+        }
+    }
+    return pending;
+}
+
+void config_watch_stop(void)
+{
+    if (watch.fd >= 0)
+    {
+        close(watch.fd);
+        watch.fd = -1;
+    }
+}
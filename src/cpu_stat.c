@@ -0,0 +1,89 @@
+#include "cpu_stat.h"
+#include "parse.h"
+#include "procfs.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Buffer de lectura por hilo, reutilizado entre llamados.
+ */
+static __thread procfs_buf_t read_buf;
+
+/**
+ * @brief Agranda el arreglo hasta slots CPUs; las nuevas arrancan sin lectura.
+ */
+static int grow(cpu_stat_t* stat, int slots)
+{
+    cpu_stat_cpu_t* cpus = realloc(stat->cpus, (size_t)slots * sizeof(*cpus));
+    if (cpus == NULL)
+    {
+        return -1;
+    }
+    memset(cpus + stat->cpu_slots, 0, (size_t)(slots - stat->cpu_slots) * sizeof(*cpus));
+    stat->cpus = cpus;
+    stat->cpu_slots = slots;
+    return 0;
+}
+
+int cpu_stat_read(cpu_stat_t* stat)
+{
+    char path[PROCFS_PATH_MAX];
+    if (procfs_read(procfs_path("stat", path, sizeof(path)), &read_buf) != 0)
+    {
+        return -1;
+    }
+
+    // Las CPUs que no aparezcan en esta lectura quedan sin intervalo
+    for (int c = 0; c < stat->cpu_slots; c++)
+    {
+        stat->cpus[c].busy_delta = 0;
+        stat->cpus[c].total_delta = 0;
+    }
+
+    const char* end = read_buf.data + read_buf.len;
+    for (const char* p = read_buf.data; p < end; p = parse_next_line(p, end))
+    {
+        if (!parse_starts_with(p, end, "cpu", 3))
+        {
+            break; // Las líneas de CPU van primero
+        }
+        const char* q = p + 3;
+        if (q >= end || !parse_is_digit(*q))
+        {
+            continue; // Línea agregada "cpu "
+        }
+        uint64_t number = parse_u64(&q, end);
+        if (number >= CPU_STAT_MAX_CPUS)
+        {
+            continue;
+        }
+        if ((int)number >= stat->cpu_slots && grow(stat, (int)number + 1) != 0)
+        {
+            return -1;
+        }
+        uint64_t v[8] = {0};
+        if (parse_u64_fields(q, parse_line_end(q, end), v, 8) < 4)
+        {
+            continue;
+        }
+        cpu_stat_cpu_t* cpu = &stat->cpus[number];
+        uint64_t total = v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] + v[7];
+        uint64_t busy = total - v[3] - v[4]; // idle e iowait no cuentan como ocupado
+
+        if (cpu->total != 0 && total > cpu->total && busy >= cpu->busy)
+        {
+            cpu->busy_delta = busy - cpu->busy;
+            cpu->total_delta = total - cpu->total;
+        }
+        cpu->busy = busy;
+        cpu->total = total;
+    }
+    return 0;
+}
+
+void cpu_stat_free(cpu_stat_t* stat)
+{
+    free(stat->cpus);
+    stat->cpus = NULL;
+    stat->cpu_slots = 0;
+}
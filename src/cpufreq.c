@@ -0,0 +1,372 @@
+#include "cpufreq.h"
+#include "log.h"
+#include "parse.h"
+#include "procfs.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Rutas relativas a /sys de los archivos de una CPU y de una zona térmica.
+ */
+#define CPU_FILE(name) "devices/system/cpu/cpu%d/" name
+#define ZONE_FILE(name) "class/thermal/thermal_zone%d/" name
+
+/**
+ * @brief Buffer de lectura por hilo, reutilizado entre llamados.
+ */
+static __thread procfs_buf_t read_buf;
+
+/**
+ * @brief Número al final de un nombre de /sys ("cpu12", "thermal_zone3"), o -1 si no lo es.
+ */
+static int entry_number(const char* name, const char* prefix)
+{
+    size_t len = strlen(prefix);
+    if (strncmp(name, prefix, len) != 0 || !parse_is_digit(name[len]))
+    {
+        return -1;
+    }
+    const char* p = name + len;
+    const char* end = p + strlen(p);
+    uint64_t value = parse_u64(&p, end);
+    return p == end && value < 1u << 20 ? (int)value : -1;
+}
+
+/**
+ * @brief Recorre un directorio de /sys y junta los números de las entradas con el prefijo, ordenados.
+ * @return Cantidad de números (en *numbers, que libera quien llama), o -1 si no se pudo abrir.
+ */
+static int list_entries(const char* rel, const char* prefix, int** numbers)
+{
+    char path[PROCFS_PATH_MAX];
+    DIR* dir = opendir(sysfs_path(rel, path, sizeof(path)));
+    if (dir == NULL)
+    {
+        return -1;
+    }
+    int count = 0;
+    int capacity = 0;
+    *numbers = NULL;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        int number = entry_number(entry->d_name, prefix);
+        if (number < 0)
+        {
+            continue;
+        }
+        if (count == capacity)
+        {
+            capacity = capacity > 0 ? capacity * 2 : 64;
+            int* grown = realloc(*numbers, (size_t)capacity * sizeof(int));
+            if (grown == NULL)
+            {
+                break;
+            }
+            *numbers = grown;
+        }
+        (*numbers)[count++] = number;
+    }
+    closedir(dir);
+
+    // Inserción: los directorios de /sys ya vienen casi ordenados
+    for (int i = 1; i < count; i++)
+    {
+        int value = (*numbers)[i];
+        int j = i - 1;
+        for (; j >= 0 && (*numbers)[j] > value; j--)
+        {
+            (*numbers)[j + 1] = (*numbers)[j];
+        }
+        (*numbers)[j + 1] = value;
+    }
+    return count;
+}
+
+/**
+ * @brief Abre un archivo para releerlo en cada tick; en replay no se cachea.
+ */
+static int open_sys_file(const char* format, int number)
+{
+    if (procfs_replay_active())
+    {
+        return -1;
+    }
+    char rel[96], path[PROCFS_PATH_MAX];
+    snprintf(rel, sizeof(rel), format, number);
+    return open(sysfs_path(rel, path, sizeof(path)), O_RDONLY | O_CLOEXEC);
+}
+
+/**
+ * @brief Lee un entero con signo de un archivo de un solo valor, por su descriptor abierto o por su ruta.
+ *
+ * La ruta (format con el número de CPU o de zona) solo se arma sin descriptor: al descubrir o en replay.
+ *
+ * @return 0 si se leyó, -1 si el archivo no existe o no tiene un número.
+ */
+static int read_value(int fd, const char* format, int number, long long* value)
+{
+    int rc;
+    if (fd >= 0)
+    {
+        rc = procfs_read_fd(fd, &read_buf);
+    }
+    else
+    {
+        char rel[96], path[PROCFS_PATH_MAX];
+        snprintf(rel, sizeof(rel), format, number);
+        rc = procfs_read(sysfs_path(rel, path, sizeof(path)), &read_buf);
+    }
+    if (rc != 0)
+    {
+        return -1;
+    }
+    char* end;
+    *value = strtoll(read_buf.data, &end, 10);
+    return end != read_buf.data ? 0 : -1;
+}
+
+/**
+ * @brief Lectura del tick: fuera de replay, un archivo que no se pudo abrir al descubrir no existe.
+ */
+static int read_tick_value(int fd, const char* format, int number, long long* value)
+{
+    if (fd < 0 && !procfs_replay_active())
+    {
+        return -1;
+    }
+    return read_value(fd, format, number, value);
+}
+
+static void discover_cpu(cpufreq_topology_t* topo, cpufreq_cpu_t* cpu)
+{
+    long long value;
+    cpu->max_hz = -1;
+    cpu->cur_hz = -1;
+    cpu->package = -1;
+    if (read_value(-1, CPU_FILE("cpufreq/cpuinfo_max_freq"), cpu->cpu, &value) == 0 && value > 0)
+    {
+        cpu->max_hz = (double)value * 1000.0; // kHz
+    }
+    if (read_value(-1, CPU_FILE("topology/physical_package_id"), cpu->cpu, &value) == 0)
+    {
+        cpu->package = (int)value;
+    }
+
+    // El contador del paquete es el mismo en todas sus CPUs: lo publica solo la primera
+    cpu->package_leader = true;
+    for (cpufreq_cpu_t* other = topo->cpus; other < cpu; other++)
+    {
+        if (other->package == cpu->package)
+        {
+            cpu->package_leader = false;
+            break;
+        }
+    }
+
+    cpu->cur_freq_fd = cpu->max_hz > 0 ? open_sys_file(CPU_FILE("cpufreq/scaling_cur_freq"), cpu->cpu) : -1;
+    cpu->core_throttle_fd = open_sys_file(CPU_FILE("thermal_throttle/core_throttle_count"), cpu->cpu);
+    cpu->package_throttle_fd =
+        cpu->package_leader ? open_sys_file(CPU_FILE("thermal_throttle/package_throttle_count"), cpu->cpu) : -1;
+}
+
+static void discover_zones(cpufreq_topology_t* topo)
+{
+    int* numbers;
+    int count = list_entries("class/thermal", "thermal_zone", &numbers);
+    if (count > CPUFREQ_MAX_ZONES)
+    {
+        log_warn("Más de %d zonas térmicas; se ignoran las restantes", CPUFREQ_MAX_ZONES);
+        count = CPUFREQ_MAX_ZONES;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        thermal_zone_t* zone = &topo->zones[topo->zone_count++];
+        char rel[96], path[PROCFS_PATH_MAX];
+        zone->id = numbers[i];
+        zone->type[0] = '\0';
+        snprintf(rel, sizeof(rel), ZONE_FILE("type"), zone->id);
+        if (procfs_read(sysfs_path(rel, path, sizeof(path)), &read_buf) == 0)
+        {
+            size_t len = strcspn(read_buf.data, "\n");
+            len = len < sizeof(zone->type) - 1 ? len : sizeof(zone->type) - 1;
+            memcpy(zone->type, read_buf.data, len);
+            zone->type[len] = '\0';
+        }
+        zone->temp_fd = open_sys_file(ZONE_FILE("temp"), zone->id);
+    }
+    free(numbers);
+}
+
+int cpufreq_discover(cpufreq_topology_t* topo)
+{
+    memset(topo, 0, sizeof(*topo));
+
+    int* numbers;
+    int count = list_entries("devices/system/cpu", "cpu", &numbers);
+    if (count <= 0)
+    {
+        log_error("No se encontraron CPUs en devices/system/cpu");
+        free(count == 0 ? numbers : NULL);
+        return -1;
+    }
+    topo->cpu_slots = numbers[count - 1] + 1;
+    topo->cpus = calloc((size_t)count, sizeof(*topo->cpus));
+    topo->cpu_index = malloc((size_t)topo->cpu_slots * sizeof(int));
+    if (topo->cpus == NULL || topo->cpu_index == NULL)
+    {
+        log_error("Error al reservar la topología de cpufreq");
+        free(numbers);
+        cpufreq_free(topo);
+        return -1;
+    }
+    for (int c = 0; c < topo->cpu_slots; c++)
+    {
+        topo->cpu_index[c] = -1;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        cpufreq_cpu_t* cpu = &topo->cpus[topo->cpu_count++];
+        cpu->cpu = numbers[i];
+        topo->cpu_index[cpu->cpu] = i;
+        discover_cpu(topo, cpu);
+    }
+    free(numbers);
+
+    discover_zones(topo);
+    return 0;
+}
+
+static void close_fd(int fd)
+{
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+void cpufreq_free(cpufreq_topology_t* topo)
+{
+    for (int i = 0; i < topo->cpu_count; i++)
+    {
+        close_fd(topo->cpus[i].cur_freq_fd);
+        close_fd(topo->cpus[i].core_throttle_fd);
+        close_fd(topo->cpus[i].package_throttle_fd);
+    }
+    for (int z = 0; z < topo->zone_count; z++)
+    {
+        close_fd(topo->zones[z].temp_fd);
+    }
+    free(topo->cpus);
+    free(topo->cpu_index);
+    memset(topo, 0, sizeof(*topo));
+}
+
+/**
+ * @brief Suma el tiempo ocupado del intervalo de cada CPU, sin pesar y pesado por su frecuencia.
+ */
+static void summarize_usage(const cpufreq_topology_t* topo, const cpu_stat_t* cpu_stat, cpufreq_summary_t* summary)
+{
+    double busy = 0;
+    double weighted = 0;
+    double total = 0;
+    bool have_ratio = false;
+    for (int i = 0; i < topo->cpu_count; i++)
+    {
+        const cpufreq_cpu_t* cpu = &topo->cpus[i];
+        uint64_t cpu_busy, cpu_total;
+        if (!cpu_stat_delta(cpu_stat, cpu->cpu, &cpu_busy, &cpu_total))
+        {
+            continue;
+        }
+        double ratio = 1.0;
+        if (cpu->cur_hz > 0 && cpu->max_hz > 0)
+        {
+            ratio = cpu->cur_hz / cpu->max_hz;
+            have_ratio = true;
+        }
+        busy += (double)cpu_busy;
+        weighted += (double)cpu_busy * ratio;
+        total += (double)cpu_total;
+    }
+
+    if (total > 0)
+    {
+        summary->usage = busy * 100.0 / total;
+        summary->normalized_usage = have_ratio ? weighted * 100.0 / total : -1;
+    }
+}
+
+void cpufreq_read(cpufreq_topology_t* topo, const cpu_stat_t* cpu_stat, cpufreq_summary_t* summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    summary->freq_avg_hz = -1;
+    summary->freq_ratio = -1;
+    summary->usage = -1;
+    summary->normalized_usage = -1;
+
+    double freq_sum = 0;
+    double ratio_sum = 0;
+    for (int i = 0; i < topo->cpu_count; i++)
+    {
+        cpufreq_cpu_t* cpu = &topo->cpus[i];
+        long long value;
+
+        cpu->cur_hz = -1;
+        if (cpu->max_hz > 0 && read_tick_value(cpu->cur_freq_fd, CPU_FILE("cpufreq/scaling_cur_freq"), cpu->cpu,
+                                               &value) == 0 && value > 0)
+        {
+            cpu->cur_hz = (double)value * 1000.0;
+            freq_sum += cpu->cur_hz;
+            ratio_sum += cpu->cur_hz / cpu->max_hz;
+            summary->cpus_with_freq++;
+        }
+
+        cpu->have_throttle =
+            read_tick_value(cpu->core_throttle_fd, CPU_FILE("thermal_throttle/core_throttle_count"), cpu->cpu,
+                            &value) == 0;
+        if (cpu->have_throttle)
+        {
+            cpu->core_throttles = (uint64_t)value;
+            summary->core_throttles += (unsigned long)value;
+        }
+        if (cpu->have_throttle && cpu->package_leader &&
+            read_tick_value(cpu->package_throttle_fd, CPU_FILE("thermal_throttle/package_throttle_count"), cpu->cpu,
+                            &value) == 0)
+        {
+            cpu->package_throttles = (uint64_t)value;
+        }
+    }
+    if (summary->cpus_with_freq > 0)
+    {
+        summary->freq_avg_hz = freq_sum / summary->cpus_with_freq;
+        summary->freq_ratio = ratio_sum / summary->cpus_with_freq;
+    }
+
+    for (int z = 0; z < topo->zone_count; z++)
+    {
+        thermal_zone_t* zone = &topo->zones[z];
+        long long millidegrees;
+
+        // Algunos sensores devuelven error mientras están suspendidos: la zona se omite ese tick
+        zone->have_temp = read_tick_value(zone->temp_fd, ZONE_FILE("temp"), zone->id, &millidegrees) == 0;
+        if (zone->have_temp)
+        {
+            zone->celsius = (double)millidegrees / 1000.0;
+            if (!summary->have_temperature || zone->celsius > summary->max_celsius)
+            {
+                summary->max_celsius = zone->celsius;
+            }
+            summary->have_temperature = true;
+        }
+    }
+
+    if (cpu_stat != NULL)
+    {
+        summarize_usage(topo, cpu_stat, summary);
+    }
+}
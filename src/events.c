@@ -0,0 +1,38 @@
+#include "events.h"
+#include "log.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+static pthread_mutex_t fifo_lock = PTHREAD_MUTEX_INITIALIZER;
+
+int fifo_write(const char* data, size_t length)
+{
+    pthread_mutex_lock(&fifo_lock);
+
+    // Abrir el FIFO en modo escritura (crearlo si no existe)
+    int fifo_fd = open(FIFO_PATH, O_WRONLY | O_CREAT, 0666);
+    if (fifo_fd == -1)
+    {
+        pthread_mutex_unlock(&fifo_lock);
+        log_error("Error al abrir el FIFO: %m");
+        return -1;
+    }
+
+    ssize_t written = write(fifo_fd, data, length);
+    close(fifo_fd);
+    pthread_mutex_unlock(&fifo_lock);
+
+    if (written != (ssize_t)length)
+    {
+        log_error("Error al escribir en el FIFO: %m");
+        return -1;
+    }
+    return 0;
+}
+
+void events_publish(const char* json, size_t length)
+{
+    fifo_write(json, length);
+}
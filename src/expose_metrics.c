@@ -1,24 +1,222 @@
 #include "expose_metrics.h"
-#include "memory.h"
+#include "alerts.h"
+#include "arena.h"
+#include "buddyinfo.h"
+#include "cardinality.h"
+#include "events.h"
+#include "interrupts.h"
+#include "log.h"
+#include "procfs.h"
+#include "rate.h"
+#include "realtime.h"
+#include <time.h>
 
 // Mutex para sincronización de hilos
 pthread_mutex_t lock;
 
+// Las métricas se registran al activar cada colector, con el servidor HTTP ya atendiendo:
+// el registro se modifica con el lock de escritura y se serializa con el de lectura
+static pthread_rwlock_t registry_lock = PTHREAD_RWLOCK_INITIALIZER;
+
 static prom_gauge_t* cpu_usage_metric;         // Metrica de Prometheus para el uso de cpu
-static prom_gauge_t* rx_bytes_metric;          // datos recibidos
-static prom_gauge_t* tx_bytes_metric;          // datos transmitidos
+static prom_counter_t* rx_bytes_metric;        // datos recibidos
+static prom_counter_t* tx_bytes_metric;        // datos transmitidos
 static prom_gauge_t* total_memory_metric;      // Metricas de Prometheus pa
 static prom_gauge_t* used_memory_metric;       // Metricas de Prometheus para uso de la memoria
 static prom_gauge_t* free_memory_metric;       // Metricas de Memoria Libre
-static prom_gauge_t* context_switches_metric;  // Metricas para cambios de contexto
+static prom_gauge_t* context_switches_metric;  // Metricas para cambios de contexto por segundo
 static prom_gauge_t* running_processes_metric; // Metricas para cantidad de procesos corriendo
-static prom_gauge_t* disk_reads_completed_metric;
-static prom_gauge_t* disk_writes_completed_metric;
+static prom_counter_t* disk_reads_completed_metric;
+static prom_counter_t* disk_writes_completed_metric;
 // Declaración de las métricas
 static prom_gauge_t* cpu_usage_metric;
-static prom_gauge_t* rx_bytes_metric;
-static prom_gauge_t* tx_bytes_metric;
-static prom_gauge_t* memory_fragmentation_metric; // Agrega esta línea
+static prom_counter_t* context_switches_total_metric; // Cambios de contexto desde el arranque
+static prom_gauge_t* rx_rate_metric;              // Bytes recibidos por segundo
+static prom_gauge_t* tx_rate_metric;              // Bytes transmitidos por segundo
+static prom_gauge_t* disk_reads_rate_metric;      // Lecturas completadas por segundo
+static prom_gauge_t* disk_writes_rate_metric;     // Escrituras completadas por segundo
+static prom_gauge_t* memory_fragmentation_metric; // Fragmentación del sistema al orden de una hugepage
+static prom_gauge_t* buddy_free_blocks_metric;    // Bloques libres por nodo, zona y orden
+static prom_gauge_t* unusable_index_metric;       // Índice de espacio libre inutilizable por nodo, zona y orden
+static prom_gauge_t* hugepages_allocatable_metric; // Hugepages reservables sin compactar por nodo y zona
+static prom_gauge_t* pagetype_free_metric;        // Páginas libres por tipo de migración
+static prom_gauge_t* pagetype_blocks_metric;      // Pageblocks por tipo de migración
+static prom_gauge_t* meminfo_bytes_metric;        // Campos de /proc/meminfo en bytes, etiqueta "field"
+static prom_gauge_t* meminfo_pages_metric;        // Campos de /proc/meminfo que son cantidades (HugePages_*)
+static prom_counter_t* vmstat_total_metric;       // Contadores acumulados de /proc/vmstat, etiqueta "counter"
+static prom_gauge_t* vmstat_rate_metric;          // Tasa por segundo de los contadores de /proc/vmstat
+static prom_gauge_t* psi_pressure_metric;         // Promedios de PSI por recurso, tipo y ventana
+static prom_counter_t* psi_stall_metric;          // Tiempo total en stall por recurso y tipo
+static prom_counter_t* psi_events_metric;         // Eventos de triggers PSI recibidos por recurso y tipo
+static prom_gauge_t* irq_rate_metric;             // Top-K de interrupciones por segundo por IRQ y CPU
+static prom_gauge_t* softirq_rate_metric;         // Top-K de softirqs por segundo por tipo y CPU
+static prom_gauge_t* irq_cpu_rate_metric;         // Interrupciones por segundo de cada CPU
+static prom_gauge_t* irq_imbalance_metric;        // Máximo sobre promedio de las tasas por CPU
+static prom_gauge_t* cpu_frequency_metric;        // Frecuencia actual de cada CPU en Hz
+static prom_gauge_t* cpu_frequency_max_metric;    // Frecuencia máxima de cada CPU en Hz
+static prom_gauge_t* cpu_normalized_metric;       // Uso de CPU pesado por cur_freq / max_freq
+static prom_gauge_t* thermal_zone_metric;         // Temperatura de cada zona térmica
+static prom_counter_t* core_throttles_metric;     // Eventos de throttling por núcleo
+static prom_counter_t* package_throttles_metric;  // Eventos de throttling por paquete
+static prom_gauge_t* numa_memory_metric;          // Campos de nodeN/meminfo en bytes por nodo
+static prom_counter_t* numastat_metric;           // Contadores de nodeN/numastat por nodo
+static prom_gauge_t* numa_remote_metric;          // Fracción de reservas del intervalo servidas a otro nodo
+static prom_gauge_t* numa_cpu_usage_metric;       // Uso de CPU de las CPUs de cada nodo
+static prom_gauge_t* numa_cpus_metric;            // CPUs de cada nodo
+static prom_counter_t* net_protocol_metric;       // Contadores de /proc/net/snmp y /proc/net/netstat
+static prom_gauge_t* sockstat_metric;             // Campos de /proc/net/sockstat
+static prom_gauge_t* tcp_sockets_metric;          // Sockets TCP por estado
+static prom_gauge_t* tcp_listen_queue_metric;     // Mayor ocupación de una cola de accept
+static prom_gauge_t* tcp_retransmit_metric;       // Retransmisiones sobre segmentos enviados en el intervalo
+static prom_gauge_t* cpu_micro_metric;            // Percentiles del uso de CPU dentro del intervalo
+static prom_gauge_t* procs_micro_metric;          // Percentiles de procs_running dentro del intervalo
+static prom_gauge_t* micro_overhead_metric;       // Costo del hilo de micro-muestreo
+static prom_gauge_t* sampling_burst_metric;       // 1 durante una ráfaga del muestreo adaptativo
+static prom_gauge_t* sampling_interval_metric;    // Intervalo de muestreo vigente
+static prom_counter_t* sampling_bursts_metric;    // Ráfagas abiertas desde el arranque
+
+static int sampling_metrics_register(void);
+
+// Últimos valores leídos en el tick, protegidos por lock
+static metrics_sample_t last_sample;
+
+// Se incrementa en reset_collectors() al cambiar las raíces; los colectores con estado cacheado
+// lo comparan en cada tick
+static unsigned collectors_generation;
+
+// Lecturas anteriores de los contadores acumulados, protegidas por lock
+static rate_engine_t rates;
+
+// Jiffies por CPU del tick, leídos por el primer colector que los pide (solo el hilo de muestreo)
+static cpu_stat_t cpu_stat;
+static bool cpu_stat_fresh; // Ya se intentó leer en este tick
+static bool cpu_stat_ok;
+
+// Primera serie del engine de cada colector
+static struct
+{
+    int context_switches; // Una serie
+    int net;              // rx y tx
+    int disk;             // Lecturas y escrituras completadas
+    int vmstat;           // VMSTAT_MAX_FIELDS series
+    int psi;              // some y full por recurso
+    int numastat;         // NUMA_STAT_FIELDS series por nodo
+    int netproto;         // NETPROTO_COUNTERS series
+} series;
+
+// Publica los gauges de tasa además de los counters (set_rate_gauges)
+static bool rate_gauges_enabled = true;
+
+// Muestras descartadas por el tope de series, por métrica; se registra al instalar un tope
+static prom_counter_t* dropped_samples_metric;
+static bool dropped_samples_registered;
+
+// Métricas creadas por los colectores, registradas o no según las reglas de cardinalidad
+static prom_metric_t* created[CARDINALITY_MAX_FAMILIES];
+static int created_count;
+
+static void store_gauge(void* metric, double value, const char** labels)
+{
+    prom_gauge_set(metric, value, labels);
+}
+
+static void store_counter(void* metric, double value, const char** labels)
+{
+    prom_counter_add(metric, value, labels);
+}
+
+/**
+ * @brief Crea un gauge y lo registra como familia en los límites de cardinalidad.
+ * @return Gauge, o NULL en caso de error.
+ */
+static prom_gauge_t* gauge_new(const char* name, const char* help, size_t label_count, const char** label_names)
+{
+    prom_gauge_t* gauge = prom_gauge_new(name, help, label_count, label_names);
+    pthread_mutex_lock(&lock);
+    int tracked =
+        gauge != NULL ? cardinality_track(gauge, name, (int)label_count, label_names, false, store_gauge) : -1;
+    pthread_mutex_unlock(&lock);
+    if (gauge != NULL && tracked != 0)
+    {
+        prom_gauge_destroy(gauge);
+        gauge = NULL;
+    }
+    return gauge;
+}
+
+/**
+ * @brief Crea un counter y lo registra como familia en los límites de cardinalidad.
+ * @return Counter, o NULL en caso de error.
+ */
+static prom_counter_t* counter_new(const char* name, const char* help, size_t label_count, const char** label_names)
+{
+    prom_counter_t* counter = prom_counter_new(name, help, label_count, label_names);
+    pthread_mutex_lock(&lock);
+    int tracked =
+        counter != NULL ? cardinality_track(counter, name, (int)label_count, label_names, true, store_counter) : -1;
+    pthread_mutex_unlock(&lock);
+    if (counter != NULL && tracked != 0)
+    {
+        prom_counter_destroy(counter);
+        counter = NULL;
+    }
+    return counter;
+}
+
+/**
+ * @brief Guarda el valor de un gauge si la serie pasa los límites de cardinalidad. Requiere lock.
+ */
+static void gauge_set(prom_gauge_t* gauge, double value, const char** labels)
+{
+    cardinality_store(gauge, value, value, labels);
+}
+
+/**
+ * @brief Suma a un counter si la serie pasa los límites de cardinalidad. Requiere lock.
+ * @param counter Counter de Prometheus.
+ * @param delta Avance a sumar.
+ * @param total Total acumulado, con el que la serie compite por un lugar.
+ * @param labels Etiquetas de la serie.
+ */
+static void counter_add(prom_counter_t* counter, double delta, double total, const char** labels)
+{
+    cardinality_store(counter, delta, total, labels);
+}
+
+/**
+ * @brief Registra una lectura de un contador, suma su avance al counter y publica la tasa. Requiere lock.
+ * @param id Serie del engine.
+ * @param value Valor crudo del contador.
+ * @param now_ms Timestamp monotónico de la lectura.
+ * @param counter Counter de Prometheus que acumula los avances.
+ * @param rate_gauge Gauge de la tasa por segundo, o NULL si el contador no tiene.
+ * @param labels Etiquetas de la serie en ambas métricas.
+ * @param scale Factor de unidades (por ejemplo, 1e-6 para pasar de microsegundos a segundos).
+ * @return Tasa por segundo ya escalada, o -1 si todavía no hay.
+ */
+static double publish_counter(int id, uint64_t value, int64_t now_ms, prom_counter_t* counter,
+                              prom_gauge_t* rate_gauge, const char** labels, double scale)
+{
+    double delta;
+    double rate = rate_update(&rates, id, value, now_ms, &delta);
+    // Con un tope de series, la serie compite por el total acumulado y no por el avance del tick
+    cardinality_store(counter, delta * scale, (double)value * scale, labels);
+    if (rate < 0)
+    {
+        return -1;
+    }
+    if (rate_gauge != NULL && rate_gauges_enabled)
+    {
+        gauge_set(rate_gauge, rate * scale, labels);
+    }
+    return rate * scale;
+}
+
+int64_t sample_now_ms(void)
+{
+    int64_t recorded = procfs_replay_now_ms();
+    return recorded >= 0 ? recorded : rate_now_ms();
+}
 
 // Esta funcion sirve para actualizar el dato desde /proc/stat para obtener el ultimo valor de Cpu_Usage
 void update_cpu_gauge()
@@ -27,12 +225,13 @@ void update_cpu_gauge()
     if (usage >= 0)
     {
         pthread_mutex_lock(&lock); // Previene condiciones de carrera y asegura la integridad de los datos.
-        prom_gauge_set(cpu_usage_metric, usage, NULL);
+        gauge_set(cpu_usage_metric, usage, NULL);
+        last_sample.cpu_usage = usage;
         pthread_mutex_unlock(&lock); // Libero mutex lock
     }
     else
     {
-        fprintf(stderr, "Error al obtener el uso de CPU\n");
+        log_error("Error al obtener el uso de CPU");
     }
 }
 
@@ -42,12 +241,13 @@ void update_running_processes_gauge()
     if (running_procs >= 0)
     {
         pthread_mutex_lock(&lock); // Previene condiciones de carrera y asegura la integridad de los datos.
-        prom_gauge_set(running_processes_metric, running_procs, NULL);
+        gauge_set(running_processes_metric, running_procs, NULL);
+        last_sample.running_processes = running_procs;
         pthread_mutex_unlock(&lock); // Libero mutex lock
     }
     else
     {
-        fprintf(stderr, "Error al obtener el número de procesos en ejecución\n");
+        log_error("Error al obtener el número de procesos en ejecución");
     }
 }
 
@@ -57,17 +257,19 @@ void update_net_stats_gauge(const char* iface)
 
     if (stats.rx_bytes >= 0 && stats.tx_bytes >= 0)
     {
+        int64_t now_ms = sample_now_ms();
         pthread_mutex_lock(&lock);
 
         // Actualizar las métricas con los valores obtenidos
-        prom_gauge_set(rx_bytes_metric, stats.rx_bytes, NULL);
-        prom_gauge_set(tx_bytes_metric, stats.tx_bytes, NULL);
+        publish_counter(series.net, (uint64_t)stats.rx_bytes, now_ms, rx_bytes_metric, rx_rate_metric, NULL, 1);
+        publish_counter(series.net + 1, (uint64_t)stats.tx_bytes, now_ms, tx_bytes_metric, tx_rate_metric, NULL, 1);
+        last_sample.net = stats;
 
         pthread_mutex_unlock(&lock);
     }
     else
     {
-        fprintf(stderr, "Error al obtener estadísticas de red para la interfaz: %s\n", iface);
+        log_error("Error al obtener estadísticas de red para la interfaz: %s", iface);
     }
 }
 
@@ -77,17 +279,21 @@ void update_disk_stats_gauge(const char* device)
 
     if (stats.reads_completed != (unsigned long)-1 && stats.writes_completed != (unsigned long)-1)
     {
+        int64_t now_ms = sample_now_ms();
         pthread_mutex_lock(&lock);
 
         // Actualizar las métricas con los valores obtenidos
-        prom_gauge_set(disk_reads_completed_metric, (double)stats.reads_completed, NULL);
-        prom_gauge_set(disk_writes_completed_metric, (double)stats.writes_completed, NULL);
+        publish_counter(series.disk, stats.reads_completed, now_ms, disk_reads_completed_metric,
+                        disk_reads_rate_metric, NULL, 1);
+        publish_counter(series.disk + 1, stats.writes_completed, now_ms, disk_writes_completed_metric,
+                        disk_writes_rate_metric, NULL, 1);
+        last_sample.disk = stats;
 
         pthread_mutex_unlock(&lock);
     }
     else
     {
-        fprintf(stderr, "Error al obtener estadísticas de disco para el dispositivo: %s\n", device);
+        log_error("Error al obtener estadísticas de disco para el dispositivo: %s", device);
     }
 }
 
@@ -96,13 +302,16 @@ void update_context_switches_gauge()
     long long ctxt = get_context_switches();
     if (ctxt >= 0)
     {
+        int64_t now_ms = sample_now_ms();
         pthread_mutex_lock(&lock);
-        prom_gauge_set(context_switches_metric, (double)ctxt, NULL);
+        publish_counter(series.context_switches, (uint64_t)ctxt, now_ms, context_switches_total_metric,
+                        context_switches_metric, NULL, 1);
+        last_sample.context_switches = ctxt;
         pthread_mutex_unlock(&lock);
     }
     else
     {
-        fprintf(stderr, "Error al obtener el número de cambios de contexto\n");
+        log_error("Error al obtener el número de cambios de contexto");
     }
 }
 
@@ -115,174 +324,1106 @@ void update_memory_gauge()
         pthread_mutex_lock(&lock);
 
         // Actualiza las métricas en Prometheus con los valores obtenidos
-        prom_gauge_set(total_memory_metric, memory_info.total_mem, NULL);
-        prom_gauge_set(used_memory_metric, memory_info.used_mem, NULL);
-        prom_gauge_set(free_memory_metric, memory_info.free_mem, NULL);
+        gauge_set(total_memory_metric, memory_info.total_mem, NULL);
+        gauge_set(used_memory_metric, memory_info.used_mem, NULL);
+        gauge_set(free_memory_metric, memory_info.free_mem, NULL);
+        last_sample.memory = memory_info;
 
         pthread_mutex_unlock(&lock);
     }
     else
     {
-        fprintf(stderr, "Error al obtener la información de memoria\n");
+        log_error("Error al obtener la información de memoria");
     }
 }
 
-void update_memory_fragmentation_gauge() {
-    double fragmentation = calculate_memory_fragmentation();
+void update_memory_fragmentation_gauge()
+{
+    // Etiquetas de orden precalculadas: evita formatear strings en cada tick
+    static const char* const order_labels[BUDDY_MAX_ORDER] = {"0", "1", "2",  "3",  "4",  "5",  "6",  "7",
+                                                              "8", "9", "10", "11", "12", "13", "14", "15"};
+    char path[PROCFS_PATH_MAX];
+
+    // Unos 18 kB de scratch: salen del arena del tick en lugar de la pila o de memoria estática
+    buddyinfo_t* info = tick_alloc(sizeof(*info));
+    if (info == NULL || read_buddyinfo(procfs_path("buddyinfo", path, sizeof(path)), info) != 0)
+    {
+        log_error("Error al obtener la fragmentación de memoria");
+        return;
+    }
+    read_pagetypeinfo(procfs_path("pagetypeinfo", path, sizeof(path)), info);
+
+    // Resumen del sistema: todas las zonas sumadas, al orden de una hugepage
+    buddy_zone_t host = {0};
+    int hugepage_order = info->pageblock_order;
+
     pthread_mutex_lock(&lock);
-    prom_gauge_set(memory_fragmentation_metric, fragmentation, NULL);
+    for (int i = 0; i < info->zone_count; i++)
+    {
+        const buddy_zone_t* z = &info->zones[i];
+        char node[12];
+        snprintf(node, sizeof(node), "%d", z->node);
+
+        for (int order = 0; order < z->orders; order++)
+        {
+            const char* labels[] = {node, z->zone, order_labels[order]};
+            gauge_set(buddy_free_blocks_metric, (double)z->free_blocks[order], labels);
+            gauge_set(unusable_index_metric, buddy_unusable_index(z, order), labels);
+            host.free_blocks[order] += z->free_blocks[order];
+        }
+        if (z->orders > host.orders)
+        {
+            host.orders = z->orders;
+        }
+
+        const char* zone_labels[] = {node, z->zone};
+        gauge_set(hugepages_allocatable_metric, (double)buddy_allocatable_blocks(z, hugepage_order), zone_labels);
+
+        for (int t = 0; info->have_types && t < info->type_count; t++)
+        {
+            const char* type_labels[] = {node, z->zone, info->type_names[t]};
+            gauge_set(pagetype_free_metric, (double)z->type_free_pages[t], type_labels);
+            gauge_set(pagetype_blocks_metric, (double)z->type_blocks[t], type_labels);
+        }
+    }
+
+    double fragmentation = buddy_unusable_index(&host, hugepage_order) * 100.0;
+    gauge_set(memory_fragmentation_metric, fragmentation, NULL);
+    last_sample.memory_fragmentation = fragmentation;
     pthread_mutex_unlock(&lock);
 }
 
+void update_meminfo_gauge(void)
+{
+    char path[PROCFS_PATH_MAX];
+    meminfo_t info;
+    vmstat_t vmstat;
 
+    if (read_meminfo(procfs_path("meminfo", path, sizeof(path)), &info) != 0)
+    {
+        log_error("Error al obtener /proc/meminfo");
+        return;
+    }
+    bool have_vmstat = read_vmstat(procfs_path("vmstat", path, sizeof(path)), &vmstat) == 0;
+    int64_t now_ms = sample_now_ms();
 
-void* expose_metrics(void* arg)
+    double vmstat_rates[VMSTAT_MAX_FIELDS];
+    for (int i = 0; i < VMSTAT_MAX_FIELDS; i++)
+    {
+        vmstat_rates[i] = -1.0;
+    }
+
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < meminfo_field_count(); i++)
+    {
+        if (!info.present[i])
+        {
+            continue;
+        }
+        const char* labels[] = {meminfo_field_name(i)};
+        if (meminfo_field_in_kb(i))
+        {
+            gauge_set(meminfo_bytes_metric, (double)info.values[i] * 1024.0, labels);
+        }
+        else
+        {
+            gauge_set(meminfo_pages_metric, (double)info.values[i], labels);
+        }
+    }
+    for (int i = 0; have_vmstat && i < vmstat_field_count(); i++)
+    {
+        if (!vmstat.present[i])
+        {
+            continue;
+        }
+        const char* labels[] = {vmstat_field_name(i)};
+        vmstat_rates[i] = publish_counter(series.vmstat + i, vmstat.values[i], now_ms, vmstat_total_metric,
+                                          vmstat_rate_metric, labels, 1);
+    }
+    last_sample.meminfo = info;
+    memcpy(last_sample.vmstat_rates, vmstat_rates, sizeof(vmstat_rates));
+    pthread_mutex_unlock(&lock);
+}
+
+/**
+ * @brief Lecturas actual y anterior de /proc/interrupts o /proc/softirqs, para calcular tasas.
+ */
+typedef struct
 {
-    (void)arg; // Argumento no utilizado
+    irq_table_t tables[2];
+    int current;
+    int64_t time_ms[2];
+    bool have_prev;
+} irq_history_t;
 
-    // Aseguramos que el manejador HTTP esté adjunto al registro por defecto
-    promhttp_set_active_collector_registry(NULL);
+/**
+ * @brief Etiquetas de una serie top-K ya publicada.
+ */
+typedef struct
+{
+    char name[IRQ_NAME_MAX];
+    char desc[IRQ_DESC_MAX];
+    char cpu[12];
+} irq_series_t;
 
-    // Iniciamos el servidor HTTP en el puerto 8000
-    struct MHD_Daemon* daemon = promhttp_start_daemon(MHD_USE_SELECT_INTERNALLY, 8000, NULL, NULL);
-    if (daemon == NULL)
+/**
+ * @brief Lee la tabla y calcula las tasas top-K contra la lectura anterior.
+ * @return Celdas en top, o -1 si todavía no hay tasas.
+ */
+static int read_irq_rates(const char* rel, irq_history_t* history, irq_cell_rate_t* top, int k, double** cpu_rates)
+{
+    char path[PROCFS_PATH_MAX];
+    int next = history->have_prev ? 1 - history->current : history->current;
+    if (read_irq_table(procfs_path(rel, path, sizeof(path)), &history->tables[next]) != 0)
     {
-        fprintf(stderr, "Error al iniciar el servidor HTTP\n");
-        return NULL;
+        return -1;
     }
+    history->time_ms[next] = sample_now_ms();
 
-    // Mantenemos el servidor en ejecución
-    while (1)
+    int count = -1;
+    if (history->have_prev)
     {
-        sleep(1); // Mantiene el hilo vivo
+        const irq_table_t* cur = &history->tables[next];
+        double seconds = (double)(history->time_ms[next] - history->time_ms[history->current]) / 1000.0;
+        *cpu_rates = tick_alloc((size_t)cur->cpu_count * sizeof(double));
+        if (*cpu_rates != NULL)
+        {
+            count = irq_top_rates(&history->tables[history->current], cur, seconds, top, k, *cpu_rates);
+        }
     }
+    history->current = next;
+    history->have_prev = true;
+    return count;
+}
 
-    // Nunca debería llegar aquí
-    MHD_stop_daemon(daemon);
-    return NULL;
+/**
+ * @brief Fija una serie top-K: etiquetas {irq, device, cpu} o, sin descripción, {type, cpu}. Requiere lock.
+ */
+static void set_irq_series(prom_gauge_t* gauge, bool with_desc, const irq_series_t* series, double value)
+{
+    if (with_desc)
+    {
+        gauge_set(gauge, value, (const char*[]){series->name, series->desc, series->cpu});
+    }
+    else
+    {
+        gauge_set(gauge, value, (const char*[]){series->name, series->cpu});
+    }
 }
 
-void init_metrics()
+/**
+ * @brief Publica las series top-K y pone en cero las del tick anterior que quedaron afuera. Requiere lock.
+ */
+static void set_top_gauges(prom_gauge_t* gauge, bool with_desc, const irq_table_t* table, const irq_cell_rate_t* top,
+                           int count, irq_series_t* exported, int* exported_count)
 {
-    // Inicializa el mutex
-    if (pthread_mutex_init(&lock, NULL) != 0)
+    irq_series_t fresh[IRQ_TOP_K_MAX];
+    for (int i = 0; i < count; i++)
     {
-        fprintf(stderr, "Error al inicializar el mutex\n");
-        return;
+        const irq_row_t* row = &table->rows[top[i].row];
+        snprintf(fresh[i].name, sizeof(fresh[i].name), "%s", row->name);
+        snprintf(fresh[i].desc, sizeof(fresh[i].desc), "%s", row->desc);
+        snprintf(fresh[i].cpu, sizeof(fresh[i].cpu), "%d", table->cpus[top[i].column]);
+        set_irq_series(gauge, with_desc, &fresh[i], top[i].rate);
     }
 
-    // Inicializamos el registro de coleccionistas de Prometheus
-    if (prom_collector_registry_default_init() != 0)
+    for (int i = 0; i < *exported_count; i++)
     {
-        fprintf(stderr, "Error al inicializar el registro de Prometheus\n");
-        return;
+        bool still = false;
+        for (int j = 0; j < count && !still; j++)
+        {
+            still = strcmp(exported[i].name, fresh[j].name) == 0 && strcmp(exported[i].cpu, fresh[j].cpu) == 0;
+        }
+        if (!still)
+        {
+            set_irq_series(gauge, with_desc, &exported[i], 0);
+        }
     }
+    memcpy(exported, fresh, (size_t)count * sizeof(*fresh));
+    *exported_count = count;
+}
 
-    // Creamos la métrica para el uso de CPU
-    cpu_usage_metric = prom_gauge_new("cpu_usage_percentage", "Porcentaje de uso de CPU", 0, NULL);
-    if (cpu_usage_metric == NULL)
+void update_interrupts_gauge(int top_k)
+{
+    static irq_history_t irq_history, softirq_history;
+    static irq_series_t irq_exported[IRQ_TOP_K_MAX], softirq_exported[IRQ_TOP_K_MAX];
+    static int irq_exported_count, softirq_exported_count;
+
+    irq_cell_rate_t irq_top[IRQ_TOP_K_MAX];
+    irq_cell_rate_t softirq_top[IRQ_TOP_K_MAX];
+    double* irq_cpu_rates = NULL;
+    double* softirq_cpu_rates = NULL;
+    int irq_count = read_irq_rates("interrupts", &irq_history, irq_top, top_k, &irq_cpu_rates);
+    int softirq_count = read_irq_rates("softirqs", &softirq_history, softirq_top, top_k, &softirq_cpu_rates);
+
+    pthread_mutex_lock(&lock);
+    if (irq_count >= 0)
     {
-        fprintf(stderr, "Error al crear la métrica de uso de CPU\n");
-        return;
+        const irq_table_t* table = &irq_history.tables[irq_history.current];
+        set_top_gauges(irq_rate_metric, true, table, irq_top, irq_count, irq_exported, &irq_exported_count);
+
+        // Desbalance: la CPU más cargada de interrupciones contra el promedio
+        double total = 0, max = 0;
+        for (int c = 0; c < table->cpu_count; c++)
+        {
+            char cpu[12];
+            snprintf(cpu, sizeof(cpu), "%d", table->cpus[c]);
+            gauge_set(irq_cpu_rate_metric, irq_cpu_rates[c], (const char*[]){cpu});
+            total += irq_cpu_rates[c];
+            max = irq_cpu_rates[c] > max ? irq_cpu_rates[c] : max;
+        }
+        double mean = total / table->cpu_count;
+        last_sample.irq_rate = total;
+        last_sample.irq_imbalance = mean > 0 ? max / mean : 0;
+        gauge_set(irq_imbalance_metric, last_sample.irq_imbalance, NULL);
+    }
+    if (softirq_count >= 0)
+    {
+        const irq_table_t* table = &softirq_history.tables[softirq_history.current];
+        set_top_gauges(softirq_rate_metric, false, table, softirq_top, softirq_count, softirq_exported,
+                       &softirq_exported_count);
+        double total = 0;
+        for (int c = 0; c < table->cpu_count; c++)
+        {
+            total += softirq_cpu_rates[c];
+        }
+        last_sample.softirq_rate = total;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+/**
+ * @brief Lectura de /proc/stat del tick, compartida por cpufreq y NUMA.
+ * @return Lecturas del tick, o NULL si no se pudo leer.
+ */
+static const cpu_stat_t* tick_cpu_stat(void)
+{
+    static unsigned generation;
+    if (generation != collectors_generation)
+    {
+        // Otra raíz: los contadores anteriores no son de las mismas CPUs
+        cpu_stat_free(&cpu_stat);
+        generation = collectors_generation;
     }
+    if (!cpu_stat_fresh)
+    {
+        cpu_stat_fresh = true;
+        cpu_stat_ok = cpu_stat_read(&cpu_stat) == 0;
+        if (!cpu_stat_ok)
+        {
+            log_error("Error al leer el uso de CPU por núcleo: %m");
+        }
+    }
+    return cpu_stat_ok ? &cpu_stat : NULL;
+}
 
-    // Creamos nuevas métricas para memoria total, usada y disponible
-    total_memory_metric = prom_gauge_new("total_memory_mb", "Memoria total en MB", 0, NULL);
-    used_memory_metric = prom_gauge_new("used_memory_mb", "Memoria usada en MB", 0, NULL);
-    free_memory_metric = prom_gauge_new("free_memory_mb", "Memoria disponible en MB", 0, NULL);
+void start_tick(void)
+{
+    cpu_stat_fresh = false;
+}
 
-    if (total_memory_metric == NULL || used_memory_metric == NULL || free_memory_metric == NULL)
+void update_cpufreq_gauge(void)
+{
+    static cpufreq_topology_t topology;
+    static bool discovered;
+    static unsigned generation;
+    static int throttle_series = -1; // Dos series por CPU: núcleo y paquete
+    static int throttle_series_count;
+    if (discovered && generation != collectors_generation)
     {
-        fprintf(stderr, "Error al crear las métricas de memoria\n");
-        return;
+        cpufreq_free(&topology);
+        discovered = false;
+    }
+    generation = collectors_generation;
+    if (!discovered)
+    {
+        if (cpufreq_discover(&topology) != 0)
+        {
+            return;
+        }
+        discovered = true;
     }
 
-    // Registramos las métricas en el registro por defecto
-    if (prom_collector_registry_must_register_metric(cpu_usage_metric) == 0 ||
-        prom_collector_registry_must_register_metric(total_memory_metric) == 0 ||
-        prom_collector_registry_must_register_metric(used_memory_metric) == 0 ||
-        prom_collector_registry_must_register_metric(free_memory_metric) == 0)
+    cpufreq_summary_t summary;
+    cpufreq_read(&topology, tick_cpu_stat(), &summary);
+
+    int64_t now_ms = sample_now_ms();
+    pthread_mutex_lock(&lock);
+    if (throttle_series_count < topology.cpu_count * 2)
     {
-        fprintf(stderr, "Error al registrar las métricas\n");
-        return;
+        throttle_series = rate_series_reserve(&rates, topology.cpu_count * 2, RATE_WIDTH_LONG);
+        throttle_series_count = throttle_series >= 0 ? topology.cpu_count * 2 : 0;
     }
-    // Crear métricas para las estadísticas de disco
-    disk_reads_completed_metric =
-        prom_gauge_new("disk_reads_completed", "Numero de lecturas completadas exitosamente", 0, NULL);
-    disk_writes_completed_metric =
-        prom_gauge_new("disk_writes_completed", "Numero de escrituras completadas exitosamente", 0, NULL);
+    for (int i = 0; i < topology.cpu_count; i++)
+    {
+        const cpufreq_cpu_t* cpu = &topology.cpus[i];
+        char label[12];
+        snprintf(label, sizeof(label), "%d", cpu->cpu);
+        if (cpu->cur_hz > 0)
+        {
+            gauge_set(cpu_frequency_metric, cpu->cur_hz, (const char*[]){label});
+            gauge_set(cpu_frequency_max_metric, cpu->max_hz, (const char*[]){label});
+        }
+        if (!cpu->have_throttle || throttle_series < 0)
+        {
+            continue;
+        }
+        publish_counter(throttle_series + i * 2, cpu->core_throttles, now_ms, core_throttles_metric, NULL,
+                        (const char*[]){label}, 1);
+        if (cpu->package_leader && cpu->package_throttle_fd >= 0)
+        {
+            snprintf(label, sizeof(label), "%d", cpu->package);
+            publish_counter(throttle_series + i * 2 + 1, cpu->package_throttles, now_ms, package_throttles_metric,
+                            NULL, (const char*[]){label}, 1);
+        }
+    }
+    for (int z = 0; z < topology.zone_count; z++)
+    {
+        const thermal_zone_t* zone = &topology.zones[z];
+        if (zone->have_temp)
+        {
+            char label[12];
+            snprintf(label, sizeof(label), "%d", zone->id);
+            gauge_set(thermal_zone_metric, zone->celsius, (const char*[]){label, zone->type});
+        }
+    }
+    if (summary.normalized_usage >= 0)
+    {
+        gauge_set(cpu_normalized_metric, summary.normalized_usage, NULL);
+    }
+    last_sample.cpufreq = summary;
+    pthread_mutex_unlock(&lock);
+}
 
-    if (disk_reads_completed_metric == NULL || disk_writes_completed_metric == NULL)
+void update_numa_gauge(void)
+{
+    static numa_topology_t topology;
+    static bool discovered;
+    static unsigned generation;
+    if (discovered && generation != collectors_generation)
     {
-        fprintf(stderr, "Error al crear las métricas de estadísticas de disco\n");
-        return;
+        numa_topology_free(&topology);
+        discovered = false;
+    }
+    generation = collectors_generation;
+    if (!discovered)
+    {
+        if (numa_topology_discover(&topology) != 0)
+        {
+            return;
+        }
+        discovered = true;
     }
 
-    if (prom_collector_registry_must_register_metric(disk_reads_completed_metric) == 0 ||
-        prom_collector_registry_must_register_metric(disk_writes_completed_metric) == 0)
+    numa_node_stats_t stats[NUMA_MAX_NODES];
+    int count = numa_read(&topology, tick_cpu_stat(), stats);
+
+    int64_t now_ms = sample_now_ms();
+    pthread_mutex_lock(&lock);
+    for (int n = 0; n < count; n++)
     {
-        fprintf(stderr, "Error al registrar las métricas de estadísticas de disco\n");
-        return;
+        char node[12];
+        snprintf(node, sizeof(node), "%d", stats[n].node);
+        gauge_set(numa_cpus_metric, stats[n].cpu_count, (const char*[]){node});
+        if (stats[n].cpu_usage >= 0)
+        {
+            gauge_set(numa_cpu_usage_metric, stats[n].cpu_usage, (const char*[]){node});
+        }
+        if (!stats[n].have_memory)
+        {
+            continue;
+        }
+        for (int f = 0; f < NUMA_MEM_FIELDS; f++)
+        {
+            gauge_set(numa_memory_metric, (double)stats[n].mem[f], (const char*[]){node, numa_mem_field_name(f)});
+        }
+        for (int f = 0; f < NUMA_STAT_FIELDS; f++)
+        {
+            publish_counter(series.numastat + n * NUMA_STAT_FIELDS + f, stats[n].stat[f], now_ms, numastat_metric,
+                            NULL, (const char*[]){node, numa_stat_field_name(f)}, 1);
+        }
+        if (stats[n].remote_ratio >= 0)
+        {
+            gauge_set(numa_remote_metric, stats[n].remote_ratio, (const char*[]){node});
+        }
     }
+    last_sample.numa_node_count = count;
+    memcpy(last_sample.numa, stats, (size_t)count * sizeof(*stats));
+    pthread_mutex_unlock(&lock);
+}
 
-    rx_bytes_metric = prom_gauge_new("rx_bytes", "Bytes recibidos por la interfaz de red", 0, NULL);
-    tx_bytes_metric = prom_gauge_new("tx_bytes", "Bytes transmitidos por la interfaz de red", 0, NULL);
+void update_netproto_gauge(void)
+{
+    static int diag_fd = -1;
+    static bool diag_tried;
+    static unsigned generation;
+    if (generation != collectors_generation)
+    {
+        if (diag_fd >= 0)
+        {
+            close(diag_fd);
+            diag_fd = -1;
+        }
+        diag_tried = false;
+        generation = collectors_generation;
+    }
+    if (!diag_tried && !procfs_replay_active())
+    {
+        diag_fd = sock_diag_open();
+        diag_tried = true;
+    }
 
-    if (rx_bytes_metric == NULL || tx_bytes_metric == NULL)
+    netproto_stats_t stats;
+    if (netproto_read(diag_fd, &stats) != 0)
     {
-        fprintf(stderr, "Error al crear las métricas de tráfico de red\n");
         return;
     }
 
-    if (prom_collector_registry_must_register_metric(rx_bytes_metric) == 0 ||
-        prom_collector_registry_must_register_metric(tx_bytes_metric) == 0)
+    int64_t now_ms = sample_now_ms();
+    pthread_mutex_lock(&lock);
+
+    double counter_rates[NETPROTO_COUNTERS];
+    for (int i = 0; i < NETPROTO_COUNTERS; i++)
     {
-        fprintf(stderr, "Error al registrar las métricas de tráfico de red\n");
-        return;
+        counter_rates[i] = -1;
+        if (stats.present[i])
+        {
+            const char* labels[] = {netproto_counter_proto(i), netproto_counter_name(i)};
+            counter_rates[i] =
+                publish_counter(series.netproto + i, stats.counters[i], now_ms, net_protocol_metric, NULL, labels, 1);
+        }
     }
-    // Metrica para cantidad de procesos en ejecucion.
-    running_processes_metric =
-        prom_gauge_new("running_processes", "Numero de procesos en ejecución en el sistema", 0, NULL);
-    if (running_processes_metric == NULL)
+
+    // Retransmisiones del intervalo sobre segmentos enviados: ambas tasas cubren el mismo intervalo
+    double retrans_rate = counter_rates[netproto_counter_index("Tcp", "RetransSegs")];
+    double out_rate = counter_rates[netproto_counter_index("Tcp", "OutSegs")];
+    double retransmit_ratio = -1;
+    if (retrans_rate >= 0 && out_rate >= 0)
     {
-        fprintf(stderr, "Error al crear la métrica de procesos en ejecución\n");
-        return;
+        retransmit_ratio = out_rate > 0 ? retrans_rate / out_rate : 0;
+    }
+    if (stats.have_sockstat)
+    {
+        for (int f = 0; f < SOCKSTAT_FIELD_COUNT; f++)
+        {
+            gauge_set(sockstat_metric, (double)stats.sockstat[f],
+                      (const char*[]){sockstat_field_name((sockstat_field_t)f)});
+        }
+    }
+    if (stats.have_states)
+    {
+        for (int s = 1; s < NETPROTO_TCP_STATES; s++)
+        {
+            gauge_set(tcp_sockets_metric, (double)stats.tcp_states[s], (const char*[]){netproto_tcp_state_name(s)});
+        }
+        gauge_set(tcp_listen_queue_metric, stats.listen_queue_ratio, NULL);
+    }
+    if (retransmit_ratio >= 0)
+    {
+        gauge_set(tcp_retransmit_metric, retransmit_ratio, NULL);
+    }
+    last_sample.netproto = stats;
+    last_sample.tcp_retransmit_ratio = retransmit_ratio;
+    pthread_mutex_unlock(&lock);
+}
+
+/**
+ * @brief Publica en Prometheus una lectura de PSI. Requiere lock.
+ */
+static void set_psi_gauges(psi_resource_t resource, const psi_stats_t* stats)
+{
+    int64_t now_ms = sample_now_ms();
+    const char* name = psi_resource_name(resource);
+    const psi_line_t* lines[] = {&stats->some, &stats->full};
+    const char* kinds[] = {"some", "full"};
+
+    for (int k = 0; k < 2; k++)
+    {
+        if (!lines[k]->present)
+        {
+            continue;
+        }
+        gauge_set(psi_pressure_metric, lines[k]->avg10, (const char*[]){name, kinds[k], "10s"});
+        gauge_set(psi_pressure_metric, lines[k]->avg60, (const char*[]){name, kinds[k], "60s"});
+        gauge_set(psi_pressure_metric, lines[k]->avg300, (const char*[]){name, kinds[k], "300s"});
+        publish_counter(series.psi + (int)resource * 2 + k, lines[k]->total_us, now_ms, psi_stall_metric, NULL,
+                        (const char*[]){name, kinds[k]}, 1e-6);
     }
+    last_sample.psi[resource] = *stats;
+}
+
+void update_psi_gauge(void)
+{
+    psi_stats_t stats[PSI_RESOURCE_COUNT];
+    bool ok[PSI_RESOURCE_COUNT];
+
+    for (int i = 0; i < PSI_RESOURCE_COUNT; i++)
+    {
+        char rel[32];
+        char path[PROCFS_PATH_MAX];
+        snprintf(rel, sizeof(rel), "pressure/%s", psi_resource_name((psi_resource_t)i));
+        ok[i] = read_psi(procfs_path(rel, path, sizeof(path)), &stats[i]) == 0;
+    }
+
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < PSI_RESOURCE_COUNT; i++)
+    {
+        if (ok[i])
+        {
+            set_psi_gauges((psi_resource_t)i, &stats[i]);
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void handle_psi_event(const psi_trigger_t* trigger, const psi_stats_t* stats)
+{
+    // Contador de eventos por recurso y tipo; solo lo modifica el hilo de triggers
+    static double event_counts[PSI_RESOURCE_COUNT][2];
+
+    const char* name = psi_resource_name(trigger->resource);
+    const char* kind = trigger->full ? "full" : "some";
+    const psi_line_t* line = trigger->full ? &stats->full : &stats->some;
+
+    pthread_mutex_lock(&lock);
+    event_counts[trigger->resource][trigger->full]++;
+    counter_add(psi_events_metric, 1, event_counts[trigger->resource][trigger->full], (const char*[]){name, kind});
+    set_psi_gauges(trigger->resource, stats);
+    pthread_mutex_unlock(&lock);
+
+    // Este hilo no usa cJSON: su allocator es el arena del hilo de muestreo
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    char json[256];
+    int length = snprintf(json, sizeof(json),
+                          "{\"event\": \"psi_stall\", \"resource\": \"%s\", \"kind\": \"%s\", \"stall_us\": %u, "
+                          "\"window_us\": %u, \"avg10\": %.2f, \"total_us\": %llu, \"timestamp_ms\": %lld}\n",
+                          name, kind, trigger->stall_us, trigger->window_us, line->avg10,
+                          (unsigned long long)line->total_us,
+                          (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000);
+    events_publish(json, (size_t)length);
+}
+
+/**
+ * @brief Publica un resumen como las series de un summary de Prometheus. Requiere lock.
+ */
+static void set_quantile_gauges(prom_gauge_t* gauge, const quantile_summary_t* summary)
+{
+    gauge_set(gauge, summary->min, (const char*[]){"0"});
+    gauge_set(gauge, summary->p50, (const char*[]){"0.5"});
+    gauge_set(gauge, summary->p90, (const char*[]){"0.9"});
+    gauge_set(gauge, summary->p99, (const char*[]){"0.99"});
+    gauge_set(gauge, summary->max, (const char*[]){"1"});
+}
 
-    // Registrar la métrica
-    if (prom_collector_registry_must_register_metric(running_processes_metric) == 0)
+void update_microsample_gauge(void)
+{
+    microsample_summary_t summary;
+    if (microsample_collect(&summary) != 0)
     {
-        fprintf(stderr, "Error al registrar la métrica de procesos en ejecución\n");
         return;
     }
 
-    context_switches_metric =
-        prom_gauge_new("custom_context_switches_per_second", "Tasa de cambios de contexto por segundo", 0, NULL);
-    if (context_switches_metric == NULL)
+    pthread_mutex_lock(&lock);
+    if (summary.cpu_usage.count > 0)
+    {
+        set_quantile_gauges(cpu_micro_metric, &summary.cpu_usage);
+    }
+    set_quantile_gauges(procs_micro_metric, &summary.running_processes);
+    gauge_set(micro_overhead_metric, summary.overhead_percent, NULL);
+    last_sample.micro = summary;
+    pthread_mutex_unlock(&lock);
+}
+
+void update_sampling_gauge(const scheduler_t* scheduler)
+{
+    static bool was_burst = false;
+    static unsigned long published_bursts = 0; // Ráfagas ya sumadas al counter
+    static int registered = 0; // 1 registradas, -1 falló el registro
+    if (registered == 0)
+    {
+        registered = sampling_metrics_register() == 0 ? 1 : -1;
+    }
+    if (registered < 0)
     {
-        fprintf(stderr, "Error al crear la métrica de cambios de contexto\n");
         return;
     }
+    int interval_ms = scheduler_interval_ms(scheduler);
 
-    if (prom_collector_registry_must_register_metric(context_switches_metric) == 0)
+    pthread_mutex_lock(&lock);
+    gauge_set(sampling_burst_metric, scheduler->burst ? 1 : 0, NULL);
+    gauge_set(sampling_interval_metric, interval_ms / 1000.0, NULL);
+    if (scheduler->bursts > published_bursts)
     {
-        fprintf(stderr, "Error al registrar la métrica de cambios de contexto\n");
+        counter_add(sampling_bursts_metric, (double)(scheduler->bursts - published_bursts), (double)scheduler->bursts,
+                    NULL);
+    }
+    published_bursts = scheduler->bursts;
+    last_sample.sampling_burst = scheduler->burst;
+    last_sample.sampling_interval_ms = interval_ms;
+    pthread_mutex_unlock(&lock);
+
+    if (scheduler->burst != was_burst)
+    {
+        was_burst = scheduler->burst;
+        char json[160];
+        int length = snprintf(json, sizeof(json), "{\"event\": \"%s\", \"reason\": \"%s\", \"interval_ms\": %d}\n",
+                              scheduler->burst ? "burst_start" : "burst_end",
+                              scheduler->reason != NULL ? scheduler->reason : "", interval_ms);
+        events_publish(json, (size_t)length);
+    }
+}
+
+void get_last_sample(metrics_sample_t* sample)
+{
+    pthread_mutex_lock(&lock);
+    *sample = last_sample;
+    pthread_mutex_unlock(&lock);
+}
+
+
+
+/**
+ * @brief Manejador HTTP: /metrics para Prometheus y /alerts con el estado de las reglas.
+ */
+static enum MHD_Result handle_request(void* cls, struct MHD_Connection* connection, const char* url,
+                                      const char* method, const char* version, const char* upload_data,
+                                      size_t* upload_data_size, void** con_cls)
+{
+    (void)cls;
+    (void)method;
+    (void)version;
+    (void)upload_data;
+    (void)upload_data_size;
+    (void)con_cls;
+
+    char* body = NULL;
+    size_t length = 0;
+    const char* content_type = "text/plain; version=0.0.4";
+    unsigned int status = MHD_HTTP_OK;
+    if (strcmp(url, "/metrics") == 0)
+    {
+        pthread_rwlock_rdlock(&registry_lock);
+        body = (char*)prom_collector_registry_bridge(PROM_COLLECTOR_REGISTRY_DEFAULT);
+        pthread_rwlock_unlock(&registry_lock);
+        length = body != NULL ? strlen(body) : 0;
+    }
+    else if (strcmp(url, "/alerts") == 0)
+    {
+        body = alerts_render_json(&length);
+        content_type = "application/json";
+    }
+    else
+    {
+        status = MHD_HTTP_NOT_FOUND;
+        body = strdup("Not found\n");
+        length = body != NULL ? strlen(body) : 0;
+    }
+    if (body == NULL)
+    {
+        return MHD_NO;
+    }
+
+    struct MHD_Response* response = MHD_create_response_from_buffer(length, body, MHD_RESPMEM_MUST_FREE);
+    if (response == NULL)
+    {
+        free(body);
+        return MHD_NO;
+    }
+    MHD_add_response_header(response, "Content-Type", content_type);
+    enum MHD_Result result = MHD_queue_response(connection, status, response);
+    MHD_destroy_response(response);
+    return result;
+}
+
+void reset_collectors(bool roots, bool disk, bool net)
+{
+    // Solo las series cuya fuente cambió: su próxima lectura fija la base
+    pthread_mutex_lock(&lock);
+    if (roots)
+    {
+        collectors_generation++;
+        rate_forget(&rates, 0, rates.count);
+    }
+    else
+    {
+        if (disk)
+        {
+            rate_forget(&rates, series.disk, 2);
+        }
+        if (net)
+        {
+            rate_forget(&rates, series.net, 2);
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void install_cardinality(cardinality_rules_t* rules)
+{
+    if (rules != NULL && rules->max_series > 0 && dropped_samples_metric == NULL)
+    {
+        dropped_samples_metric =
+            prom_counter_new("cardinality_dropped_samples_total",
+                             "Muestras descartadas porque la métrica llegó al tope de series", 1,
+                             (const char*[]){"metric"});
+        if (dropped_samples_metric == NULL)
+        {
+            fprintf(stderr, "Error al crear el contador de series descartadas\n");
+        }
+    }
+
+    pthread_rwlock_wrlock(&registry_lock);
+    pthread_mutex_lock(&lock);
+    if (dropped_samples_metric != NULL && !dropped_samples_registered)
+    {
+        dropped_samples_registered = prom_collector_registry_must_register_metric(dropped_samples_metric) != 0;
+    }
+    cardinality_install(rules);
+    for (int i = 0; i < created_count; i++)
+    {
+        if (cardinality_claim_registration(created[i]) && prom_collector_registry_must_register_metric(created[i]) == 0)
+        {
+            fprintf(stderr, "Error al registrar una métrica permitida por la recarga\n");
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    pthread_rwlock_unlock(&registry_lock);
+}
+
+/**
+ * @brief Suma los descartes de una familia al counter de overflow. Requiere lock.
+ */
+static void add_dropped_samples(const char* name, uint64_t dropped)
+{
+    if (dropped_samples_registered)
+    {
+        prom_counter_add(dropped_samples_metric, (double)dropped, (const char*[]){name});
+    }
+}
+
+void publish_cardinality(void)
+{
+    pthread_mutex_lock(&lock);
+    cardinality_flush(add_dropped_samples);
+    pthread_mutex_unlock(&lock);
+}
+
+void set_rate_gauges(bool enabled)
+{
+    pthread_mutex_lock(&lock);
+    rate_gauges_enabled = enabled;
+    pthread_mutex_unlock(&lock);
+}
+
+void* expose_metrics(void* arg)
+{
+    // El hilo interno de libmicrohttpd hereda la afinidad de este
+    if (arg != NULL)
+    {
+        realtime_pin_thread((const realtime_cpuset_t*)arg);
+    }
+
+    // Iniciamos el servidor HTTP en el puerto 8000
+    struct MHD_Daemon* daemon =
+        MHD_start_daemon(MHD_USE_SELECT_INTERNALLY, 8000, NULL, NULL, handle_request, NULL, MHD_OPTION_END);
+    if (daemon == NULL)
+    {
+        fprintf(stderr, "Error al iniciar el servidor HTTP\n");
+        return NULL;
+    }
+
+    // Mantenemos el servidor en ejecución
+    while (1)
+    {
+        sleep(1); // Mantiene el hilo vivo
+    }
+
+    // Nunca debería llegar aquí
+    MHD_stop_daemon(daemon);
+    return NULL;
+}
+
+void init_metrics()
+{
+    // Inicializa el mutex
+    if (pthread_mutex_init(&lock, NULL) != 0)
+    {
+        fprintf(stderr, "Error al inicializar el mutex\n");
         return;
     }
 
-    memory_fragmentation_metric = prom_gauge_new("heap_memory_fragmentation_percentage", "Fragmentacion del heap en porcentaje", 0, NULL);
-    if (memory_fragmentation_metric == NULL) {
-        fprintf(stderr, "Error al crear la métrica de fragmentación de memoria\n");
+    // Inicializamos el registro de coleccionistas de Prometheus
+    if (prom_collector_registry_default_init() != 0)
+    {
+        fprintf(stderr, "Error al inicializar el registro de Prometheus\n");
         return;
     }
 
-    // Registrar la métrica de fragmentación de memoria
-    if (prom_collector_registry_must_register_metric(memory_fragmentation_metric) == 0) {
-        fprintf(stderr, "Error al registrar la métrica de fragmentación de memoria\n");
+    // Series de los contadores acumulados: el ancho es el del campo del kernel que las publica
+    series.context_switches = rate_series_reserve(&rates, 1, 64);
+    series.net = rate_series_reserve(&rates, 2, RATE_WIDTH_LONG);
+    series.disk = rate_series_reserve(&rates, 2, RATE_WIDTH_LONG);
+    series.vmstat = rate_series_reserve(&rates, VMSTAT_MAX_FIELDS, RATE_WIDTH_LONG);
+    series.psi = rate_series_reserve(&rates, PSI_RESOURCE_COUNT * 2, 64);
+    series.numastat = rate_series_reserve(&rates, NUMA_MAX_NODES * NUMA_STAT_FIELDS, RATE_WIDTH_LONG);
+    series.netproto = rate_series_reserve(&rates, NETPROTO_COUNTERS, RATE_WIDTH_LONG);
+    if (series.context_switches < 0 || series.net < 0 || series.disk < 0 || series.vmstat < 0 || series.psi < 0 ||
+        series.numastat < 0 || series.netproto < 0)
+    {
+        fprintf(stderr, "Error al reservar las series de contadores\n");
         return;
     }
 }
 
+/**
+ * @brief Registra un grupo de métricas recién creadas, con el registro bloqueado para el servidor HTTP.
+ * @param metrics Métricas a registrar; alguna en NULL indica que falló su creación.
+ * @param count Cantidad de métricas.
+ * @param what Nombre del grupo para los mensajes de error.
+ * @return 0 si se registraron todas, -1 en caso de error.
+ */
+static int register_metrics(prom_metric_t* const* metrics, int count, const char* what)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (metrics[i] == NULL)
+        {
+            fprintf(stderr, "Error al crear las métricas de %s\n", what);
+            return -1;
+        }
+    }
+
+    int result = 0;
+    pthread_rwlock_wrlock(&registry_lock);
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < count && result == 0; i++)
+    {
+        // Las denegadas no se registran; quedan en created por si una recarga las permite
+        if (created_count < CARDINALITY_MAX_FAMILIES)
+        {
+            created[created_count++] = metrics[i];
+        }
+        if (cardinality_claim_registration(metrics[i]) && prom_collector_registry_must_register_metric(metrics[i]) == 0)
+        {
+            result = -1;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    pthread_rwlock_unlock(&registry_lock);
+    if (result != 0)
+    {
+        fprintf(stderr, "Error al registrar las métricas de %s\n", what);
+    }
+    return result;
+}
+
+int cpu_metrics_register(void)
+{
+    cpu_usage_metric = gauge_new("cpu_usage_percentage", "Porcentaje de uso de CPU", 0, NULL);
+    return register_metrics((prom_metric_t*[]){cpu_usage_metric}, 1, "uso de CPU");
+}
+
+int memory_metrics_register(void)
+{
+    total_memory_metric = gauge_new("total_memory_mb", "Memoria total en MB", 0, NULL);
+    used_memory_metric = gauge_new("used_memory_mb", "Memoria usada en MB", 0, NULL);
+    free_memory_metric = gauge_new("free_memory_mb", "Memoria disponible en MB", 0, NULL);
+    return register_metrics((prom_metric_t*[]){total_memory_metric, used_memory_metric, free_memory_metric}, 3,
+                            "memoria");
+}
+
+int disk_metrics_register(void)
+{
+    disk_reads_completed_metric =
+        counter_new("disk_reads_completed_total", "Numero de lecturas completadas exitosamente", 0, NULL);
+    disk_writes_completed_metric =
+        counter_new("disk_writes_completed_total", "Numero de escrituras completadas exitosamente", 0, NULL);
+    disk_reads_rate_metric =
+        gauge_new("disk_reads_completed_per_second", "Lecturas completadas por segundo", 0, NULL);
+    disk_writes_rate_metric =
+        gauge_new("disk_writes_completed_per_second", "Escrituras completadas por segundo", 0, NULL);
+    return register_metrics((prom_metric_t*[]){disk_reads_completed_metric, disk_writes_completed_metric,
+                                               disk_reads_rate_metric, disk_writes_rate_metric},
+                            4, "estadísticas de disco");
+}
+
+int net_metrics_register(void)
+{
+    rx_bytes_metric = counter_new("rx_bytes_total", "Bytes recibidos por la interfaz de red", 0, NULL);
+    tx_bytes_metric = counter_new("tx_bytes_total", "Bytes transmitidos por la interfaz de red", 0, NULL);
+    rx_rate_metric = gauge_new("rx_bytes_per_second", "Bytes recibidos por segundo", 0, NULL);
+    tx_rate_metric = gauge_new("tx_bytes_per_second", "Bytes transmitidos por segundo", 0, NULL);
+    return register_metrics((prom_metric_t*[]){rx_bytes_metric, tx_bytes_metric, rx_rate_metric, tx_rate_metric}, 4,
+                            "tráfico de red");
+}
+
+int running_processes_metrics_register(void)
+{
+    running_processes_metric =
+        gauge_new("running_processes", "Numero de procesos en ejecución en el sistema", 0, NULL);
+    return register_metrics((prom_metric_t*[]){running_processes_metric}, 1, "procesos en ejecución");
+}
+
+int context_switches_metrics_register(void)
+{
+    context_switches_metric =
+        gauge_new("custom_context_switches_per_second", "Tasa de cambios de contexto por segundo", 0, NULL);
+    context_switches_total_metric =
+        counter_new("context_switches_total", "Cambios de contexto desde el arranque", 0, NULL);
+    return register_metrics((prom_metric_t*[]){context_switches_metric, context_switches_total_metric}, 2,
+                            "cambios de contexto");
+}
+
+int memory_fragmentation_metrics_register(void)
+{
+    // Fragmentación real del sistema desde /proc/buddyinfo y /proc/pagetypeinfo
+    memory_fragmentation_metric =
+        gauge_new("memory_fragmentation_percentage",
+                  "Porcentaje de memoria libre inutilizable para reservar una hugepage", 0, NULL);
+    buddy_free_blocks_metric = gauge_new("buddy_free_blocks", "Bloques libres del buddy allocator por orden", 3,
+                                         (const char*[]){"node", "zone", "order"});
+    unusable_index_metric =
+        gauge_new("memory_unusable_free_index", "Fraccion de memoria libre inutilizable para reservas del orden",
+                  3, (const char*[]){"node", "zone", "order"});
+    hugepages_allocatable_metric = gauge_new("hugepages_allocatable",
+                                             "Hugepages reservables sin compactar", 2, (const char*[]){"node", "zone"});
+    pagetype_free_metric = gauge_new("pagetype_free_pages", "Paginas libres por tipo de migracion", 3,
+                                     (const char*[]){"node", "zone", "type"});
+    pagetype_blocks_metric = gauge_new("pagetype_blocks", "Pageblocks por tipo de migracion", 3,
+                                       (const char*[]){"node", "zone", "type"});
+    return register_metrics((prom_metric_t*[]){memory_fragmentation_metric, buddy_free_blocks_metric,
+                                               unusable_index_metric, hugepages_allocatable_metric,
+                                               pagetype_free_metric, pagetype_blocks_metric},
+                            6, "fragmentación de memoria");
+}
+
+int meminfo_metrics_register(void)
+{
+    // Métricas de /proc/meminfo y /proc/vmstat, una serie por campo
+    meminfo_bytes_metric =
+        gauge_new("meminfo_bytes", "Campos de /proc/meminfo en bytes", 1, (const char*[]){"field"});
+    meminfo_pages_metric =
+        gauge_new("meminfo_pages", "Campos de /proc/meminfo que son cantidades", 1, (const char*[]){"field"});
+    vmstat_total_metric =
+        counter_new("vmstat_total", "Contadores acumulados de /proc/vmstat", 1, (const char*[]){"counter"});
+    vmstat_rate_metric = gauge_new("vmstat_rate_per_second", "Tasa por segundo de los contadores de /proc/vmstat",
+                                   1, (const char*[]){"counter"});
+    return register_metrics(
+        (prom_metric_t*[]){meminfo_bytes_metric, meminfo_pages_metric, vmstat_total_metric, vmstat_rate_metric}, 4,
+        "meminfo/vmstat");
+}
+
+int psi_metrics_register(void)
+{
+    // Métricas de /proc/pressure y de los triggers de PSI
+    psi_pressure_metric = gauge_new("psi_pressure_percent", "Porcentaje de tiempo en stall (PSI)", 3,
+                                    (const char*[]){"resource", "kind", "window"});
+    psi_stall_metric = counter_new("psi_stall_seconds_total", "Tiempo total en stall desde el arranque (PSI)",
+                                   2, (const char*[]){"resource", "kind"});
+    psi_events_metric = counter_new("psi_trigger_events_total", "Eventos de triggers PSI recibidos", 2,
+                                    (const char*[]){"resource", "kind"});
+    return register_metrics((prom_metric_t*[]){psi_pressure_metric, psi_stall_metric, psi_events_metric}, 3, "PSI");
+}
+
+int microsample_metrics_register(void)
+{
+    // Percentiles del micro-muestreo, con la forma de un summary junto a cpu_usage_percentage
+    cpu_micro_metric = gauge_new("cpu_usage_percentage_micro", "Percentiles del uso de CPU dentro del intervalo",
+                                 1, (const char*[]){"quantile"});
+    procs_micro_metric = gauge_new("running_processes_micro", "Percentiles de procs_running dentro del intervalo",
+                                   1, (const char*[]){"quantile"});
+    micro_overhead_metric = gauge_new("microsample_overhead_percent",
+                                      "CPU del hilo de micro-muestreo en porcentaje de un núcleo", 0, NULL);
+    return register_metrics((prom_metric_t*[]){cpu_micro_metric, procs_micro_metric, micro_overhead_metric}, 3,
+                            "micro-muestreo");
+}
+
+int interrupts_metrics_register(void)
+{
+    // Métricas de /proc/interrupts y /proc/softirqs (solo las k celdas con más tasa)
+    irq_rate_metric = gauge_new("irq_rate", "Interrupciones por segundo por IRQ y CPU (top-K)", 3,
+                                (const char*[]){"irq", "device", "cpu"});
+    softirq_rate_metric = gauge_new("softirq_rate", "Softirqs por segundo por tipo y CPU (top-K)", 2,
+                                    (const char*[]){"type", "cpu"});
+    irq_cpu_rate_metric = gauge_new("irq_cpu_rate", "Interrupciones por segundo de cada CPU", 1,
+                                    (const char*[]){"cpu"});
+    irq_imbalance_metric = gauge_new("irq_imbalance_ratio",
+                                     "Tasa de interrupciones de la CPU más cargada sobre el promedio", 0, NULL);
+    return register_metrics(
+        (prom_metric_t*[]){irq_rate_metric, softirq_rate_metric, irq_cpu_rate_metric, irq_imbalance_metric}, 4,
+        "interrupciones");
+}
+
+int cpufreq_metrics_register(void)
+{
+    cpu_frequency_metric = gauge_new("cpu_frequency_hertz", "Frecuencia actual de cada CPU (scaling_cur_freq)", 1,
+                                     (const char*[]){"cpu"});
+    cpu_frequency_max_metric = gauge_new("cpu_frequency_max_hertz",
+                                         "Frecuencia máxima de cada CPU (cpuinfo_max_freq)", 1,
+                                         (const char*[]){"cpu"});
+    cpu_normalized_metric = gauge_new("cpu_usage_freq_normalized_percentage",
+                                      "Uso de CPU con el tiempo ocupado de cada CPU pesado por cur_freq / max_freq",
+                                      0, NULL);
+    thermal_zone_metric = gauge_new("thermal_zone_celsius", "Temperatura de cada zona térmica", 2,
+                                    (const char*[]){"zone", "type"});
+    core_throttles_metric = counter_new("cpu_core_throttles_total",
+                                        "Eventos de throttling térmico de cada núcleo (core_throttle_count)", 1,
+                                        (const char*[]){"cpu"});
+    package_throttles_metric =
+        counter_new("cpu_package_throttles_total",
+                    "Eventos de throttling térmico de cada paquete (package_throttle_count)", 1,
+                    (const char*[]){"package"});
+    return register_metrics((prom_metric_t*[]){cpu_frequency_metric, cpu_frequency_max_metric, cpu_normalized_metric,
+                                               thermal_zone_metric, core_throttles_metric, package_throttles_metric},
+                            6, "cpufreq");
+}
+
+int numa_metrics_register(void)
+{
+    numa_memory_metric = gauge_new("numa_memory_bytes", "Campos de meminfo de cada nodo NUMA en bytes", 2,
+                                   (const char*[]){"node", "field"});
+    numastat_metric = counter_new("numastat_pages_total", "Contadores de numastat de cada nodo NUMA en páginas", 2,
+                                  (const char*[]){"node", "counter"});
+    numa_remote_metric = gauge_new("numa_remote_alloc_ratio",
+                                   "Fracción de las reservas del intervalo en el nodo hechas desde otro nodo", 1,
+                                   (const char*[]){"node"});
+    numa_cpu_usage_metric = gauge_new("numa_cpu_usage_percentage", "Uso de CPU de las CPUs de cada nodo NUMA", 1,
+                                      (const char*[]){"node"});
+    numa_cpus_metric = gauge_new("numa_cpus", "CPUs de cada nodo NUMA", 1, (const char*[]){"node"});
+    return register_metrics((prom_metric_t*[]){numa_memory_metric, numastat_metric, numa_remote_metric,
+                                               numa_cpu_usage_metric, numa_cpus_metric},
+                            5, "NUMA");
+}
+
+int netproto_metrics_register(void)
+{
+    net_protocol_metric = counter_new("net_protocol_total", "Contadores de /proc/net/snmp y /proc/net/netstat", 2,
+                                      (const char*[]){"proto", "counter"});
+    sockstat_metric = gauge_new("sockstat", "Sockets y memoria de /proc/net/sockstat", 1, (const char*[]){"field"});
+    tcp_sockets_metric = gauge_new("tcp_sockets", "Sockets TCP por estado (IPv4 e IPv6)", 1,
+                                   (const char*[]){"state"});
+    tcp_listen_queue_metric = gauge_new("tcp_listen_queue_ratio",
+                                        "Mayor ocupación de la cola de accept entre los sockets en LISTEN", 0, NULL);
+    tcp_retransmit_metric = gauge_new("tcp_retransmit_ratio",
+                                      "Segmentos retransmitidos sobre segmentos enviados en el intervalo", 0, NULL);
+    return register_metrics((prom_metric_t*[]){net_protocol_metric, sockstat_metric, tcp_sockets_metric,
+                                               tcp_listen_queue_metric, tcp_retransmit_metric},
+                            5, "protocolos de red");
+}
+
+/**
+ * @brief Crea las métricas del muestreo adaptativo la primera vez que el planificador publica.
+ */
+static int sampling_metrics_register(void)
+{
+    sampling_burst_metric = gauge_new("sampling_burst_active", "1 mientras dura una ráfaga de muestreo rápido", 0,
+                                      NULL);
+    sampling_interval_metric = gauge_new("sampling_interval_seconds", "Intervalo de muestreo vigente", 0, NULL);
+    sampling_bursts_metric = counter_new("sampling_bursts_total", "Ráfagas de muestreo desde el arranque", 0, NULL);
+    return register_metrics((prom_metric_t*[]){sampling_burst_metric, sampling_interval_metric, sampling_bursts_metric},
+                            3, "muestreo adaptativo");
+}
 
 void destroy_mutex()
 {
@@ -0,0 +1,316 @@
+#include "interrupts.h"
+#include "log.h"
+#include "parse.h"
+#include "procfs.h"
+#include "rate.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Bits de cada celda: el kernel las cuenta en unsigned int.
+ */
+#define IRQ_COUNTER_WIDTH 32
+
+/**
+ * @brief Buffer de lectura por hilo, reutilizado entre llamados.
+ */
+static __thread procfs_buf_t read_buf;
+
+/**
+ * @brief Asegura lugar para una fila más y para sus contadores.
+ */
+static int reserve_row(irq_table_t* table)
+{
+    if (table->row_count == table->row_cap)
+    {
+        int cap = table->row_cap != 0 ? table->row_cap * 2 : 64;
+        irq_row_t* rows = realloc(table->rows, (size_t)cap * sizeof(*rows));
+        if (rows == NULL)
+        {
+            return -1;
+        }
+        table->rows = rows;
+        table->row_cap = cap;
+    }
+
+    size_t needed = (size_t)(table->row_count + 1) * (size_t)table->cpu_count;
+    if (needed > table->counts_cap)
+    {
+        size_t cap = (size_t)table->row_cap * (size_t)table->cpu_count;
+        uint64_t* counts = realloc(table->counts, cap * sizeof(*counts));
+        if (counts == NULL)
+        {
+            return -1;
+        }
+        table->counts = counts;
+        table->counts_cap = cap;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parsea la cabecera "CPU0 CPU1 ..." y guarda el número de cada columna.
+ */
+static int parse_header(const char* p, const char* end, irq_table_t* table)
+{
+    table->cpu_count = 0;
+    while ((p = parse_skip_spaces(p, end)) < end)
+    {
+        if (!parse_starts_with(p, end, "CPU", 3))
+        {
+            return -1;
+        }
+        p += 3;
+        if (table->cpu_count == table->cpu_cap)
+        {
+            int cap = table->cpu_cap != 0 ? table->cpu_cap * 2 : 64;
+            int* cpus = realloc(table->cpus, (size_t)cap * sizeof(*cpus));
+            if (cpus == NULL)
+            {
+                return -1;
+            }
+            table->cpus = cpus;
+            table->cpu_cap = cap;
+        }
+        table->cpus[table->cpu_count++] = (int)parse_u64(&p, end);
+    }
+    return table->cpu_count > 0 ? 0 : -1;
+}
+
+/**
+ * @brief Copia la descripción de la fila: el dispositivo (último campo) en las IRQ numeradas, o el texto completo.
+ */
+static void copy_desc(irq_row_t* row, const char* p, const char* end)
+{
+    p = parse_skip_spaces(p, end);
+    while (end > p && (end[-1] == ' ' || end[-1] == '\t'))
+    {
+        end--;
+    }
+    if (parse_is_digit(row->name[0]))
+    {
+        const char* last = end;
+        while (last > p && last[-1] != ' ' && last[-1] != '\t')
+        {
+            last--;
+        }
+        p = last;
+    }
+    size_t len = (size_t)(end - p);
+    if (len >= IRQ_DESC_MAX)
+    {
+        len = IRQ_DESC_MAX - 1;
+    }
+    memcpy(row->desc, p, len);
+    row->desc[len] = '\0';
+}
+
+int read_irq_table(const char* path, irq_table_t* table)
+{
+    if (procfs_read(path, &read_buf) != 0)
+    {
+        log_error("Error al abrir %s: %m", path);
+        return -1;
+    }
+
+    const char* end = read_buf.data + read_buf.len;
+    const char* line = read_buf.data;
+    if (parse_header(line, parse_line_end(line, end), table) != 0)
+    {
+        log_error("Cabecera inesperada en %s", path);
+        return -1;
+    }
+
+    table->row_count = 0;
+    for (line = parse_next_line(line, end); line < end; line = parse_next_line(line, end))
+    {
+        const char* line_end = parse_line_end(line, end);
+        const char* name = parse_skip_spaces(line, line_end);
+        const char* colon = memchr(name, ':', (size_t)(line_end - name));
+        if (colon == NULL || colon == name)
+        {
+            continue;
+        }
+        if (reserve_row(table) != 0)
+        {
+            log_error("Sin memoria para la tabla de %s", path);
+            return -1;
+        }
+
+        irq_row_t* row = &table->rows[table->row_count];
+        size_t name_len = (size_t)(colon - name);
+        if (name_len >= IRQ_NAME_MAX)
+        {
+            name_len = IRQ_NAME_MAX - 1;
+        }
+        memcpy(row->name, name, name_len);
+        row->name[name_len] = '\0';
+
+        // Una columna por CPU; las filas cortas (ERR, MIS) se completan con ceros
+        uint64_t* counts = table->counts + (size_t)table->row_count * (size_t)table->cpu_count;
+        const char* p = colon + 1;
+        int column = 0;
+        for (; column < table->cpu_count; column++)
+        {
+            p = parse_skip_padding(p, line_end);
+            if (p >= line_end || !parse_is_digit(*p))
+            {
+                break;
+            }
+            counts[column] = parse_u64(&p, line_end);
+        }
+        for (; column < table->cpu_count; column++)
+        {
+            counts[column] = 0;
+        }
+
+        copy_desc(row, p, line_end);
+        table->row_count++;
+    }
+    return 0;
+}
+
+void irq_table_free(irq_table_t* table)
+{
+    free(table->cpus);
+    free(table->rows);
+    free(table->counts);
+    memset(table, 0, sizeof(*table));
+}
+
+/**
+ * @brief Busca en prev la fila con el nombre dado, empezando por la posición esperada.
+ */
+static int find_row(const irq_table_t* prev, const char* name, int hint)
+{
+    if (hint < prev->row_count && strcmp(prev->rows[hint].name, name) == 0)
+    {
+        return hint;
+    }
+    for (int i = 0; i < prev->row_count; i++)
+    {
+        if (strcmp(prev->rows[i].name, name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Restaura la propiedad de min-heap (por tasa) desde la posición i.
+ */
+static void sift_down(irq_cell_rate_t* heap, int size, int i)
+{
+    for (;;)
+    {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < size && heap[left].rate < heap[smallest].rate)
+        {
+            smallest = left;
+        }
+        if (right < size && heap[right].rate < heap[smallest].rate)
+        {
+            smallest = right;
+        }
+        if (smallest == i)
+        {
+            return;
+        }
+        irq_cell_rate_t tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+static void sift_up(irq_cell_rate_t* heap, int i)
+{
+    while (i > 0 && heap[(i - 1) / 2].rate > heap[i].rate)
+    {
+        irq_cell_rate_t tmp = heap[i];
+        heap[i] = heap[(i - 1) / 2];
+        heap[(i - 1) / 2] = tmp;
+        i = (i - 1) / 2;
+    }
+}
+
+int irq_top_rates(const irq_table_t* prev, const irq_table_t* cur, double seconds, irq_cell_rate_t* top, int k,
+                  double* cpu_rates)
+{
+    if (seconds <= 0 || prev->cpu_count != cur->cpu_count ||
+        memcmp(prev->cpus, cur->cpus, (size_t)cur->cpu_count * sizeof(int)) != 0)
+    {
+        return -1;
+    }
+    if (k > IRQ_TOP_K_MAX)
+    {
+        k = IRQ_TOP_K_MAX;
+    }
+    if (cpu_rates != NULL)
+    {
+        for (int c = 0; c < cur->cpu_count; c++)
+        {
+            cpu_rates[c] = 0;
+        }
+    }
+
+    // Min-heap de las k mayores tasas: la raíz es la menor de las que quedan adentro
+    int size = 0;
+    int hint = 0;
+    for (int r = 0; r < cur->row_count; r++)
+    {
+        int pr = find_row(prev, cur->rows[r].name, hint);
+        if (pr < 0)
+        {
+            continue; // Interrupción nueva: todavía no hay tasa
+        }
+        hint = pr + 1;
+
+        const uint64_t* now = cur->counts + (size_t)r * (size_t)cur->cpu_count;
+        const uint64_t* before = prev->counts + (size_t)pr * (size_t)cur->cpu_count;
+        for (int c = 0; c < cur->cpu_count; c++)
+        {
+            // Las celdas son unsigned int: LOC y RES dan la vuelta en hosts ocupados
+            uint64_t delta = rate_counter_delta(before[c], now[c], IRQ_COUNTER_WIDTH);
+            if (delta == 0)
+            {
+                continue;
+            }
+            double rate = (double)delta / seconds;
+            if (cpu_rates != NULL)
+            {
+                cpu_rates[c] += rate;
+            }
+            if (size < k)
+            {
+                top[size] = (irq_cell_rate_t){r, c, rate};
+                sift_up(top, size++);
+            }
+            else if (k > 0 && rate > top[0].rate)
+            {
+                top[0] = (irq_cell_rate_t){r, c, rate};
+                sift_down(top, size, 0);
+            }
+        }
+    }
+
+    // De mayor a menor (k es chico)
+    for (int i = 1; i < size; i++)
+    {
+        irq_cell_rate_t cell = top[i];
+        int j = i;
+        while (j > 0 && top[j - 1].rate < cell.rate)
+        {
+            top[j] = top[j - 1];
+            j--;
+        }
+        top[j] = cell;
+    }
+    return size;
+}
@@ -0,0 +1,846 @@
+#include "log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Tamaño fijo de un registro en el ring.
+ */
+#define LOG_RECORD_SIZE 256
+
+/**
+ * @brief Líneas por writev() del hilo escritor.
+ */
+#define LOG_BATCH 64
+
+/**
+ * @brief Largo máximo de una línea formateada.
+ */
+#define LOG_LINE_MAX 512
+
+/**
+ * @brief Registro binario: el formato se resuelve recién en el hilo escritor.
+ */
+typedef struct
+{
+    const log_site_t* site;      // Sitio de la llamada
+    const char* format;          // Formato (literal, vive todo el programa)
+    int64_t timestamp_ns;        // CLOCK_REALTIME de la llamada
+    int saved_errno;             // errno de la llamada, para %m
+    uint16_t arg_count;          // Argumentos capturados
+    uint16_t text_used;          // Bytes usados de text
+    uint64_t args[LOG_MAX_ARGS]; // Enteros, bits de double, punteros u offsets en text
+    char text[LOG_RECORD_SIZE - 2 * sizeof(void*) - sizeof(int64_t) - sizeof(int) - 2 * sizeof(uint16_t) -
+              LOG_MAX_ARGS * sizeof(uint64_t)]; // Copia de los strings
+} log_record_t;
+
+_Static_assert(sizeof(log_record_t) == LOG_RECORD_SIZE, "log_record_t debe medir LOG_RECORD_SIZE");
+
+/**
+ * @brief Ring de un hilo: el hilo produce, el escritor consume.
+ */
+typedef struct
+{
+    log_record_t records[LOG_RING_RECORDS];
+    uint32_t head;    // Próximo registro a escribir (solo el productor)
+    uint32_t tail;    // Próximo registro a leer (solo el escritor)
+    uint32_t dropped; // Registros descartados con el ring lleno
+    int alive;        // 0 cuando el hilo dueño terminó: el ring se puede reasignar
+} log_ring_t;
+
+/**
+ * @brief Clase de argumento de una conversión.
+ */
+typedef enum
+{
+    ARG_NONE,
+    ARG_SIGNED,
+    ARG_UNSIGNED,
+    ARG_DOUBLE,
+    ARG_STRING,
+    ARG_POINTER,
+    ARG_ERRNO,
+    ARG_UNSUPPORTED
+} arg_kind_t;
+
+/**
+ * @brief Conversión de un formato: "%-8.3lu" → flags/ancho/precisión, modificador y conversión.
+ */
+typedef struct
+{
+    const char* start;  // '%'
+    const char* end;    // Después de la conversión
+    size_t prefix_len;  // Largo de '%' + flags + ancho + precisión
+    char length[3];     // Modificador de largo ("", "h", "hh", "l", "ll", "z", "j", "t", "L")
+    char conversion;    // Letra de la conversión
+    arg_kind_t kind;    // Qué argumento consume
+} spec_t;
+
+static log_ring_t* rings[LOG_MAX_THREADS];
+static int ring_count;
+static __thread log_ring_t* thread_ring;
+static pthread_key_t ring_key;
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+
+static log_site_t* sites; // Lista de sitios con algún registro, para informar los suprimidos
+
+static struct
+{
+    pthread_mutex_t fd_lock; // Solo entre el escritor y log_reopen(); los productores no lo usan
+    int fd;
+    bool own_fd;
+    pthread_t thread;
+    int running;
+    int stop;
+} writer = {.fd_lock = PTHREAD_MUTEX_INITIALIZER, .fd = STDERR_FILENO};
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Analiza la conversión que empieza en p ('%').
+ */
+static void parse_spec(const char* p, spec_t* spec)
+{
+    spec->start = p++;
+    while (*p != '\0' && strchr("-+ #0'", *p) != NULL)
+    {
+        p++;
+    }
+    while ((*p >= '0' && *p <= '9') || *p == '.')
+    {
+        p++;
+    }
+    spec->prefix_len = (size_t)(p - spec->start);
+
+    size_t n = 0;
+    while (*p != '\0' && strchr("hlzjtL", *p) != NULL && n < sizeof(spec->length) - 1)
+    {
+        spec->length[n++] = *p++;
+    }
+    spec->length[n] = '\0';
+    spec->conversion = *p;
+    spec->end = *p != '\0' ? p + 1 : p;
+
+    switch (spec->conversion)
+    {
+    case 'd':
+    case 'i':
+        spec->kind = ARG_SIGNED;
+        break;
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+        spec->kind = ARG_UNSIGNED;
+        break;
+    case 'c':
+        spec->kind = ARG_SIGNED;
+        break;
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'e':
+    case 'E':
+    case 'a':
+    case 'A':
+        spec->kind = ARG_DOUBLE;
+        break;
+    case 's':
+        spec->kind = ARG_STRING;
+        break;
+    case 'p':
+        spec->kind = ARG_POINTER;
+        break;
+    case 'm':
+        spec->kind = ARG_ERRNO;
+        break;
+    case '%':
+        spec->kind = ARG_NONE;
+        break;
+    default:
+        spec->kind = ARG_UNSUPPORTED; // '*' o conversión desconocida: el resto sale literal
+        break;
+    }
+}
+
+/**
+ * @brief Tipo C con el que se lee un argumento: clase de la conversión más modificador de largo.
+ */
+typedef enum
+{
+    TYPE_INT,
+    TYPE_LONG,
+    TYPE_LLONG,
+    TYPE_SSIZE,
+    TYPE_INTMAX,
+    TYPE_PTRDIFF,
+    TYPE_UINT,
+    TYPE_ULONG,
+    TYPE_ULLONG,
+    TYPE_SIZE,
+    TYPE_UINTMAX,
+    TYPE_DOUBLE,
+    TYPE_LONG_DOUBLE,
+    TYPE_STRING,
+    TYPE_POINTER
+} arg_type_t;
+
+/**
+ * @brief Tipo del argumento de un entero según el modificador; unsigned_offset pasa a la variante sin signo.
+ */
+static uint8_t integer_type(const char* length, int unsigned_offset)
+{
+    if (strcmp(length, "l") == 0)
+    {
+        return (uint8_t)(TYPE_LONG + unsigned_offset);
+    }
+    if (strcmp(length, "ll") == 0)
+    {
+        return (uint8_t)(TYPE_LLONG + unsigned_offset);
+    }
+    if (strcmp(length, "z") == 0)
+    {
+        return (uint8_t)(TYPE_SSIZE + unsigned_offset);
+    }
+    if (strcmp(length, "j") == 0)
+    {
+        return (uint8_t)(TYPE_INTMAX + unsigned_offset);
+    }
+    if (strcmp(length, "t") == 0)
+    {
+        return TYPE_PTRDIFF; // Sin variante sin signo: se lee con signo y se guardan los mismos bits
+    }
+    return (uint8_t)(TYPE_INT + unsigned_offset);
+}
+
+/**
+ * @brief Resuelve del formato los tipos de los argumentos que se capturan.
+ * @return Cantidad de argumentos; se corta en LOG_MAX_ARGS o en la primera conversión no admitida.
+ */
+static uint8_t parse_layout(const char* format, uint8_t types[LOG_MAX_ARGS])
+{
+    uint8_t count = 0;
+    for (const char* p = strchr(format, '%'); p != NULL && count < LOG_MAX_ARGS; p = strchr(p, '%'))
+    {
+        spec_t spec;
+        parse_spec(p, &spec);
+        p = spec.end;
+        switch (spec.kind)
+        {
+        case ARG_NONE:
+        case ARG_ERRNO:
+            continue;
+        case ARG_UNSUPPORTED:
+            return count;
+        case ARG_SIGNED:
+            types[count] = integer_type(spec.length, 0);
+            break;
+        case ARG_UNSIGNED:
+            types[count] = integer_type(spec.length, TYPE_UINT - TYPE_INT);
+            break;
+        case ARG_DOUBLE:
+            types[count] = strcmp(spec.length, "L") == 0 ? TYPE_LONG_DOUBLE : TYPE_DOUBLE;
+            break;
+        case ARG_STRING:
+            types[count] = TYPE_STRING;
+            break;
+        case ARG_POINTER:
+            types[count] = TYPE_POINTER;
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Tabla de argumentos del sitio: se calcula en la primera llamada y queda fija.
+ *
+ * Si dos hilos estrenan el sitio a la vez, el que pierde usa su propia copia en scratch.
+ */
+static const uint8_t* site_layout(log_site_t* site, const char* format, uint8_t scratch[LOG_MAX_ARGS],
+                                  uint8_t* count)
+{
+    if (__atomic_load_n(&site->layout_ready, __ATOMIC_ACQUIRE) == 1)
+    {
+        *count = site->arg_count;
+        return site->arg_types;
+    }
+    *count = parse_layout(format, scratch);
+    int expected = 0;
+    if (__atomic_compare_exchange_n(&site->layout_ready, &expected, 2, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+    {
+        memcpy(site->arg_types, scratch, sizeof(site->arg_types));
+        site->arg_count = *count;
+        __atomic_store_n(&site->layout_ready, 1, __ATOMIC_RELEASE);
+    }
+    return scratch;
+}
+
+/**
+ * @brief Copia el string al texto del registro y devuelve su offset.
+ */
+static uint64_t capture_string(log_record_t* record, const char* value)
+{
+    // Por valor: el string puede ser un buffer en la pila del que llama
+    if (value == NULL)
+    {
+        value = "(null)";
+    }
+    size_t room = sizeof(record->text) - record->text_used;
+    if (room == 0)
+    {
+        return sizeof(record->text) - 1; // Sin lugar: string vacío
+    }
+    size_t length = strnlen(value, room - 1);
+    uint64_t offset = record->text_used;
+    memcpy(record->text + record->text_used, value, length);
+    record->text[record->text_used + length] = '\0';
+    record->text_used = (uint16_t)(record->text_used + length + 1);
+    return offset;
+}
+
+/**
+ * @brief Copia los argumentos de la llamada al registro según la tabla del sitio, sin volver a leer el formato.
+ */
+static void capture_args(log_record_t* record, const uint8_t* types, uint8_t count, va_list* args)
+{
+    record->arg_count = count;
+    record->text_used = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint64_t* slot = &record->args[i];
+        switch ((arg_type_t)types[i])
+        {
+        case TYPE_INT:
+            *slot = (uint64_t)(int64_t)va_arg(*args, int);
+            break;
+        case TYPE_LONG:
+            *slot = (uint64_t)(int64_t)va_arg(*args, long);
+            break;
+        case TYPE_LLONG:
+            *slot = (uint64_t)(int64_t)va_arg(*args, long long);
+            break;
+        case TYPE_SSIZE:
+            *slot = (uint64_t)(int64_t)va_arg(*args, ssize_t);
+            break;
+        case TYPE_INTMAX:
+            *slot = (uint64_t)(int64_t)va_arg(*args, intmax_t);
+            break;
+        case TYPE_PTRDIFF:
+            *slot = (uint64_t)(int64_t)va_arg(*args, ptrdiff_t);
+            break;
+        case TYPE_UINT:
+            *slot = va_arg(*args, unsigned int);
+            break;
+        case TYPE_ULONG:
+            *slot = va_arg(*args, unsigned long);
+            break;
+        case TYPE_ULLONG:
+            *slot = va_arg(*args, unsigned long long);
+            break;
+        case TYPE_SIZE:
+            *slot = va_arg(*args, size_t);
+            break;
+        case TYPE_UINTMAX:
+            *slot = va_arg(*args, uintmax_t);
+            break;
+        case TYPE_DOUBLE:
+        case TYPE_LONG_DOUBLE:
+        {
+            double value = types[i] == TYPE_LONG_DOUBLE ? (double)va_arg(*args, long double) : va_arg(*args, double);
+            memcpy(slot, &value, sizeof(value));
+            break;
+        }
+        case TYPE_POINTER:
+            *slot = (uint64_t)(uintptr_t)va_arg(*args, void*);
+            break;
+        case TYPE_STRING:
+            *slot = capture_string(record, va_arg(*args, const char*));
+            break;
+        }
+    }
+}
+
+static void release_ring(void* ring)
+{
+    __atomic_store_n(&((log_ring_t*)ring)->alive, 0, __ATOMIC_RELEASE);
+}
+
+static void create_ring_key(void)
+{
+    pthread_key_create(&ring_key, release_ring);
+}
+
+/**
+ * @brief Ring del hilo actual: reutiliza uno de un hilo terminado ya drenado o reserva uno nuevo.
+ */
+static log_ring_t* acquire_ring(void)
+{
+    pthread_once(&ring_key_once, create_ring_key);
+    log_ring_t* ring = NULL;
+    int count = __atomic_load_n(&ring_count, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count && ring == NULL; i++)
+    {
+        log_ring_t* candidate = __atomic_load_n(&rings[i], __ATOMIC_ACQUIRE);
+        int expected = 0;
+        if (candidate != NULL &&
+            __atomic_load_n(&candidate->tail, __ATOMIC_ACQUIRE) == candidate->head &&
+            __atomic_compare_exchange_n(&candidate->alive, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        {
+            ring = candidate;
+        }
+    }
+    if (ring == NULL)
+    {
+        int index = __atomic_fetch_add(&ring_count, 1, __ATOMIC_ACQ_REL);
+        if (index >= LOG_MAX_THREADS)
+        {
+            __atomic_fetch_sub(&ring_count, 1, __ATOMIC_ACQ_REL);
+            return NULL;
+        }
+        ring = calloc(1, sizeof(*ring));
+        if (ring == NULL)
+        {
+            return NULL; // El slot queda vacío; el escritor lo saltea
+        }
+        ring->alive = 1;
+        __atomic_store_n(&rings[index], ring, __ATOMIC_RELEASE);
+    }
+    pthread_setspecific(ring_key, ring);
+    return ring;
+}
+
+/**
+ * @brief Aplica el límite del sitio. Devuelve false si el registro se suprime.
+ */
+static bool site_admit(log_site_t* site, int64_t now)
+{
+    if (!__atomic_load_n(&site->registered, __ATOMIC_ACQUIRE))
+    {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&site->registered, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        {
+            site->next = __atomic_load_n(&sites, __ATOMIC_ACQUIRE);
+            while (!__atomic_compare_exchange_n(&sites, &site->next, site, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+            }
+        }
+    }
+    if (site->burst == 0)
+    {
+        return true;
+    }
+
+    int64_t start = __atomic_load_n(&site->window_start_ns, __ATOMIC_RELAXED);
+    if (now - start >= (int64_t)LOG_RATE_WINDOW_MS * 1000000LL &&
+        __atomic_compare_exchange_n(&site->window_start_ns, &start, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+        __atomic_store_n(&site->window_count, 0, __ATOMIC_RELAXED);
+    }
+    if (__atomic_fetch_add(&site->window_count, 1, __ATOMIC_RELAXED) >= site->burst)
+    {
+        __atomic_fetch_add(&site->suppressed, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    return true;
+}
+
+static size_t format_record(const log_record_t* record, char* out, size_t size);
+
+void log_write(log_site_t* site, const char* format, ...)
+{
+    int saved_errno = errno;
+    int64_t now = now_ns();
+    if (!site_admit(site, now))
+    {
+        errno = saved_errno;
+        return;
+    }
+
+    log_record_t local;
+    log_record_t* record = &local;
+    log_ring_t* ring = NULL;
+    uint32_t head = 0;
+    if (__atomic_load_n(&writer.running, __ATOMIC_ACQUIRE))
+    {
+        ring = thread_ring != NULL ? thread_ring : (thread_ring = acquire_ring());
+        if (ring == NULL)
+        {
+            errno = saved_errno;
+            return;
+        }
+        head = ring->head;
+        if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == LOG_RING_RECORDS)
+        {
+            __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+            errno = saved_errno;
+            return;
+        }
+        record = &ring->records[head & (LOG_RING_RECORDS - 1)];
+    }
+
+    record->site = site;
+    record->format = format;
+    record->timestamp_ns = now;
+    record->saved_errno = saved_errno;
+    uint8_t scratch[LOG_MAX_ARGS];
+    uint8_t count;
+    const uint8_t* types = site_layout(site, format, scratch, &count);
+    va_list args;
+    va_start(args, format);
+    capture_args(record, types, count, &args);
+    va_end(args);
+
+    if (ring != NULL)
+    {
+        __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    }
+    else
+    {
+        // Sin hilo escritor: se formatea en el momento
+        char line[LOG_LINE_MAX];
+        size_t length = format_record(record, line, sizeof(line));
+        ssize_t written = write(STDERR_FILENO, line, length);
+        (void)written;
+    }
+    errno = saved_errno;
+}
+
+/**
+ * @brief Resuelve el formato del registro con sus argumentos capturados.
+ */
+static size_t format_message(const log_record_t* record, char* out, size_t size)
+{
+    size_t used = 0;
+    int arg = 0;
+    const char* p = record->format;
+    while (*p != '\0' && used + 1 < size)
+    {
+        if (*p != '%')
+        {
+            out[used++] = *p++;
+            continue;
+        }
+        spec_t spec;
+        parse_spec(p, &spec);
+        if (spec.kind == ARG_UNSUPPORTED || (spec.kind != ARG_NONE && spec.kind != ARG_ERRNO &&
+                                             arg >= record->arg_count))
+        {
+            // Lo que no se capturó sale tal cual
+            int n = snprintf(out + used, size - used, "%s", p);
+            used += n > 0 ? (size_t)n : 0;
+            break;
+        }
+
+        // La conversión se rearma con un tipo fijo por clase: "%5lu" → "%5llu"
+        char conversion[24];
+        size_t prefix = spec.prefix_len < 16 ? spec.prefix_len : 16;
+        memcpy(conversion, spec.start, prefix);
+        conversion[prefix] = '\0';
+        uint64_t value = spec.kind != ARG_NONE && spec.kind != ARG_ERRNO ? record->args[arg++] : 0;
+        int n = 0;
+        switch (spec.kind)
+        {
+        case ARG_NONE:
+            n = snprintf(out + used, size - used, "%%");
+            break;
+        case ARG_ERRNO:
+            n = snprintf(out + used, size - used, "%s", strerror(record->saved_errno));
+            break;
+        case ARG_SIGNED:
+        case ARG_UNSIGNED:
+            if (spec.conversion == 'c')
+            {
+                strcat(conversion, "c");
+                n = snprintf(out + used, size - used, conversion, (int)value);
+            }
+            else
+            {
+                size_t end = strlen(conversion);
+                conversion[end] = 'l';
+                conversion[end + 1] = 'l';
+                conversion[end + 2] = spec.conversion;
+                conversion[end + 3] = '\0';
+                n = spec.kind == ARG_SIGNED ? snprintf(out + used, size - used, conversion, (long long)value)
+                                            : snprintf(out + used, size - used, conversion, (unsigned long long)value);
+            }
+            break;
+        case ARG_DOUBLE:
+        {
+            double d;
+            memcpy(&d, &value, sizeof(d));
+            size_t end = strlen(conversion);
+            conversion[end] = spec.conversion;
+            conversion[end + 1] = '\0';
+            n = snprintf(out + used, size - used, conversion, d);
+            break;
+        }
+        case ARG_STRING:
+            strcat(conversion, "s");
+            n = snprintf(out + used, size - used, conversion, record->text + value);
+            break;
+        case ARG_POINTER:
+            strcat(conversion, "p");
+            n = snprintf(out + used, size - used, conversion, (void*)(uintptr_t)value);
+            break;
+        case ARG_UNSUPPORTED:
+            break;
+        }
+        used += n > 0 ? (size_t)n : 0;
+        if (used >= size)
+        {
+            used = size - 1;
+        }
+        p = spec.end;
+    }
+    out[used] = '\0';
+    return used;
+}
+
+/**
+ * @brief Antepone fecha, nivel y sitio a una línea de texto.
+ */
+static size_t format_prefix(int64_t timestamp_ns, const log_site_t* site, char* out, size_t size)
+{
+    static const char* const levels[] = {"ERROR", "WARN", "INFO"};
+    static __thread time_t cached_second = -1;
+    static __thread char cached_stamp[24];
+
+    time_t second = (time_t)(timestamp_ns / 1000000000LL);
+    if (second != cached_second)
+    {
+        struct tm tm;
+        localtime_r(&second, &tm);
+        strftime(cached_stamp, sizeof(cached_stamp), "%Y-%m-%d %H:%M:%S", &tm);
+        cached_second = second;
+    }
+    const char* file = strrchr(site->file, '/');
+    int n = snprintf(out, size, "%s.%03d %s %s:%d: ", cached_stamp, (int)(timestamp_ns / 1000000 % 1000),
+                     levels[site->level], file != NULL ? file + 1 : site->file, site->line);
+    return n > 0 && (size_t)n < size ? (size_t)n : 0;
+}
+
+static size_t format_record(const log_record_t* record, char* out, size_t size)
+{
+    size_t used = format_prefix(record->timestamp_ns, record->site, out, size);
+    used += format_message(record, out + used, size - used - 1);
+    out[used++] = '\n';
+    return used;
+}
+
+/**
+ * @brief Escribe un lote completo con un solo writev().
+ */
+static void flush_batch(struct iovec* iov, int count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    pthread_mutex_lock(&writer.fd_lock);
+    ssize_t written = writev(writer.fd, iov, count);
+    (void)written; // Si el disco falla no hay dónde informarlo
+    pthread_mutex_unlock(&writer.fd_lock);
+}
+
+/**
+ * @brief Drena todos los rings en orden de timestamp e informa suprimidos y descartados.
+ * @param final true en el último drenaje: los suprimidos se informan aunque la ventana siga abierta.
+ */
+static void drain(bool final)
+{
+    static char lines[LOG_BATCH][LOG_LINE_MAX];
+    struct iovec iov[LOG_BATCH];
+    int batch = 0;
+    int count = __atomic_load_n(&ring_count, __ATOMIC_ACQUIRE);
+    int64_t now = now_ns();
+
+    // Mezcla de los rings: siempre el registro pendiente más antiguo
+    while (true)
+    {
+        log_ring_t* oldest = NULL;
+        const log_record_t* record = NULL;
+        for (int i = 0; i < count; i++)
+        {
+            log_ring_t* ring = __atomic_load_n(&rings[i], __ATOMIC_ACQUIRE);
+            if (ring == NULL || ring->tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE))
+            {
+                continue;
+            }
+            const log_record_t* candidate = &ring->records[ring->tail & (LOG_RING_RECORDS - 1)];
+            if (record == NULL || candidate->timestamp_ns < record->timestamp_ns)
+            {
+                oldest = ring;
+                record = candidate;
+            }
+        }
+        if (oldest == NULL)
+        {
+            break;
+        }
+        size_t length = format_record(record, lines[batch], LOG_LINE_MAX);
+        __atomic_store_n(&oldest->tail, oldest->tail + 1, __ATOMIC_RELEASE);
+        iov[batch].iov_base = lines[batch];
+        iov[batch].iov_len = length;
+        if (++batch == LOG_BATCH)
+        {
+            flush_batch(iov, batch);
+            batch = 0;
+        }
+    }
+
+    // Suprimidos por sitio, una línea por ventana cerrada
+    for (log_site_t* site = __atomic_load_n(&sites, __ATOMIC_ACQUIRE); site != NULL; site = site->next)
+    {
+        if (__atomic_load_n(&site->suppressed, __ATOMIC_RELAXED) == 0 ||
+            (!final &&
+             now - __atomic_load_n(&site->window_start_ns, __ATOMIC_RELAXED) < (int64_t)LOG_RATE_WINDOW_MS * 1000000LL))
+        {
+            continue;
+        }
+        uint32_t suppressed = __atomic_exchange_n(&site->suppressed, 0, __ATOMIC_RELAXED);
+        size_t used = format_prefix(now, site, lines[batch], LOG_LINE_MAX);
+        int n = snprintf(lines[batch] + used, LOG_LINE_MAX - used, "%u mensajes suprimidos en los últimos %d s\n",
+                         suppressed, LOG_RATE_WINDOW_MS / 1000);
+        iov[batch].iov_base = lines[batch];
+        iov[batch].iov_len = used + (n > 0 ? (size_t)n : 0);
+        if (++batch == LOG_BATCH)
+        {
+            flush_batch(iov, batch);
+            batch = 0;
+        }
+    }
+
+    // Descartados por ring lleno
+    uint32_t dropped = 0;
+    for (int i = 0; i < count; i++)
+    {
+        log_ring_t* ring = __atomic_load_n(&rings[i], __ATOMIC_ACQUIRE);
+        dropped += ring != NULL ? __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED) : 0;
+    }
+    if (dropped > 0)
+    {
+        static log_site_t logger_site = {.file = __FILE__, .line = __LINE__, .level = LOG_LEVEL_WARN};
+        size_t used = format_prefix(now, &logger_site, lines[batch], LOG_LINE_MAX);
+        int n = snprintf(lines[batch] + used, LOG_LINE_MAX - used, "%u registros descartados con el buffer lleno\n",
+                         dropped);
+        iov[batch].iov_base = lines[batch];
+        iov[batch].iov_len = used + (n > 0 ? (size_t)n : 0);
+        batch++;
+    }
+    flush_batch(iov, batch);
+}
+
+static void* writer_thread(void* arg)
+{
+    (void)arg;
+    struct timespec period = {0, LOG_FLUSH_MS * 1000000L};
+    while (!__atomic_load_n(&writer.stop, __ATOMIC_ACQUIRE))
+    {
+        nanosleep(&period, NULL);
+        drain(false);
+    }
+    drain(true);
+    return NULL;
+}
+
+/**
+ * @brief Abre el destino del log: el archivo en modo append o stderr.
+ */
+static int open_target(const char* path, bool* own)
+{
+    *own = path != NULL && path[0] != '\0';
+    if (!*own)
+    {
+        return STDERR_FILENO;
+    }
+    int fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Error al abrir el log %s: %s\n", path, strerror(errno));
+    }
+    return fd;
+}
+
+int log_start(const char* path)
+{
+    if (writer.running)
+    {
+        return log_reopen(path);
+    }
+    bool own;
+    int fd = open_target(path, &own);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    writer.fd = fd;
+    writer.own_fd = own;
+    writer.stop = 0;
+    if (pthread_create(&writer.thread, NULL, writer_thread, NULL) != 0)
+    {
+        fprintf(stderr, "Error al crear el hilo del logger\n");
+        if (own)
+        {
+            close(fd);
+        }
+        writer.fd = STDERR_FILENO;
+        writer.own_fd = false;
+        return -1;
+    }
+    __atomic_store_n(&writer.running, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int log_reopen(const char* path)
+{
+    bool own;
+    int fd = open_target(path, &own);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    pthread_mutex_lock(&writer.fd_lock);
+    if (writer.own_fd)
+    {
+        close(writer.fd);
+    }
+    writer.fd = fd;
+    writer.own_fd = own;
+    pthread_mutex_unlock(&writer.fd_lock);
+    return 0;
+}
+
+void log_stop(void)
+{
+    if (!writer.running)
+    {
+        return;
+    }
+    // Los registros que lleguen después van directo a stderr
+    __atomic_store_n(&writer.running, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&writer.stop, 1, __ATOMIC_RELEASE);
+    pthread_join(writer.thread, NULL);
+    if (writer.own_fd)
+    {
+        close(writer.fd);
+    }
+    writer.fd = STDERR_FILENO;
+    writer.own_fd = false;
+}
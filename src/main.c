@@ -1,37 +1,30 @@
 // main.c
 #include "config.h" // Incluir config.h
+#include "alerts.h"
+#include "allocator.h"
+#include "arena.h"
+#include "collectors.h"
+#include "config_watch.h"
 #include "expose_metrics.h"
+#include "log.h"
 #include "memory.h" // Incluir memory.h
+#include "microsample.h"
+#include "procfs.h"
+#include "psi.h"
+#include "realtime.h"
+#include "scheduler.h"
 #include <cjson/cJSON.h>
+#include <errno.h>
 #include <fcntl.h>   // For open, O_WRONLY
 #include <libgen.h>  // For dirname
 #include <limits.h>  // For PATH_MAX
 #include <pthread.h> // For pthread_create, pthread_join
 #include <stdbool.h>
 #include <sys/stat.h> // For mkfifo
+#include <time.h>     // For clock_gettime
 #include <unistd.h>   // For write, close, sleep, readlink>
 
 
-const char* detect_disk() {
-    static char device[256];
-    FILE *fp;
-
-    // Ejecuta el comando lsblk para obtener el nombre del disco
-    fp = popen("lsblk -nd -o NAME | head -n 1", "r");
-    if (fp == NULL) {
-        perror("Error ejecutando lsblk");
-        return "sda"; // Valor predeterminado
-    }
-
-    if (fgets(device, sizeof(device), fp) != NULL) {
-        device[strcspn(device, "\n")] = 0; // Eliminar salto de línea
-    } else {
-        strncpy(device, "sda", sizeof(device));
-    }
-
-    pclose(fp);
-    return device;
-}
 /**
  * @brief Inicializa la configuración con valores predeterminados.
  */
@@ -44,51 +37,334 @@ void init_default_config(config_t* config) {
     config->collect_net = false;
     config->collect_context_switches = false;
     config->collect_running_processes = false;
+    config->collect_meminfo = false;
+    config->collect_psi = false;
+    config->collect_interrupts = false;
+    config->irq_top_k = 10;
+    config->collect_numa = false;
+    config->collect_cpufreq = false;
+    config->collect_netproto = false;
+    config->psi_trigger_count = psi_default_triggers(config->psi_triggers);
+    adaptive_config_defaults(&config->adaptive, config->sampling_interval);
+    realtime_config_defaults(&config->realtime);
+    config->micro_sampling_ms = 0;
+    config->collect_microsample = false;
+    config->rate_gauges = true;
+    config->alerts = NULL;
+    config->cardinality = NULL;
     config->allocation_method = FIRST_FIT; // Método predeterminado
     strncpy(config->log_file, "/tmp/metrics.log", sizeof(config->log_file) - 1);
     config->log_file[sizeof(config->log_file) - 1] = '\0';
+    config->proc_root[0] = '\0';
+    config->sys_root[0] = '\0';
+    config->replay_dir[0] = '\0';
+    config->replay_speed = 1.0;
+    config->replay_loop = false;
+    config->procfs_batch = PROCFS_BATCH_OFF;
+    config->disk_device[0] = '\0';
+    snprintf(config->net_interface, sizeof(config->net_interface), "%s", "wlp1s0");
+}
+
+/**
+ * @brief Milisegundos de CLOCK_MONOTONIC a partir de un timespec.
+ */
+static int64_t timespec_ms(const struct timespec* ts) {
+    return (int64_t)ts->tv_sec * 1000 + ts->tv_nsec / 1000000;
+}
+
+/**
+ * @brief Duerme hasta el próximo tick, interval_us después del anterior.
+ *
+ * Los plazos son absolutos para que el tiempo de recolección no se acumule como deriva; si un
+ * tick se atrasó más de un intervalo, el siguiente se programa desde ahora en vez de encadenar
+ * ticks atrasados.
+ *
+ * @param next Plazo del tick actual; se avanza al del siguiente.
+ * @param interval_us Intervalo hasta el próximo tick, en microsegundos.
+ */
+static void sleep_until_next_tick(struct timespec* next, long interval_us) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
 
-    printf("Configuración predeterminada cargada:\n");
-    printf("  Intervalo de muestreo: %d\n", config->sampling_interval);
-    printf("  CPU: %s\n", config->collect_cpu ? "Activado" : "Desactivado");
-    printf("  Memoria: %s\n", config->collect_memory ? "Activado" : "Desactivado");
-    printf("  Fragmentación de memoria: %s\n", config->collect_memory_fragmentation ? "Activado" : "Desactivado");
-    printf("  Disco: %s\n", config->collect_disk ? "Activado" : "Desactivado");
-    printf("  Red: %s\n", config->collect_net ? "Activado" : "Desactivado");
-    printf("  Cambios de contexto: %s\n", config->collect_context_switches ? "Activado" : "Desactivado");
-    printf("  Procesos en ejecución: %s\n", config->collect_running_processes ? "Activado" : "Desactivado");
-    printf("  Archivo de log: %s\n", config->log_file);
+    next->tv_sec += interval_us / 1000000L;
+    next->tv_nsec += (interval_us % 1000000L) * 1000L;
+    if (next->tv_nsec >= 1000000000L) {
+        next->tv_sec++;
+        next->tv_nsec -= 1000000000L;
+    }
+    if (timespec_ms(next) < timespec_ms(&now)) {
+        *next = now;
+        return;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, next, NULL) == EINTR) {
+    }
+}
+
+/**
+ * @brief Ejercita el allocator de la biblioteca memory fuera del camino de muestreo.
+ *
+ * simulate_memory_activity() reserva y libera bloques para medir la fragmentación del heap
+ * propio; se ejecuta solo a pedido con --heap-benchmark y nunca dentro del bucle de métricas.
+ *
+ * @param method Método de asignación (FIRST_FIT, BEST_FIT o WORST_FIT).
+ * @param iterations Cantidad de rondas de simulación.
+ * @return EXIT_SUCCESS, o EXIT_FAILURE si el método no usa la biblioteca memory.
+ */
+static int run_heap_benchmark(int method, int iterations) {
+    if (method == SEGREGATED_FIT) {
+        // simulate_memory_activity() usa el heap interno de la biblioteca memory
+        fprintf(stderr, "segregated_fit no usa simulate_memory_activity(); comparar con bench_alloc\n");
+        return EXIT_FAILURE;
+    }
+    allocator_select(method);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < iterations; i++) {
+        simulate_memory_activity();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double elapsed = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("Heap benchmark (método %d): %d iteraciones en %.3f s (%.1f us/iteración)\n", method, iterations,
+           elapsed, elapsed * 1e6 / iterations);
+    printf("Fragmentación del heap: %.2f%%\n", calculate_memory_fragmentation());
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Indica si dos configuraciones piden los mismos triggers PSI.
+ */
+static bool psi_triggers_equal(const config_t* a, const config_t* b) {
+    if (a->psi_trigger_count != b->psi_trigger_count) {
+        return false;
+    }
+    for (int i = 0; i < a->psi_trigger_count; i++) {
+        const psi_trigger_t* x = &a->psi_triggers[i];
+        const psi_trigger_t* y = &b->psi_triggers[i];
+        if (x->resource != y->resource || x->full != y->full || x->stall_us != y->stall_us ||
+            x->window_us != y->window_us) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Elige el backend de lecturas por lote; avisa si io_uring no está disponible.
+ */
+static void start_procfs_batch(procfs_batch_backend_t backend) {
+    procfs_batch_backend_t active = procfs_batch_init(backend);
+    if (active != backend) {
+        fprintf(stderr, "io_uring no disponible (%s); las lecturas por lote usan %s\n", strerror(errno),
+                procfs_batch_name(active));
+    }
+}
+
+/**
+ * @brief Relee config.json y aplica la configuración nueva entre dos ticks.
+ *
+ * La configuración se carga completa sobre una copia: si el archivo falta, no es válido o tiene
+ * alguna entrada rechazada (una regla de alerta, una métrica desconocida...) se descarta y sigue
+ * la anterior. Si es válida se aplica entera en el hilo del bucle, antes de
+ * recolectar, así el tick no se pierde y el servidor HTTP sigue respondiendo con los últimos
+ * valores. Los hilos de PSI y de micro-muestreo se reinician solo si cambió su configuración;
+ * los descriptores de los colectores y las lecturas previas de los contadores se descartan solo
+ * si cambió su fuente (raíces, disco o interfaz). replay_dir y realtime solo cambian al
+ * reiniciar; los hilos de PSI y de micro-muestreo reiniciados corren en SCHED_OTHER sobre las CPUs
+ * que tenía el proceso al arrancar, no en las del colector.
+ */
+static void reload_config(const char* path, config_t* config, scheduler_t* scheduler) {
+    config_t next = *config;
+    next.alerts = NULL;
+    next.cardinality = NULL;
+    int rejected = 0;
+    if (!load_config(path, &next, &rejected) || rejected > 0) {
+        // Aplicar solo una parte (por ejemplo, sin una regla de alerta) cambiaría en silencio lo que se vigila
+        fprintf(stderr, "Configuración de %s inválida; se mantiene la anterior\n", path);
+        alert_program_free(next.alerts);
+        cardinality_rules_free(next.cardinality);
+        return;
+    }
+
+    // El replay abre sus snapshots al arrancar
+    if (strcmp(next.replay_dir, config->replay_dir) != 0) {
+        fprintf(stderr, "replay_dir solo cambia al reiniciar; se mantiene %s\n",
+                config->replay_dir[0] != '\0' ? config->replay_dir : "(sin replay)");
+    }
+    memcpy(next.replay_dir, config->replay_dir, sizeof(next.replay_dir));
+    next.replay_speed = config->replay_speed;
+    next.replay_loop = config->replay_loop;
+
+    // Las CPUs, la prioridad y el bloqueo de memoria se aplicaron al arrancar
+    if (memcmp(&next.realtime, &config->realtime, sizeof(next.realtime)) != 0) {
+        fprintf(stderr, "La configuración realtime solo cambia al reiniciar; se mantiene la anterior\n");
+    }
+    next.realtime = config->realtime;
+
+    if (next.allocation_method != config->allocation_method) {
+        allocator_select(next.allocation_method);
+    }
+
+    // Los hilos de PSI y de micro-muestreo se detienen antes de cambiar las raíces (se reinician
+    // más abajo): así ninguno sigue leyendo el buffer anterior cuando se reutilice
+    bool roots_changed = strcmp(next.proc_root, config->proc_root) != 0 || strcmp(next.sys_root, config->sys_root) != 0;
+    if (roots_changed) {
+        psi_monitor_stop();
+        microsample_stop();
+        procfs_set_root(next.proc_root, next.sys_root);
+    }
+    if (next.procfs_batch != config->procfs_batch) {
+        start_procfs_batch(next.procfs_batch);
+    }
+
+    if (strcmp(next.log_file, config->log_file) != 0) {
+        log_reopen(next.log_file);
+    }
+
+    // Las reglas nuevas se aplican antes de crear las métricas de los colectores recién activados
+    install_cardinality(next.cardinality);
+    next.cardinality = NULL;
+
+    // Los colectores recién activados registran sus métricas antes de que otro hilo publique en ellas
+    collectors_prepare(&next);
+
+    if (roots_changed || next.collect_psi != config->collect_psi || !psi_triggers_equal(config, &next)) {
+        psi_monitor_stop();
+        if (next.collect_psi && !procfs_replay_active() &&
+            psi_monitor_start(next.psi_triggers, next.psi_trigger_count, handle_psi_event) != 0) {
+            fprintf(stderr, "Triggers PSI no disponibles; solo se muestrea /proc/pressure en cada tick\n");
+        }
+    }
+
+    if (roots_changed || next.micro_sampling_ms != config->micro_sampling_ms) {
+        microsample_stop();
+        if (next.micro_sampling_ms > 0 && !procfs_replay_active() && microsample_start(next.micro_sampling_ms) != 0) {
+            fprintf(stderr, "Micro-muestreo no disponible\n");
+        }
+    }
+
+    // Cambiar solo los parámetros conserva la ráfaga en curso y las líneas de base
+    if (next.adaptive.enabled != config->adaptive.enabled) {
+        scheduler_init(scheduler, &next.adaptive);
+    } else {
+        scheduler->config = next.adaptive;
+    }
+    if (next.sampling_interval != config->sampling_interval) {
+        save_sampling_interval(next.sampling_interval);
+    }
+
+    // Las reglas que no cambiaron conservan su estado
+    alerts_install(next.alerts);
+    next.alerts = NULL;
+
+    reset_collectors(roots_changed, strcmp(next.disk_device, config->disk_device) != 0,
+                     strcmp(next.net_interface, config->net_interface) != 0);
+    set_rate_gauges(next.rate_gauges);
+    *config = next;
+    char summary[1024];
+    config_summary(config, summary, sizeof(summary));
+    printf("Configuración recargada desde %s: %s\n", path, summary);
 }
 
 /**
  * @brief Función principal del sistema.
+ *
+ * Uso: metricShell [config.json]
+ *      metricShell --heap-benchmark [iteraciones] [config.json]
  */
 int main(int argc, char* argv[]) {
     config_t config;
+    struct timespec started;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+
+    // Modo benchmark del heap: opcional y separado del muestreo
+    bool heap_benchmark = false;
+    int heap_iterations = 100;
+    if (argc > 1 && strcmp(argv[1], "--heap-benchmark") == 0) {
+        heap_benchmark = true;
+        argv++;
+        argc--;
+        if (argc > 1 && atoi(argv[1]) > 0) {
+            heap_iterations = atoi(argv[1]);
+            argv++;
+            argc--;
+        }
+    }
+
+    // Arena del tick: cJSON y los colectores reservan ahí su memoria temporal
+    if (tick_arena_init(0) != 0) {
+        return EXIT_FAILURE;
+    }
 
     // Determinar la ruta de config.json
     const char* config_path = (argc > 1) ? argv[1] : "config/config.json";
-    printf("Intentando abrir %s\n", config_path);
 
     // Intentar cargar config.json; si falla, usar configuración predeterminada
-    if (!load_config(config_path, &config)) {
+    if (!load_config(config_path, &config, NULL)) {
         fprintf(stderr, "Error al cargar configuración. Usando valores predeterminados.\n");
         init_default_config(&config);
     }
+    {
+        // Una sola línea de arranque: cada printf por opción sumaba latencia hasta la primera muestra
+        char summary[1024];
+        config_summary(&config, summary, sizeof(summary));
+        printf("Configuración de %s: %s\n", config_path, summary);
+    }
+
+    if (heap_benchmark) {
+        return run_heap_benchmark(config.allocation_method, heap_iterations);
+    }
 
     // Configurar el método de asignación de memoria
-    malloc_control(config.allocation_method);
+    allocator_select(config.allocation_method);
+
+    // Memoria bloqueada antes de crear hilos, así sus pilas también quedan residentes
+    realtime_prepare_process(&config.realtime);
 
+    // Logger asíncrono: los colectores registran errores sin formatear ni escribir en el tick
+    log_start(config.log_file);
+
+    // Fuentes de datos: raíz de /proc y /sys o replay de snapshots grabados
+    procfs_set_root(config.proc_root, config.sys_root);
+    if (config.replay_dir[0] != '\0' &&
+        procfs_replay_open(config.replay_dir, config.replay_speed, config.replay_loop) != 0)
+    {
+        fprintf(stderr, "Error al abrir el replay %s\n", config.replay_dir);
+        return EXIT_FAILURE;
+    }
+    if (config.procfs_batch != PROCFS_BATCH_OFF) {
+        start_procfs_batch(config.procfs_batch);
+    }
+
+    // Solo se registran las métricas de los colectores activos; el disco se resuelve una vez
     init_metrics();
+    set_rate_gauges(config.rate_gauges);
+    install_cardinality(config.cardinality);
+    config.cardinality = NULL;
+    collectors_prepare(&config);
+
+    // Reglas de alerta: el motor toma el programa compilado
+    alerts_install(config.alerts);
+    config.alerts = NULL;
 
-    // Inicializar logger si es necesario
-    if (config.log_file[0] != '\0') {
-        initialize_logger(config.log_file);
+    // Los triggers PSI avisan de un stall sin esperar al próximo tick (no aplica en replay)
+    if (config.collect_psi && !procfs_replay_active()) {
+        if (psi_monitor_start(config.psi_triggers, config.psi_trigger_count, handle_psi_event) != 0) {
+            fprintf(stderr, "Triggers PSI no disponibles; solo se muestrea /proc/pressure en cada tick\n");
+        }
+    }
+
+    // Micro-muestreo de /proc/stat en su propio hilo (no aplica en replay)
+    if (config.micro_sampling_ms > 0 && !procfs_replay_active()) {
+        if (microsample_start(config.micro_sampling_ms) != 0) {
+            fprintf(stderr, "Micro-muestreo no disponible\n");
+        }
     }
 
     // Crear hilo para el servidor HTTP si es necesario
     pthread_t tid;
-    if (pthread_create(&tid, NULL, expose_metrics, NULL) != 0) {
+    if (pthread_create(&tid, NULL, expose_metrics, &config.realtime.http_cpus) != 0) {
         fprintf(stderr, "Error al crear el hilo del servidor HTTP\n");
         return EXIT_FAILURE;
     }
@@ -96,48 +372,87 @@ int main(int argc, char* argv[]) {
     // Enviar el valor de sampling interval por pipe a la shell
     save_sampling_interval(config.sampling_interval);
 
+    // Muestreo adaptativo: el planificador decide el intervalo de cada tick
+    scheduler_t scheduler;
+    scheduler_init(&scheduler, &config.adaptive);
+    struct timespec next_tick;
+    clock_gettime(CLOCK_MONOTONIC, &next_tick);
+
+    // Recarga en caliente: cambios de config.json (inotify) o SIGHUP
+    config_watch_start(config_path);
+
+    // El colector toma sus CPUs y su prioridad después de crear los demás hilos, que no las heredan
+    realtime_enter_collector(&config.realtime);
+
     // Bucle principal para actualizar las métricas
+    bool first_tick = true;
     while (true) {
-        // Simular actividad de memoria si la fragmentación de memoria está activada
-        if (config.collect_memory_fragmentation) {
-            simulate_memory_activity();
-            update_memory_fragmentation_gauge();
+        // Una recarga pendiente se aplica antes de recolectar, sin perder el tick
+        if (config_watch_pending()) {
+            reload_config(config_path, &config, &scheduler);
         }
 
-        if (config.collect_cpu) {
-            update_cpu_gauge();
-        }
+        // Colectores activos, en el orden de collector_list.h
+        collectors_collect(&config);
 
-        if (config.collect_memory) {
-            update_memory_gauge();
+        int interval_ms = config.sampling_interval * 1000;
+        if (config.adaptive.enabled) {
+            metrics_sample_t sample;
+            get_last_sample(&sample);
+            scheduler_signals_t signals = {
+                .cpu_usage = config.collect_cpu ? sample.cpu_usage : -1.0,
+                .context_switches = config.collect_context_switches ? sample.context_switches : -1,
+                .running_processes = config.collect_running_processes ? sample.running_processes : -1,
+            };
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            interval_ms = scheduler_update(&scheduler, &signals, timespec_ms(&now));
+            update_sampling_gauge(&scheduler);
         }
 
-        if (config.collect_disk) {
-            const char *disk = detect_disk();
-            char disk_path[256];
-            snprintf(disk_path, sizeof(disk_path), "/dev/%s", disk);
-            update_disk_stats_gauge(disk_path);
+        // Reglas de alerta sobre la muestra recién recolectada
+        {
+            // Mismo reloj que las lecturas: en replay acelerado rate() y "for" siguen el tiempo grabado
+            metrics_sample_t sample;
+            get_last_sample(&sample);
+            alerts_evaluate(&sample, sample_now_ms());
         }
 
-        if (config.collect_net) {
-            update_net_stats_gauge("wlp1s0");
-        }
+        // Enviar las métricas a través del FIFO
+        send_metrics(&config);
 
-        if (config.collect_context_switches) {
-            update_context_switches_gauge();
+        // Costo de arranque hasta la primera muestra completa (el servidor HTTP ya atiende)
+        if (first_tick) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            log_info("Primera muestra publicada %lld ms después del arranque",
+                     (long long)(timespec_ms(&now) - timespec_ms(&started)));
+            first_tick = false;
         }
 
-        if (config.collect_running_processes) {
-            update_running_processes_gauge();
-        }
+        // Fin del tick: se descarta la memoria temporal (cJSON y scratch de los colectores)
+        tick_arena_reset();
 
-        // Enviar las métricas a través del FIFO
-        send_metrics(&config);
+        // En replay se avanza al siguiente snapshot respetando el tiempo grabado (acelerado)
+        if (procfs_replay_active()) {
+            long wait_us = procfs_replay_advance();
+            if (wait_us < 0) {
+                printf("Replay finalizado\n");
+                break;
+            }
+            sleep_until_next_tick(&next_tick, wait_us);
+            continue;
+        }
 
         // Dormir según el intervalo de muestreo
-        sleep(config.sampling_interval);
+        sleep_until_next_tick(&next_tick, interval_ms * 1000L);
     }
 
-    finalize_logger();
+    config_watch_stop();
+    microsample_stop();
+    psi_monitor_stop();
+    procfs_batch_init(PROCFS_BATCH_OFF);
+    procfs_replay_close();
+    log_stop();
     return EXIT_SUCCESS;
 }
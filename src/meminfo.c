@@ -0,0 +1,128 @@
+#include "meminfo.h"
+#include "log.h"
+#include "meminfo_keys.h"
+#include "parse.h"
+#include "procfs.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+_Static_assert(MEMINFO_FIELD_COUNT <= MEMINFO_MAX_FIELDS, "MEMINFO_MAX_FIELDS es menor que la tabla generada");
+_Static_assert(VMSTAT_FIELD_COUNT <= VMSTAT_MAX_FIELDS, "VMSTAT_MAX_FIELDS es menor que la tabla generada");
+
+/**
+ * @brief Buffer de lectura por hilo, reutilizado entre llamados.
+ */
+static __thread procfs_buf_t read_buf;
+
+// FNV-1a de 64 bits: debe coincidir con tools/gen_meminfo_keys.py
+#define FNV_OFFSET 0xCBF29CE484222325ULL
+#define FNV_PRIME 0x100000001B3ULL
+
+int meminfo_field_count(void)
+{
+    return MEMINFO_FIELD_COUNT;
+}
+
+const char* meminfo_field_name(int field)
+{
+    return meminfo_field_names[field];
+}
+
+bool meminfo_field_in_kb(int field)
+{
+    return meminfo_field_is_kb[field] != 0;
+}
+
+int vmstat_field_count(void)
+{
+    return VMSTAT_FIELD_COUNT;
+}
+
+const char* vmstat_field_name(int field)
+{
+    return vmstat_field_names[field];
+}
+
+/**
+ * @brief Hashea la clave hasta el separador y devuelve su posición.
+ *
+ * El hash se calcula en la misma pasada que busca el fin de la clave.
+ */
+static const char* hash_key(const char* p, const char* end, char sep, uint64_t* hash)
+{
+    uint64_t h = FNV_OFFSET;
+    while (p < end && *p != sep && *p != '\n')
+    {
+        h = (h ^ (unsigned char)*p) * FNV_PRIME;
+        p++;
+    }
+    *hash = h;
+    return p;
+}
+
+int read_meminfo(const char* path, meminfo_t* info)
+{
+    if (procfs_read(path, &read_buf) != 0)
+    {
+        log_error("Error al abrir %s: %m", path);
+        return -1;
+    }
+
+    memset(info->present, 0, sizeof(info->present));
+
+    const char* end = read_buf.data + read_buf.len;
+    const char* p = read_buf.data;
+    while (p < end)
+    {
+        // Formato: "Clave:   valor kB"
+        uint64_t h;
+        p = hash_key(p, end, ':', &h);
+        unsigned slot = (unsigned)((h * MEMINFO_HASH_SEED) >> (64 - MEMINFO_HASH_BITS));
+        int field = meminfo_slot_field[slot];
+        if (p < end && *p == ':' && field >= 0 && meminfo_slot_hash[slot] == h)
+        {
+            p = parse_skip_spaces(p + 1, end);
+            info->values[field] = parse_u64(&p, end);
+            info->present[field] = true;
+        }
+        p = parse_next_line(p, end);
+    }
+
+    if (!info->present[0]) // MemTotal es el primer campo de la tabla
+    {
+        log_error("No se encontró MemTotal en %s", path);
+        return -1;
+    }
+    return 0;
+}
+
+int read_vmstat(const char* path, vmstat_t* stats)
+{
+    if (procfs_read(path, &read_buf) != 0)
+    {
+        log_error("Error al abrir %s: %m", path);
+        return -1;
+    }
+
+    memset(stats->present, 0, sizeof(stats->present));
+
+    const char* end = read_buf.data + read_buf.len;
+    const char* p = read_buf.data;
+    while (p < end)
+    {
+        // Formato: "clave valor"; la mayoría de las claves no interesan y se descartan por slot
+        uint64_t h;
+        p = hash_key(p, end, ' ', &h);
+        unsigned slot = (unsigned)((h * VMSTAT_HASH_SEED) >> (64 - VMSTAT_HASH_BITS));
+        int field = vmstat_slot_field[slot];
+        if (p < end && *p == ' ' && field >= 0 && vmstat_slot_hash[slot] == h)
+        {
+            p++;
+            stats->values[field] = parse_u64(&p, end);
+            stats->present[field] = true;
+        }
+        p = parse_next_line(p, end);
+    }
+    return 0;
+}
@@ -0,0 +1,270 @@
+/**
+ * @file meminfo_keys.h
+ * @brief Tablas de hash perfecto para las claves de /proc/meminfo y /proc/vmstat.
+ *
+ * ARCHIVO GENERADO por tools/gen_meminfo_keys.py; no editar a mano.
+ */
+
+#ifndef MEMINFO_KEYS_H
+#define MEMINFO_KEYS_H
+
+#include <stdint.h>
+
+/** Cantidad de campos de /proc/meminfo con slot fijo. */
+#define MEMINFO_FIELD_COUNT 65
+/** Cantidad de contadores de /proc/vmstat con slot fijo. */
+#define VMSTAT_FIELD_COUNT 20
+
+/** Nombre de cada campo de /proc/meminfo. */
+static const char* const meminfo_field_names[MEMINFO_FIELD_COUNT] = {
+    "MemTotal",
+    "MemFree",
+    "MemAvailable",
+    "Buffers",
+    "Cached",
+    "SwapCached",
+    "Active",
+    "Inactive",
+    "Active(anon)",
+    "Inactive(anon)",
+    "Active(file)",
+    "Inactive(file)",
+    "Unevictable",
+    "Mlocked",
+    "HighTotal",
+    "HighFree",
+    "LowTotal",
+    "LowFree",
+    "MmapCopy",
+    "SwapTotal",
+    "SwapFree",
+    "Zswap",
+    "Zswapped",
+    "Dirty",
+    "Writeback",
+    "AnonPages",
+    "Mapped",
+    "Shmem",
+    "KReclaimable",
+    "Slab",
+    "SReclaimable",
+    "SUnreclaim",
+    "KernelStack",
+    "ShadowCallStack",
+    "PageTables",
+    "SecPageTables",
+    "NFS_Unstable",
+    "Bounce",
+    "WritebackTmp",
+    "CommitLimit",
+    "Committed_AS",
+    "VmallocTotal",
+    "VmallocUsed",
+    "VmallocChunk",
+    "Percpu",
+    "HardwareCorrupted",
+    "AnonHugePages",
+    "ShmemHugePages",
+    "ShmemPmdMapped",
+    "FileHugePages",
+    "FilePmdMapped",
+    "CmaTotal",
+    "CmaFree",
+    "Unaccepted",
+    "Balloon",
+    "HugePages_Total",
+    "HugePages_Free",
+    "HugePages_Rsvd",
+    "HugePages_Surp",
+    "Hugepagesize",
+    "Hugetlb",
+    "DirectMap4k",
+    "DirectMap2M",
+    "DirectMap4M",
+    "DirectMap1G",
+};
+
+/** true si el campo está en kB (se exporta en bytes); false si es una cantidad. */
+static const unsigned char meminfo_field_is_kb[MEMINFO_FIELD_COUNT] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+    1,
+};
+
+/** Nombre de cada contador de /proc/vmstat. */
+static const char* const vmstat_field_names[VMSTAT_FIELD_COUNT] = {
+    "pgpgin",
+    "pgpgout",
+    "pswpin",
+    "pswpout",
+    "pgfault",
+    "pgmajfault",
+    "pgscan_kswapd",
+    "pgscan_direct",
+    "pgsteal_kswapd",
+    "pgsteal_direct",
+    "allocstall_normal",
+    "allocstall_movable",
+    "compact_stall",
+    "compact_fail",
+    "compact_success",
+    "thp_fault_alloc",
+    "thp_fault_fallback",
+    "oom_kill",
+    "workingset_refault_anon",
+    "workingset_refault_file",
+};
+
+#define MEMINFO_HASH_BITS 8
+#define MEMINFO_HASH_SEED 0x389FD7E5F2A1D559ULL
+
+/** Hash FNV-1a completo de la clave alojada en cada slot (0 si está vacío). */
+static const uint64_t meminfo_slot_hash[1 << MEMINFO_HASH_BITS] = {
+    0x71377F681BEDC4FBULL, 0x0000000000000000ULL, 0x2F1036AFCB28EA40ULL,
+    0x0000000000000000ULL, 0xB90ABDA0157A9195ULL, 0x4DC3398B46AAE9C8ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x681B379D5E68DC0FULL, 0x1EAD8B9E7D9FCFE3ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0xB73EFA1F03BCD84EULL,
+    0x0000000000000000ULL, 0x9EE6429342C5510BULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x2EC6DD5974E0E37BULL, 0x0000000000000000ULL,
+    0x92E76B4E833257CCULL, 0x0000000000000000ULL, 0x381D143DC9E8819BULL,
+    0x3B6ED5608938CC7DULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0xC0987AD6FA7B16F3ULL,
+    0x9EDC2E9342BCDA8AULL, 0xFF4CF4F8B1B71F1CULL, 0x0000000000000000ULL,
+    0x0C1B0AF741602F41ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x56EAD6E292E2458CULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0E5BB09C2D5689C2ULL,
+    0x0000000000000000ULL, 0x7F9AB237889EBAE9ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x91B31124F59C1B89ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x34C5CA3617DE1DBAULL, 0x0000000000000000ULL,
+    0xE273E1D04B13F271ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0BD976A74CE2DC81ULL, 0x0000000000000000ULL, 0xF73A5C00345B75DBULL,
+    0x16277F9E63869678ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0xC4F181AF711B9BCBULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x9EE6689342C5919DULL, 0x4409ADA9C5C2A7F8ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0xBEEDF44A28EDB164ULL, 0x0000000000000000ULL,
+    0xEC04F31EE034BAD8ULL, 0x42D1C421DEBDF7F9ULL, 0x0000000000000000ULL,
+    0x8D15774621A3C795ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0xE6CECF7536EB232BULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x9C2663BE14488B14ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x5F8DB759B552C20EULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x5C7E2787929BACB8ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x2F9D400EFA6F63D3ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0xA45A194B58837E4FULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0xB37D9D389FAA8BDDULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x6725242CCB3B3190ULL, 0x0000000000000000ULL,
+    0x6A90969FDF9537F4ULL, 0x0000000000000000ULL, 0xC8EA8748A1F0B8F7ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x6BC8854BD562B2F2ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0xD4320A730B734D88ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0EA661FE33438F1FULL,
+    0x9FAFAFB85AA3FA25ULL, 0x0000000000000000ULL, 0x7373834B4810E516ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x7D30A9BCFE5AB1B8ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x6049991AEDA77066ULL, 0x0000000000000000ULL,
+    0x63F1D55DC92A6A4BULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x9ED1849342B36527ULL, 0xF31FF895D5497425ULL, 0xDCA1C26D8538CBE1ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x11A5DE53EBD39C83ULL, 0x623AC1DD6DAAD043ULL,
+    0x45459B81E9EC085EULL, 0x39825A4640284397ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x44BA54CB0E961086ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0xA3AD7F8B045E1040ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0xD286A53D96275BDCULL, 0x0000000000000000ULL,
+    0x2A2BE72289F7F0D0ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x64F13978C8852082ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0xA4F06057042EA91FULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x9D3D8006EBF996E3ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0xEF60E7D5BE54C40EULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL,
+};
+
+/** Campo alojado en cada slot, o -1. */
+static const signed char meminfo_slot_field[1 << MEMINFO_HASH_BITS] = {
+    12, -1, 19, -1, 2, 46, -1, -1, -1, -1, -1, -1, -1, 17, 22, -1,
+    -1, -1, -1, -1, 44, -1, 61, -1, -1, -1, -1, -1, 53, -1, 20, -1,
+    34, 37, -1, -1, -1, -1, 4, 64, 1, -1, 41, -1, -1, -1, 49, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, 57, -1, 56, -1, -1, -1, 29, -1,
+    -1, -1, -1, 52, -1, 16, -1, -1, -1, -1, -1, -1, -1, -1, 30, -1,
+    23, 60, -1, -1, -1, -1, -1, -1, -1, 27, -1, -1, -1, 63, 7, -1,
+    -1, -1, -1, -1, 38, -1, 59, 28, -1, 25, -1, -1, -1, -1, -1, -1,
+    -1, 50, -1, -1, -1, -1, -1, 47, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, 40, -1, -1, -1, 5, -1, -1,
+    15, -1, -1, -1, 6, -1, -1, 11, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, 0, -1, 42, -1, 24, -1, -1, 26, -1, -1,
+    -1, -1, -1, -1, -1, -1, 31, -1, -1, 33, 14, -1, 21, -1, -1, 3,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 51, -1, 36, -1, -1, 62,
+    58, 9, -1, -1, -1, -1, 18, 48, 10, 45, -1, -1, 43, -1, -1, -1,
+    -1, -1, 35, -1, -1, -1, -1, -1, 54, -1, 32, -1, -1, 8, -1, -1,
+    39, -1, -1, -1, -1, -1, -1, -1, 55, -1, -1, -1, 13, -1, -1, -1,
+};
+
+#define VMSTAT_HASH_BITS 6
+#define VMSTAT_HASH_SEED 0x1634106F49E1859FULL
+
+/** Hash FNV-1a completo de la clave alojada en cada slot (0 si está vacío). */
+static const uint64_t vmstat_slot_hash[1 << VMSTAT_HASH_BITS] = {
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0xE47D9CBE620334EDULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0xFA20325736205357ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x948E1F316C657A06ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x84E8535CBDC9FC99ULL, 0xDDB3E724AB70787DULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x89D4733A4DFE7976ULL,
+    0x2AE6B86231EF7A3FULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x017EF253104412B8ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0xAC6AB21BC2E6C753ULL, 0x0000000000000000ULL, 0x687CE00A0AF21446ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x6C669F108F11FFA7ULL,
+    0xC65E4F36F2F4804BULL, 0x0000000000000000ULL, 0x8EE5E05153CA63FEULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x29DBD809A63767F7ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x4769329F1F22AEACULL, 0x0000000000000000ULL, 0x39F787794CAF6A94ULL,
+    0x14375ECD2728E2B0ULL, 0x5E531216594B6D82ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+    0x0000000000000000ULL, 0x5C783948B4FC953FULL, 0x7E32153D8ABE0AD3ULL,
+    0x0000000000000000ULL,
+};
+
+/** Campo alojado en cada slot, o -1. */
+static const signed char vmstat_slot_field[1 << VMSTAT_HASH_BITS] = {
+    -1, -1, 9, -1, -1, 19, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    14, -1, -1, -1, -1, 11, 3, -1, -1, -1, 8, 12, -1, -1, 2, -1,
+    -1, 18, -1, 0, -1, -1, 1, 7, -1, 15, -1, -1, -1, -1, 13, -1,
+    -1, -1, -1, 4, -1, 5, 6, 10, -1, -1, -1, -1, -1, 17, 16, -1,
+};
+
+#endif // MEMINFO_KEYS_H
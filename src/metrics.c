@@ -1,7 +1,11 @@
 #include "metrics.h"
+#include "log.h"
+#include "parse.h"
+#include "procfs.h"
 #include <ctype.h>
-#include <fcntl.h> // Para open
+#include <errno.h>
 #include <pthread.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -10,76 +14,63 @@
 // obtenemos los datos de la red de forma parecida a como obtubimos los datos de memoria.
 extern pthread_mutex_t lock; // Asegúrate de que el mutex sea accesible
 
-#define BUFFER_SIZE 256
+/**
+ * @brief Buffer de lectura por hilo: se reutiliza entre llamados y no se comparte entre hilos.
+ */
+static __thread procfs_buf_t read_buf;
 
 net_stats_t get_net_stats(const char* iface)
 {
-    FILE* fp;
-    char buffer[BUFFER_SIZE];
+    char path[PROCFS_PATH_MAX];
+    return read_net_stats(procfs_path("net/dev", path, sizeof(path)), iface);
+}
+
+net_stats_t read_net_stats(const char* path, const char* iface)
+{
     net_stats_t stats = {0};
     stats.rx_bytes = -1;
     stats.tx_bytes = -1;
 
-    // Abrir /proc/net/dev
-    fp = fopen("/proc/net/dev", "r");
-    if (fp == NULL)
+    if (procfs_read(path, &read_buf) != 0)
     {
-        perror("Error al abrir /proc/net/dev");
+        log_error("Error al abrir %s: %m", path);
         return stats; // Error
     }
 
+    const char* end = read_buf.data + read_buf.len;
+    size_t iface_len = strlen(iface);
+
     // Saltar las dos primeras líneas (encabezado)
-    fgets(buffer, sizeof(buffer), fp);
-    fgets(buffer, sizeof(buffer), fp);
+    const char* line = parse_next_line(parse_next_line(read_buf.data, end), end);
 
-    // Leer cada línea del archivo
-    while (fgets(buffer, sizeof(buffer), fp) != NULL)
+    for (; line < end; line = parse_next_line(line, end))
     {
-        char* ptr = buffer;
-        char* token;
-        char* saveptr;
-
-        // Obtener el nombre de la interfaz
-        token = strtok_r(ptr, " \t\n", &saveptr);
-        if (token == NULL)
+        // El nombre va alineado a la derecha y termina en ':'
+        const char* name = parse_skip_spaces(line, end);
+        const char* line_end = parse_line_end(name, end);
+        const char* colon = memchr(name, ':', (size_t)(line_end - name));
+        if (colon == NULL || (size_t)(colon - name) != iface_len || memcmp(name, iface, iface_len) != 0)
+        {
             continue;
+        }
 
-        // Quitar ':' del nombre de la interfaz
-        char* colon = strchr(token, ':');
-        if (colon)
-            *colon = '\0';
-
-        // Quitar espacios en blanco iniciales
-        while (isspace(*token))
-            token++;
-
-        if (strcmp(token, iface) == 0)
+        uint64_t values[16];
+        if (parse_u64_fields(colon + 1, line_end, values, 16) == 16)
+        {
+            stats.rx_bytes = (long long)values[0];
+            stats.tx_bytes = (long long)values[8];
+            snprintf(stats.iface, sizeof(stats.iface), "%s", iface);
+        }
+        else
         {
-            unsigned long long values[16];
-            int i = 0;
-            while (i < 16 && (token = strtok_r(NULL, " \t\n", &saveptr)) != NULL)
-            {
-                values[i++] = strtoull(token, NULL, 10);
-            }
-            if (i >= 16)
-            {
-                stats.rx_bytes = values[0];
-                stats.tx_bytes = values[8];
-                snprintf(stats.iface, sizeof(stats.iface), "%s", iface);
-            }
-            else
-            {
-                fprintf(stderr, "Error al leer los campos para la interfaz %s\n", iface);
-            }
-            break;
+            log_error("Error al leer los campos para la interfaz %s", iface);
         }
+        break;
     }
 
-    fclose(fp);
-
     if (stats.rx_bytes == -1 && stats.tx_bytes == -1)
     {
-        fprintf(stderr, "No se encontraron datos para la interfaz %s\n", iface);
+        log_error("No se encontraron datos para la interfaz %s", iface);
     }
 
     return stats;
@@ -87,20 +78,22 @@ net_stats_t get_net_stats(const char* iface)
 
 disk_stats_t get_disk_stats(const char* device)
 {
-    FILE* fp = fopen("/proc/diskstats", "r");
-    if (fp == NULL)
-    {
-        perror("Error al abrir /proc/diskstats");
-        disk_stats_t error_stats = {0};
-        strncpy(error_stats.device, device, sizeof(error_stats.device) - 1);
-        error_stats.reads_completed = (unsigned long)-1;
-        error_stats.writes_completed = (unsigned long)-1;
-        return error_stats;
-    }
+    char path[PROCFS_PATH_MAX];
+    return read_disk_stats(procfs_path("diskstats", path, sizeof(path)), device);
+}
 
-    char buffer[BUFFER_SIZE];
+disk_stats_t read_disk_stats(const char* path, const char* device)
+{
     disk_stats_t stats = {0};
     strncpy(stats.device, device, sizeof(stats.device) - 1);
+    stats.reads_completed = (unsigned long)-1;
+    stats.writes_completed = (unsigned long)-1;
+
+    if (procfs_read(path, &read_buf) != 0)
+    {
+        log_error("Error al abrir %s: %m", path);
+        return stats;
+    }
 
     // Remover "/dev/" si está presente
     const char* device_name = device;
@@ -108,59 +101,65 @@ disk_stats_t get_disk_stats(const char* device)
     {
         device_name = device + 5; // Saltar el prefijo "/dev/"
     }
+    size_t name_len = strlen(device_name);
 
-    while (fgets(buffer, sizeof(buffer), fp) != NULL)
+    const char* end = read_buf.data + read_buf.len;
+    for (const char* line = read_buf.data; line < end; line = parse_next_line(line, end))
     {
-        unsigned int major_num, minor_num;
-        char dev_name[32];
-        unsigned long reads_completed, writes_completed;
-
-        int items = sscanf(buffer, "%u %u %31s %lu %*s %*s %*s %lu", &major_num, &minor_num, dev_name, &reads_completed,
-                           &writes_completed);
+        // Formato: major minor nombre lecturas ... escrituras ...
+        const char* line_end = parse_line_end(line, end);
+        const char* p = parse_skip_token(parse_skip_spaces(line, line_end), line_end); // major
+        p = parse_skip_token(parse_skip_spaces(p, line_end), line_end);                  // minor
+        const char* name = parse_skip_spaces(p, line_end);
+        p = parse_skip_token(name, line_end);
+        if ((size_t)(p - name) != name_len || memcmp(name, device_name, name_len) != 0)
+        {
+            continue;
+        }
 
-        if (items >= 5 && strcmp(dev_name, device_name) == 0)
+        uint64_t values[5];
+        if (parse_u64_fields(p, line_end, values, 5) == 5)
         {
-            stats.reads_completed = reads_completed;
-            stats.writes_completed = writes_completed;
-            fclose(fp);
+            stats.reads_completed = (unsigned long)values[0];
+            stats.writes_completed = (unsigned long)values[4];
             return stats;
         }
     }
 
-    fclose(fp);
     // Si no se encontró el dispositivo
-    fprintf(stderr, "No se encontraron datos para el dispositivo %s\n", device);
-    stats.reads_completed = (unsigned long)-1;
-    stats.writes_completed = (unsigned long)-1;
+    log_error("No se encontraron datos para el dispositivo %s", device);
     return stats;
 }
 
 int get_running_processes()
 {
-    FILE* fp = fopen("/proc/stat", "r");
-    if (fp == NULL)
+    char path[PROCFS_PATH_MAX];
+    return read_running_processes(procfs_path("stat", path, sizeof(path)));
+}
+
+int read_running_processes(const char* path)
+{
+    if (procfs_read(path, &read_buf) != 0)
     {
-        perror("Error al abrir /proc/stat");
+        log_error("Error al abrir %s: %m", path);
         return -1;
     }
 
-    char buffer[256];
     int running_procs = -1;
-
-    while (fgets(buffer, sizeof(buffer), fp) != NULL)
+    const char* end = read_buf.data + read_buf.len;
+    const char* p = parse_find_line(read_buf.data, end, "procs_running", 13);
+    if (p != NULL)
     {
-        if (strncmp(buffer, "procs_running", 13) == 0)
+        p = parse_skip_spaces(p, end);
+        if (p < end && parse_is_digit(*p))
         {
-            sscanf(buffer, "procs_running %d", &running_procs);
-            break;
+            running_procs = (int)parse_u64(&p, end);
         }
     }
 
-    fclose(fp);
-
     if (running_procs == -1)
     {
-        fprintf(stderr, "No se pudo encontrar 'procs_running' en /proc/stat\n");
+        log_error("No se pudo encontrar 'procs_running' en %s", path);
     }
 
     return running_procs;
@@ -168,34 +167,37 @@ int get_running_processes()
 
 long long get_context_switches()
 {
-    FILE* fp = fopen("/proc/stat", "r");
-    if (fp == NULL)
+    char path[PROCFS_PATH_MAX];
+    return read_context_switches(procfs_path("stat", path, sizeof(path)));
+}
+
+long long read_context_switches(const char* path)
+{
+    if (procfs_read(path, &read_buf) != 0)
     {
-        perror("Error al abrir /proc/stat");
+        log_error("Error al abrir %s: %m", path);
         return -1;
     }
 
-    char buffer[256];
     long long ctxt = -1;
-
-    while (fgets(buffer, sizeof(buffer), fp) != NULL)
+    const char* end = read_buf.data + read_buf.len;
+    const char* p = parse_find_line(read_buf.data, end, "ctxt", 4);
+    if (p != NULL)
     {
-        if (strncmp(buffer, "ctxt", 4) == 0)
+        p = parse_skip_spaces(p, end);
+        if (p < end && parse_is_digit(*p))
         {
-            if (sscanf(buffer, "ctxt %lld", &ctxt) != 1)
-            {
-                fprintf(stderr, "Error al analizar 'ctxt' en /proc/stat\n");
-                ctxt = -1;
-            }
-            break;
+            ctxt = (long long)parse_u64(&p, end);
+        }
+        else
+        {
+            log_error("Error al analizar 'ctxt' en %s", path);
         }
     }
 
-    fclose(fp);
-
     if (ctxt == -1)
     {
-        fprintf(stderr, "No se pudo encontrar 'ctxt' en /proc/stat\n");
+        log_error("No se pudo encontrar 'ctxt' en %s", path);
     }
 
     return ctxt;
@@ -203,37 +205,42 @@ long long get_context_switches()
 // Estructura para almacenar los datos de memoria
 memory_info_t get_memory_usage()
 {
-    FILE* fp;
-    char buffer[BUFFER_SIZE];
+    char path[PROCFS_PATH_MAX];
+    return read_memory_usage(procfs_path("meminfo", path, sizeof(path)));
+}
+
+memory_info_t read_memory_usage(const char* path)
+{
     unsigned long long total_mem = 0, free_mem = 0;
 
-    // Abrir el archivo /proc/meminfo
-    fp = fopen("/proc/meminfo", "r");
-    if (fp == NULL)
+    // Leer el archivo de memoria (normalmente /proc/meminfo)
+    if (procfs_read(path, &read_buf) != 0)
     {
-        perror("Error al abrir /proc/meminfo");
+        log_error("Error al abrir %s: %m", path);
         return (memory_info_t){-1.0, -1.0, -1.0}; // Devolver error
     }
 
-    // Leer los valores de memoria total y disponible
-    while (fgets(buffer, sizeof(buffer), fp) != NULL)
+    // Leer los valores de memoria total y disponible; MemAvailable aparece después de MemTotal
+    const char* end = read_buf.data + read_buf.len;
+    for (const char* line = read_buf.data; line < end; line = parse_next_line(line, end))
     {
-        if (sscanf(buffer, "MemTotal: %llu kB", &total_mem) == 1)
+        if (parse_starts_with(line, end, "MemTotal:", 9))
         {
-            continue; // MemTotal encontrado
+            const char* p = parse_skip_spaces(line + 9, end);
+            total_mem = parse_u64(&p, end);
         }
-        if (sscanf(buffer, "MemAvailable: %llu kB", &free_mem) == 1)
+        else if (parse_starts_with(line, end, "MemAvailable:", 13))
         {
+            const char* p = parse_skip_spaces(line + 13, end);
+            free_mem = parse_u64(&p, end);
             break; // MemAvailable encontrado
         }
     }
 
-    fclose(fp);
-
     // Verificar si se encontraron ambos valores
     if (total_mem == 0 || free_mem == 0)
     {
-        fprintf(stderr, "Error al leer la información de memoria desde /proc/meminfo\n");
+        log_error("Error al leer la información de memoria desde %s", path);
         return (memory_info_t){-1.0, -1.0, -1.0}; // Devolver error
     }
 
@@ -250,73 +257,77 @@ memory_info_t get_memory_usage()
     return memory_info;
 }
 
-double get_cpu_usage()
+int read_cpu_times(const char* path, cpu_times_t* times)
 {
-    FILE* fp;
-    char buffer[BUFFER_SIZE];
-    unsigned long long user1, nice1, system1, idle1, iowait1, irq1, softirq1, steal1;
-    unsigned long long user2, nice2, system2, idle2, iowait2, irq2, softirq2, steal2;
-
-    // Primera lectura
-    fp = fopen("/proc/stat", "r");
-    if (fp == NULL)
+    if (procfs_read(path, &read_buf) != 0)
     {
-        perror("Error al abrir /proc/stat");
-        return -1.0;
+        log_error("Error al abrir %s: %m", path);
+        return -1;
     }
-    if (fgets(buffer, sizeof(buffer), fp) == NULL)
+
+    const char* end = read_buf.data + read_buf.len;
+    if (!parse_starts_with(read_buf.data, end, "cpu ", 4))
     {
-        perror("Error al leer /proc/stat");
-        fclose(fp);
-        return -1.0;
+        log_error("Error al analizar %s", path);
+        return -1;
     }
-    fclose(fp);
 
-    if (sscanf(buffer, "cpu %llu %llu %llu %llu %llu %llu %llu %llu", &user1, &nice1, &system1, &idle1, &iowait1, &irq1,
-               &softirq1, &steal1) < 4)
+    // Los campos que el kernel no reporte quedan en cero
+    uint64_t values[8] = {0};
+    if (parse_u64_fields(read_buf.data + 4, parse_line_end(read_buf.data, end), values, 8) < 4)
     {
-        fprintf(stderr, "Error al analizar /proc/stat en la primera lectura\n");
-        return -1.0;
+        log_error("Error al analizar %s", path);
+        return -1;
     }
+    *times = (cpu_times_t){values[0], values[1], values[2], values[3],
+                           values[4], values[5], values[6], values[7]};
+    return 0;
+}
 
-    // Esperar un intervalo
-    usleep(100000); // 100 milisegundos
-
-    // Segunda lectura
-    fp = fopen("/proc/stat", "r");
-    if (fp == NULL)
+double get_cpu_usage()
+{
+    // Muestra del llamado anterior: el uso se calcula sobre todo el intervalo entre llamados
+    static cpu_times_t prev;
+    static bool have_prev = false;
+    char path[PROCFS_PATH_MAX];
+    cpu_times_t t1, t2;
+
+    procfs_path("stat", path, sizeof(path));
+    if (have_prev)
     {
-        perror("Error al abrir /proc/stat");
-        return -1.0;
+        t1 = prev;
     }
-    if (fgets(buffer, sizeof(buffer), fp) == NULL)
+    else
     {
-        perror("Error al leer /proc/stat");
-        fclose(fp);
-        return -1.0;
+        // Primera lectura: no hay muestra previa, se espera un intervalo corto
+        if (read_cpu_times(path, &t1) != 0)
+        {
+            return -1.0;
+        }
+        usleep(100000); // 100 milisegundos
     }
-    fclose(fp);
 
-    if (sscanf(buffer, "cpu %llu %llu %llu %llu %llu %llu %llu %llu", &user2, &nice2, &system2, &idle2, &iowait2, &irq2,
-               &softirq2, &steal2) < 4)
+    if (read_cpu_times(path, &t2) != 0)
     {
-        fprintf(stderr, "Error al analizar /proc/stat en la segunda lectura\n");
         return -1.0;
     }
+    prev = t2;
+    have_prev = true;
 
     // Calcular los totales
-    unsigned long long total1 = user1 + nice1 + system1 + idle1 + iowait1 + irq1 + softirq1 + steal1;
-    unsigned long long total2 = user2 + nice2 + system2 + idle2 + iowait2 + irq2 + softirq2 + steal2;
+    unsigned long long total1 = t1.user + t1.nice + t1.system + t1.idle + t1.iowait + t1.irq + t1.softirq + t1.steal;
+    unsigned long long total2 = t2.user + t2.nice + t2.system + t2.idle + t2.iowait + t2.irq + t2.softirq + t2.steal;
 
-    unsigned long long totald = total2 - total1;
-    unsigned long long idled = (idle2 + iowait2) - (idle1 + iowait1);
-
-    if (totald == 0)
+    if (total2 <= total1)
     {
-        fprintf(stderr, "Totald es cero, no se puede calcular el uso de CPU!\n");
+        // Sin avance (o contadores reiniciados, por ejemplo al repetir un replay)
+        log_error("Totald es cero, no se puede calcular el uso de CPU!");
         return -1.0;
     }
 
+    unsigned long long totald = total2 - total1;
+    unsigned long long idled = (t2.idle + t2.iowait) - (t1.idle + t1.iowait);
+
     // Calcular el uso de CPU
     double cpu_usage = (1.0 - ((double)idled / (double)totald)) * 100.0;
     return cpu_usage;
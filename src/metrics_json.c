@@ -0,0 +1,245 @@
+#include "metrics_json.h"
+#include "arena.h"
+#include <cjson/cJSON.h>
+#include <string.h>
+
+/**
+ * @brief Longitud del último JSON generado, para dimensionar el buffer del siguiente.
+ */
+static size_t last_length = 1024;
+
+static void encode_cpu(cJSON* root, const metrics_sample_t* sample)
+{
+    cJSON_AddNumberToObject(root, "cpu_usage", sample->cpu_usage);
+}
+
+static void encode_cpufreq(cJSON* root, const metrics_sample_t* sample)
+{
+    const cpufreq_summary_t* cpufreq = &sample->cpufreq;
+    if (cpufreq->cpus_with_freq > 0)
+    {
+        cJSON_AddNumberToObject(root, "cpu_freq_avg_hz", cpufreq->freq_avg_hz);
+        cJSON_AddNumberToObject(root, "cpu_freq_ratio", cpufreq->freq_ratio);
+    }
+    if (cpufreq->normalized_usage >= 0)
+    {
+        cJSON_AddNumberToObject(root, "cpu_usage_freq_normalized", cpufreq->normalized_usage);
+    }
+    if (cpufreq->have_temperature)
+    {
+        cJSON_AddNumberToObject(root, "thermal_max_celsius", cpufreq->max_celsius);
+    }
+    cJSON_AddNumberToObject(root, "cpu_core_throttles", (double)cpufreq->core_throttles);
+}
+
+static void encode_memory(cJSON* root, const metrics_sample_t* sample)
+{
+    cJSON_AddNumberToObject(root, "total_memory", sample->memory.total_mem);
+    cJSON_AddNumberToObject(root, "used_memory", sample->memory.used_mem);
+    cJSON_AddNumberToObject(root, "free_memory", sample->memory.free_mem);
+}
+
+static void encode_disk(cJSON* root, const metrics_sample_t* sample)
+{
+    cJSON_AddNumberToObject(root, "disk_reads", sample->disk.reads_completed);
+    cJSON_AddNumberToObject(root, "disk_writes", sample->disk.writes_completed);
+}
+
+static void encode_net(cJSON* root, const metrics_sample_t* sample)
+{
+    cJSON_AddNumberToObject(root, "rx_bytes", sample->net.rx_bytes);
+    cJSON_AddNumberToObject(root, "tx_bytes", sample->net.tx_bytes);
+}
+
+static void encode_context_switches(cJSON* root, const metrics_sample_t* sample)
+{
+    cJSON_AddNumberToObject(root, "context_switches", sample->context_switches);
+}
+
+static void encode_running_processes(cJSON* root, const metrics_sample_t* sample)
+{
+    cJSON_AddNumberToObject(root, "running_processes", sample->running_processes);
+}
+
+static void encode_memory_fragmentation(cJSON* root, const metrics_sample_t* sample)
+{
+    cJSON_AddNumberToObject(root, "memory_fragmentation", sample->memory_fragmentation);
+}
+
+static void encode_meminfo(cJSON* root, const metrics_sample_t* sample)
+{
+    cJSON* meminfo = cJSON_AddObjectToObject(root, "meminfo");
+    for (int i = 0; i < meminfo_field_count(); i++)
+    {
+        if (sample->meminfo.present[i])
+        {
+            cJSON_AddNumberToObject(meminfo, meminfo_field_name(i), (double)sample->meminfo.values[i]);
+        }
+    }
+    cJSON* rates = cJSON_AddObjectToObject(root, "vmstat_rates");
+    for (int i = 0; i < vmstat_field_count(); i++)
+    {
+        if (sample->vmstat_rates[i] >= 0)
+        {
+            cJSON_AddNumberToObject(rates, vmstat_field_name(i), sample->vmstat_rates[i]);
+        }
+    }
+}
+
+static void encode_microsample(cJSON* root, const metrics_sample_t* sample)
+{
+    if (sample->micro.running_processes.count == 0)
+    {
+        return;
+    }
+    const quantile_summary_t* summaries[] = {&sample->micro.cpu_usage, &sample->micro.running_processes};
+    const char* names[] = {"cpu_usage_micro", "running_processes_micro"};
+    for (int i = 0; i < 2; i++)
+    {
+        cJSON* q = cJSON_AddObjectToObject(root, names[i]);
+        cJSON_AddNumberToObject(q, "min", summaries[i]->min);
+        cJSON_AddNumberToObject(q, "p50", summaries[i]->p50);
+        cJSON_AddNumberToObject(q, "p90", summaries[i]->p90);
+        cJSON_AddNumberToObject(q, "p99", summaries[i]->p99);
+        cJSON_AddNumberToObject(q, "max", summaries[i]->max);
+        cJSON_AddNumberToObject(q, "samples", (double)summaries[i]->count);
+    }
+}
+
+static void encode_interrupts(cJSON* root, const metrics_sample_t* sample)
+{
+    cJSON_AddNumberToObject(root, "irq_rate", sample->irq_rate);
+    cJSON_AddNumberToObject(root, "softirq_rate", sample->softirq_rate);
+    cJSON_AddNumberToObject(root, "irq_imbalance_ratio", sample->irq_imbalance);
+}
+
+static void encode_numa(cJSON* root, const metrics_sample_t* sample)
+{
+    cJSON* nodes = cJSON_AddArrayToObject(root, "numa");
+    for (int n = 0; n < sample->numa_node_count; n++)
+    {
+        const numa_node_stats_t* stats = &sample->numa[n];
+        cJSON* node = cJSON_CreateObject();
+        cJSON_AddNumberToObject(node, "node", stats->node);
+        cJSON_AddNumberToObject(node, "cpus", stats->cpu_count);
+        if (stats->cpu_usage >= 0)
+        {
+            cJSON_AddNumberToObject(node, "cpu_usage", stats->cpu_usage);
+        }
+        if (stats->have_memory)
+        {
+            for (int f = 0; f < NUMA_MEM_FIELDS; f++)
+            {
+                cJSON_AddNumberToObject(node, numa_mem_field_name(f), (double)stats->mem[f]);
+            }
+            if (stats->remote_ratio >= 0)
+            {
+                cJSON_AddNumberToObject(node, "remote_alloc_ratio", stats->remote_ratio);
+            }
+        }
+        cJSON_AddItemToArray(nodes, node);
+    }
+}
+
+static void encode_netproto(cJSON* root, const metrics_sample_t* sample)
+{
+    const netproto_stats_t* stats = &sample->netproto;
+    cJSON* tcp = cJSON_AddObjectToObject(root, "tcp");
+    if (stats->have_states)
+    {
+        for (int s = 1; s < NETPROTO_TCP_STATES; s++)
+        {
+            cJSON_AddNumberToObject(tcp, netproto_tcp_state_name(s), (double)stats->tcp_states[s]);
+        }
+        cJSON_AddNumberToObject(tcp, "listen_queue_ratio", stats->listen_queue_ratio);
+    }
+    if (sample->tcp_retransmit_ratio >= 0)
+    {
+        cJSON_AddNumberToObject(tcp, "retransmit_ratio", sample->tcp_retransmit_ratio);
+    }
+    int overflows = netproto_counter_index("TcpExt", "ListenOverflows");
+    if (stats->present[overflows])
+    {
+        cJSON_AddNumberToObject(tcp, "listen_overflows", (double)stats->counters[overflows]);
+    }
+}
+
+static void encode_psi(cJSON* root, const metrics_sample_t* sample)
+{
+    cJSON* psi = cJSON_AddObjectToObject(root, "psi");
+    for (int i = 0; i < PSI_RESOURCE_COUNT; i++)
+    {
+        const psi_stats_t* stats = &sample->psi[i];
+        if (!stats->some.present)
+        {
+            continue;
+        }
+        cJSON* resource = cJSON_AddObjectToObject(psi, psi_resource_name((psi_resource_t)i));
+        cJSON_AddNumberToObject(resource, "some_avg10", stats->some.avg10);
+        cJSON_AddNumberToObject(resource, "some_avg60", stats->some.avg60);
+        cJSON_AddNumberToObject(resource, "some_total_us", (double)stats->some.total_us);
+        if (stats->full.present)
+        {
+            cJSON_AddNumberToObject(resource, "full_avg10", stats->full.avg10);
+            cJSON_AddNumberToObject(resource, "full_avg60", stats->full.avg60);
+            cJSON_AddNumberToObject(resource, "full_total_us", (double)stats->full.total_us);
+        }
+    }
+}
+
+/**
+ * @brief Codificador de cada colector y el flag de config_t que lo activa, desde collector_list.h.
+ */
+static const struct
+{
+    size_t config_flag;
+    void (*encode)(cJSON* root, const metrics_sample_t* sample);
+} encoders[] = {
+#define COLLECTOR(id, name, label, flag, sources) {offsetof(config_t, flag), encode_##id},
+#include "collector_list.h"
+#undef COLLECTOR
+};
+
+char* metrics_json_encode(const config_t* config, const metrics_sample_t* sample, size_t* length)
+{
+    // Crear el JSON con las métricas usando cJSON
+    cJSON* root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return NULL;
+    }
+    if (config->adaptive.enabled)
+    {
+        // Los ticks de una ráfaga quedan marcados para distinguirlos del muestreo en reposo
+        cJSON_AddBoolToObject(root, "burst", sample->sampling_burst);
+        cJSON_AddNumberToObject(root, "interval_ms", sample->sampling_interval_ms);
+    }
+    for (size_t i = 0; i < sizeof(encoders) / sizeof(encoders[0]); i++)
+    {
+        if (config_flag_enabled(config, encoders[i].config_flag))
+        {
+            encoders[i].encode(root, sample);
+        }
+    }
+
+    // Imprimir en un buffer del arena: cJSON_Print crecería el texto con realloc
+    size_t capacity = last_length + last_length / 2 + 256;
+    char* json_string = NULL;
+    for (int attempt = 0; attempt < 8; attempt++, capacity *= 2)
+    {
+        char* buffer = tick_alloc(capacity);
+        if (buffer != NULL && cJSON_PrintPreallocated(root, buffer, (int)capacity, 1))
+        {
+            json_string = buffer;
+            break;
+        }
+    }
+    cJSON_Delete(root);
+
+    if (json_string != NULL)
+    {
+        *length = strlen(json_string);
+        last_length = *length;
+    }
+    return json_string;
+}
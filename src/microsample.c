@@ -0,0 +1,246 @@
+#include "microsample.h"
+#include "log.h"
+#include "parse.h"
+#include "procfs.h"
+#include "quantile.h"
+#include "realtime.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Error relativo de los cuantiles.
+ */
+#define SKETCH_ACCURACY 0.01
+
+/**
+ * @brief Cada cuánto el hilo evalúa su propio costo.
+ */
+#define OVERHEAD_WINDOW_NS 1000000000LL
+
+/**
+ * @brief Estado del muestreador. Los sketches se protegen con lock; el resto es del hilo.
+ */
+static struct
+{
+    bool running;
+    int stop; // Se lee y escribe con __atomic
+    pthread_t thread;
+    int fd;
+    int interval_ms;
+    double overhead_percent;
+    pthread_mutex_t lock;
+    qsketch_t cpu_usage;
+    qsketch_t running_processes;
+    procfs_buf_t buf;
+} sampler = {.lock = PTHREAD_MUTEX_INITIALIZER, .fd = -1};
+
+static int64_t clock_ns(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Extrae de /proc/stat los tiempos de la línea "cpu" y procs_running.
+ * @return 0 si se encontraron ambos, -1 en caso contrario.
+ */
+static int parse_stat(const char* data, size_t len, uint64_t* busy, uint64_t* total, int* running)
+{
+    const char* end = data + len;
+    if (!parse_starts_with(data, end, "cpu ", 4))
+    {
+        return -1;
+    }
+    uint64_t v[8] = {0};
+    if (parse_u64_fields(data + 4, parse_line_end(data, end), v, 8) < 4)
+    {
+        return -1;
+    }
+    *total = v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] + v[7];
+    *busy = *total - v[3] - v[4]; // Sin idle ni iowait, como get_cpu_usage()
+
+    const char* p = parse_find_line(data, end, "procs_running", 13);
+    if (p == NULL)
+    {
+        return -1;
+    }
+    p = parse_skip_spaces(p, end);
+    *running = (int)parse_u64(&p, end);
+    return 0;
+}
+
+static void* sampler_thread(void* arg)
+{
+    (void)arg;
+    realtime_enter_worker();
+    uint64_t prev_busy = 0, prev_total = 0;
+    bool have_prev = false;
+
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    int64_t window_wall = clock_ns(CLOCK_MONOTONIC);
+    int64_t window_cpu = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+
+    while (!__atomic_load_n(&sampler.stop, __ATOMIC_ACQUIRE))
+    {
+        // Plazos absolutos: la lectura no desplaza la cadencia
+        next.tv_nsec += (long)sampler.interval_ms * 1000000L;
+        while (next.tv_nsec >= 1000000000L)
+        {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000L;
+        }
+        int64_t now = clock_ns(CLOCK_MONOTONIC);
+        if ((int64_t)next.tv_sec * 1000000000LL + next.tv_nsec < now)
+        {
+            next.tv_sec = (time_t)(now / 1000000000LL);
+            next.tv_nsec = (long)(now % 1000000000LL);
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR)
+        {
+        }
+
+        uint64_t busy, total;
+        int running;
+        if (procfs_read_fd(sampler.fd, &sampler.buf) == 0 &&
+            parse_stat(sampler.buf.data, sampler.buf.len, &busy, &total, &running) == 0)
+        {
+            // Si ningún contador avanzó (sub-intervalo menor que un jiffy) no hay dato de CPU
+            bool have_usage = have_prev && total > prev_total && busy >= prev_busy;
+            double usage = have_usage ? (double)(busy - prev_busy) * 100.0 / (double)(total - prev_total) : 0;
+            prev_busy = busy;
+            prev_total = total;
+            have_prev = true;
+
+            pthread_mutex_lock(&sampler.lock);
+            if (have_usage)
+            {
+                qsketch_add(&sampler.cpu_usage, usage);
+            }
+            qsketch_add(&sampler.running_processes, running);
+            pthread_mutex_unlock(&sampler.lock);
+        }
+
+        // Presupuesto de CPU propio (incluido el costo de despertar): si se excede, se muestrea con menos frecuencia
+        int64_t wall = clock_ns(CLOCK_MONOTONIC);
+        if (wall - window_wall >= OVERHEAD_WINDOW_NS)
+        {
+            int64_t cpu = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+            double overhead = (double)(cpu - window_cpu) * 100.0 / (double)(wall - window_wall);
+            window_wall = wall;
+            window_cpu = cpu;
+
+            pthread_mutex_lock(&sampler.lock);
+            sampler.overhead_percent = overhead;
+            if (overhead > MICROSAMPLE_OVERHEAD_BUDGET && sampler.interval_ms < MICROSAMPLE_MAX_INTERVAL_MS)
+            {
+                sampler.interval_ms *= 2;
+                log_warn("Micro-muestreo al %.2f%% de un núcleo; intervalo ampliado a %d ms", overhead,
+                         sampler.interval_ms);
+            }
+            pthread_mutex_unlock(&sampler.lock);
+        }
+    }
+    return NULL;
+}
+
+int microsample_start(int interval_ms)
+{
+    if (sampler.running || interval_ms <= 0)
+    {
+        return -1;
+    }
+
+    char path[PROCFS_PATH_MAX];
+    sampler.fd = open(procfs_path("stat", path, sizeof(path)), O_RDONLY | O_CLOEXEC);
+    if (sampler.fd < 0)
+    {
+        log_error("Error al abrir %s: %m", path);
+        return -1;
+    }
+
+    // El buffer alcanza su tamaño antes de arrancar: el hilo no reserva memoria en régimen estable
+    if (procfs_read_fd(sampler.fd, &sampler.buf) != 0)
+    {
+        log_error("Error al leer %s: %m", path);
+        close(sampler.fd);
+        sampler.fd = -1;
+        return -1;
+    }
+
+    qsketch_init(&sampler.cpu_usage, SKETCH_ACCURACY);
+    qsketch_init(&sampler.running_processes, SKETCH_ACCURACY);
+    sampler.interval_ms = interval_ms;
+    sampler.overhead_percent = 0;
+    __atomic_store_n(&sampler.stop, 0, __ATOMIC_RELEASE);
+    // Sin SCHED_FIFO aunque lo reinicie el colector en una recarga
+    pthread_attr_t attr;
+    realtime_worker_attr(&attr);
+    int created = pthread_create(&sampler.thread, &attr, sampler_thread, NULL);
+    pthread_attr_destroy(&attr);
+    if (created != 0)
+    {
+        log_error("Error al crear el hilo de micro-muestreo");
+        close(sampler.fd);
+        sampler.fd = -1;
+        return -1;
+    }
+    sampler.running = true;
+    return 0;
+}
+
+void microsample_stop(void)
+{
+    if (!sampler.running)
+    {
+        return;
+    }
+    __atomic_store_n(&sampler.stop, 1, __ATOMIC_RELEASE);
+    pthread_join(sampler.thread, NULL);
+    close(sampler.fd);
+    sampler.fd = -1;
+    free(sampler.buf.data);
+    memset(&sampler.buf, 0, sizeof(sampler.buf));
+    sampler.running = false;
+}
+
+static void summarize(const qsketch_t* sketch, quantile_summary_t* summary)
+{
+    summary->min = qsketch_quantile(sketch, 0);
+    summary->p50 = qsketch_quantile(sketch, 0.5);
+    summary->p90 = qsketch_quantile(sketch, 0.9);
+    summary->p99 = qsketch_quantile(sketch, 0.99);
+    summary->max = qsketch_quantile(sketch, 1);
+    summary->count = sketch->count;
+}
+
+int microsample_collect(microsample_summary_t* summary)
+{
+    if (!sampler.running)
+    {
+        return -1;
+    }
+
+    // Los cuantiles se calculan fuera del lock sobre copias, para no frenar al muestreador
+    static qsketch_t cpu_usage, running_processes;
+    pthread_mutex_lock(&sampler.lock);
+    cpu_usage = sampler.cpu_usage;
+    running_processes = sampler.running_processes;
+    qsketch_reset(&sampler.cpu_usage);
+    qsketch_reset(&sampler.running_processes);
+    summary->overhead_percent = sampler.overhead_percent;
+    summary->interval_ms = sampler.interval_ms;
+    pthread_mutex_unlock(&sampler.lock);
+
+    summarize(&cpu_usage, &summary->cpu_usage);
+    summarize(&running_processes, &summary->running_processes);
+    return running_processes.count > 0 ? 0 : -1;
+}
@@ -0,0 +1,378 @@
+#include "netproto.h"
+#include "log.h"
+#include "parse.h"
+#include "procfs.h"
+#include <errno.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @brief Estados que se cuentan con sock_diag: todos menos ESTABLISHED y TIME_WAIT, que se derivan de contadores.
+ */
+#define DIAG_STATES (((1u << NETPROTO_TCP_STATES) - 1) & ~(1u << TCP_ESTABLISHED) & ~(1u << TCP_TIME_WAIT) & ~1u)
+
+/**
+ * @brief Tamaño del buffer de recepción de netlink (cada recv trae muchos mensajes).
+ */
+#define DIAG_BUF_SIZE 65536
+
+/**
+ * @brief Contador registrado: protocolo y nombre.
+ */
+typedef struct
+{
+    const char* proto;
+    const char* name;
+} proto_counter_t;
+
+// Agrupados por protocolo: el parser solo recorre el grupo de la línea
+static const proto_counter_t counters[NETPROTO_COUNTERS] = {
+    {"Tcp", "ActiveOpens"},
+    {"Tcp", "PassiveOpens"},
+    {"Tcp", "AttemptFails"},
+    {"Tcp", "EstabResets"},
+    {"Tcp", "CurrEstab"},
+    {"Tcp", "InSegs"},
+    {"Tcp", "OutSegs"},
+    {"Tcp", "RetransSegs"},
+    {"Tcp", "InErrs"},
+    {"Tcp", "OutRsts"},
+    {"Udp", "InDatagrams"},
+    {"Udp", "NoPorts"},
+    {"Udp", "InErrors"},
+    {"Udp", "OutDatagrams"},
+    {"Udp", "RcvbufErrors"},
+    {"Udp", "SndbufErrors"},
+    {"TcpExt", "ListenOverflows"},
+    {"TcpExt", "ListenDrops"},
+    {"TcpExt", "SyncookiesSent"},
+    {"TcpExt", "TCPTimeouts"},
+    {"TcpExt", "TCPSynRetrans"},
+    {"TcpExt", "TCPFastRetrans"},
+    {"TcpExt", "TCPLostRetransmit"},
+    {"TcpExt", "TCPAbortOnTimeout"},
+    {"TcpExt", "TCPAbortOnMemory"},
+    {"TcpExt", "TCPBacklogDrop"},
+    {"TcpExt", "TCPRcvQDrop"},
+    {"IpExt", "InOctets"},
+    {"IpExt", "OutOctets"},
+};
+
+static const char* const tcp_state_names[NETPROTO_TCP_STATES] = {
+    NULL,        "established", "syn_sent",   "syn_recv", "fin_wait1", "fin_wait2",
+    "time_wait", "close",       "close_wait", "last_ack", "listen",    "closing",
+};
+
+static const char* const sockstat_names[SOCKSTAT_FIELD_COUNT] = {
+    "tcp_inuse", "tcp_orphan", "tcp_tw", "tcp_alloc", "tcp_mem_pages", "udp_inuse",
+};
+
+/**
+ * @brief Buffer de lectura por hilo, reutilizado entre llamados.
+ */
+static __thread procfs_buf_t read_buf;
+
+const char* netproto_counter_name(int counter)
+{
+    return counters[counter].name;
+}
+
+const char* netproto_counter_proto(int counter)
+{
+    return counters[counter].proto;
+}
+
+int netproto_counter_index(const char* proto, const char* name)
+{
+    for (int i = 0; i < NETPROTO_COUNTERS; i++)
+    {
+        if (strcmp(counters[i].proto, proto) == 0 && strcmp(counters[i].name, name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const char* netproto_tcp_state_name(int state)
+{
+    return state > 0 && state < NETPROTO_TCP_STATES ? tcp_state_names[state] : NULL;
+}
+
+const char* sockstat_field_name(sockstat_field_t field)
+{
+    return sockstat_names[field];
+}
+
+/**
+ * @brief Compara una palabra del buffer (sin terminador) con un string.
+ */
+static bool token_equals(const char* p, size_t len, const char* s)
+{
+    return strncmp(s, p, len) == 0 && s[len] == '\0';
+}
+
+/**
+ * @brief Busca el rango [first, last) de contadores registrados del protocolo dado.
+ */
+static void proto_range(const char* proto, size_t len, int* first, int* last)
+{
+    *first = *last = 0;
+    for (int i = 0; i < NETPROTO_COUNTERS; i++)
+    {
+        if (token_equals(proto, len, counters[i].proto))
+        {
+            if (*last == 0)
+            {
+                *first = i;
+            }
+            *last = i + 1;
+        }
+    }
+}
+
+int read_proto_counters(const char* path, netproto_stats_t* stats)
+{
+    if (procfs_read(path, &read_buf) != 0)
+    {
+        log_error("Error al abrir %s: %m", path);
+        return -1;
+    }
+
+    const char* end = read_buf.data + read_buf.len;
+    const char* names = read_buf.data;
+    while (names < end)
+    {
+        // Cabecera "Proto: nombres..." seguida de "Proto: valores..."
+        const char* names_end = parse_line_end(names, end);
+        const char* values = parse_next_line(names, end);
+        const char* values_end = parse_line_end(values, end);
+        const char* colon = memchr(names, ':', (size_t)(names_end - names));
+        if (colon == NULL || values >= end)
+        {
+            break;
+        }
+        size_t proto_len = (size_t)(colon - names);
+        if ((size_t)(values_end - values) <= proto_len || memcmp(values, names, proto_len + 1) != 0)
+        {
+            log_error("Formato inesperado en %s", path);
+            return -1;
+        }
+
+        int first, last;
+        proto_range(names, proto_len, &first, &last);
+        const char* name = colon + 1;
+        const char* value = values + proto_len + 1;
+        while (first < last)
+        {
+            name = parse_skip_spaces(name, names_end);
+            value = parse_skip_spaces(value, values_end);
+            if (name >= names_end || value >= values_end)
+            {
+                break;
+            }
+            const char* name_end = parse_skip_token(name, names_end);
+            for (int i = first; i < last; i++)
+            {
+                if (!stats->present[i] && token_equals(name, (size_t)(name_end - name), counters[i].name))
+                {
+                    const char* v = value;
+                    stats->counters[i] = *v == '-' ? 0 : parse_u64(&v, values_end); // MaxConn puede ser -1
+                    stats->present[i] = true;
+                    break;
+                }
+            }
+            name = name_end;
+            value = parse_skip_token(value, values_end);
+        }
+        names = parse_next_line(values, end);
+    }
+    return 0;
+}
+
+int read_sockstat(const char* path, netproto_stats_t* stats)
+{
+    if (procfs_read(path, &read_buf) != 0)
+    {
+        log_error("Error al abrir %s: %m", path);
+        return -1;
+    }
+
+    static const struct
+    {
+        const char* prefix;
+        const char* key;
+        sockstat_field_t field;
+    } fields[] = {
+        {"TCP:", "inuse", SOCKSTAT_TCP_INUSE}, {"TCP:", "orphan", SOCKSTAT_TCP_ORPHAN},
+        {"TCP:", "tw", SOCKSTAT_TCP_TW},       {"TCP:", "alloc", SOCKSTAT_TCP_ALLOC},
+        {"TCP:", "mem", SOCKSTAT_TCP_MEM},     {"UDP:", "inuse", SOCKSTAT_UDP_INUSE},
+    };
+
+    // Líneas "TCP: inuse 4 orphan 0 tw 0 alloc 4 mem 0"
+    const char* end = read_buf.data + read_buf.len;
+    for (const char* line = read_buf.data; line < end; line = parse_next_line(line, end))
+    {
+        const char* line_end = parse_line_end(line, end);
+        const char* p = parse_skip_token(line, line_end);
+        size_t prefix_len = (size_t)(p - line);
+        while ((p = parse_skip_spaces(p, line_end)) < line_end)
+        {
+            const char* key_end = parse_skip_token(p, line_end);
+            const char* v = parse_skip_spaces(key_end, line_end);
+            uint64_t value = parse_u64(&v, line_end);
+            for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+            {
+                if (token_equals(line, prefix_len, fields[i].prefix) &&
+                    token_equals(p, (size_t)(key_end - p), fields[i].key))
+                {
+                    stats->sockstat[fields[i].field] = value;
+                }
+            }
+            p = v;
+        }
+    }
+    stats->have_sockstat = true;
+    return 0;
+}
+
+int sock_diag_open(void)
+{
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    if (fd < 0)
+    {
+        log_error("Error al abrir NETLINK_SOCK_DIAG: %m");
+        return -1;
+    }
+    // Un buffer grande evita que el kernel parta el volcado en demasiados recv
+    int rcvbuf = 1 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    return fd;
+}
+
+/**
+ * @brief Pide un volcado de inet_diag de una familia y cuenta las respuestas por estado.
+ */
+static int dump_family(int fd, int family, uint32_t states, netproto_stats_t* stats)
+{
+    static __thread uint32_t seq;
+    static __thread char buf[DIAG_BUF_SIZE] __attribute__((aligned(NLMSG_ALIGNTO)));
+
+    struct
+    {
+        struct nlmsghdr nlh;
+        struct inet_diag_req_v2 req;
+    } request = {
+        .nlh = {.nlmsg_len = sizeof(request),
+                .nlmsg_type = SOCK_DIAG_BY_FAMILY,
+                .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+                .nlmsg_seq = ++seq},
+        .req = {.sdiag_family = (uint8_t)family, .sdiag_protocol = IPPROTO_TCP, .idiag_states = states},
+    };
+    struct sockaddr_nl kernel = {.nl_family = AF_NETLINK};
+    if (sendto(fd, &request, sizeof(request), 0, (struct sockaddr*)&kernel, sizeof(kernel)) < 0)
+    {
+        return -1;
+    }
+
+    for (;;)
+    {
+        ssize_t len = recv(fd, buf, sizeof(buf), 0);
+        if (len < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        for (const struct nlmsghdr* nlh = (const struct nlmsghdr*)buf; NLMSG_OK(nlh, (size_t)len);
+             nlh = NLMSG_NEXT(nlh, len))
+        {
+            if (nlh->nlmsg_seq != seq)
+            {
+                continue; // Resto de un volcado anterior interrumpido
+            }
+            if (nlh->nlmsg_type == NLMSG_DONE)
+            {
+                return 0;
+            }
+            if (nlh->nlmsg_type == NLMSG_ERROR)
+            {
+                const struct nlmsgerr* err = NLMSG_DATA(nlh);
+                if (family == AF_INET6 && err->error == -ENOENT)
+                {
+                    return 0; // Kernel sin IPv6
+                }
+                errno = -err->error;
+                return -1;
+            }
+
+            const struct inet_diag_msg* msg = NLMSG_DATA(nlh);
+            if (msg->idiag_state < NETPROTO_TCP_STATES)
+            {
+                stats->tcp_states[msg->idiag_state]++;
+            }
+            // En LISTEN, rqueue es la cola de accept y wqueue su máximo (backlog)
+            if (msg->idiag_state == TCP_LISTEN && msg->idiag_wqueue > 0)
+            {
+                double ratio = (double)msg->idiag_rqueue / (double)msg->idiag_wqueue;
+                stats->listen_queue_ratio = ratio > stats->listen_queue_ratio ? ratio : stats->listen_queue_ratio;
+            }
+        }
+    }
+}
+
+int sock_diag_count_tcp(int fd, uint32_t states, netproto_stats_t* stats)
+{
+    for (int s = 0; s < NETPROTO_TCP_STATES; s++)
+    {
+        if (states & (1u << s))
+        {
+            stats->tcp_states[s] = 0;
+        }
+    }
+    stats->listen_queue_ratio = 0;
+    if (dump_family(fd, AF_INET, states, stats) != 0 || dump_family(fd, AF_INET6, states, stats) != 0)
+    {
+        log_error("Error en el volcado de sock_diag: %m");
+        return -1;
+    }
+    return 0;
+}
+
+int netproto_read(int diag_fd, netproto_stats_t* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    char path[PROCFS_PATH_MAX];
+    if (read_proto_counters(procfs_path("net/snmp", path, sizeof(path)), stats) != 0)
+    {
+        return -1;
+    }
+    // netstat y sockstat son opcionales (kernels recortados o namespaces sin ellos)
+    read_proto_counters(procfs_path("net/netstat", path, sizeof(path)), stats);
+    read_sockstat(procfs_path("net/sockstat", path, sizeof(path)), stats);
+
+    if (diag_fd >= 0 && sock_diag_count_tcp(diag_fd, DIAG_STATES, stats) == 0)
+    {
+        stats->have_states = true;
+
+        // CurrEstab cuenta ESTABLISHED y CLOSE_WAIT (RFC 4022)
+        int curr_estab = netproto_counter_index("Tcp", "CurrEstab");
+        uint64_t close_wait = stats->tcp_states[TCP_CLOSE_WAIT];
+        if (stats->present[curr_estab])
+        {
+            uint64_t estab = stats->counters[curr_estab];
+            stats->tcp_states[TCP_ESTABLISHED] = estab > close_wait ? estab - close_wait : 0;
+        }
+        stats->tcp_states[TCP_TIME_WAIT] = stats->sockstat[SOCKSTAT_TCP_TW];
+    }
+    return 0;
+}
@@ -0,0 +1,330 @@
+#include "numa.h"
+#include "log.h"
+#include "parse.h"
+#include "procfs.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Índices de local_node y other_node en numa_stat_fields.
+ */
+#define STAT_LOCAL_NODE 4
+#define STAT_OTHER_NODE 5
+
+static const char* const numa_mem_fields[NUMA_MEM_FIELDS] = {
+    "MemTotal", "MemFree", "MemUsed", "Active", "Inactive", "FilePages", "AnonPages", "Shmem", "Slab", "Dirty",
+};
+
+static const char* const numa_stat_fields[NUMA_STAT_FIELDS] = {
+    "numa_hit", "numa_miss", "numa_foreign", "interleave_hit", "local_node", "other_node",
+};
+
+/**
+ * @brief Buffer de lectura por hilo, reutilizado entre llamados.
+ */
+static __thread procfs_buf_t read_buf;
+
+const char* numa_mem_field_name(int field)
+{
+    return numa_mem_fields[field];
+}
+
+const char* numa_stat_field_name(int field)
+{
+    return numa_stat_fields[field];
+}
+
+/**
+ * @brief Recorre una lista de rangos con el formato de cpulist ("0-3,8,10-11").
+ */
+typedef struct
+{
+    const char* p;
+    const char* end;
+    int next;
+    int last;
+} range_iter_t;
+
+static bool range_next(range_iter_t* it, int* value)
+{
+    if (it->next > it->last)
+    {
+        it->p = parse_skip_spaces(it->p, it->end);
+        if (it->p < it->end && *it->p == ',')
+        {
+            it->p++;
+        }
+        if (it->p >= it->end || !parse_is_digit(*it->p))
+        {
+            return false;
+        }
+        it->next = (int)parse_u64(&it->p, it->end);
+        it->last = it->next;
+        if (it->p < it->end && *it->p == '-')
+        {
+            it->p++;
+            it->last = (int)parse_u64(&it->p, it->end);
+        }
+    }
+    *value = it->next++;
+    return true;
+}
+
+/**
+ * @brief Lee un archivo de /sys con una lista de rangos y prepara el iterador sobre su contenido.
+ */
+static int read_range_file(const char* rel, range_iter_t* it)
+{
+    char path[PROCFS_PATH_MAX];
+    if (procfs_read(sysfs_path(rel, path, sizeof(path)), &read_buf) != 0)
+    {
+        return -1;
+    }
+    *it = (range_iter_t){read_buf.data, read_buf.data + read_buf.len, 1, 0};
+    return 0;
+}
+
+/**
+ * @brief Abre un archivo del nodo para releerlo en cada tick; en replay no se cachea.
+ */
+static int open_node_file(int node, const char* name)
+{
+    if (procfs_replay_active())
+    {
+        return -1;
+    }
+    char rel[64], path[PROCFS_PATH_MAX];
+    snprintf(rel, sizeof(rel), "devices/system/node/node%d/%s", node, name);
+    return open(sysfs_path(rel, path, sizeof(path)), O_RDONLY | O_CLOEXEC);
+}
+
+/**
+ * @brief Relee un archivo por su descriptor abierto o, sin descriptor, por su ruta.
+ */
+static int read_node_file(int fd, int node, const char* name)
+{
+    if (fd >= 0)
+    {
+        return procfs_read_fd(fd, &read_buf);
+    }
+    char rel[64], path[PROCFS_PATH_MAX];
+    snprintf(rel, sizeof(rel), "devices/system/node/node%d/%s", node, name);
+    return procfs_read(sysfs_path(rel, path, sizeof(path)), &read_buf);
+}
+
+int numa_topology_discover(numa_topology_t* topo)
+{
+    memset(topo, 0, sizeof(*topo));
+
+    // El tamaño de los arreglos por CPU sale de las CPUs posibles, no de las en línea
+    range_iter_t it;
+    int cpu;
+    if (read_range_file("devices/system/cpu/possible", &it) != 0)
+    {
+        log_error("Error al leer las CPUs posibles: %m");
+        return -1;
+    }
+    while (range_next(&it, &cpu))
+    {
+        topo->cpu_slots = cpu + 1 > topo->cpu_slots ? cpu + 1 : topo->cpu_slots;
+    }
+    topo->cpu_node = malloc((size_t)topo->cpu_slots * sizeof(int));
+    if (topo->cpu_slots == 0 || topo->cpu_node == NULL)
+    {
+        log_error("Error al reservar la topología NUMA");
+        numa_topology_free(topo);
+        return -1;
+    }
+
+    int node_ids[NUMA_MAX_NODES];
+    topo->has_sysfs = read_range_file("devices/system/node/online", &it) == 0;
+    if (topo->has_sysfs)
+    {
+        int node;
+        while (range_next(&it, &node))
+        {
+            if (topo->node_count == NUMA_MAX_NODES)
+            {
+                log_warn("Más de %d nodos NUMA; se ignoran los restantes", NUMA_MAX_NODES);
+                break;
+            }
+            node_ids[topo->node_count++] = node;
+        }
+    }
+    if (topo->node_count == 0)
+    {
+        topo->has_sysfs = false;
+        node_ids[topo->node_count++] = 0;
+    }
+
+    for (int c = 0; c < topo->cpu_slots; c++)
+    {
+        topo->cpu_node[c] = topo->has_sysfs ? -1 : 0;
+    }
+    for (int n = 0; n < topo->node_count; n++)
+    {
+        numa_node_t* node = &topo->nodes[n];
+        node->id = node_ids[n];
+        node->meminfo_fd = -1;
+        node->numastat_fd = -1;
+        if (!topo->has_sysfs)
+        {
+            node->cpu_count = topo->cpu_slots;
+            continue;
+        }
+
+        char rel[64];
+        snprintf(rel, sizeof(rel), "devices/system/node/node%d/cpulist", node->id);
+        if (read_range_file(rel, &it) == 0)
+        {
+            while (range_next(&it, &cpu))
+            {
+                if (cpu < topo->cpu_slots)
+                {
+                    topo->cpu_node[cpu] = n;
+                    node->cpu_count++;
+                }
+            }
+        }
+        node->meminfo_fd = open_node_file(node->id, "meminfo");
+        node->numastat_fd = open_node_file(node->id, "numastat");
+    }
+    return 0;
+}
+
+void numa_topology_free(numa_topology_t* topo)
+{
+    for (int n = 0; n < topo->node_count; n++)
+    {
+        if (topo->nodes[n].meminfo_fd >= 0)
+        {
+            close(topo->nodes[n].meminfo_fd);
+        }
+        if (topo->nodes[n].numastat_fd >= 0)
+        {
+            close(topo->nodes[n].numastat_fd);
+        }
+    }
+    free(topo->cpu_node);
+    memset(topo, 0, sizeof(*topo));
+}
+
+/**
+ * @brief Busca la clave de una línea entre los nombres dados.
+ * @return Índice del nombre, o -1 si no es un campo leído.
+ */
+static int match_field(const char* key, size_t len, const char* const* names, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strncmp(names[i], key, len) == 0 && names[i][len] == '\0')
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Parsea "Node N Campo:   valor kB" de nodeN/meminfo, con los valores en bytes.
+ */
+static void parse_node_meminfo(const char* p, const char* end, uint64_t* mem)
+{
+    for (; p < end; p = parse_next_line(p, end))
+    {
+        const char* line_end = parse_line_end(p, end);
+        const char* key = parse_skip_spaces(parse_skip_token(p, line_end), line_end); // "Node"
+        key = parse_skip_spaces(parse_skip_token(key, line_end), line_end);            // Número de nodo
+        const char* colon = memchr(key, ':', (size_t)(line_end - key));
+        if (colon == NULL)
+        {
+            continue;
+        }
+        int field = match_field(key, (size_t)(colon - key), numa_mem_fields, NUMA_MEM_FIELDS);
+        if (field >= 0)
+        {
+            const char* value = parse_skip_spaces(colon + 1, line_end);
+            mem[field] = parse_u64(&value, line_end) * 1024;
+        }
+    }
+}
+
+/**
+ * @brief Parsea "contador valor" de nodeN/numastat.
+ */
+static void parse_node_numastat(const char* p, const char* end, uint64_t* stat)
+{
+    for (; p < end; p = parse_next_line(p, end))
+    {
+        const char* line_end = parse_line_end(p, end);
+        const char* key_end = parse_skip_token(p, line_end);
+        int field = match_field(p, (size_t)(key_end - p), numa_stat_fields, NUMA_STAT_FIELDS);
+        if (field >= 0)
+        {
+            const char* value = parse_skip_spaces(key_end, line_end);
+            stat[field] = parse_u64(&value, line_end);
+        }
+    }
+}
+
+int numa_read(numa_topology_t* topo, const cpu_stat_t* cpu_stat, numa_node_stats_t* stats)
+{
+    // El uso de cada nodo es la suma del intervalo de sus CPUs
+    uint64_t busy[NUMA_MAX_NODES] = {0};
+    uint64_t total[NUMA_MAX_NODES] = {0};
+    for (int cpu = 0; cpu_stat != NULL && cpu < topo->cpu_slots; cpu++)
+    {
+        uint64_t cpu_busy, cpu_total;
+        if (topo->cpu_node[cpu] >= 0 && cpu_stat_delta(cpu_stat, cpu, &cpu_busy, &cpu_total))
+        {
+            busy[topo->cpu_node[cpu]] += cpu_busy;
+            total[topo->cpu_node[cpu]] += cpu_total;
+        }
+    }
+
+    for (int n = 0; n < topo->node_count; n++)
+    {
+        numa_node_t* node = &topo->nodes[n];
+        numa_node_stats_t* out = &stats[n];
+        memset(out, 0, sizeof(*out));
+        out->node = node->id;
+        out->cpu_count = node->cpu_count;
+        out->cpu_usage = total[n] > 0 ? (double)busy[n] * 100.0 / (double)total[n] : -1;
+        out->remote_ratio = -1;
+        if (!topo->has_sysfs)
+        {
+            continue;
+        }
+
+        if (read_node_file(node->meminfo_fd, node->id, "meminfo") == 0)
+        {
+            parse_node_meminfo(read_buf.data, read_buf.data + read_buf.len, out->mem);
+            out->have_memory = true;
+        }
+        if (out->have_memory && read_node_file(node->numastat_fd, node->id, "numastat") == 0)
+        {
+            parse_node_numastat(read_buf.data, read_buf.data + read_buf.len, out->stat);
+
+            // Páginas reservadas en este nodo por procesos que corren en él o en otro
+            uint64_t local = out->stat[STAT_LOCAL_NODE];
+            uint64_t remote = out->stat[STAT_OTHER_NODE];
+            if ((node->prev_local != 0 || node->prev_remote != 0) && local >= node->prev_local &&
+                remote >= node->prev_remote)
+            {
+                uint64_t delta = (local - node->prev_local) + (remote - node->prev_remote);
+                out->remote_ratio = delta > 0 ? (double)(remote - node->prev_remote) / (double)delta : 0;
+            }
+            node->prev_local = local;
+            node->prev_remote = remote;
+        }
+        else
+        {
+            out->have_memory = false;
+        }
+    }
+    return topo->node_count;
+}
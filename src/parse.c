@@ -0,0 +1,33 @@
+#include "parse.h"
+
+size_t parse_u64_fields(const char* p, const char* end, uint64_t* values, size_t max)
+{
+    size_t count = 0;
+
+    while (count < max)
+    {
+        p = parse_skip_spaces(p, end);
+        if (p >= end || !parse_is_digit(*p))
+        {
+            break;
+        }
+        values[count++] = parse_u64(&p, end);
+    }
+    return count;
+}
+
+const char* parse_find_line(const char* buf, const char* end, const char* prefix, size_t len)
+{
+    const char* p = buf;
+
+    while (p < end)
+    {
+        // Comparar el primer carácter antes de llamar a memcmp descarta casi todas las líneas
+        if (*p == prefix[0] && parse_starts_with(p, end, prefix, len))
+        {
+            return p + len;
+        }
+        p = parse_next_line(p, end);
+    }
+    return NULL;
+}
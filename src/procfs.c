@@ -0,0 +1,336 @@
+#include "procfs.h"
+#include "procfs_batch.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Capacidad inicial de un procfs_buf_t.
+ */
+#define PROCFS_BUF_INITIAL 4096
+
+/**
+ * @brief Snapshot de un directorio de replay.
+ */
+typedef struct
+{
+    long long timestamp_ms; /**< Momento de la captura. */
+    char proc_root[PROCFS_PATH_MAX]; /**< Ruta al /proc grabado. */
+    char sys_root[PROCFS_PATH_MAX];  /**< Ruta al /sys grabado. */
+} replay_snapshot_t;
+
+// Raíces configuradas por el usuario, en dos juegos: procfs_set_root() escribe en el que no está
+// publicado, así un hilo que todavía usa la raíz anterior nunca la ve a medio escribir
+static char user_roots[2][2][PROCFS_PATH_MAX] = {{"/proc", "/sys"}, {"/proc", "/sys"}};
+static int user_slot; // Juego publicado
+
+// Raíces vigentes. Se reemplazan de forma atómica para que otros hilos nunca vean una ruta a medias.
+static const char* proc_root = user_roots[0][0];
+static const char* sys_root = user_roots[0][1];
+
+// Estado del replay
+static replay_snapshot_t* snapshots;
+static size_t snapshot_count;
+static size_t snapshot_index;
+static double replay_speed;
+static bool replay_loop;
+static int64_t replay_clock_ms; // Tiempo grabado acumulado: no retrocede al volver al principio
+
+// Contadores del lector (los usan también los hilos de PSI y de micro-muestreo)
+static procfs_stats_t stats;
+
+static void set_roots(const char* proc, const char* sys)
+{
+    __atomic_store_n(&proc_root, proc, __ATOMIC_RELEASE);
+    __atomic_store_n(&sys_root, sys, __ATOMIC_RELEASE);
+}
+
+void procfs_set_root(const char* proc, const char* sys)
+{
+    int next = user_slot ^ 1;
+    snprintf(user_roots[next][0], PROCFS_PATH_MAX, "%s", proc != NULL && proc[0] != '\0' ? proc : "/proc");
+    snprintf(user_roots[next][1], PROCFS_PATH_MAX, "%s", sys != NULL && sys[0] != '\0' ? sys : "/sys");
+    user_slot = next;
+    if (snapshots == NULL)
+    {
+        set_roots(user_roots[next][0], user_roots[next][1]);
+    }
+}
+
+const char* procfs_path(const char* rel, char* buf, size_t len)
+{
+    snprintf(buf, len, "%s/%s", __atomic_load_n(&proc_root, __ATOMIC_ACQUIRE), rel);
+    return buf;
+}
+
+const char* sysfs_path(const char* rel, char* buf, size_t len)
+{
+    snprintf(buf, len, "%s/%s", __atomic_load_n(&sys_root, __ATOMIC_ACQUIRE), rel);
+    return buf;
+}
+
+void procfs_count(unsigned syscalls, unsigned batched, unsigned direct)
+{
+    __atomic_fetch_add(&stats.syscalls, syscalls, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats.batched, batched, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats.direct, direct, __ATOMIC_RELAXED);
+}
+
+void procfs_stats_get(procfs_stats_t* out)
+{
+    out->syscalls = __atomic_load_n(&stats.syscalls, __ATOMIC_RELAXED);
+    out->batched = __atomic_load_n(&stats.batched, __ATOMIC_RELAXED);
+    out->direct = __atomic_load_n(&stats.direct, __ATOMIC_RELAXED);
+}
+
+int procfs_buf_reserve(procfs_buf_t* buf, size_t size)
+{
+    if (buf->cap >= size)
+    {
+        return 0;
+    }
+    size_t cap = buf->cap != 0 ? buf->cap : PROCFS_BUF_INITIAL;
+    while (cap < size)
+    {
+        cap *= 2;
+    }
+    char* data = realloc(buf->data, cap);
+    if (data == NULL)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+    buf->data = data;
+    buf->cap = cap;
+    return 0;
+}
+
+/**
+ * @brief Lee desde la posición actual de fd hasta el final. No cierra el descriptor.
+ */
+static int read_all(int fd, procfs_buf_t* buf)
+{
+    buf->len = 0;
+    for (;;)
+    {
+        // Siempre reservar lugar para el '\0' final
+        if (buf->cap - buf->len < 2 && procfs_buf_reserve(buf, buf->cap + 1) != 0)
+        {
+            return -1;
+        }
+
+        ssize_t n = read(fd, buf->data + buf->len, buf->cap - buf->len - 1);
+        procfs_count(1, 0, 0);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0)
+        {
+            break;
+        }
+        buf->len += (size_t)n;
+    }
+
+    buf->data[buf->len] = '\0';
+    return 0;
+}
+
+int procfs_read(const char* path, procfs_buf_t* buf)
+{
+    if (procfs_batch_lookup(path, buf))
+    {
+        return 0;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    procfs_count(1, 0, 1);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    int rc = read_all(fd, buf);
+    int saved = errno;
+    close(fd);
+    procfs_count(1, 0, 0);
+    errno = saved;
+    if (rc == 0)
+    {
+        procfs_batch_learn(path, buf->len);
+    }
+    return rc;
+}
+
+int procfs_read_fd(int fd, procfs_buf_t* buf)
+{
+    // Leer desde el offset 0 hace que el kernel regenere el archivo. Si entra completo en el
+    // buffer alcanza con una sola llamada; si no, se vuelve al inicio y se lee hasta el final.
+    if (buf->cap >= 2)
+    {
+        ssize_t n;
+        do
+        {
+            n = pread(fd, buf->data, buf->cap - 1, 0);
+            procfs_count(1, 0, 0);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0)
+        {
+            return -1;
+        }
+        if ((size_t)n < buf->cap - 1)
+        {
+            buf->len = (size_t)n;
+            buf->data[buf->len] = '\0';
+            return 0;
+        }
+    }
+    procfs_count(1, 0, 0);
+    if (lseek(fd, 0, SEEK_SET) < 0)
+    {
+        return -1;
+    }
+    return read_all(fd, buf);
+}
+
+static int compare_snapshots(const void* a, const void* b)
+{
+    long long ta = ((const replay_snapshot_t*)a)->timestamp_ms;
+    long long tb = ((const replay_snapshot_t*)b)->timestamp_ms;
+    return (ta > tb) - (ta < tb);
+}
+
+int procfs_replay_open(const char* dir, double speed, bool loop)
+{
+    DIR* d = opendir(dir);
+    if (d == NULL)
+    {
+        fprintf(stderr, "Error al abrir el directorio de replay %s: %s\n", dir, strerror(errno));
+        return -1;
+    }
+
+    size_t capacity = 64;
+    replay_snapshot_t* list = malloc(capacity * sizeof(*list));
+    size_t count = 0;
+    struct dirent* entry;
+
+    while (list != NULL && (entry = readdir(d)) != NULL)
+    {
+        char* end;
+        long long ts = strtoll(entry->d_name, &end, 10);
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9' || *end != '\0')
+        {
+            continue; // No es un snapshot
+        }
+        if (count == capacity)
+        {
+            capacity *= 2;
+            replay_snapshot_t* grown = realloc(list, capacity * sizeof(*list));
+            if (grown == NULL)
+            {
+                free(list);
+                list = NULL;
+                break;
+            }
+            list = grown;
+        }
+        list[count].timestamp_ms = ts;
+        snprintf(list[count].proc_root, sizeof(list[count].proc_root), "%s/%s/proc", dir, entry->d_name);
+        snprintf(list[count].sys_root, sizeof(list[count].sys_root), "%s/%s/sys", dir, entry->d_name);
+        count++;
+    }
+    closedir(d);
+
+    if (list == NULL)
+    {
+        fprintf(stderr, "Sin memoria para el índice de replay\n");
+        return -1;
+    }
+    if (count == 0)
+    {
+        fprintf(stderr, "No se encontraron snapshots en %s\n", dir);
+        free(list);
+        return -1;
+    }
+
+    qsort(list, count, sizeof(*list), compare_snapshots);
+
+    procfs_replay_close();
+    snapshots = list;
+    snapshot_count = count;
+    snapshot_index = 0;
+    replay_speed = speed;
+    replay_loop = loop;
+    __atomic_store_n(&replay_clock_ms, (int64_t)snapshots[0].timestamp_ms, __ATOMIC_RELAXED);
+    set_roots(snapshots[0].proc_root, snapshots[0].sys_root);
+    return 0;
+}
+
+bool procfs_replay_active(void)
+{
+    return snapshots != NULL;
+}
+
+long procfs_replay_advance(void)
+{
+    if (snapshots == NULL)
+    {
+        return -1;
+    }
+
+    size_t next = snapshot_index + 1;
+    long long delta_ms = 0;
+    if (next == snapshot_count)
+    {
+        if (!replay_loop)
+        {
+            return -1;
+        }
+        // Al reiniciar no hay un intervalo grabado: se repite el primero para no adelantar un tick
+        next = 0;
+        delta_ms = snapshot_count > 1 ? snapshots[1].timestamp_ms - snapshots[0].timestamp_ms : 0;
+    }
+    else
+    {
+        delta_ms = snapshots[next].timestamp_ms - snapshots[snapshot_index].timestamp_ms;
+    }
+
+    snapshot_index = next;
+    if (delta_ms > 0)
+    {
+        __atomic_store_n(&replay_clock_ms, replay_clock_ms + delta_ms, __ATOMIC_RELAXED);
+    }
+    set_roots(snapshots[next].proc_root, snapshots[next].sys_root);
+
+    if (replay_speed <= 0.0 || delta_ms <= 0)
+    {
+        return 0;
+    }
+    return (long)((double)delta_ms * 1000.0 / replay_speed);
+}
+
+int64_t procfs_replay_now_ms(void)
+{
+    return snapshots != NULL ? __atomic_load_n(&replay_clock_ms, __ATOMIC_RELAXED) : -1;
+}
+
+void procfs_replay_close(void)
+{
+    if (snapshots == NULL)
+    {
+        return;
+    }
+    set_roots(user_roots[user_slot][0], user_roots[user_slot][1]);
+    free(snapshots);
+    snapshots = NULL;
+    snapshot_count = 0;
+    snapshot_index = 0;
+}
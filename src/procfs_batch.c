@@ -0,0 +1,617 @@
+#include "procfs_batch.h"
+#include "log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/**
+ * @brief Tope de archivos del lote; además se limita a la mitad de RLIMIT_NOFILE.
+ */
+#define BATCH_MAX_FILES 4096
+
+/**
+ * @brief Capacidad inicial del buffer de un archivo del lote.
+ */
+#define BATCH_BUF_INITIAL 4096
+
+/**
+ * @brief Ticks sin leerse tras los que un archivo sale del lote (colector desactivado, interfaz quitada).
+ */
+#define BATCH_IDLE_TICKS 3
+
+/**
+ * @brief Entradas del ring de io_uring; los lotes más grandes se envían en tramos de este tamaño.
+ */
+#define RING_ENTRIES 256
+
+/**
+ * @brief Archivo del lote: descriptor abierto entre ticks y buffer propio (fijo en io_uring).
+ */
+typedef struct
+{
+    char* path;      /**< Ruta tal como la pide el colector. */
+    uint32_t hash;   /**< Hash de path. */
+    int fd;          /**< Descriptor abierto; su índice en el arreglo es el del archivo registrado. */
+    char* data;      /**< Buffer del lote. */
+    size_t cap;      /**< Capacidad de data. */
+    ssize_t result;  /**< Bytes leídos en el lote del tick, o -errno. */
+    bool fresh;      /**< result es del lote del tick en curso. */
+    int idle_ticks;  /**< Ticks seguidos sin que procfs_read() pida el archivo. */
+} batch_file_t;
+
+/**
+ * @brief Ring de io_uring mapeado a mano (sin liburing).
+ */
+typedef struct
+{
+    int fd;                     /**< Descriptor del ring, o -1. */
+    unsigned entries;           /**< Entradas de la cola de envío. */
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_sqe* sqes;
+    struct io_uring_cqe* cqes;
+    void* sq_ring;
+    size_t sq_ring_len;
+    void* cq_ring;
+    size_t cq_ring_len;
+    size_t sqes_len;
+    bool files_registered;      /**< Los descriptores del lote están registrados. */
+    bool buffers_registered;    /**< Los buffers del lote están registrados (IORING_OP_READ_FIXED). */
+} ring_t;
+
+static procfs_batch_backend_t backend = PROCFS_BATCH_OFF;
+static int max_files;
+static batch_file_t* files;
+static int file_count;
+static int file_capacity;
+static int* slots;        // Tabla de hash abierta: posición en files o -1
+static int slot_count;    // Potencia de 2, al menos el doble de file_capacity
+static bool registration_stale; // Cambiaron los descriptores o algún buffer desde el último registro
+static ring_t ring = {.fd = -1};
+
+// Solo el hilo que abrió el lote lo consulta; PSI y micro-muestreo leen siempre directo
+static __thread bool batch_active;
+
+static uint32_t hash_path(const char* path)
+{
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)path; *p != '\0'; p++)
+    {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+static int find_file(const char* path, uint32_t hash)
+{
+    if (slot_count == 0)
+    {
+        return -1;
+    }
+    for (int slot = (int)(hash & (uint32_t)(slot_count - 1));; slot = (slot + 1) & (slot_count - 1))
+    {
+        int index = slots[slot];
+        if (index < 0)
+        {
+            return -1;
+        }
+        if (files[index].hash == hash && strcmp(files[index].path, path) == 0)
+        {
+            return index;
+        }
+    }
+}
+
+/**
+ * @brief Reconstruye la tabla de hash después de agregar o quitar archivos.
+ */
+static int rebuild_slots(void)
+{
+    int wanted = 64;
+    while (wanted < file_capacity * 2)
+    {
+        wanted *= 2;
+    }
+    if (wanted != slot_count)
+    {
+        int* grown = realloc(slots, (size_t)wanted * sizeof(*slots));
+        if (grown == NULL)
+        {
+            return -1;
+        }
+        slots = grown;
+        slot_count = wanted;
+    }
+    for (int i = 0; i < slot_count; i++)
+    {
+        slots[i] = -1;
+    }
+    for (int i = 0; i < file_count; i++)
+    {
+        int slot = (int)(files[i].hash & (uint32_t)(slot_count - 1));
+        while (slots[slot] >= 0)
+        {
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        slots[slot] = i;
+    }
+    return 0;
+}
+
+static void close_file(batch_file_t* file)
+{
+    close(file->fd);
+    free(file->path);
+    free(file->data);
+}
+
+static size_t buffer_size_for(size_t len)
+{
+    size_t cap = BATCH_BUF_INITIAL;
+    while (cap < len + 2)
+    {
+        cap *= 2;
+    }
+    return cap;
+}
+
+static void add_file(const char* path, uint32_t hash, size_t len)
+{
+    if (file_count >= max_files)
+    {
+        return;
+    }
+    if (file_count == file_capacity)
+    {
+        int capacity = file_capacity > 0 ? file_capacity * 2 : 64;
+        batch_file_t* grown = realloc(files, (size_t)capacity * sizeof(*files));
+        if (grown == NULL)
+        {
+            return;
+        }
+        files = grown;
+        file_capacity = capacity;
+    }
+
+    batch_file_t file = {.hash = hash, .cap = buffer_size_for(len)};
+    file.fd = open(path, O_RDONLY | O_CLOEXEC);
+    procfs_count(1, 0, 0);
+    if (file.fd < 0)
+    {
+        return; // Sin descriptores libres el archivo se sigue leyendo directo
+    }
+    file.path = strdup(path);
+    file.data = malloc(file.cap);
+    if (file.path == NULL || file.data == NULL)
+    {
+        close_file(&file);
+        return;
+    }
+    files[file_count++] = file;
+    registration_stale = true;
+    if (rebuild_slots() != 0)
+    {
+        close_file(&files[--file_count]);
+    }
+}
+
+static void close_all(void)
+{
+    for (int i = 0; i < file_count; i++)
+    {
+        close_file(&files[i]);
+    }
+    free(files);
+    free(slots);
+    files = NULL;
+    slots = NULL;
+    file_count = 0;
+    file_capacity = 0;
+    slot_count = 0;
+    registration_stale = true;
+}
+
+static int ring_register_op(unsigned opcode, void* arg, unsigned count)
+{
+    procfs_count(1, 0, 0);
+    return (int)syscall(__NR_io_uring_register, ring.fd, opcode, arg, count);
+}
+
+static void ring_close(void)
+{
+    if (ring.fd < 0)
+    {
+        return;
+    }
+    munmap(ring.sqes, ring.sqes_len);
+    if (ring.cq_ring != ring.sq_ring)
+    {
+        munmap(ring.cq_ring, ring.cq_ring_len);
+    }
+    munmap(ring.sq_ring, ring.sq_ring_len);
+    close(ring.fd);
+    memset(&ring, 0, sizeof(ring));
+    ring.fd = -1;
+}
+
+static int ring_open(void)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = (int)syscall(__NR_io_uring_setup, RING_ENTRIES, &params);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    ring.fd = fd;
+    ring.entries = params.sq_entries;
+    ring.sq_ring_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring.cq_ring_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (ring.cq_ring_len > ring.sq_ring_len)
+        {
+            ring.sq_ring_len = ring.cq_ring_len;
+        }
+        ring.cq_ring_len = ring.sq_ring_len;
+    }
+    ring.sq_ring = mmap(NULL, ring.sq_ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                        IORING_OFF_SQ_RING);
+    if (ring.sq_ring == MAP_FAILED)
+    {
+        close(fd);
+        ring.fd = -1;
+        return -1;
+    }
+    ring.cq_ring = ring.sq_ring;
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP))
+    {
+        ring.cq_ring = mmap(NULL, ring.cq_ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                            IORING_OFF_CQ_RING);
+    }
+    ring.sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring.sqes = mmap(NULL, ring.sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring.cq_ring == MAP_FAILED || ring.sqes == MAP_FAILED)
+    {
+        int saved = errno;
+        if (ring.cq_ring != MAP_FAILED && ring.cq_ring != ring.sq_ring)
+        {
+            munmap(ring.cq_ring, ring.cq_ring_len);
+        }
+        munmap(ring.sq_ring, ring.sq_ring_len);
+        close(fd);
+        memset(&ring, 0, sizeof(ring));
+        ring.fd = -1;
+        errno = saved;
+        return -1;
+    }
+
+    char* sq = ring.sq_ring;
+    char* cq = ring.cq_ring;
+    ring.sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    ring.sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring.sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring.cq_head = (unsigned*)(cq + params.cq_off.head);
+    ring.cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    ring.cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    return 0;
+}
+
+/**
+ * @brief Registra los descriptores y los buffers del lote. Solo cuando cambió el conjunto.
+ *
+ * Los buffers fijos cuentan contra RLIMIT_MEMLOCK en kernels viejos; si no se pueden registrar se
+ * sigue con IORING_OP_READ sobre los descriptores registrados.
+ */
+static int ring_register(void)
+{
+    if (ring.files_registered)
+    {
+        ring_register_op(IORING_UNREGISTER_FILES, NULL, 0);
+        ring.files_registered = false;
+    }
+    if (ring.buffers_registered)
+    {
+        ring_register_op(IORING_UNREGISTER_BUFFERS, NULL, 0);
+        ring.buffers_registered = false;
+    }
+    registration_stale = false;
+    if (file_count == 0)
+    {
+        return 0;
+    }
+
+    int* fds = malloc((size_t)file_count * sizeof(*fds));
+    struct iovec* iov = malloc((size_t)file_count * sizeof(*iov));
+    if (fds == NULL || iov == NULL)
+    {
+        free(fds);
+        free(iov);
+        registration_stale = true;
+        return -1;
+    }
+    for (int i = 0; i < file_count; i++)
+    {
+        fds[i] = files[i].fd;
+        iov[i].iov_base = files[i].data;
+        iov[i].iov_len = files[i].cap;
+    }
+    ring.files_registered = ring_register_op(IORING_REGISTER_FILES, fds, (unsigned)file_count) == 0;
+    ring.buffers_registered =
+        ring.files_registered && ring_register_op(IORING_REGISTER_BUFFERS, iov, (unsigned)file_count) == 0;
+    free(fds);
+    free(iov);
+    if (!ring.files_registered)
+    {
+        registration_stale = true;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Recoge las completions disponibles.
+ * @return Completions recogidas.
+ */
+static unsigned ring_reap(void)
+{
+    unsigned head = *ring.cq_head;
+    unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+    unsigned reaped = 0;
+    while (head != tail)
+    {
+        struct io_uring_cqe* cqe = &ring.cqes[head & *ring.cq_mask];
+        batch_file_t* file = &files[cqe->user_data];
+        file->result = cqe->res;
+        file->fresh = true;
+        head++;
+        reaped++;
+    }
+    __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+
+/**
+ * @brief Lee el lote con io_uring: un io_uring_enter que envía y espera cada tramo de RING_ENTRIES.
+ * @return 0 si todo el lote se leyó, -1 si hay que volver a pread.
+ */
+static int ring_read_all(void)
+{
+    if (registration_stale && ring_register() != 0)
+    {
+        return -1;
+    }
+
+    for (int first = 0; first < file_count; first += (int)ring.entries)
+    {
+        unsigned count = (unsigned)(file_count - first) < ring.entries ? (unsigned)(file_count - first) : ring.entries;
+        unsigned tail = *ring.sq_tail;
+        for (unsigned k = 0; k < count; k++)
+        {
+            int index = first + (int)k;
+            unsigned slot = tail & *ring.sq_mask;
+            struct io_uring_sqe* sqe = &ring.sqes[slot];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = ring.buffers_registered ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            sqe->flags = IOSQE_FIXED_FILE;
+            sqe->fd = index;
+            sqe->addr = (uint64_t)(uintptr_t)files[index].data;
+            sqe->len = (unsigned)(files[index].cap - 1);
+            sqe->off = 0;
+            sqe->buf_index = (uint16_t)index;
+            sqe->user_data = (uint64_t)index;
+            ring.sq_array[slot] = slot;
+            tail++;
+        }
+        __atomic_store_n(ring.sq_tail, tail, __ATOMIC_RELEASE);
+
+        unsigned to_submit = count;
+        unsigned done = 0;
+        while (done < count)
+        {
+            int rc = (int)syscall(__NR_io_uring_enter, ring.fd, to_submit, count - done, IORING_ENTER_GETEVENTS,
+                                  NULL, 0);
+            procfs_count(1, 0, 0);
+            if (rc < 0 && errno != EINTR)
+            {
+                return -1;
+            }
+            if (rc > 0)
+            {
+                to_submit -= (unsigned)rc < to_submit ? (unsigned)rc : to_submit;
+            }
+            done += ring_reap();
+        }
+    }
+    return 0;
+}
+
+static void pread_all(void)
+{
+    for (int i = 0; i < file_count; i++)
+    {
+        batch_file_t* file = &files[i];
+        ssize_t n;
+        do
+        {
+            n = pread(file->fd, file->data, file->cap - 1, 0);
+            procfs_count(1, 0, 0);
+        } while (n < 0 && errno == EINTR);
+        file->result = n < 0 ? -errno : n;
+        file->fresh = true;
+    }
+}
+
+procfs_batch_backend_t procfs_batch_init(procfs_batch_backend_t requested)
+{
+    batch_active = false;
+    ring_close();
+    close_all();
+    backend = requested;
+
+    // El resto de los descriptores del proceso (sockets, colectores, logger) conserva su margen
+    struct rlimit limit;
+    max_files = BATCH_MAX_FILES;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY &&
+        limit.rlim_cur / 2 < (rlim_t)max_files)
+    {
+        max_files = (int)(limit.rlim_cur / 2);
+    }
+
+    if (backend == PROCFS_BATCH_IO_URING && ring_open() != 0)
+    {
+        backend = PROCFS_BATCH_PREAD;
+    }
+    return backend;
+}
+
+void procfs_batch_begin(void)
+{
+    if (backend == PROCFS_BATCH_OFF || procfs_replay_active())
+    {
+        return;
+    }
+    batch_active = true;
+    if (file_count == 0)
+    {
+        return;
+    }
+    if (backend == PROCFS_BATCH_IO_URING && ring_read_all() != 0)
+    {
+        log_warn("io_uring falló al leer el lote (%s); se usa pread", strerror(errno));
+        ring_close();
+        backend = PROCFS_BATCH_PREAD;
+    }
+    if (backend == PROCFS_BATCH_PREAD)
+    {
+        pread_all();
+    }
+}
+
+void procfs_batch_end(void)
+{
+    if (!batch_active)
+    {
+        return;
+    }
+    batch_active = false;
+
+    int kept = 0;
+    for (int i = 0; i < file_count; i++)
+    {
+        batch_file_t* file = &files[i];
+        file->fresh = false;
+        if (++file->idle_ticks > BATCH_IDLE_TICKS)
+        {
+            close_file(file);
+            continue;
+        }
+        files[kept++] = *file;
+    }
+    if (kept != file_count)
+    {
+        file_count = kept;
+        registration_stale = true;
+        rebuild_slots();
+    }
+}
+
+bool procfs_batch_lookup(const char* path, procfs_buf_t* buf)
+{
+    if (!batch_active)
+    {
+        return false;
+    }
+    int index = find_file(path, hash_path(path));
+    if (index < 0)
+    {
+        return false;
+    }
+
+    // Un error o un buffer lleno (posible truncado) se resuelven con una lectura directa
+    batch_file_t* file = &files[index];
+    if (!file->fresh || file->result < 0 || (size_t)file->result >= file->cap - 1)
+    {
+        return false;
+    }
+    size_t len = (size_t)file->result;
+    if (procfs_buf_reserve(buf, len + 1) != 0)
+    {
+        return false;
+    }
+    memcpy(buf->data, file->data, len);
+    buf->data[len] = '\0';
+    buf->len = len;
+    file->idle_ticks = 0;
+    procfs_count(0, 1, 0);
+    return true;
+}
+
+void procfs_batch_learn(const char* path, size_t len)
+{
+    if (!batch_active)
+    {
+        return;
+    }
+    uint32_t hash = hash_path(path);
+    int index = find_file(path, hash);
+    if (index < 0)
+    {
+        add_file(path, hash, len);
+        return;
+    }
+
+    batch_file_t* file = &files[index];
+    file->idle_ticks = 0;
+    if (file->fresh && file->result < 0)
+    {
+        // El descriptor quedó inválido (dispositivo quitado y vuelto a crear): se reabre
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        procfs_count(1, 0, 0);
+        if (fd >= 0)
+        {
+            close(file->fd);
+            procfs_count(1, 0, 0);
+            file->fd = fd;
+            registration_stale = true;
+        }
+    }
+    else if (len + 2 > file->cap)
+    {
+        char* data = malloc(buffer_size_for(len));
+        if (data != NULL)
+        {
+            free(file->data);
+            file->data = data;
+            file->cap = buffer_size_for(len);
+            registration_stale = true;
+        }
+    }
+}
+
+const char* procfs_batch_name(procfs_batch_backend_t value)
+{
+    switch (value)
+    {
+    case PROCFS_BATCH_PREAD:
+        return "pread";
+    case PROCFS_BATCH_IO_URING:
+        return "io_uring";
+    default:
+        return "off";
+    }
+}
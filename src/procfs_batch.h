@@ -0,0 +1,39 @@
+/**
+ * @file procfs_batch.h
+ * @brief Enlace interno entre procfs_read() y el lote del tick (procfs_batch.c).
+ */
+
+#ifndef PROCFS_BATCH_H
+#define PROCFS_BATCH_H
+
+#include "procfs.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Sirve una lectura desde el lote del tick, si el archivo está en él y entró completo.
+ * @param path Ruta pedida a procfs_read().
+ * @param buf Buffer de destino.
+ * @return true si buf quedó con el contenido; false si hay que leer el archivo directamente.
+ */
+bool procfs_batch_lookup(const char* path, procfs_buf_t* buf);
+
+/**
+ * @brief Incorpora al lote un archivo leído directamente, o ajusta su buffer o su descriptor.
+ * @param path Ruta leída.
+ * @param len Bytes que tuvo la lectura directa.
+ */
+void procfs_batch_learn(const char* path, size_t len);
+
+/**
+ * @brief Suma a los contadores del lector.
+ */
+void procfs_count(unsigned syscalls, unsigned batched, unsigned direct);
+
+/**
+ * @brief Asegura capacidad para al menos size bytes (incluido el '\0').
+ * @return 0 si hay capacidad, -1 si no hay memoria.
+ */
+int procfs_buf_reserve(procfs_buf_t* buf, size_t size);
+
+#endif // PROCFS_BATCH_H
@@ -0,0 +1,311 @@
+#include "psi.h"
+#include "log.h"
+#include "parse.h"
+#include "procfs.h"
+#include "realtime.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Buffer de lectura por hilo, reutilizado entre llamados.
+ */
+static __thread procfs_buf_t read_buf;
+
+static const char* const resource_names[PSI_RESOURCE_COUNT] = {"cpu", "memory", "io"};
+
+const char* psi_resource_name(psi_resource_t resource)
+{
+    return resource_names[resource];
+}
+
+int psi_resource_from_name(const char* name)
+{
+    for (int i = 0; i < PSI_RESOURCE_COUNT; i++)
+    {
+        if (strcmp(name, resource_names[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Lee un decimal sin signo del formato de PSI ("12.34") sin depender del locale.
+ */
+static double parse_decimal(const char** p, const char* end)
+{
+    double value = (double)parse_u64(p, end);
+    if (*p < end && **p == '.')
+    {
+        (*p)++;
+        double scale = 0.1;
+        while (*p < end && parse_is_digit(**p))
+        {
+            value += (**p - '0') * scale;
+            scale *= 0.1;
+            (*p)++;
+        }
+    }
+    return value;
+}
+
+/**
+ * @brief Parsea "avg10=X avg60=Y avg300=Z total=T" a partir de p.
+ */
+static void parse_psi_line(const char* p, const char* end, psi_line_t* line)
+{
+    line->present = true;
+    while ((p = parse_skip_spaces(p, end)) < end)
+    {
+        if (parse_starts_with(p, end, "avg10=", 6))
+        {
+            p += 6;
+            line->avg10 = parse_decimal(&p, end);
+        }
+        else if (parse_starts_with(p, end, "avg60=", 6))
+        {
+            p += 6;
+            line->avg60 = parse_decimal(&p, end);
+        }
+        else if (parse_starts_with(p, end, "avg300=", 7))
+        {
+            p += 7;
+            line->avg300 = parse_decimal(&p, end);
+        }
+        else if (parse_starts_with(p, end, "total=", 6))
+        {
+            p += 6;
+            line->total_us = parse_u64(&p, end);
+        }
+        else
+        {
+            p = parse_skip_token(p, end); // Campo de un kernel más nuevo
+        }
+    }
+}
+
+int read_psi(const char* path, psi_stats_t* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+    if (procfs_read(path, &read_buf) != 0)
+    {
+        log_error("Error al abrir %s: %m", path);
+        return -1;
+    }
+
+    const char* end = read_buf.data + read_buf.len;
+    for (const char* line = read_buf.data; line < end; line = parse_next_line(line, end))
+    {
+        const char* line_end = parse_line_end(line, end);
+        if (parse_starts_with(line, line_end, "some ", 5))
+        {
+            parse_psi_line(line + 5, line_end, &stats->some);
+        }
+        else if (parse_starts_with(line, line_end, "full ", 5))
+        {
+            parse_psi_line(line + 5, line_end, &stats->full);
+        }
+    }
+
+    if (!stats->some.present)
+    {
+        log_error("Formato inesperado en %s", path);
+        return -1;
+    }
+    return 0;
+}
+
+int psi_default_triggers(psi_trigger_t* triggers)
+{
+    for (int i = 0; i < PSI_RESOURCE_COUNT; i++)
+    {
+        triggers[i].resource = (psi_resource_t)i;
+        triggers[i].full = false;
+        triggers[i].stall_us = 150000;
+        triggers[i].window_us = 1000000;
+    }
+    return PSI_RESOURCE_COUNT;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Hilo de triggers
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @brief Estado del monitor: un fd por trigger más el extremo de lectura del pipe de parada.
+ */
+static struct
+{
+    bool running;
+    pthread_t thread;
+    int stop_pipe[2];
+    int count;
+    psi_trigger_t triggers[PSI_MAX_TRIGGERS];
+    char paths[PSI_MAX_TRIGGERS][PROCFS_PATH_MAX];
+    struct pollfd fds[PSI_MAX_TRIGGERS + 1];
+    psi_event_cb callback;
+} monitor;
+
+/**
+ * @brief Abre el archivo de presión y registra el umbral en el kernel.
+ * @return fd del trigger, o -1 si el kernel lo rechazó.
+ */
+static int register_trigger(const psi_trigger_t* trigger, const char* path)
+{
+    int fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+    {
+        log_error("Error al abrir %s para triggers: %m", path);
+        return -1;
+    }
+
+    // El kernel espera el texto con su terminador
+    char spec[64];
+    int len = snprintf(spec, sizeof(spec), "%s %u %u", trigger->full ? "full" : "some", trigger->stall_us,
+                       trigger->window_us);
+    if (write(fd, spec, (size_t)len + 1) < 0)
+    {
+        log_error("El kernel rechazó el trigger \"%s\" en %s: %m", spec, path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void* monitor_thread(void* arg)
+{
+    (void)arg;
+    realtime_enter_worker();
+    for (;;)
+    {
+        if (poll(monitor.fds, (nfds_t)monitor.count + 1, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            log_error("Error en poll de triggers PSI: %m");
+            break;
+        }
+        if (monitor.fds[monitor.count].revents != 0)
+        {
+            break; // Pedido de parada
+        }
+
+        for (int i = 0; i < monitor.count; i++)
+        {
+            short revents = monitor.fds[i].revents;
+            if (revents & POLLERR)
+            {
+                // El archivo dejó de existir (por ejemplo, se borró el cgroup): no se vigila más
+                log_warn("Trigger PSI sobre %s desactivado", monitor.paths[i]);
+                close(monitor.fds[i].fd);
+                monitor.fds[i].fd = -1;
+            }
+            else if (revents & POLLPRI)
+            {
+                psi_stats_t stats;
+                if (read_psi(monitor.paths[i], &stats) == 0)
+                {
+                    monitor.callback(&monitor.triggers[i], &stats);
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+int psi_monitor_start(const psi_trigger_t* triggers, int count, psi_event_cb callback)
+{
+    if (monitor.running || count <= 0)
+    {
+        return -1;
+    }
+    if (count > PSI_MAX_TRIGGERS)
+    {
+        count = PSI_MAX_TRIGGERS;
+    }
+
+    monitor.count = 0;
+    monitor.callback = callback;
+    for (int i = 0; i < count; i++)
+    {
+        char rel[32];
+        snprintf(rel, sizeof(rel), "pressure/%s", psi_resource_name(triggers[i].resource));
+        char* path = monitor.paths[monitor.count];
+        procfs_path(rel, path, PROCFS_PATH_MAX);
+
+        int fd = register_trigger(&triggers[i], path);
+        if (fd < 0)
+        {
+            continue;
+        }
+        monitor.triggers[monitor.count] = triggers[i];
+        monitor.fds[monitor.count].fd = fd;
+        monitor.fds[monitor.count].events = POLLPRI;
+        monitor.count++;
+    }
+    if (monitor.count == 0)
+    {
+        return -1;
+    }
+
+    if (pipe(monitor.stop_pipe) != 0)
+    {
+        log_error("Error al crear el pipe del monitor PSI: %m");
+        psi_monitor_stop();
+        return -1;
+    }
+    monitor.fds[monitor.count].fd = monitor.stop_pipe[0];
+    monitor.fds[monitor.count].events = POLLIN;
+
+    // Se puede reiniciar desde el colector: no hereda su prioridad ni (al arrancar el hilo) sus CPUs
+    pthread_attr_t attr;
+    realtime_worker_attr(&attr);
+    int created = pthread_create(&monitor.thread, &attr, monitor_thread, NULL);
+    pthread_attr_destroy(&attr);
+    if (created != 0)
+    {
+        log_error("Error al crear el hilo del monitor PSI");
+        close(monitor.stop_pipe[0]);
+        close(monitor.stop_pipe[1]);
+        monitor.fds[monitor.count].fd = -1;
+        psi_monitor_stop();
+        return -1;
+    }
+    monitor.running = true;
+    return 0;
+}
+
+void psi_monitor_stop(void)
+{
+    if (monitor.running)
+    {
+        char byte = 0;
+        if (write(monitor.stop_pipe[1], &byte, 1) < 0)
+        {
+            log_error("Error al detener el monitor PSI: %m");
+        }
+        pthread_join(monitor.thread, NULL);
+        close(monitor.stop_pipe[0]);
+        close(monitor.stop_pipe[1]);
+        monitor.running = false;
+    }
+
+    // Cerrar un trigger lo da de baja en el kernel
+    for (int i = 0; i < monitor.count; i++)
+    {
+        if (monitor.fds[i].fd >= 0)
+        {
+            close(monitor.fds[i].fd);
+        }
+    }
+    monitor.count = 0;
+}
@@ -0,0 +1,92 @@
+#include "quantile.h"
+#include <math.h>
+#include <string.h>
+
+void qsketch_init(qsketch_t* sketch, double relative_accuracy)
+{
+    double gamma = (1.0 + relative_accuracy) / (1.0 - relative_accuracy);
+    sketch->log_gamma = log(gamma);
+    sketch->min_key = (int)ceil(log(QSKETCH_MIN_VALUE) / sketch->log_gamma);
+    qsketch_reset(sketch);
+}
+
+void qsketch_reset(qsketch_t* sketch)
+{
+    sketch->count = 0;
+    sketch->zero_count = 0;
+    sketch->min = 0;
+    sketch->max = 0;
+    memset(sketch->buckets, 0, sizeof(sketch->buckets));
+}
+
+void qsketch_add(qsketch_t* sketch, double value)
+{
+    if (value < 0)
+    {
+        value = 0;
+    }
+    if (sketch->count == 0 || value < sketch->min)
+    {
+        sketch->min = value;
+    }
+    if (sketch->count == 0 || value > sketch->max)
+    {
+        sketch->max = value;
+    }
+    sketch->count++;
+
+    if (value < QSKETCH_MIN_VALUE)
+    {
+        sketch->zero_count++;
+        return;
+    }
+
+    // Los valores fuera de rango se acumulan en el último bucket; el máximo exacto los acota
+    int index = (int)ceil(log(value) / sketch->log_gamma) - sketch->min_key;
+    if (index < 0)
+    {
+        index = 0;
+    }
+    else if (index >= QSKETCH_BUCKETS)
+    {
+        index = QSKETCH_BUCKETS - 1;
+    }
+    sketch->buckets[index]++;
+}
+
+double qsketch_quantile(const qsketch_t* sketch, double q)
+{
+    if (sketch->count == 0)
+    {
+        return 0;
+    }
+    if (q <= 0)
+    {
+        return sketch->min;
+    }
+    if (q >= 1)
+    {
+        return sketch->max;
+    }
+
+    // Rango del valor buscado (base 0) dentro de los valores ordenados
+    uint64_t rank = (uint64_t)(q * (double)(sketch->count - 1));
+    if (rank < sketch->zero_count)
+    {
+        return sketch->min;
+    }
+
+    uint64_t seen = sketch->zero_count;
+    for (int i = 0; i < QSKETCH_BUCKETS; i++)
+    {
+        seen += sketch->buckets[i];
+        if (seen > rank)
+        {
+            // Punto medio (en error relativo) del bucket (gamma^(k-1), gamma^k]
+            double gamma = exp(sketch->log_gamma);
+            double value = 2.0 * exp((double)(i + sketch->min_key) * sketch->log_gamma) / (gamma + 1.0);
+            return value < sketch->min ? sketch->min : value > sketch->max ? sketch->max : value;
+        }
+    }
+    return sketch->max;
+}
@@ -0,0 +1,146 @@
+#include "rate.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief La serie recibió al menos una lectura desde que se reservó.
+ */
+#define RATE_SEEN 0x1
+
+/**
+ * @brief previous y previous_ms son válidos.
+ */
+#define RATE_HAVE_PREVIOUS 0x2
+
+/**
+ * @brief Agranda un arreglo del engine; el puntero original sigue siendo válido si falla.
+ */
+static int grow(void** array, int capacity, size_t element)
+{
+    void* grown = realloc(*array, (size_t)capacity * element);
+    if (grown == NULL)
+    {
+        return -1;
+    }
+    *array = grown;
+    return 0;
+}
+
+int rate_series_reserve(rate_engine_t* engine, int count, int width)
+{
+    if (count <= 0 || (width != 32 && width != 64))
+    {
+        return -1;
+    }
+    if (engine->count + count > engine->capacity)
+    {
+        int capacity = engine->capacity > 0 ? engine->capacity : 64;
+        while (capacity < engine->count + count)
+        {
+            capacity *= 2;
+        }
+        if (grow((void**)&engine->previous, capacity, sizeof(*engine->previous)) != 0 ||
+            grow((void**)&engine->previous_ms, capacity, sizeof(*engine->previous_ms)) != 0 ||
+            grow((void**)&engine->rate, capacity, sizeof(*engine->rate)) != 0 ||
+            grow((void**)&engine->width, capacity, sizeof(*engine->width)) != 0 ||
+            grow((void**)&engine->state, capacity, sizeof(*engine->state)) != 0)
+        {
+            return -1;
+        }
+        engine->capacity = capacity;
+    }
+
+    int first = engine->count;
+    for (int i = first; i < first + count; i++)
+    {
+        engine->previous[i] = 0;
+        engine->previous_ms[i] = 0;
+        engine->rate[i] = -1;
+        engine->width[i] = (uint8_t)width;
+        engine->state[i] = 0;
+    }
+    engine->count += count;
+    return first;
+}
+
+/**
+ * @brief Avance de un contador que retrocedió: la vuelta si es un desborde plausible, si no el valor actual.
+ */
+static uint64_t backwards_delta(uint64_t previous, uint64_t value, int width)
+{
+    if (width < 64)
+    {
+        uint64_t range = (uint64_t)1 << width;
+        uint64_t wrapped = range - previous + value;
+        if (previous < range && wrapped < range / 2)
+        {
+            return wrapped;
+        }
+    }
+    return value;
+}
+
+uint64_t rate_counter_delta(uint64_t previous, uint64_t value, int width)
+{
+    return value >= previous ? value - previous : backwards_delta(previous, value, width);
+}
+
+double rate_update(rate_engine_t* engine, int series, uint64_t value, int64_t now_ms, double* delta)
+{
+    uint8_t state = engine->state[series];
+    double advance = 0;
+    double rate = -1;
+
+    if (state & RATE_HAVE_PREVIOUS)
+    {
+        uint64_t previous = engine->previous[series];
+        uint64_t diff = rate_counter_delta(previous, value, engine->width[series]);
+        int64_t elapsed_ms = now_ms - engine->previous_ms[series];
+        advance = (double)diff;
+        if (elapsed_ms > 0)
+        {
+            rate = advance * 1000.0 / (double)elapsed_ms;
+        }
+    }
+    else if (!(state & RATE_SEEN))
+    {
+        advance = (double)value;
+    }
+
+    engine->previous[series] = value;
+    engine->previous_ms[series] = now_ms;
+    engine->rate[series] = rate;
+    engine->state[series] = RATE_SEEN | RATE_HAVE_PREVIOUS;
+    if (delta != NULL)
+    {
+        *delta = advance;
+    }
+    return rate;
+}
+
+void rate_forget(rate_engine_t* engine, int first, int count)
+{
+    for (int i = first; i < first + count && i < engine->count; i++)
+    {
+        engine->state[i] &= (uint8_t)~RATE_HAVE_PREVIOUS;
+        engine->rate[i] = -1;
+    }
+}
+
+void rate_engine_free(rate_engine_t* engine)
+{
+    free(engine->previous);
+    free(engine->previous_ms);
+    free(engine->rate);
+    free(engine->width);
+    free(engine->state);
+    memset(engine, 0, sizeof(*engine));
+}
+
+int64_t rate_now_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
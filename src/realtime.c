@@ -0,0 +1,228 @@
+#include "realtime.h"
+#include <errno.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @brief Bits por palabra de la máscara.
+ */
+#define WORD_BITS (8 * sizeof(unsigned long))
+
+// CPUs del proceso al arrancar, antes de fijar ningún hilo (vacío: no se guardaron)
+static realtime_cpuset_t startup_cpus;
+
+void realtime_config_defaults(realtime_config_t* config)
+{
+    memset(config, 0, sizeof(*config));
+    config->prefault_heap_kb = REALTIME_DEFAULT_HEAP_KB;
+    config->prefault_stack_kb = REALTIME_DEFAULT_STACK_KB;
+}
+
+bool realtime_config_active(const realtime_config_t* config)
+{
+    return config->collector_cpus.count > 0 || config->http_cpus.count > 0 || config->collector_priority > 0 ||
+           config->lock_memory;
+}
+
+static void cpuset_add(realtime_cpuset_t* set, int cpu)
+{
+    unsigned long bit = 1UL << (cpu % WORD_BITS);
+    if ((set->bits[cpu / WORD_BITS] & bit) == 0)
+    {
+        set->bits[cpu / WORD_BITS] |= bit;
+        set->count++;
+    }
+}
+
+static bool cpuset_has(const realtime_cpuset_t* set, int cpu)
+{
+    return (set->bits[cpu / WORD_BITS] >> (cpu % WORD_BITS)) & 1UL;
+}
+
+int realtime_parse_cpus(const char* list, realtime_cpuset_t* set, char* error, size_t error_len)
+{
+    memset(set, 0, sizeof(*set));
+    const char* p = list;
+    while (*p != '\0')
+    {
+        char* end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        if (end == p)
+        {
+            snprintf(error, error_len, "se esperaba un número de CPU en '%s'", p);
+            return -1;
+        }
+        if (*end == '-')
+        {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p)
+            {
+                snprintf(error, error_len, "rango sin final en '%s'", list);
+                return -1;
+            }
+        }
+        if (first < 0 || last < first || last >= REALTIME_MAX_CPUS)
+        {
+            snprintf(error, error_len, "rango %ld-%ld fuera de 0-%d", first, last, REALTIME_MAX_CPUS - 1);
+            return -1;
+        }
+        for (long cpu = first; cpu <= last; cpu++)
+        {
+            cpuset_add(set, (int)cpu);
+        }
+        if (*end != ',' && *end != '\0')
+        {
+            snprintf(error, error_len, "carácter inesperado '%c' en '%s'", *end, list);
+            return -1;
+        }
+        p = *end == ',' ? end + 1 : end;
+    }
+    if (set->count == 0)
+    {
+        snprintf(error, error_len, "lista de CPUs vacía");
+        return -1;
+    }
+    return 0;
+}
+
+void realtime_format_cpus(const realtime_cpuset_t* set, char* out, size_t len)
+{
+    size_t used = 0;
+    out[0] = '\0';
+    for (int cpu = 0; cpu < REALTIME_MAX_CPUS && used < len; cpu++)
+    {
+        if (!cpuset_has(set, cpu))
+        {
+            continue;
+        }
+        int last = cpu;
+        while (last + 1 < REALTIME_MAX_CPUS && cpuset_has(set, last + 1))
+        {
+            last++;
+        }
+        int n = last > cpu ? snprintf(out + used, len - used, "%s%d-%d", used > 0 ? "," : "", cpu, last)
+                           : snprintf(out + used, len - used, "%s%d", used > 0 ? "," : "", cpu);
+        used += n > 0 ? (size_t)n : 0;
+        cpu = last;
+    }
+}
+
+int realtime_pin_thread(const realtime_cpuset_t* set)
+{
+    if (set->count == 0)
+    {
+        return 0;
+    }
+    // pid 0 es el hilo que llama; la máscara tiene el formato del kernel
+    if (syscall(__NR_sched_setaffinity, 0, sizeof(set->bits), set->bits) != 0)
+    {
+        char cpus[128];
+        realtime_format_cpus(set, cpus, sizeof(cpus));
+        fprintf(stderr, "No se pudo fijar el hilo a las CPUs %s: %s\n", cpus, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Toca kb de pila por debajo del marco actual para que el crecimiento no falle de página en un tick.
+ */
+static void prefault_stack(int kb)
+{
+    volatile unsigned char stack[(size_t)kb * 1024];
+    long page = sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < sizeof(stack); i += (size_t)page)
+    {
+        stack[i] = 0;
+    }
+}
+
+int realtime_prepare_process(const realtime_config_t* config)
+{
+    long saved = syscall(__NR_sched_getaffinity, 0, sizeof(startup_cpus.bits), startup_cpus.bits);
+    startup_cpus.count = 0;
+    for (size_t i = 0; saved > 0 && i < sizeof(startup_cpus.bits) / sizeof(startup_cpus.bits[0]); i++)
+    {
+        startup_cpus.count += __builtin_popcountl(startup_cpus.bits[i]);
+    }
+
+    if (!config->lock_memory)
+    {
+        return 0;
+    }
+
+    // La memoria liberada queda en el heap (ya residente y bloqueada) en lugar de volver al sistema
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        fprintf(stderr, "No se pudo bloquear la memoria del proceso (mlockall): %s\n", strerror(errno));
+        return -1;
+    }
+
+    // Reserva de heap: se toca cada página y se libera, queda disponible para los colectores
+    size_t size = (size_t)config->prefault_heap_kb * 1024;
+    unsigned char* heap = size > 0 ? malloc(size) : NULL;
+    if (heap != NULL)
+    {
+        long page = sysconf(_SC_PAGESIZE);
+        for (size_t i = 0; i < size; i += (size_t)page)
+        {
+            heap[i] = 0;
+        }
+        free(heap);
+    }
+    return 0;
+}
+
+int realtime_enter_collector(const realtime_config_t* config)
+{
+    int rc = realtime_pin_thread(&config->collector_cpus);
+
+    if (config->lock_memory && config->prefault_stack_kb > 0)
+    {
+        prefault_stack(config->prefault_stack_kb);
+    }
+
+    if (config->collector_priority > 0)
+    {
+        int max = sched_get_priority_max(SCHED_FIFO);
+        struct sched_param param = {.sched_priority = config->collector_priority < max ? config->collector_priority
+                                                                                      : max};
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0)
+        {
+            fprintf(stderr, "No se pudo pasar el colector a SCHED_FIFO %d: %s\n", param.sched_priority,
+                    strerror(err));
+            rc = -1;
+        }
+    }
+    return rc;
+}
+
+void realtime_worker_attr(pthread_attr_t* attr)
+{
+    pthread_attr_init(attr);
+    struct sched_param param = {.sched_priority = 0};
+    if (pthread_attr_setinheritsched(attr, PTHREAD_EXPLICIT_SCHED) != 0 ||
+        pthread_attr_setschedpolicy(attr, SCHED_OTHER) != 0 || pthread_attr_setschedparam(attr, &param) != 0)
+    {
+        // Sin los atributos el hilo hereda la política de quien lo crea, como antes
+        pthread_attr_setinheritsched(attr, PTHREAD_INHERIT_SCHED);
+    }
+}
+
+void realtime_enter_worker(void)
+{
+    realtime_pin_thread(&startup_cpus);
+}
@@ -0,0 +1,137 @@
+#include "scheduler.h"
+#include <stddef.h>
+
+/**
+ * @brief Peso de la observación nueva en las medias móviles de referencia.
+ */
+#define BASELINE_ALPHA 0.2
+
+void adaptive_config_defaults(adaptive_config_t* config, int sampling_interval)
+{
+    config->enabled = false;
+    config->slow_interval_ms = (sampling_interval > 0 ? sampling_interval : 1) * 1000;
+    config->fast_interval_ms = 100;
+    config->calm_ms = 5000;
+    config->max_burst_ms = 60000;
+    config->cooldown_ms = 30000;
+    config->cpu_threshold = 80.0;
+    config->ctxt_rate_factor = 3.0;
+    config->procs_running_growth = 4;
+    config->hysteresis = 0.8;
+}
+
+void scheduler_init(scheduler_t* scheduler, const adaptive_config_t* config)
+{
+    scheduler->config = *config;
+    scheduler->burst = false;
+    scheduler->reason = NULL;
+    scheduler->burst_start_ms = 0;
+    scheduler->calm_since_ms = -1;
+    scheduler->cooldown_until_ms = 0;
+    scheduler->last_ms = -1;
+    scheduler->last_ctxt = -1;
+    scheduler->ctxt_rate_base = -1.0;
+    scheduler->procs_base = -1.0;
+    scheduler->bursts = 0;
+}
+
+int scheduler_interval_ms(const scheduler_t* scheduler)
+{
+    return scheduler->burst ? scheduler->config.fast_interval_ms : scheduler->config.slow_interval_ms;
+}
+
+static double update_baseline(double base, double value)
+{
+    return base < 0 ? value : base + BASELINE_ALPHA * (value - base);
+}
+
+int scheduler_update(scheduler_t* scheduler, const scheduler_signals_t* signals, int64_t now_ms)
+{
+    const adaptive_config_t* config = &scheduler->config;
+
+    // Tasa de cambios de contexto desde la observación anterior (se descarta si el contador retrocede)
+    double ctxt_rate = -1.0;
+    if (signals->context_switches >= 0 && scheduler->last_ctxt >= 0 && now_ms > scheduler->last_ms &&
+        signals->context_switches >= scheduler->last_ctxt)
+    {
+        ctxt_rate = (double)(signals->context_switches - scheduler->last_ctxt) * 1000.0 /
+                    (double)(now_ms - scheduler->last_ms);
+    }
+    scheduler->last_ms = now_ms;
+    scheduler->last_ctxt = signals->context_switches;
+
+    // trigger: condición que supera su umbral de entrada; hot: alguna señal sigue sobre su umbral de salida
+    const char* trigger = NULL;
+    bool hot = false;
+    if (config->cpu_threshold > 0 && signals->cpu_usage >= 0)
+    {
+        if (signals->cpu_usage >= config->cpu_threshold)
+        {
+            trigger = "cpu";
+        }
+        hot |= signals->cpu_usage >= config->cpu_threshold * config->hysteresis;
+    }
+    if (config->ctxt_rate_factor > 0 && ctxt_rate >= 0 && scheduler->ctxt_rate_base > 0)
+    {
+        double level = scheduler->ctxt_rate_base * config->ctxt_rate_factor;
+        if (ctxt_rate >= level && trigger == NULL)
+        {
+            trigger = "context_switches";
+        }
+        hot |= ctxt_rate >= level * config->hysteresis;
+    }
+    if (config->procs_running_growth > 0 && signals->running_processes >= 0 && scheduler->procs_base >= 0)
+    {
+        double excess = (double)signals->running_processes - scheduler->procs_base;
+        if (excess >= config->procs_running_growth && trigger == NULL)
+        {
+            trigger = "procs_running";
+        }
+        hot |= excess >= config->procs_running_growth * config->hysteresis;
+    }
+
+    if (!scheduler->burst)
+    {
+        // Las referencias solo aprenden del régimen estable, para que un pico no se normalice a sí mismo
+        if (trigger == NULL)
+        {
+            if (ctxt_rate >= 0)
+            {
+                scheduler->ctxt_rate_base = update_baseline(scheduler->ctxt_rate_base, ctxt_rate);
+            }
+            if (signals->running_processes >= 0)
+            {
+                scheduler->procs_base = update_baseline(scheduler->procs_base, signals->running_processes);
+            }
+        }
+        else if (now_ms >= scheduler->cooldown_until_ms)
+        {
+            scheduler->burst = true;
+            scheduler->reason = trigger;
+            scheduler->burst_start_ms = now_ms;
+            scheduler->calm_since_ms = -1;
+            scheduler->bursts++;
+        }
+        return scheduler_interval_ms(scheduler);
+    }
+
+    if (trigger != NULL || hot)
+    {
+        scheduler->calm_since_ms = -1;
+    }
+    else if (scheduler->calm_since_ms < 0)
+    {
+        scheduler->calm_since_ms = now_ms;
+    }
+
+    if (scheduler->calm_since_ms >= 0 && now_ms - scheduler->calm_since_ms >= config->calm_ms)
+    {
+        scheduler->burst = false;
+    }
+    else if (now_ms - scheduler->burst_start_ms >= config->max_burst_ms)
+    {
+        scheduler->burst = false;
+        scheduler->cooldown_until_ms = now_ms + config->cooldown_ms;
+    }
+    return scheduler_interval_ms(scheduler);
+}
@@ -0,0 +1,691 @@
+#include "segregated_alloc.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/*
+ * La memoria se pide al sistema en superbloques de 1 MB alineados a 1 MB, de modo que
+ * (ptr & ~(SUPER_SIZE - 1)) lleva al encabezado del superbloque que contiene cualquier puntero:
+ *
+ *  - SUPER_SMALL: 16 slabs de 64 kB; el primero aloja el encabezado y los demás se asignan a
+ *    una clase de tamaño y se cortan en slots iguales, sin encabezado por bloque.
+ *  - SUPER_LARGE: un heap con etiquetas de frontera (prev_size, size) para bloques grandes.
+ *  - SUPER_HUGE: un único bloque mayor que un superbloque, mapeado y liberado con munmap.
+ */
+
+#define SUPER_SIZE ((size_t)1 << 20)
+#define SLAB_SIZE ((size_t)1 << 16)
+#define SLABS_PER_SUPER (SUPER_SIZE / SLAB_SIZE)
+#define SUPER_HEADER 64
+#define SUPER_MAGIC 0x53454746u // "SEGF"
+
+enum
+{
+    SUPER_SMALL,
+    SUPER_LARGE,
+    SUPER_HUGE
+};
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t kind;
+    size_t size;                              /**< Bytes mapeados (solo SUPER_HUGE). */
+    uint8_t slab_class[SLABS_PER_SUPER];      /**< Clase asignada a cada slab (solo SUPER_SMALL). */
+} super_t;
+
+_Static_assert(sizeof(super_t) <= SUPER_HEADER, "el encabezado del superbloque no entra en SUPER_HEADER");
+
+// Clases de tamaño: de 16 en 16 hasta 256 bytes y luego 4 subclases por potencia de dos hasta SEG_MAX_SMALL
+#define SMALL_STEP_CLASSES 16
+#define CLASS_COUNT (SMALL_STEP_CLASSES + 4 * 7)
+
+_Static_assert(SEG_MAX_SMALL == 32768, "la tabla de clases asume SEG_MAX_SMALL = 32 kB");
+
+/**
+ * @brief Clase de tamaño de un pedido, en O(1).
+ */
+static inline unsigned size_class(size_t size)
+{
+    if (size <= 256)
+    {
+        return (unsigned)((size - 1) >> 4);
+    }
+    unsigned k = 63u - (unsigned)__builtin_clzll((unsigned long long)(size - 1)); // 2^k < size <= 2^(k+1)
+    unsigned sub = (unsigned)((size - 1) >> (k - 2)) & 3u;
+    return SMALL_STEP_CLASSES + (k - 8) * 4 + sub;
+}
+
+/**
+ * @brief Tamaño de slot de una clase.
+ */
+static inline size_t class_size(unsigned c)
+{
+    if (c < SMALL_STEP_CLASSES)
+    {
+        return ((size_t)c + 1) << 4;
+    }
+    unsigned k = (c - SMALL_STEP_CLASSES) / 4 + 8;
+    unsigned sub = (c - SMALL_STEP_CLASSES) % 4;
+    return ((size_t)1 << k) + ((size_t)(sub + 1) << (k - 2));
+}
+
+/**
+ * @brief Slots que un hilo toma o devuelve de una vez al depósito global.
+ */
+static inline uint32_t class_batch(unsigned c)
+{
+    size_t n = 16384 / class_size(c);
+    return n < 4 ? 4 : (n > 64 ? 64 : (uint32_t)n);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Estado global
+// ---------------------------------------------------------------------------------------------
+
+typedef struct seg_tcache
+{
+    void* head[CLASS_COUNT];
+    uint32_t count[CLASS_COUNT];
+    size_t cached_bytes;     /**< Bytes en las listas locales; lo leen las estadísticas sin lock. */
+    bool registered;
+    struct seg_tcache* next; /**< Lista de caches vivos, protegida por small_lock. */
+} seg_tcache_t;
+
+static __thread seg_tcache_t tcache;
+
+static pthread_mutex_t small_lock = PTHREAD_MUTEX_INITIALIZER;
+static void* depot_head[CLASS_COUNT];     // Slots libres por clase compartidos entre hilos
+static void* free_slabs;                  // Slabs sin clase asignada, enlazados por su primera palabra
+static size_t free_slab_count;
+static size_t small_slot_bytes;           // Bytes en slots de todos los slabs cortados
+static size_t depot_bytes;
+static seg_tcache_t* tcaches;
+
+static pthread_once_t tcache_once = PTHREAD_ONCE_INIT;
+static pthread_key_t tcache_key;
+
+static pthread_mutex_t large_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t mapped_bytes;               // Lo actualizan ambos heaps: solo con operaciones atómicas
+static size_t large_in_use;
+static size_t large_free;
+static int large_supers;
+
+// ---------------------------------------------------------------------------------------------
+// Superbloques
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @brief Mapea size bytes alineados a SUPER_SIZE recortando el excedente.
+ */
+static void* map_aligned(size_t size)
+{
+    uint8_t* raw = mmap(NULL, size + SUPER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+    {
+        return NULL;
+    }
+    uint8_t* base = (uint8_t*)(((uintptr_t)raw + SUPER_SIZE - 1) & ~(uintptr_t)(SUPER_SIZE - 1));
+    if (base > raw)
+    {
+        munmap(raw, (size_t)(base - raw));
+    }
+    size_t tail = (size_t)(raw + size + SUPER_SIZE - (base + size));
+    if (tail > 0)
+    {
+        munmap(base + size, tail);
+    }
+    return base;
+}
+
+static inline super_t* super_of(const void* ptr)
+{
+    return (super_t*)((uintptr_t)ptr & ~(uintptr_t)(SUPER_SIZE - 1));
+}
+
+// ---------------------------------------------------------------------------------------------
+// Bloques chicos: caches por hilo y depósito por clase
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @brief Corta un slab libre en slots de la clase c y los agrega al depósito. Requiere small_lock.
+ */
+static bool carve_slab(unsigned c)
+{
+    if (free_slabs == NULL)
+    {
+        super_t* super = map_aligned(SUPER_SIZE);
+        if (super == NULL)
+        {
+            return false;
+        }
+        super->magic = SUPER_MAGIC;
+        super->kind = SUPER_SMALL;
+        __atomic_add_fetch(&mapped_bytes, SUPER_SIZE, __ATOMIC_RELAXED);
+        for (size_t i = SLABS_PER_SUPER - 1; i >= 1; i--) // El slab 0 aloja el encabezado
+        {
+            void* slab = (uint8_t*)super + i * SLAB_SIZE;
+            *(void**)slab = free_slabs;
+            free_slabs = slab;
+            free_slab_count++;
+        }
+    }
+
+    uint8_t* slab = free_slabs;
+    free_slabs = *(void**)slab;
+    free_slab_count--;
+
+    super_t* super = super_of(slab);
+    super->slab_class[((uintptr_t)slab - (uintptr_t)super) / SLAB_SIZE] = (uint8_t)c;
+
+    size_t size = class_size(c);
+    size_t slots = SLAB_SIZE / size;
+    for (size_t i = slots; i > 0; i--)
+    {
+        void* slot = slab + (i - 1) * size;
+        *(void**)slot = depot_head[c];
+        depot_head[c] = slot;
+    }
+    depot_bytes += slots * size;
+    small_slot_bytes += slots * size;
+    return true;
+}
+
+/**
+ * @brief Devuelve hasta n slots de la lista local de la clase c al depósito. Requiere small_lock.
+ */
+static void flush_locked(seg_tcache_t* cache, unsigned c, uint32_t n)
+{
+    size_t size = class_size(c);
+    while (n-- > 0 && cache->head[c] != NULL)
+    {
+        void* slot = cache->head[c];
+        cache->head[c] = *(void**)slot;
+        cache->count[c]--;
+        *(void**)slot = depot_head[c];
+        depot_head[c] = slot;
+        depot_bytes += size;
+        __atomic_store_n(&cache->cached_bytes, cache->cached_bytes - size, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Al terminar un hilo su cache vuelve completo al depósito.
+ */
+static void tcache_destroy(void* arg)
+{
+    seg_tcache_t* cache = arg;
+    pthread_mutex_lock(&small_lock);
+    for (unsigned c = 0; c < CLASS_COUNT; c++)
+    {
+        flush_locked(cache, c, UINT32_MAX);
+    }
+    for (seg_tcache_t** p = &tcaches; *p != NULL; p = &(*p)->next)
+    {
+        if (*p == cache)
+        {
+            *p = cache->next;
+            break;
+        }
+    }
+    cache->registered = false;
+    pthread_mutex_unlock(&small_lock);
+}
+
+static void tcache_key_create(void)
+{
+    pthread_key_create(&tcache_key, tcache_destroy);
+}
+
+/**
+ * @brief Llena la lista local de la clase c desde el depósito, cortando un slab nuevo si hace falta.
+ */
+static bool refill(seg_tcache_t* cache, unsigned c)
+{
+    if (!cache->registered)
+    {
+        pthread_once(&tcache_once, tcache_key_create);
+        pthread_setspecific(tcache_key, cache);
+    }
+
+    size_t size = class_size(c);
+    uint32_t batch = class_batch(c);
+    uint32_t moved = 0;
+
+    pthread_mutex_lock(&small_lock);
+    if (!cache->registered)
+    {
+        cache->next = tcaches;
+        tcaches = cache;
+        cache->registered = true;
+    }
+    while (moved < batch)
+    {
+        if (depot_head[c] == NULL && (moved > 0 || !carve_slab(c)))
+        {
+            break;
+        }
+        void* slot = depot_head[c];
+        depot_head[c] = *(void**)slot;
+        *(void**)slot = cache->head[c];
+        cache->head[c] = slot;
+        moved++;
+    }
+    depot_bytes -= moved * size;
+    pthread_mutex_unlock(&small_lock);
+
+    cache->count[c] += moved;
+    __atomic_store_n(&cache->cached_bytes, cache->cached_bytes + moved * size, __ATOMIC_RELAXED);
+    return moved > 0;
+}
+
+static void* small_malloc(size_t size)
+{
+    unsigned c = size_class(size);
+    seg_tcache_t* cache = &tcache;
+    if (cache->head[c] == NULL && !refill(cache, c))
+    {
+        return NULL;
+    }
+    void* slot = cache->head[c];
+    cache->head[c] = *(void**)slot;
+    cache->count[c]--;
+    __atomic_store_n(&cache->cached_bytes, cache->cached_bytes - class_size(c), __ATOMIC_RELAXED);
+    return slot;
+}
+
+static void small_free(super_t* super, void* ptr)
+{
+    unsigned c = super->slab_class[((uintptr_t)ptr - (uintptr_t)super) / SLAB_SIZE];
+    seg_tcache_t* cache = &tcache;
+    *(void**)ptr = cache->head[c];
+    cache->head[c] = ptr;
+    cache->count[c]++;
+    __atomic_store_n(&cache->cached_bytes, cache->cached_bytes + class_size(c), __ATOMIC_RELAXED);
+
+    // Un hilo que solo libera (productor/consumidor) no debe acumular slots sin límite
+    uint32_t batch = class_batch(c);
+    if (cache->count[c] > 2 * batch)
+    {
+        pthread_mutex_lock(&small_lock);
+        flush_locked(cache, c, batch);
+        pthread_mutex_unlock(&small_lock);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// Bloques grandes: etiquetas de frontera y listas libres por potencia de dos
+// ---------------------------------------------------------------------------------------------
+
+typedef struct block
+{
+    size_t prev_size;   /**< Tamaño del bloque anterior; válido solo si está libre. */
+    size_t size;        /**< Tamaño con encabezado, múltiplo de 16, más los bits IN_USE y PREV_IN_USE. */
+    struct block* next; /**< Enlaces de la lista libre (solo bloques libres). */
+    struct block* prev;
+} block_t;
+
+#define BLOCK_HEADER 16
+#define IN_USE ((size_t)1)
+#define PREV_IN_USE ((size_t)2)
+#define SIZE_MASK (~(size_t)15)
+#define MIN_SPLIT 64
+#define BIN_SHIFT 5 // El bin 0 contiene bloques de 32 a 63 bytes
+#define BIN_COUNT 16
+#define LARGE_FIRST SUPER_HEADER
+#define LARGE_SPAN (SUPER_SIZE - SUPER_HEADER - BLOCK_HEADER) // Deja lugar para el centinela final
+
+static block_t* bins[BIN_COUNT];
+static uint32_t bin_map; // Bit i encendido si bins[i] no está vacío
+
+static inline size_t block_size(const block_t* b)
+{
+    return b->size & SIZE_MASK;
+}
+
+static inline block_t* block_next(block_t* b)
+{
+    return (block_t*)((uint8_t*)b + block_size(b));
+}
+
+static inline unsigned bin_floor(size_t size)
+{
+    unsigned k = 63u - (unsigned)__builtin_clzll((unsigned long long)size) - BIN_SHIFT;
+    return k >= BIN_COUNT ? BIN_COUNT - 1 : k;
+}
+
+static void bin_insert(block_t* b)
+{
+    unsigned i = bin_floor(block_size(b));
+    b->prev = NULL;
+    b->next = bins[i];
+    if (bins[i] != NULL)
+    {
+        bins[i]->prev = b;
+    }
+    bins[i] = b;
+    bin_map |= 1u << i;
+}
+
+static void bin_remove(block_t* b)
+{
+    unsigned i = bin_floor(block_size(b));
+    if (b->prev != NULL)
+    {
+        b->prev->next = b->next;
+    }
+    else
+    {
+        bins[i] = b->next;
+    }
+    if (b->next != NULL)
+    {
+        b->next->prev = b->prev;
+    }
+    if (bins[i] == NULL)
+    {
+        bin_map &= ~(1u << i);
+    }
+}
+
+/**
+ * @brief Marca un bloque libre, actualiza la etiqueta del siguiente y lo agrega a su bin.
+ */
+static void mark_free(block_t* b, size_t size)
+{
+    b->size = size | (b->size & PREV_IN_USE);
+    block_t* next = block_next(b);
+    next->prev_size = size;
+    next->size &= ~PREV_IN_USE;
+    bin_insert(b);
+}
+
+/**
+ * @brief Agrega un superbloque nuevo al heap de bloques grandes. Requiere large_lock.
+ */
+static bool large_grow(void)
+{
+    super_t* super = map_aligned(SUPER_SIZE);
+    if (super == NULL)
+    {
+        return false;
+    }
+    super->magic = SUPER_MAGIC;
+    super->kind = SUPER_LARGE;
+    __atomic_add_fetch(&mapped_bytes, SUPER_SIZE, __ATOMIC_RELAXED);
+    large_supers++;
+
+    block_t* b = (block_t*)((uint8_t*)super + LARGE_FIRST);
+    b->size = PREV_IN_USE;
+    block_t* sentinel = (block_t*)((uint8_t*)b + LARGE_SPAN);
+    sentinel->size = IN_USE; // Tamaño 0 y en uso: la fusión nunca lo atraviesa
+    mark_free(b, LARGE_SPAN);
+    large_free += LARGE_SPAN;
+    return true;
+}
+
+/**
+ * @brief Busca un bloque libre de al menos need bytes. Requiere large_lock.
+ */
+static block_t* large_find(size_t need)
+{
+    // Cualquier bloque de un bin con piso >= need sirve: se toma el primero, en O(1)
+    unsigned floor_bin = bin_floor(need);
+    unsigned first = (need & (need - 1)) == 0 ? floor_bin : floor_bin + 1;
+    uint32_t mask = first < BIN_COUNT ? bin_map & (~0u << first) : 0;
+    if (mask != 0)
+    {
+        return bins[__builtin_ctz(mask)];
+    }
+    // Si no, los bloques del bin de need pueden alcanzar o no: primer ajuste dentro del bin
+    for (block_t* b = bins[floor_bin]; b != NULL; b = b->next)
+    {
+        if (block_size(b) >= need)
+        {
+            return b;
+        }
+    }
+    return NULL;
+}
+
+static void* large_malloc(size_t size)
+{
+    size_t need = (size + BLOCK_HEADER + 15) & SIZE_MASK;
+
+    pthread_mutex_lock(&large_lock);
+    block_t* b = large_find(need);
+    if (b == NULL && large_grow())
+    {
+        b = large_find(need);
+    }
+    if (b == NULL)
+    {
+        pthread_mutex_unlock(&large_lock);
+        return NULL;
+    }
+
+    bin_remove(b);
+    size_t have = block_size(b);
+    large_free -= have;
+    if (have - need >= MIN_SPLIT)
+    {
+        block_t* rest = (block_t*)((uint8_t*)b + need);
+        rest->size = PREV_IN_USE;
+        mark_free(rest, have - need);
+        large_free += have - need;
+        have = need;
+    }
+    b->size = have | IN_USE | (b->size & PREV_IN_USE);
+    block_next(b)->size |= PREV_IN_USE;
+    large_in_use += have;
+    pthread_mutex_unlock(&large_lock);
+
+    return (uint8_t*)b + BLOCK_HEADER;
+}
+
+static void large_free_block(super_t* super, void* ptr)
+{
+    block_t* b = (block_t*)((uint8_t*)ptr - BLOCK_HEADER);
+
+    pthread_mutex_lock(&large_lock);
+    size_t size = block_size(b);
+    large_in_use -= size;
+
+    block_t* next = block_next(b);
+    if (!(next->size & IN_USE))
+    {
+        bin_remove(next);
+        size += block_size(next);
+        large_free -= block_size(next);
+    }
+    if (!(b->size & PREV_IN_USE))
+    {
+        block_t* prev = (block_t*)((uint8_t*)b - b->prev_size);
+        bin_remove(prev);
+        size += block_size(prev);
+        large_free -= block_size(prev);
+        b = prev;
+    }
+
+    if (size == LARGE_SPAN && large_supers > 1)
+    {
+        // Superbloque vacío: se devuelve al sistema conservando siempre uno
+        large_supers--;
+        __atomic_sub_fetch(&mapped_bytes, SUPER_SIZE, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&large_lock);
+        munmap(super, SUPER_SIZE);
+        return;
+    }
+    b->size &= ~IN_USE;
+    mark_free(b, size);
+    large_free += size;
+    pthread_mutex_unlock(&large_lock);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Bloques enormes: un mapeo propio
+// ---------------------------------------------------------------------------------------------
+
+static void* huge_malloc(size_t size)
+{
+    if (size > SIZE_MAX - SUPER_HEADER - SUPER_SIZE)
+    {
+        return NULL;
+    }
+    size_t length = (size + SUPER_HEADER + 4095) & ~(size_t)4095;
+    super_t* super = map_aligned(length);
+    if (super == NULL)
+    {
+        return NULL;
+    }
+    super->magic = SUPER_MAGIC;
+    super->kind = SUPER_HUGE;
+    super->size = length;
+    __atomic_add_fetch(&mapped_bytes, length, __ATOMIC_RELAXED);
+    return (uint8_t*)super + SUPER_HEADER;
+}
+
+// ---------------------------------------------------------------------------------------------
+// API pública
+// ---------------------------------------------------------------------------------------------
+
+void* seg_malloc(size_t size)
+{
+    if (size == 0)
+    {
+        size = 1;
+    }
+    if (size <= SEG_MAX_SMALL)
+    {
+        return small_malloc(size);
+    }
+    if (size <= LARGE_SPAN - BLOCK_HEADER)
+    {
+        return large_malloc(size);
+    }
+    return huge_malloc(size);
+}
+
+void seg_free(void* ptr)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+    super_t* super = super_of(ptr);
+    switch (super->kind)
+    {
+    case SUPER_SMALL:
+        small_free(super, ptr);
+        break;
+    case SUPER_LARGE:
+        large_free_block(super, ptr);
+        break;
+    default:
+        __atomic_sub_fetch(&mapped_bytes, super->size, __ATOMIC_RELAXED);
+        munmap(super, super->size);
+        break;
+    }
+}
+
+void* seg_calloc(size_t count, size_t size)
+{
+    if (size != 0 && count > SIZE_MAX / size)
+    {
+        return NULL;
+    }
+    void* ptr = seg_malloc(count * size);
+    if (ptr != NULL)
+    {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+/**
+ * @brief Bytes utilizables de un bloque reservado.
+ */
+static size_t usable_size(void* ptr)
+{
+    super_t* super = super_of(ptr);
+    switch (super->kind)
+    {
+    case SUPER_SMALL:
+        return class_size(super->slab_class[((uintptr_t)ptr - (uintptr_t)super) / SLAB_SIZE]);
+    case SUPER_LARGE:
+        return block_size((block_t*)((uint8_t*)ptr - BLOCK_HEADER)) - BLOCK_HEADER;
+    default:
+        return super->size - SUPER_HEADER;
+    }
+}
+
+void* seg_realloc(void* ptr, size_t size)
+{
+    if (ptr == NULL)
+    {
+        return seg_malloc(size);
+    }
+    if (size == 0)
+    {
+        seg_free(ptr);
+        return NULL;
+    }
+
+    size_t old = usable_size(ptr);
+    if (size <= old && (size > SEG_MAX_SMALL || old <= SEG_MAX_SMALL))
+    {
+        return ptr; // Sigue entrando en el mismo bloque y de la misma categoría
+    }
+    void* fresh = seg_malloc(size);
+    if (fresh != NULL)
+    {
+        memcpy(fresh, ptr, old < size ? old : size);
+        seg_free(ptr);
+    }
+    return fresh;
+}
+
+void seg_get_stats(seg_stats_t* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+    pthread_mutex_lock(&small_lock);
+    size_t cached = 0;
+    for (seg_tcache_t* cache = tcaches; cache != NULL; cache = cache->next)
+    {
+        cached += __atomic_load_n(&cache->cached_bytes, __ATOMIC_RELAXED);
+    }
+    stats->small_free = depot_bytes + cached + free_slab_count * SLAB_SIZE;
+    stats->small_in_use = small_slot_bytes - depot_bytes - cached;
+    pthread_mutex_unlock(&small_lock);
+
+    pthread_mutex_lock(&large_lock);
+    stats->mapped_bytes = __atomic_load_n(&mapped_bytes, __ATOMIC_RELAXED);
+    stats->large_in_use = large_in_use;
+    stats->large_free = large_free;
+    if (bin_map != 0)
+    {
+        // El mayor bloque libre está en el bin no vacío más alto
+        for (block_t* b = bins[31 - __builtin_clz(bin_map)]; b != NULL; b = b->next)
+        {
+            if (block_size(b) > stats->largest_free)
+            {
+                stats->largest_free = block_size(b);
+            }
+        }
+    }
+    pthread_mutex_unlock(&large_lock);
+}
+
+double seg_fragmentation(void)
+{
+    seg_stats_t stats;
+    seg_get_stats(&stats);
+    if (stats.large_free == 0)
+    {
+        return 0.0;
+    }
+    return (1.0 - (double)stats.largest_free / (double)stats.large_free) * 100.0;
+}
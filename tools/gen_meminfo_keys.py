@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""Genera src/meminfo_keys.h: hash perfecto de las claves de /proc/meminfo y /proc/vmstat.
+
+Cada clave se resume con FNV-1a de 64 bits; se busca un multiplicador tal que los bits
+altos de (hash * multiplicador) asignen un slot distinto a cada clave conocida. La tabla
+guarda el hash completo de cada slot, de modo que el parser valida la clave comparando
+un entero y nunca compara strings. Una clave desconocida (kernel más nuevo) cae en un
+slot vacío o con otro hash y se ignora.
+
+Uso: gen_meminfo_keys.py [salida]   (por defecto src/meminfo_keys.h)
+"""
+
+import os
+import random
+import sys
+
+# (nombre, unidad) en el orden en que las expone un kernel 6.x. "kB" se exporta en bytes.
+MEMINFO_FIELDS = [
+    ("MemTotal", "kB"), ("MemFree", "kB"), ("MemAvailable", "kB"), ("Buffers", "kB"), ("Cached", "kB"),
+    ("SwapCached", "kB"), ("Active", "kB"), ("Inactive", "kB"), ("Active(anon)", "kB"),
+    ("Inactive(anon)", "kB"), ("Active(file)", "kB"), ("Inactive(file)", "kB"), ("Unevictable", "kB"),
+    ("Mlocked", "kB"), ("HighTotal", "kB"), ("HighFree", "kB"), ("LowTotal", "kB"), ("LowFree", "kB"),
+    ("MmapCopy", "kB"), ("SwapTotal", "kB"), ("SwapFree", "kB"), ("Zswap", "kB"), ("Zswapped", "kB"),
+    ("Dirty", "kB"), ("Writeback", "kB"), ("AnonPages", "kB"), ("Mapped", "kB"), ("Shmem", "kB"),
+    ("KReclaimable", "kB"), ("Slab", "kB"), ("SReclaimable", "kB"), ("SUnreclaim", "kB"),
+    ("KernelStack", "kB"), ("ShadowCallStack", "kB"), ("PageTables", "kB"), ("SecPageTables", "kB"),
+    ("NFS_Unstable", "kB"), ("Bounce", "kB"), ("WritebackTmp", "kB"), ("CommitLimit", "kB"),
+    ("Committed_AS", "kB"), ("VmallocTotal", "kB"), ("VmallocUsed", "kB"), ("VmallocChunk", "kB"),
+    ("Percpu", "kB"), ("HardwareCorrupted", "kB"), ("AnonHugePages", "kB"), ("ShmemHugePages", "kB"),
+    ("ShmemPmdMapped", "kB"), ("FileHugePages", "kB"), ("FilePmdMapped", "kB"), ("CmaTotal", "kB"),
+    ("CmaFree", "kB"), ("Unaccepted", "kB"), ("Balloon", "kB"), ("HugePages_Total", ""), ("HugePages_Free", ""),
+    ("HugePages_Rsvd", ""), ("HugePages_Surp", ""), ("Hugepagesize", "kB"), ("Hugetlb", "kB"),
+    ("DirectMap4k", "kB"), ("DirectMap2M", "kB"), ("DirectMap4M", "kB"), ("DirectMap1G", "kB"),
+]
+
+# Contadores acumulados de /proc/vmstat que se exportan con su tasa por segundo.
+VMSTAT_FIELDS = [
+    "pgpgin", "pgpgout", "pswpin", "pswpout", "pgfault", "pgmajfault", "pgscan_kswapd", "pgscan_direct",
+    "pgsteal_kswapd", "pgsteal_direct", "allocstall_normal", "allocstall_movable", "compact_stall",
+    "compact_fail", "compact_success", "thp_fault_alloc", "thp_fault_fallback", "oom_kill",
+    "workingset_refault_anon", "workingset_refault_file",
+]
+
+
+def fnv1a(s):
+    h = 0xCBF29CE484222325
+    for c in s.encode():
+        h ^= c
+        h = (h * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+
+def find_seed(names, bits):
+    rng = random.Random(29)
+    hashes = [fnv1a(n) for n in names]
+    for _ in range(1_000_000):
+        seed = rng.getrandbits(64) | 1
+        slots = {((h * seed) & 0xFFFFFFFFFFFFFFFF) >> (64 - bits) for h in hashes}
+        if len(slots) == len(names):
+            return seed
+    raise SystemExit("no se encontró multiplicador para %d bits" % bits)
+
+
+def emit_table(out, prefix, names, bits):
+    seed = find_seed(names, bits)
+    size = 1 << bits
+    hashes = [0] * size
+    fields = [-1] * size
+    for i, n in enumerate(names):
+        h = fnv1a(n)
+        slot = ((h * seed) & 0xFFFFFFFFFFFFFFFF) >> (64 - bits)
+        hashes[slot] = h
+        fields[slot] = i
+    up = prefix.upper()
+    out.append("#define %s_HASH_BITS %d" % (up, bits))
+    out.append("#define %s_HASH_SEED 0x%016XULL" % (up, seed))
+    out.append("")
+    out.append("/** Hash FNV-1a completo de la clave alojada en cada slot (0 si está vacío). */")
+    out.append("static const uint64_t %s_slot_hash[1 << %s_HASH_BITS] = {" % (prefix, up))
+    for i in range(0, size, 3):
+        out.append("    " + " ".join("0x%016XULL," % h for h in hashes[i:i + 3]))
+    out.append("};")
+    out.append("")
+    out.append("/** Campo alojado en cada slot, o -1. */")
+    out.append("static const signed char %s_slot_field[1 << %s_HASH_BITS] = {" % (prefix, up))
+    for i in range(0, size, 16):
+        out.append("    " + " ".join("%d," % f for f in fields[i:i + 16]))
+    out.append("};")
+    out.append("")
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    dest = sys.argv[1] if len(sys.argv) > 1 else os.path.join(here, "..", "src", "meminfo_keys.h")
+
+    out = [
+        "/**",
+        " * @file meminfo_keys.h",
+        " * @brief Tablas de hash perfecto para las claves de /proc/meminfo y /proc/vmstat.",
+        " *",
+        " * ARCHIVO GENERADO por tools/gen_meminfo_keys.py; no editar a mano.",
+        " */",
+        "",
+        "#ifndef MEMINFO_KEYS_H",
+        "#define MEMINFO_KEYS_H",
+        "",
+        "#include <stdint.h>",
+        "",
+        "/** Cantidad de campos de /proc/meminfo con slot fijo. */",
+        "#define MEMINFO_FIELD_COUNT %d" % len(MEMINFO_FIELDS),
+        "/** Cantidad de contadores de /proc/vmstat con slot fijo. */",
+        "#define VMSTAT_FIELD_COUNT %d" % len(VMSTAT_FIELDS),
+        "",
+        "/** Nombre de cada campo de /proc/meminfo. */",
+        "static const char* const meminfo_field_names[MEMINFO_FIELD_COUNT] = {",
+    ]
+    out += ['    "%s",' % n for n, _ in MEMINFO_FIELDS]
+    out += ["};", "", "/** true si el campo está en kB (se exporta en bytes); false si es una cantidad. */",
+            "static const unsigned char meminfo_field_is_kb[MEMINFO_FIELD_COUNT] = {"]
+    flags = ["1," if u == "kB" else "0," for _, u in MEMINFO_FIELDS]
+    for i in range(0, len(flags), 16):
+        out.append("    " + " ".join(flags[i:i + 16]))
+    out += ["};", "", "/** Nombre de cada contador de /proc/vmstat. */",
+            "static const char* const vmstat_field_names[VMSTAT_FIELD_COUNT] = {"]
+    out += ['    "%s",' % n for n in VMSTAT_FIELDS]
+    out += ["};", ""]
+
+    emit_table(out, "meminfo", [n for n, _ in MEMINFO_FIELDS], 8)
+    emit_table(out, "vmstat", VMSTAT_FIELDS, 6)
+
+    out.append("#endif // MEMINFO_KEYS_H")
+    with open(dest, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
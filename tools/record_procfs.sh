@@ -0,0 +1,39 @@
+#!/bin/sh
+# Graba snapshots de /proc y /sys para reproducirlos con "replay_dir" en config.json.
+#
+# Uso: record_procfs.sh <directorio_destino> [intervalo_segundos] [cantidad]
+#
+# Cada snapshot queda en <destino>/<timestamp_ms>/proc/... y <destino>/<timestamp_ms>/sys/...
+#
+# Los archivos a grabar salen de la columna de fuentes de include/collector_list.h (se puede
+# indicar otra lista con COLLECTOR_LIST), así que un colector nuevo se graba sin tocar este script.
+
+set -eu
+
+DEST=${1:?"Uso: $0 <directorio_destino> [intervalo_segundos] [cantidad]"}
+INTERVAL=${2:-1}
+COUNT=${3:-60}
+COLLECTOR_LIST=${COLLECTOR_LIST:-$(dirname "$0")/../include/collector_list.h}
+
+# Archivos que leen los colectores: los literales "proc/..." y "sys/..." de la lista, sin repetir
+SOURCES=$(grep -v '^ \*' "$COLLECTOR_LIST" | grep -o '"\(proc\|sys\)/[^"]*"' | tr -d '"' | sort -u)
+if [ -z "$SOURCES" ]; then
+    echo "No hay fuentes en $COLLECTOR_LIST" >&2
+    exit 1
+fi
+
+i=0
+while [ "$i" -lt "$COUNT" ]; do
+    TS=$(date +%s%3N)
+    SNAP="$DEST/$TS"
+    for pattern in $SOURCES; do
+        # Los comodines se expanden en cada snapshot; los que no coinciden quedan literales y se saltan
+        for f in /$pattern; do
+            [ -f "$f" ] || continue
+            mkdir -p "$SNAP$(dirname "$f")"
+            cat "$f" > "$SNAP$f" 2>/dev/null || true
+        done
+    done
+    i=$((i + 1))
+    sleep "$INTERVAL"
+done
@@ -0,0 +1,47 @@
+#!/bin/sh
+# Mide el arranque en frío de metricShell: desde el exec hasta el primer scrape servido en :8000.
+#
+# Uso: startup_latency.sh <metricShell> [config.json] [repeticiones] [presupuesto_ms]
+#
+# Cada repetición lanza el binario, consulta /metrics cada 1 ms hasta recibir un 200 y lo
+# detiene. Imprime el tiempo de cada repetición y la mediana; falla si la mediana supera el
+# presupuesto. Requiere curl y que el puerto 8000 esté libre.
+
+set -eu
+
+BIN=${1:?"Uso: $0 <metricShell> [config.json] [repeticiones] [presupuesto_ms]"}
+CONFIG=${2:-config/config.json}
+RUNS=${3:-10}
+BUDGET_MS=${4:-20}
+
+now_ms() {
+    date +%s%3N
+}
+
+RESULTS=""
+i=0
+while [ "$i" -lt "$RUNS" ]; do
+    START=$(now_ms)
+    "$BIN" "$CONFIG" >/dev/null 2>&1 &
+    PID=$!
+    until curl -sf -o /dev/null http://127.0.0.1:8000/metrics; do
+        if ! kill -0 "$PID" 2>/dev/null; then
+            echo "metricShell terminó antes de servir /metrics" >&2
+            exit 1
+        fi
+        sleep 0.001
+    done
+    ELAPSED=$(($(now_ms) - START))
+    kill "$PID"
+    wait "$PID" 2>/dev/null || true
+    echo "arranque $((i + 1)): ${ELAPSED} ms"
+    RESULTS="$RESULTS $ELAPSED"
+    i=$((i + 1))
+done
+
+MEDIAN=$(echo "$RESULTS" | tr ' ' '\n' | sed '/^$/d' | sort -n | awk '{v[NR] = $1} END {print v[int((NR + 1) / 2)]}')
+echo "mediana: ${MEDIAN} ms (presupuesto ${BUDGET_MS} ms)"
+if [ "$MEDIAN" -gt "$BUDGET_MS" ]; then
+    echo "El arranque supera el presupuesto" >&2
+    exit 1
+fi